@@ -1,5 +1,5 @@
 from ._core import array, int8, int16, int32, int64, long, float32, float64, double, uint8, uint16, uint32, uint64, boolean
-from ._utils import randn, randint, uniform, linspace, fill, zeros, zeros_like, ones, ones_like, arange
+from ._utils import randn, randint, uniform, linspace, fill, zeros, zeros_like, ones, ones_like, arange, simd_level, set_simd_level, math_mode, set_math_mode, sum_mode, set_sum_mode, get_num_threads, set_num_threads, alloc_stats, reset_alloc_stats, trim_alloc_pool, hugepage_mode, set_hugepage_mode, hugepage_threshold
 from . import linalg
 
 __version__ = '0.0.2'
@@ -1,5 +1,5 @@
 import ctypes, os, sys, platform, sysconfig
-from ctypes import Structure, c_float, c_double, c_int, c_int8, c_int16, c_int32, c_int64, c_uint8, c_uint16, c_uint32, c_uint64, c_size_t, c_void_p, c_char_p, POINTER
+from ctypes import Structure, c_float, c_double, c_int, c_int8, c_int16, c_int32, c_int64, c_uint8, c_uint16, c_uint32, c_uint64, c_size_t, c_ulonglong, c_void_p, c_char_p, c_bool, POINTER
 from typing import *
 
 def _get_lib_path():
@@ -21,7 +21,7 @@ def _get_lib_path():
 lib = ctypes.CDLL(_get_lib_path())
 class DType: FLOAT32, FLOAT64, INT8, INT16, INT32, INT64, UINT8, UINT16, UINT32, UINT64, BOOL = range(11)
 class DTypeValue(ctypes.Union): _fields_ = [('f32', c_float), ('f64', c_double), ('i8', c_int8), ('i16', c_int16), ('i32', c_int32), ('i64', c_int64), ('u8', c_uint8), ('u16', c_uint16), ('u32', c_uint32), ('u64', c_uint64), ('boolean', c_uint8)]
-class CArray(Structure): _fields_ = [('data', c_void_p), ('strides', POINTER(c_int)), ('backstrides', POINTER(c_int)), ('shape', POINTER(c_int)), ('size', c_size_t), ('ndim', c_size_t), ('dtype', c_int), ('is_view', c_int)]
+class CArray(Structure): _fields_ = [('data', c_void_p), ('strides', POINTER(c_int)), ('backstrides', POINTER(c_int)), ('shape', POINTER(c_int)), ('size', c_size_t), ('ndim', c_size_t), ('dtype', c_int), ('is_view', c_int), ('storage', c_void_p), ('dims', c_int * 24)]
 
 def _setup_func(name, argtypes, restype):
   func = getattr(lib, name)
@@ -31,9 +31,11 @@ def _setup_func(name, argtypes, restype):
 _array_funcs = {
   'create_array': ([POINTER(c_float), c_size_t, POINTER(c_int), c_size_t, c_int], POINTER(CArray)), 'delete_array': ([POINTER(CArray)], None), 'delete_data': ([POINTER(CArray)], None),
   'delete_shape': ([POINTER(CArray)], None), 'delete_strides': ([POINTER(CArray)], None), 'print_array': ([POINTER(CArray)], None), 'out_data': ([POINTER(CArray)], POINTER(c_float)),
+  'delete_buffer': ([c_void_p], None), 'storage_refcount_array': ([POINTER(CArray)], c_int), 'hugepage_array': ([POINTER(CArray)], c_int),
   'out_shape': ([POINTER(CArray)], POINTER(c_int)), 'out_strides': ([POINTER(CArray)], POINTER(c_int)), 'out_size': ([POINTER(CArray)], c_int), 'contiguous_array': ([POINTER(CArray)], POINTER(CArray)),
   'is_contiguous_array': ([POINTER(CArray)], POINTER(CArray)), 'make_contiguous_inplace_array': ([POINTER(CArray)], POINTER(CArray)), 'transpose_array': ([POINTER(CArray)], POINTER(CArray)),
-  'view_array': ([POINTER(CArray)], POINTER(CArray)), 'is_view_array': ([POINTER(CArray)], POINTER(CArray)), 'cast_array': ([POINTER(CArray), c_int], POINTER(CArray)), 'cast_array_simple': ([POINTER(CArray), c_int], POINTER(CArray)),
+  'permute_array': ([POINTER(CArray), POINTER(c_int), c_int], POINTER(CArray)),
+  'view_array': ([POINTER(CArray)], POINTER(CArray)), 'is_view_array': ([POINTER(CArray)], c_int), 'cast_array': ([POINTER(CArray), c_int], POINTER(CArray)), 'cast_array_simple': ([POINTER(CArray), c_int], POINTER(CArray)),
   'get_dtype_size': ([c_int], c_size_t), 'get_dtype_name': ([c_int], c_char_p), 'get_item_array': ([POINTER(CArray), POINTER(c_int)], float),
   'set_item_array': ([POINTER(CArray), POINTER(c_int), c_float], None), 'get_linear_index': ([POINTER(CArray), POINTER(c_int)], c_int),
   'dtype_to_float32': ([c_void_p, c_int, c_size_t], c_float), 'float32_to_dtype': ([c_float, c_void_p, c_int, c_size_t], None),
@@ -66,9 +68,10 @@ _array_funcs = {
   'smaller_scalar': ([POINTER(CArray), c_float], POINTER(CArray)), 'smaller_equal_scalar': ([POINTER(CArray), c_float], POINTER(CArray)),
   'reshape_array': ([POINTER(CArray), POINTER(c_int), c_int], POINTER(CArray)), 'squeeze_array': ([POINTER(CArray), c_int], POINTER(CArray)),
   'expand_dims_array': ([POINTER(CArray), c_int], POINTER(CArray)), 'flatten_array': ([POINTER(CArray)], POINTER(CArray)),
-  'sum_array': ([POINTER(CArray), c_int, ctypes.c_bool], POINTER(CArray)), 'min_array': ([POINTER(CArray), c_int, ctypes.c_bool], POINTER(CArray)),
-  'max_array': ([POINTER(CArray), c_int, ctypes.c_bool], POINTER(CArray)), 'mean_array': ([POINTER(CArray), c_int, ctypes.c_bool], POINTER(CArray)),
-  'var_array': ([POINTER(CArray), c_int, c_int], POINTER(CArray)), 'std_array': ([POINTER(CArray), c_int, c_int], POINTER(CArray)),
+  'sum_array': ([POINTER(CArray), POINTER(c_int), c_int, ctypes.c_bool], POINTER(CArray)), 'min_array': ([POINTER(CArray), POINTER(c_int), c_int, ctypes.c_bool], POINTER(CArray)),
+  'max_array': ([POINTER(CArray), POINTER(c_int), c_int, ctypes.c_bool], POINTER(CArray)), 'mean_array': ([POINTER(CArray), POINTER(c_int), c_int, ctypes.c_bool], POINTER(CArray)),
+  'var_array': ([POINTER(CArray), POINTER(c_int), c_int, c_int, ctypes.c_bool], POINTER(CArray)), 'std_array': ([POINTER(CArray), POINTER(c_int), c_int, c_int, ctypes.c_bool], POINTER(CArray)),
+  'mean_var_array': ([POINTER(CArray), POINTER(c_int), c_int, c_int, ctypes.c_bool], POINTER(POINTER(CArray))),
 }
 
 _utils_funcs = {
@@ -76,7 +79,11 @@ _utils_funcs = {
   'zeros_array': ([POINTER(c_int), c_size_t, c_size_t, c_int], POINTER(CArray)), 'ones_array': ([POINTER(c_int), c_size_t, c_size_t, c_int], POINTER(CArray)),
   'randn_array': ([POINTER(c_int), c_size_t, c_size_t, c_int], POINTER(CArray)), 'randint_array': ([c_int, c_int, POINTER(c_int), c_size_t, c_size_t, c_int], POINTER(CArray)),
   'uniform_array': ([c_int, c_int, POINTER(c_int), c_size_t, c_size_t, c_int], POINTER(CArray)), 'fill_array': ([c_float, POINTER(c_int), c_size_t, c_size_t, c_int], POINTER(CArray)),
-  'linspace_array': ([c_float, c_float, c_float, POINTER(c_int), c_size_t, c_size_t, c_int], POINTER(CArray)), 'arange_array': ([c_float, c_float, c_float, c_int], POINTER(CArray))
+  'linspace_array': ([c_float, c_float, c_float, POINTER(c_int), c_size_t, c_size_t, c_int], POINTER(CArray)), 'arange_array': ([c_float, c_float, c_float, c_int], POINTER(CArray)),
+  'get_simd_level': ([], c_int), 'get_simd_name': ([], c_char_p), 'set_simd_level': ([c_int], c_int),
+  'get_math_mode': ([], c_int), 'set_math_mode': ([c_int], c_int), 'get_sum_mode': ([], c_int), 'set_sum_mode': ([c_int], c_int), 'get_num_threads': ([], c_int), 'set_num_threads': ([c_int], c_int),
+  'get_alloc_stats': ([POINTER(c_ulonglong)], None), 'reset_alloc_stats': ([], None), 'trim_alloc_pool': ([], None),
+  'get_hugepage_mode': ([], c_int), 'set_hugepage_mode': ([c_int], c_int), 'get_hugepage_threshold': ([], c_size_t), 'set_hugepage_threshold': ([c_size_t], c_size_t)
 }
 
 _vector_funcs = {
@@ -87,18 +94,22 @@ _vector_funcs = {
   'linear_transform_array': ([POINTER(CArray), POINTER(CArray), POINTER(CArray)], POINTER(CArray)),
   'det_array': ([POINTER(CArray)], POINTER(CArray)), 'batched_det_array': ([POINTER(CArray)], POINTER(CArray)),
   'eig_array': ([POINTER(CArray)], POINTER(CArray)), 'batched_eig_array': ([POINTER(CArray)], POINTER(CArray)),
-  'eigv_array': ([POINTER(CArray)], POINTER(CArray)), 'batched_eigv_array': ([POINTER(CArray)], POINTER(CArray)),
+  'eigv_array': ([POINTER(CArray)], POINTER(CArray)), 'batched_eigv_array': ([POINTER(CArray)], POINTER(CArray)), 'eig_parts_array': ([POINTER(CArray)], POINTER(POINTER(CArray))),
+  'eig_pairs_array': ([POINTER(CArray), c_bool], POINTER(POINTER(CArray))), 'eigh_pairs_array': ([POINTER(CArray)], POINTER(POINTER(CArray))),
   'eigh_array': ([POINTER(CArray)], POINTER(CArray)), 'batched_eigh_array': ([POINTER(CArray)], POINTER(CArray)),
   'eighv_array': ([POINTER(CArray)], POINTER(CArray)), 'batched_eighv_array': ([POINTER(CArray)], POINTER(CArray)),
   'clip_array': ([POINTER(CArray), c_float], POINTER(CArray)), 'clamp_array': ([POINTER(CArray), c_float, c_float], POINTER(CArray)),
   'mm_norm_array': ([POINTER(CArray)], POINTER(CArray)), 'std_norm_array': ([POINTER(CArray)], POINTER(CArray)), 'robust_norm_array': ([POINTER(CArray)], POINTER(CArray)),
   'rms_norm_array': ([POINTER(CArray)], POINTER(CArray)), 'unit_norm_array': ([POINTER(CArray)], POINTER(CArray)),
   'l1_norm_array': ([POINTER(CArray)], POINTER(CArray)), 'l2_norm_array': ([POINTER(CArray)], POINTER(CArray)),
-  'qr_array': ([POINTER(CArray)], POINTER(POINTER(CArray))), 'batched_qr_array': ([POINTER(CArray)], POINTER(POINTER(CArray))),
+  'qr_array': ([POINTER(CArray), c_bool], POINTER(POINTER(CArray))), 'batched_qr_array': ([POINTER(CArray), c_bool], POINTER(POINTER(CArray))),
   'lu_array': ([POINTER(CArray)], POINTER(POINTER(CArray))), 'batched_lu_array': ([POINTER(CArray)], POINTER(POINTER(CArray))),
   'inv_array': ([POINTER(CArray)], POINTER(CArray)), 'matrix_rank_array': ([POINTER(CArray)], POINTER(CArray)),
   'solve_array': ([POINTER(CArray), POINTER(CArray)], POINTER(CArray)), 'lstsq_array': ([POINTER(CArray), POINTER(CArray)], POINTER(CArray)),
-  'svd_array': ([POINTER(CArray)], POINTER(POINTER(CArray))), 'cholesky_array': ([POINTER(CArray)], POINTER(CArray))
+  'svd_array': ([POINTER(CArray), c_bool, c_bool], POINTER(POINTER(CArray))), 'svd_topk_array': ([POINTER(CArray), c_int, c_int, c_int64, c_bool], POINTER(POINTER(CArray))),
+  'eigh_topk_array': ([POINTER(CArray), c_int, c_int64, c_bool], POINTER(POINTER(CArray))), 'cholesky_array': ([POINTER(CArray)], POINTER(CArray)),
+  'lu_factor_array': ([POINTER(CArray)], POINTER(POINTER(CArray))), 'lu_solve_array': ([POINTER(CArray), POINTER(CArray), POINTER(CArray)], POINTER(CArray)),
+  'cho_factor_array': ([POINTER(CArray)], POINTER(CArray)), 'cho_solve_array': ([POINTER(CArray), POINTER(CArray)], POINTER(CArray))
 }
 
 for name, (argtypes, restype) in _array_funcs.items(): _setup_func(name, argtypes, restype)
@@ -6,7 +6,7 @@ from ._helpers import ShapeHelp, DtypeHelp, _get_item_array, _set_item_array, _i
 from .ops.binary import *
 from .ops.unary import *
 from .ops.shape import transpose_array_ops, flatten_array_ops, contiguous_array_ops, view_array_ops, reshape_array_ops, expand_dims_ops, make_contiguous_array_ops, squeeze_array_ops, to_list_array
-from .ops.redux import sum_array_ops, mean_array_ops, max_array_ops, var_array_ops, min_array_ops, std_array_ops
+from .ops.redux import sum_array_ops, mean_array_ops, max_array_ops, var_array_ops, min_array_ops, std_array_ops, mean_var_array_ops
 
 int8, int16, int32, int64, long = "int8", "int16", "int32", "int64", "long"
 float32, float64, double = "float32", "float64", "double"
@@ -16,13 +16,17 @@ boolean = "bool"
 class array:
   int8, int16, int32, int64, long, float32, float64, double, uint8, uint16, uint32, uint64, boolean = int8, int16, int32, int64, long, float32, float64, double, uint8, uint16, uint32, uint64, boolean
   def __init__(self, data: Union[List[Any], int, float], dtype: str=float32):
+    self._owns, self._base = True, None   # wrapping another array shares its c array, `_base` keeps that one alive
     if isinstance(data, CArray): self.data, self.shape, self.size, self.ndim, self.strides, self.dtype = data, (), 0, 0, [], dtype or "float32"
-    elif isinstance(data, array): self.data, self.shape, self.dtype, self.size, self.ndim, self.strides = data.data, data.shape, dtype or data.dtype, data.size, data.ndim, data.strides
+    elif isinstance(data, array): self.data, self.shape, self.dtype, self.size, self.ndim, self.strides, self._owns, self._base = data.data, data.shape, dtype or data.dtype, data.size, data.ndim, data.strides, False, data
     else:
       data, shape = ShapeHelp.flatten([data] if isinstance(data, (int, float)) else data), tuple(ShapeHelp.get_shape(data))
       self.size, self.ndim, self.dtype, self.shape, self.strides = len(data), len(shape), dtype or "float32", shape, ShapeHelp.get_strides(shape)
       self._data_ctypes, self._shape_ctypes = (c_float * self.size)(*data.copy()), (c_int * self.ndim)(*shape)
       self.data = lib.create_array(self._data_ctypes, c_size_t(self.ndim), self._shape_ctypes, c_size_t(self.size), c_int(DtypeHelp._parse_dtype(self.dtype)))
+  def __del__(self):
+    # views hold their own reference on the shared storage, so deleting a base never frees a live view's data
+    if getattr(self, "_owns", False) and hasattr(self, "data") and lib is not None: lib.delete_array(self.data)
   def astype(self, dtype: str) -> "array":
     out = array(lib.cast_array(self.data, c_int(DtypeHelp._parse_dtype(dtype))).contents, dtype)
     out.shape, out.size, out.ndim, out.strides = self.shape, self.size, self.ndim, self.strides
@@ -31,6 +35,7 @@ class array:
   def __str__(self) -> str: return (lib.print_array(self.data), "")[1]
   def is_contiguous(self) -> bool: return bool(lib.is_contiguous_array(self.data))
   def is_view(self) -> bool:  return bool(lib.is_view_array(self.data))
+  def is_hugepage(self) -> bool: return lib.hugepage_array(self.data) != 0
   def __hash__(self): return id(self)
   def __getitem__(self, key): return _get_item_array(self, key)
   def __setitem__(self, key, value): return _set_item_array(self, key, value)
@@ -63,46 +68,54 @@ class array:
   def sinh(self) -> "array": return sinh_array_ops(self)
   def cosh(self) -> "array": return cosh_array_ops(self)
   def tanh(self) -> "array": return tanh_array_ops(self)
-  def transpose(self) -> "array": return transpose_array_ops(self)
+  def transpose(self, *axes) -> "array": return transpose_array_ops(self, list(axes[0] if len(axes) == 1 and isinstance(axes[0], (list, tuple)) else axes) or None)
+  def permute(self, *axes) -> "array": return transpose_array_ops(self, list(axes[0] if len(axes) == 1 and isinstance(axes[0], (list, tuple)) else axes))
   def reshape(self, new_shape: Union[List[int], Tuple[int]]) -> "array": return reshape_array_ops(self, new_shape)
   def squeeze(self, axis: int = -1) -> "array": return squeeze_array_ops(self, axis)
   def expand_dims(self, axis: int) -> "array": return expand_dims_ops(self, axis)
   def flatten(self) -> "array": return flatten_array_ops(self)
   def clip(self, max: float): return clip_norm_ops(self, max)
   def clamp(self, max: float, min: float): return clamp_norm_ops(self, max, min)
-  def sum(self, axis: int = -1, keepdims: bool = False) -> "array": return sum_array_ops(self, axis, keepdims)
-  def mean(self, axis: int = -1, keepdims: bool = False) -> "array": return mean_array_ops(self, axis, keepdims)
-  def max(self, axis: int = -1, keepdims: bool = False) -> "array": return max_array_ops(self, axis, keepdims)
-  def min(self, axis: int = -1, keepdims: bool = False) -> "array": return min_array_ops(self, axis, keepdims)
-  def var(self, axis: int = -1, ddof: int = 0) -> "array": return var_array_ops(self, axis, ddof)
-  def std(self, axis: int = -1, ddof: int = 0) -> "array": return std_array_ops(self, axis, ddof)
+  def sum(self, axis: Optional[Union[int, Tuple[int, ...]]] = None, keepdims: bool = False) -> "array": return sum_array_ops(self, axis, keepdims)
+  def mean(self, axis: Optional[Union[int, Tuple[int, ...]]] = None, keepdims: bool = False) -> "array": return mean_array_ops(self, axis, keepdims)
+  def max(self, axis: Optional[Union[int, Tuple[int, ...]]] = None, keepdims: bool = False) -> "array": return max_array_ops(self, axis, keepdims)
+  def min(self, axis: Optional[Union[int, Tuple[int, ...]]] = None, keepdims: bool = False) -> "array": return min_array_ops(self, axis, keepdims)
+  def var(self, axis: Optional[Union[int, Tuple[int, ...]]] = None, ddof: int = 0, keepdims: bool = False) -> "array": return var_array_ops(self, axis, ddof, keepdims)
+  def std(self, axis: Optional[Union[int, Tuple[int, ...]]] = None, ddof: int = 0, keepdims: bool = False) -> "array": return std_array_ops(self, axis, ddof, keepdims)
+  def mean_var(self, axis: Optional[Union[int, Tuple[int, ...]]] = None, ddof: int = 0, keepdims: bool = False) -> Tuple["array", "array"]: return mean_var_array_ops(self, axis, ddof, keepdims)
   def __eq__(self, other) -> "array":
     other = other if isinstance(other, (CArray, array)) or isinstance(other, (int, float)) else array(other)
     if isinstance(other, (int, float)): out = array(lib.equal_scalar(self.data, c_float(other)).contents, DType.BOOL)
     else: out = array(lib.equal_array(self.data, other.data).contents, DType.BOOL)
-    return (setattr(out, "shape", self.shape), setattr(out, "size", self.size), setattr(out, "ndim", self.ndim), setattr(out, "strides", self.strides), out)[4]
+    shape = self.shape if isinstance(other, (int, float)) else ShapeHelp.broadcast_shapes(self.shape, other.shape)[0]
+    return (setattr(out, "shape", shape), setattr(out, "size", ShapeHelp.get_size(shape)), setattr(out, "ndim", len(shape)), setattr(out, "strides", ShapeHelp.get_strides(shape)), out)[4]
   def __ne__(self, other) -> "array":
     other = other if isinstance(other, (CArray, array)) or isinstance(other, (int, float)) else array(other)
     if isinstance(other, (int, float)): out = array(lib.not_equal_scalar(self.data, c_float(other)).contents, DType.BOOL)
     else: out = array(lib.not_equal_array(self.data, other.data).contents, DType.BOOL)
-    return (setattr(out, "shape", self.shape), setattr(out, "size", self.size), setattr(out, "ndim", self.ndim), setattr(out, "strides", self.strides), out)[4]
+    shape = self.shape if isinstance(other, (int, float)) else ShapeHelp.broadcast_shapes(self.shape, other.shape)[0]
+    return (setattr(out, "shape", shape), setattr(out, "size", ShapeHelp.get_size(shape)), setattr(out, "ndim", len(shape)), setattr(out, "strides", ShapeHelp.get_strides(shape)), out)[4]
   def __gt__(self, other) -> "array":
     other = other if isinstance(other, (CArray, array)) or isinstance(other, (int, float)) else array(other)
     if isinstance(other, (int, float)): out = array(lib.greater_scalar(self.data, c_float(other)).contents, DType.BOOL)
     else: out = array(lib.greater_array(self.data, other.data).contents, DType.BOOL)
-    return (setattr(out, "shape", self.shape), setattr(out, "size", self.size), setattr(out, "ndim", self.ndim), setattr(out, "strides", self.strides), out)[4]
+    shape = self.shape if isinstance(other, (int, float)) else ShapeHelp.broadcast_shapes(self.shape, other.shape)[0]
+    return (setattr(out, "shape", shape), setattr(out, "size", ShapeHelp.get_size(shape)), setattr(out, "ndim", len(shape)), setattr(out, "strides", ShapeHelp.get_strides(shape)), out)[4]
   def __lt__(self, other) -> "array":
     other = other if isinstance(other, (CArray, array)) or isinstance(other, (int, float)) else array(other)
     if isinstance(other, (int, float)): out = array(lib.smaller_scalar(self.data, c_float(other)).contents, DType.BOOL)
     else: out = array(lib.smaller_array(self.data, other.data).contents, DType.BOOL)
-    return (setattr(out, "shape", self.shape), setattr(out, "size", self.size), setattr(out, "ndim", self.ndim), setattr(out, "strides", self.strides), out)[4]
+    shape = self.shape if isinstance(other, (int, float)) else ShapeHelp.broadcast_shapes(self.shape, other.shape)[0]
+    return (setattr(out, "shape", shape), setattr(out, "size", ShapeHelp.get_size(shape)), setattr(out, "ndim", len(shape)), setattr(out, "strides", ShapeHelp.get_strides(shape)), out)[4]
   def __ge__(self, other) -> "array":
     other = other if isinstance(other, (CArray, array)) or isinstance(other, (int, float)) else array(other)
     if isinstance(other, (int, float)): out = array(lib.greater_equal_scalar(self.data, c_float(other)).contents, DType.BOOL)
     else: out = array(lib.greater_equal_array(self.data, other.data).contents, DType.BOOL)
-    return (setattr(out, "shape", self.shape), setattr(out, "size", self.size), setattr(out, "ndim", self.ndim), setattr(out, "strides", self.strides), out)[4]
+    shape = self.shape if isinstance(other, (int, float)) else ShapeHelp.broadcast_shapes(self.shape, other.shape)[0]
+    return (setattr(out, "shape", shape), setattr(out, "size", ShapeHelp.get_size(shape)), setattr(out, "ndim", len(shape)), setattr(out, "strides", ShapeHelp.get_strides(shape)), out)[4]
   def __le__(self, other) -> "array":
     other = other if isinstance(other, (CArray, array)) or isinstance(other, (int, float)) else array(other)
     if isinstance(other, (int, float)): out = array(lib.smaller_equal_scalar(self.data, c_float(other)).contents, DType.BOOL)
     else: out = array(lib.smaller_equal_array(self.data, other.data).contents, DType.BOOL)
-    return (setattr(out, "shape", self.shape), setattr(out, "size", self.size), setattr(out, "ndim", self.ndim), setattr(out, "strides", self.strides), out)[4]
\ No newline at end of file
+    shape = self.shape if isinstance(other, (int, float)) else ShapeHelp.broadcast_shapes(self.shape, other.shape)[0]
+    return (setattr(out, "shape", shape), setattr(out, "size", ShapeHelp.get_size(shape)), setattr(out, "ndim", len(shape)), setattr(out, "strides", ShapeHelp.get_strides(shape)), out)[4]
\ No newline at end of file
@@ -1,5 +1,5 @@
 from ._cbase import CArray, lib, DType
-from ctypes import c_int, c_size_t, c_float
+from ctypes import c_int, c_size_t, c_float, c_ulonglong
 from typing import *
 from ._helpers import ShapeHelp, DtypeHelp
 from ._core import array
@@ -53,4 +53,59 @@ def arange(start: float, stop: float, step: float = 1.0, dtype: str = "float32")
   c_array = lib.arange_array(c_float(start), c_float(stop), c_float(step), c_int(DtypeHelp._parse_dtype(dtype)))
   sz = lib.out_size(c_array)
   out = array(c_array.contents, dtype)
-  return (setattr(out, "shape", (sz,)), setattr(out, "ndim", 1), setattr(out, "size", sz), setattr(out, "strides", ShapeHelp.get_strides((sz,))), out)[4]
\ No newline at end of file
+  return (setattr(out, "shape", (sz,)), setattr(out, "ndim", 1), setattr(out, "size", sz), setattr(out, "strides", ShapeHelp.get_strides((sz,))), out)[4]
+
+_SIMD_LEVELS = ("scalar", "sse4", "avx2", "avx512")
+
+def simd_level() -> str: return lib.get_simd_name().decode()
+
+def set_simd_level(level: str) -> str:
+  if level not in _SIMD_LEVELS: raise ValueError(f"Unknown simd level '{level}', expected one of {_SIMD_LEVELS}")
+  return _SIMD_LEVELS[lib.set_simd_level(c_int(_SIMD_LEVELS.index(level)))]
+
+_MATH_MODES = ("exact", "fast")
+
+def math_mode() -> str: return _MATH_MODES[lib.get_math_mode()]
+
+def set_math_mode(mode: str) -> str:
+  if mode not in _MATH_MODES: raise ValueError(f"Unknown math mode '{mode}', expected one of {_MATH_MODES}")
+  return _MATH_MODES[lib.set_math_mode(c_int(_MATH_MODES.index(mode)))]
+
+_SUM_MODES = ("pairwise", "kahan")
+
+def sum_mode() -> str: return _SUM_MODES[lib.get_sum_mode()]
+
+def set_sum_mode(mode: str) -> str:
+  if mode not in _SUM_MODES: raise ValueError(f"Unknown sum mode '{mode}', expected one of {_SUM_MODES}")
+  return _SUM_MODES[lib.set_sum_mode(c_int(_SUM_MODES.index(mode)))]
+
+def get_num_threads() -> int: return lib.get_num_threads()
+
+def set_num_threads(n: int) -> int:
+  if not isinstance(n, int) or n < 0: raise ValueError(f"Thread count must be a non-negative int (0 restores the default), got {n!r}")
+  return lib.set_num_threads(c_int(n))
+
+_ALLOC_STATS = ("hits", "misses", "large", "recycled", "released", "cached_bytes")
+
+def alloc_stats() -> Dict[str, Union[int, float]]:
+  counts = (c_ulonglong * len(_ALLOC_STATS))()
+  lib.get_alloc_stats(counts)
+  stats = dict(zip(_ALLOC_STATS, counts))
+  pooled = stats["hits"] + stats["misses"]
+  return {**stats, "hit_rate": stats["hits"] / pooled if pooled else 0.0}
+
+def reset_alloc_stats() -> None: lib.reset_alloc_stats()
+def trim_alloc_pool() -> None: lib.trim_alloc_pool()
+
+_HUGEPAGE_MODES = ("off", "thp", "explicit")
+
+def hugepage_mode() -> str: return _HUGEPAGE_MODES[lib.get_hugepage_mode()]
+
+def set_hugepage_mode(mode: str, threshold: Optional[int] = None) -> str:
+  if mode not in _HUGEPAGE_MODES: raise ValueError(f"Unknown huge page mode '{mode}', expected one of {_HUGEPAGE_MODES}")
+  if threshold is not None:
+    if not isinstance(threshold, int) or threshold < 0: raise ValueError(f"Huge page threshold must be a non-negative int of bytes (0 restores the default), got {threshold!r}")
+    lib.set_hugepage_threshold(c_size_t(threshold))
+  return _HUGEPAGE_MODES[lib.set_hugepage_mode(c_int(_HUGEPAGE_MODES.index(mode)))]
+
+def hugepage_threshold() -> int: return lib.get_hugepage_threshold()
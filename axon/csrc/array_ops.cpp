@@ -3,6 +3,34 @@
 #include "array_ops.h"
 #include "cpu/ops_array.h"
 
+// matmul operands in `dtype`: an array that already has it is read in place through its own strides
+// (transposed & sliced views included), anything else is converted into a dense copy; `strides`
+// gets the element strides to read it with, release the data with release_dtype_data()
+static void* matmul_operand(Array* x, dtype_t dtype, int* strides) {
+  if (x->dtype == dtype) {
+    for (size_t d = 0; d < x->ndim; d++) strides[d] = x->strides[d];
+    return x->data;
+  }
+  int stride = 1;
+  for (int d = (int)x->ndim - 1; d >= 0; d--) {
+    strides[d] = stride;
+    stride *= x->shape[d];
+  }
+  return as_contiguous_data(x, dtype);
+}
+
+// dot operands in `dtype`: vectors that are dense along their last dim are read in place with
+// `*row_stride` between the rows (batch_dot), the rest go through a dense copy like matmul_operand
+static void* dot_operand(Array* x, dtype_t dtype, int* row_stride) {
+  int last = x->ndim ? x->shape[x->ndim - 1] : 1;
+  if (x->dtype == dtype && (last <= 1 || x->strides[x->ndim - 1] == 1)) {
+    *row_stride = (x->ndim == 2) ? x->strides[0] : last;
+    return x->data;
+  }
+  *row_stride = last;
+  return as_contiguous_data(x, dtype);
+}
+
 Array* matmul_array(Array* a, Array* b) {
   if (a == NULL || b == NULL) {
     fprintf(stderr, "Array value pointers are null!\n");
@@ -17,43 +45,32 @@ Array* matmul_array(Array* a, Array* b) {
     exit(EXIT_FAILURE);
   }
 
-  // converting both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-  if (a_float == NULL || b_float == NULL) {
+  // both operands are promoted to the result dtype, views that already have it are read in place
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
+  int a_strides[2], b_strides[2];
+  void* a_data = matmul_operand(a, result_dtype, a_strides);
+  void* b_data = matmul_operand(b, result_dtype, b_strides);
+  if (a_data == NULL || b_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
     exit(EXIT_FAILURE);
   }
 
   int* result_shape = (int*)malloc(2 * sizeof(int));    // result shape: [a->shape[0], b->shape[1]]
   if (result_shape == NULL) {
     fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
+    release_dtype_data(a_data, a->data);
+    release_dtype_data(b_data, b->data);
     exit(EXIT_FAILURE);
   }
   result_shape[0] = a->shape[0];
   result_shape[1] = b->shape[1];  // result is A rows × B rows (since we're doing A @ B^T)
   size_t result_size = result_shape[0] * result_shape[1];
 
-  float* out = (float*)malloc(result_size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    free(result_shape);
-    exit(EXIT_FAILURE);
-  }
-
   // performing optimized matrix multiplication (regular A @ B)
-  matmul_array_ops(a_float, b_float, out, a->shape, b->shape);
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, 2, result_shape, result_size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
+  Array* result = empty_array(2, result_shape, result_size, result_dtype);
+  matmul_array_ops(a_data, b_data, result->data, a->shape, b->shape, a_strides, b_strides, result_dtype);
+  release_dtype_data(a_data, a->data);
+  release_dtype_data(b_data, b->data);
   free(result_shape);
   return result;
 }
@@ -76,14 +93,13 @@ Array* batch_matmul_array(Array* a, Array* b) {
     exit(EXIT_FAILURE);
   }
 
-  // converting both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-
-  if (a_float == NULL || b_float == NULL) {
+  // both operands are promoted to the result dtype, views that already have it are read in place
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
+  int a_strides[3], b_strides[3];
+  void* a_data = matmul_operand(a, result_dtype, a_strides);
+  void* b_data = matmul_operand(b, result_dtype, b_strides);
+  if (a_data == NULL || b_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
     exit(EXIT_FAILURE);
   }
 
@@ -91,8 +107,8 @@ Array* batch_matmul_array(Array* a, Array* b) {
   int* result_shape = (int*)malloc(3 * sizeof(int));
   if (result_shape == NULL) {
     fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
+    release_dtype_data(a_data, a->data);
+    release_dtype_data(b_data, b->data);
     exit(EXIT_FAILURE);
   }
   result_shape[0] = a->shape[0];
@@ -100,25 +116,10 @@ Array* batch_matmul_array(Array* a, Array* b) {
   result_shape[2] = b->shape[2];
   size_t result_size = result_shape[0] * result_shape[1] * result_shape[2];
 
-  float* out = (float*)malloc(result_size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    free(result_shape);
-    exit(EXIT_FAILURE);
-  }
-
-  // calculate strides for batch matmul
-  int a_strides[3] = {a->shape[1] * a->shape[2], a->shape[2], 1};
-  int b_strides[3] = {b->shape[1] * b->shape[2], b->shape[2], 1};
-
-  batch_matmul_array_ops(a_float, b_float, out, a->shape, b->shape, a_strides, b_strides);
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, 3, result_shape, result_size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
+  Array* result = empty_array(3, result_shape, result_size, result_dtype);
+  batch_matmul_array_ops(a_data, b_data, result->data, a->shape, b->shape, a_strides, b_strides, result_dtype);
+  release_dtype_data(a_data, a->data);
+  release_dtype_data(b_data, b->data);
   free(result_shape);
   return result;
 }
@@ -137,14 +138,13 @@ Array* broadcasted_matmul_array(Array* a, Array* b) {
     exit(EXIT_FAILURE);
   }
 
-  // converting both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-
-  if (a_float == NULL || b_float == NULL) {
+  // both operands are promoted to the result dtype, views that already have it are read in place
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
+  int a_strides[2], b_strides[3];
+  void* a_data = matmul_operand(a, result_dtype, a_strides);
+  void* b_data = matmul_operand(b, result_dtype, b_strides);
+  if (a_data == NULL || b_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
     exit(EXIT_FAILURE);
   }
 
@@ -152,8 +152,8 @@ Array* broadcasted_matmul_array(Array* a, Array* b) {
   int* result_shape = (int*)malloc(3 * sizeof(int));
   if (result_shape == NULL) {
     fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
+    release_dtype_data(a_data, a->data);
+    release_dtype_data(b_data, b->data);
     exit(EXIT_FAILURE);
   }
   result_shape[0] = b->shape[0];
@@ -161,25 +161,10 @@ Array* broadcasted_matmul_array(Array* a, Array* b) {
   result_shape[2] = b->shape[2];
   size_t result_size = result_shape[0] * result_shape[1] * result_shape[2];
 
-  float* out = (float*)malloc(result_size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    free(result_shape);
-    exit(EXIT_FAILURE);
-  }
-
-  // calculate strides
-  int a_strides[2] = {a->shape[1], 1};
-  int b_strides[3] = {b->shape[1] * b->shape[2], b->shape[2], 1};
-
-  broadcasted_matmul_array_ops(a_float, b_float, out, a->shape, b->shape, a_strides, b_strides);
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, 3, result_shape, result_size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
+  Array* result = empty_array(3, result_shape, result_size, result_dtype);
+  broadcasted_matmul_array_ops(a_data, b_data, result->data, a->shape, b->shape, a_strides, b_strides, result_dtype);
+  release_dtype_data(a_data, a->data);
+  release_dtype_data(b_data, b->data);
   free(result_shape);
   return result;
 }
@@ -198,14 +183,13 @@ Array* dot_array(Array* a, Array* b) {
     exit(EXIT_FAILURE);
   }
 
-  // converting both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-
-  if (a_float == NULL || b_float == NULL) {
+  // both operands are promoted to the result dtype, dense vectors that already have it are read in place
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
+  int a_stride, b_stride;
+  void* a_data = dot_operand(a, result_dtype, &a_stride);
+  void* b_data = dot_operand(b, result_dtype, &b_stride);
+  if (a_data == NULL || b_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
     exit(EXIT_FAILURE);
   }
 
@@ -213,27 +197,16 @@ Array* dot_array(Array* a, Array* b) {
   int* result_shape = (int*)malloc(1 * sizeof(int));
   if (result_shape == NULL) {
     fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
+    release_dtype_data(a_data, a->data);
+    release_dtype_data(b_data, b->data);
     exit(EXIT_FAILURE);
   }
   result_shape[0] = 1;
 
-  float* out = (float*)malloc(sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    free(result_shape);
-    exit(EXIT_FAILURE);
-  }
-
-  dot_array_ops(a_float, b_float, out, a->size);
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, 0, NULL, 1, result_dtype);  // 0D array for scalar
-  free(a_float);
-  free(b_float);
-  free(out);
+  Array* result = empty_array(0, NULL, 1, result_dtype);  // 0D array for scalar
+  dot_array_ops(a_data, b_data, result->data, a->size, result_dtype);
+  release_dtype_data(a_data, a->data);
+  release_dtype_data(b_data, b->data);
   free(result_shape);
   return result;
 }
@@ -252,14 +225,13 @@ Array* batch_dot_array(Array* a, Array* b) {
     exit(EXIT_FAILURE);
   }
 
-  // converting both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-
-  if (a_float == NULL || b_float == NULL) {
+  // both operands are promoted to the result dtype, dense vectors that already have it are read in place
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
+  int a_stride, b_stride;
+  void* a_data = dot_operand(a, result_dtype, &a_stride);
+  void* b_data = dot_operand(b, result_dtype, &b_stride);
+  if (a_data == NULL || b_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
     exit(EXIT_FAILURE);
   }
 
@@ -267,28 +239,17 @@ Array* batch_dot_array(Array* a, Array* b) {
   int* result_shape = (int*)malloc(1 * sizeof(int));
   if (result_shape == NULL) {
     fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
+    release_dtype_data(a_data, a->data);
+    release_dtype_data(b_data, b->data);
     exit(EXIT_FAILURE);
   }
   result_shape[0] = a->shape[0];
   size_t result_size = result_shape[0];
 
-  float* out = (float*)malloc(result_size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    free(result_shape);
-    exit(EXIT_FAILURE);
-  }
-
-  batch_dot_array_ops(a_float, b_float, out, a->shape[0], a->shape[1]);
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, 1, result_shape, result_size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
+  Array* result = empty_array(1, result_shape, result_size, result_dtype);
+  batch_dot_array_ops(a_data, b_data, result->data, a->shape[0], a->shape[1], a_stride, b_stride, result_dtype);
+  release_dtype_data(a_data, a->data);
+  release_dtype_data(b_data, b->data);
   free(result_shape);
   return result;
 }
\ No newline at end of file
@@ -21,31 +21,16 @@ Array* add_array(Array* a, Array* b) {
     }
   }
 
-  // converting both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-
-  if (a_float == NULL || b_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
-    exit(EXIT_FAILURE);
-  }
-
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    exit(EXIT_FAILURE);
-  }
-  add_ops(a_float, b_float, out, a->size);  // Perform the addition operation
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);  // determining result dtype
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
-
+  // operands are promoted to the result dtype, no-op when they already match
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
+  Array* a_cast = as_dtype_array(a, result_dtype);
+  Array* b_cast = as_dtype_array(b, result_dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_binary(&it, a_cast, b_cast, result);
+  add_ops(&it, result_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
   return result;
 }
 
@@ -54,24 +39,11 @@ Array* add_scalar_array(Array* a, float b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  // converting both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    exit(1);
-  }
-  add_scalar_ops(a_float, b, out, a->size);  // Perform the addition operation
-  dtype_t result_dtype = a->dtype;  // determining result dtype
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
 
+  Array* result = empty_array(a->ndim, a->shape, a->size, a->dtype);   // scalar ops keep the array's dtype
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  add_scalar_ops(&it, b, a->dtype);
   return result;
 }
 
@@ -80,54 +52,21 @@ Array* add_broadcasted_array(Array* a, Array* b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  int max_ndim = a->ndim > b->ndim ? a->ndim : b->ndim;
-  int* broadcasted_shape = (int*)malloc(max_ndim * sizeof(int));
-  if (broadcasted_shape == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    exit(EXIT_FAILURE);
-  }
-  for (int i = 0; i < max_ndim; i++) {
-    int dim1 = i < a->ndim ? a->shape[a->ndim - 1 - i] : 1;
-    int dim2 = i < b->ndim ? b->shape[b->ndim - 1 - i] : 1;
-    if (dim1 != dim2 && dim1 != 1 && dim2 != 1) {
-      fprintf(stderr, "shapes are not compatible for broadcasting\n");
-      free(broadcasted_shape);
-      exit(EXIT_FAILURE);
-    }
-    broadcasted_shape[max_ndim - 1 - i] = dim1 > dim2 ? dim1 : dim2;
-  }
+  int* broadcasted_shape;
+  size_t broadcasted_size;
+  int max_ndim = broadcast_shape(a, b, &broadcasted_shape, &broadcasted_size);
 
-  // calculate broadcasted size
-  size_t broadcasted_size = 1;
-  for (int i = 0; i < max_ndim; i++) {
-    broadcasted_size *= broadcasted_shape[i];
-  }
-  // convert both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-  if (a_float == NULL || b_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
-    free(broadcasted_shape);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(broadcasted_size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    free(broadcasted_shape);
-    exit(EXIT_FAILURE);
-  }
-  add_broadcasted_array_ops(a_float, b_float, out, broadcasted_shape, broadcasted_size, a->ndim, b->ndim, a->shape, b->shape);
   // determining result dtype using proper dtype promotion
   dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, max_ndim, broadcasted_shape, broadcasted_size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
-  free(broadcasted_shape);  
+  Array* a_cast = as_dtype_array(a, result_dtype);
+  Array* b_cast = as_dtype_array(b, result_dtype);
+  Array* result = empty_array(max_ndim, broadcasted_shape, broadcasted_size, result_dtype);
+  NdIter it;
+  iter_init_broadcast(&it, a_cast, b_cast, result);   // zero strides on the broadcast dims, no index math per element
+  add_ops(&it, result_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
+  free(broadcasted_shape);
   return result;
 }
 
@@ -149,31 +88,16 @@ Array* sub_array(Array* a, Array* b) {
     }
   }
 
-  // converting both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-
-  if (a_float == NULL || b_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
-    exit(EXIT_FAILURE);
-  }
-
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    exit(EXIT_FAILURE);
-  }
-  sub_ops(a_float, b_float, out, a->size);  // Perform the addition operation
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);  // determining result dtype
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
-
+  // operands are promoted to the result dtype, no-op when they already match
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
+  Array* a_cast = as_dtype_array(a, result_dtype);
+  Array* b_cast = as_dtype_array(b, result_dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_binary(&it, a_cast, b_cast, result);
+  sub_ops(&it, result_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
   return result;
 }
 
@@ -182,23 +106,11 @@ Array* sub_scalar_array(Array* a, float b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    exit(1);
-  }
-  sub_scalar_ops(a_float, b, out, a->size);  // Perform the addition operation
-  dtype_t result_dtype = a->dtype;  // determining result dtype
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
 
+  Array* result = empty_array(a->ndim, a->shape, a->size, a->dtype);   // scalar ops keep the array's dtype
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  sub_scalar_ops(&it, b, a->dtype);
   return result;
 }
 
@@ -207,54 +119,21 @@ Array* sub_broadcasted_array(Array* a, Array* b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  int max_ndim = a->ndim > b->ndim ? a->ndim : b->ndim;
-  int* broadcasted_shape = (int*)malloc(max_ndim * sizeof(int));
-  if (broadcasted_shape == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    exit(EXIT_FAILURE);
-  }
-  for (int i = 0; i < max_ndim; i++) {
-    int dim1 = i < a->ndim ? a->shape[a->ndim - 1 - i] : 1;
-    int dim2 = i < b->ndim ? b->shape[b->ndim - 1 - i] : 1;
-    if (dim1 != dim2 && dim1 != 1 && dim2 != 1) {
-      fprintf(stderr, "shapes are not compatible for broadcasting\n");
-      free(broadcasted_shape);
-      exit(EXIT_FAILURE);
-    }
-    broadcasted_shape[max_ndim - 1 - i] = dim1 > dim2 ? dim1 : dim2;
-  }
+  int* broadcasted_shape;
+  size_t broadcasted_size;
+  int max_ndim = broadcast_shape(a, b, &broadcasted_shape, &broadcasted_size);
 
-  // calculate broadcasted size
-  size_t broadcasted_size = 1;
-  for (int i = 0; i < max_ndim; i++) {
-    broadcasted_size *= broadcasted_shape[i];
-  }
-  // convert both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-  if (a_float == NULL || b_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
-    free(broadcasted_shape);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(broadcasted_size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    free(broadcasted_shape);
-    exit(EXIT_FAILURE);
-  }
-  sub_broadcasted_array_ops(a_float, b_float, out, broadcasted_shape, broadcasted_size, a->ndim, b->ndim, a->shape, b->shape);
   // determining result dtype using proper dtype promotion
   dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, max_ndim, broadcasted_shape, broadcasted_size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
-  free(broadcasted_shape);  
+  Array* a_cast = as_dtype_array(a, result_dtype);
+  Array* b_cast = as_dtype_array(b, result_dtype);
+  Array* result = empty_array(max_ndim, broadcasted_shape, broadcasted_size, result_dtype);
+  NdIter it;
+  iter_init_broadcast(&it, a_cast, b_cast, result);
+  sub_ops(&it, result_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
+  free(broadcasted_shape);
   return result;
 }
 
@@ -276,31 +155,16 @@ Array* mul_array(Array* a, Array* b) {
     }
   }
 
-  // converting both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-
-  if (a_float == NULL || b_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
-    exit(EXIT_FAILURE);
-  }
-
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    exit(EXIT_FAILURE);
-  }
-  mul_ops(a_float, b_float, out, a->size);  // Perform the addition operation
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);  // determining result dtype
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
-
+  // operands are promoted to the result dtype, no-op when they already match
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
+  Array* a_cast = as_dtype_array(a, result_dtype);
+  Array* b_cast = as_dtype_array(b, result_dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_binary(&it, a_cast, b_cast, result);
+  mul_ops(&it, result_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
   return result;
 }
 
@@ -309,23 +173,11 @@ Array* mul_scalar_array(Array* a, float b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    exit(1);
-  }
-  mul_scalar_ops(a_float, b, out, a->size);  // Perform the addition operation
-  dtype_t result_dtype = a->dtype;  // determining result dtype
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
 
+  Array* result = empty_array(a->ndim, a->shape, a->size, a->dtype);   // scalar ops keep the array's dtype
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  mul_scalar_ops(&it, b, a->dtype);
   return result;
 }
 
@@ -334,54 +186,21 @@ Array* mul_broadcasted_array(Array* a, Array* b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  int max_ndim = a->ndim > b->ndim ? a->ndim : b->ndim;
-  int* broadcasted_shape = (int*)malloc(max_ndim * sizeof(int));
-  if (broadcasted_shape == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    exit(EXIT_FAILURE);
-  }
-  for (int i = 0; i < max_ndim; i++) {
-    int dim1 = i < a->ndim ? a->shape[a->ndim - 1 - i] : 1;
-    int dim2 = i < b->ndim ? b->shape[b->ndim - 1 - i] : 1;
-    if (dim1 != dim2 && dim1 != 1 && dim2 != 1) {
-      fprintf(stderr, "shapes are not compatible for broadcasting\n");
-      free(broadcasted_shape);
-      exit(EXIT_FAILURE);
-    }
-    broadcasted_shape[max_ndim - 1 - i] = dim1 > dim2 ? dim1 : dim2;
-  }
+  int* broadcasted_shape;
+  size_t broadcasted_size;
+  int max_ndim = broadcast_shape(a, b, &broadcasted_shape, &broadcasted_size);
 
-  // calculate broadcasted size
-  size_t broadcasted_size = 1;
-  for (int i = 0; i < max_ndim; i++) {
-    broadcasted_size *= broadcasted_shape[i];
-  }
-  // convert both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-  if (a_float == NULL || b_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
-    free(broadcasted_shape);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(broadcasted_size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    free(broadcasted_shape);
-    exit(EXIT_FAILURE);
-  }
-  mul_broadcasted_array_ops(a_float, b_float, out, broadcasted_shape, broadcasted_size, a->ndim, b->ndim, a->shape, b->shape);
   // determining result dtype using proper dtype promotion
   dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, max_ndim, broadcasted_shape, broadcasted_size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
-  free(broadcasted_shape);  
+  Array* a_cast = as_dtype_array(a, result_dtype);
+  Array* b_cast = as_dtype_array(b, result_dtype);
+  Array* result = empty_array(max_ndim, broadcasted_shape, broadcasted_size, result_dtype);
+  NdIter it;
+  iter_init_broadcast(&it, a_cast, b_cast, result);
+  mul_ops(&it, result_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
+  free(broadcasted_shape);
   return result;
 }
 
@@ -403,31 +222,16 @@ Array* div_array(Array* a, Array* b) {
     }
   }
 
-  // converting both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-
-  if (a_float == NULL || b_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
-    exit(EXIT_FAILURE);
-  }
-
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    exit(EXIT_FAILURE);
-  }
-  div_ops(a_float, b_float, out, a->size);  // Perform the addition operation
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);  // determining result dtype
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
-
+  // operands are promoted to the result dtype, no-op when they already match
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
+  Array* a_cast = as_dtype_array(a, result_dtype);
+  Array* b_cast = as_dtype_array(b, result_dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_binary(&it, a_cast, b_cast, result);
+  div_ops(&it, result_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
   return result;
 }
 
@@ -436,23 +240,11 @@ Array* div_scalar_array(Array* a, float b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    exit(1);
-  }
-  div_scalar_ops(a_float, b, out, a->size);  // Perform the addition operation
-  dtype_t result_dtype = a->dtype;  // determining result dtype
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
 
+  Array* result = empty_array(a->ndim, a->shape, a->size, a->dtype);   // scalar ops keep the array's dtype
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  div_scalar_ops(&it, b, a->dtype);
   return result;
 }
 
@@ -461,54 +253,21 @@ Array* div_broadcasted_array(Array* a, Array* b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  int max_ndim = a->ndim > b->ndim ? a->ndim : b->ndim;
-  int* broadcasted_shape = (int*)malloc(max_ndim * sizeof(int));
-  if (broadcasted_shape == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    exit(EXIT_FAILURE);
-  }
-  for (int i = 0; i < max_ndim; i++) {
-    int dim1 = i < a->ndim ? a->shape[a->ndim - 1 - i] : 1;
-    int dim2 = i < b->ndim ? b->shape[b->ndim - 1 - i] : 1;
-    if (dim1 != dim2 && dim1 != 1 && dim2 != 1) {
-      fprintf(stderr, "shapes are not compatible for broadcasting\n");
-      free(broadcasted_shape);
-      exit(EXIT_FAILURE);
-    }
-    broadcasted_shape[max_ndim - 1 - i] = dim1 > dim2 ? dim1 : dim2;
-  }
+  int* broadcasted_shape;
+  size_t broadcasted_size;
+  int max_ndim = broadcast_shape(a, b, &broadcasted_shape, &broadcasted_size);
 
-  // calculate broadcasted size
-  size_t broadcasted_size = 1;
-  for (int i = 0; i < max_ndim; i++) {
-    broadcasted_size *= broadcasted_shape[i];
-  }
-  // convert both arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* b_float = convert_to_float32(b->data, b->dtype, b->size);
-  if (a_float == NULL || b_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
-    free(broadcasted_shape);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(broadcasted_size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    free(b_float);
-    free(broadcasted_shape);
-    exit(EXIT_FAILURE);
-  }
-  div_broadcasted_array_ops(a_float, b_float, out, broadcasted_shape, broadcasted_size, a->ndim, b->ndim, a->shape, b->shape);
   // determining result dtype using proper dtype promotion
   dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, max_ndim, broadcasted_shape, broadcasted_size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
-  free(broadcasted_shape);  
+  Array* a_cast = as_dtype_array(a, result_dtype);
+  Array* b_cast = as_dtype_array(b, result_dtype);
+  Array* result = empty_array(max_ndim, broadcasted_shape, broadcasted_size, result_dtype);
+  NdIter it;
+  iter_init_broadcast(&it, a_cast, b_cast, result);
+  div_ops(&it, result_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
+  free(broadcasted_shape);
   return result;
 }
 
@@ -518,32 +277,13 @@ Array* pow_array(Array* a, float exp) {
     exit(EXIT_FAILURE);
   }
 
-  // converting array to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }  
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
-
-  pow_array_ops(a_float, exp, out, a->size);
   // for power operations, promote integer types to float
   // keeping existing float precision
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) {
-    result_dtype = DTYPE_FLOAT32;
-  } else {
-    result_dtype = a->dtype; // keeping float32 or float64
-  }
-  
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  pow_array_ops(&it, exp, a->dtype);
   return result;
 }
 
@@ -552,29 +292,13 @@ Array* pow_scalar(float a, Array* exp) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* exp_float = convert_to_float32(exp->data, exp->dtype, exp->size);
-  if (exp_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
 
-  float* out = (float*)malloc(exp->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(exp_float);
-    exit(EXIT_FAILURE);
-  }
-  pow_scalar_ops(a, exp_float, out, exp->size);
   // for power operations, promote integer types to float
   // keeping existing float precision
-  dtype_t result_dtype;
-  if (is_integer_dtype(exp->dtype) || exp->dtype == DTYPE_BOOL) {
-    result_dtype = DTYPE_FLOAT32;
-  } else {
-    result_dtype = exp->dtype; // keeping float32 or float64
-  }
-  Array* result = create_array(out, exp->ndim, exp->shape, exp->size, result_dtype);
-  free(exp_float);
-  free(out);  
+  dtype_t result_dtype = get_float_dtype(exp->dtype);
+  Array* result = empty_array(exp->ndim, exp->shape, exp->size, result_dtype);
+  NdIter it;
+  iter_init_unary(&it, exp, result);
+  pow_scalar_ops(a, &it, exp->dtype);
   return result;
-}
+}
\ No newline at end of file
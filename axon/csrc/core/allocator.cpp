@@ -0,0 +1,347 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#include "allocator.h"
+
+#define POOL_HEADER POOL_ALIGN    // block header, the payload right after it keeps the alignment
+#define POOL_LARGE 0xFFFFFFFFu    // header tag of blocks that bypass the pool
+#define POOL_MAPPED 0xFFFFFFFEu   // header tag of mmap'd blocks
+
+// sits in the POOL_HEADER bytes in front of every payload
+typedef struct BlockHeader {
+  uint32_t tag;       // size class, POOL_LARGE or POOL_MAPPED
+  uint32_t pages;     // PAGES_* the block got
+  size_t mapped;      // length of the mapping for POOL_MAPPED blocks
+} BlockHeader;
+
+// free blocks are chained through their own payload
+typedef struct Block {
+  struct Block* next;
+} Block;
+
+typedef struct Depot {
+  std::mutex lock;
+  Block* head = NULL;
+  size_t count = 0;
+} Depot;
+
+typedef struct ThreadCache {
+  Block* head[POOL_CLASSES] = {};
+  int count[POOL_CLASSES] = {};
+  ~ThreadCache();
+} ThreadCache;
+
+static Depot depots[POOL_CLASSES];
+static std::atomic<unsigned long long> stats[ALLOC_STAT_COUNT];
+static thread_local ThreadCache cache;
+static thread_local int cache_gone = 0;   // set once the thread's cache is torn down, later frees go to the depot
+
+static inline size_t class_bytes(int c) { return (size_t)1 << (POOL_MIN_SHIFT + c); }
+static inline size_t depot_cap(int c) {
+  size_t cap = POOL_DEPOT_BYTES / class_bytes(c);
+  return cap > POOL_CACHE_BLOCKS ? cap : POOL_CACHE_BLOCKS;
+}
+
+static inline int size_class(size_t bytes) {
+  int c = 0;
+  while (class_bytes(c) < bytes) c++;
+  return c;
+}
+
+static inline void stat_add(int stat, unsigned long long n) { stats[stat].fetch_add(n, std::memory_order_relaxed); }
+static inline void stat_sub(int stat, unsigned long long n) { stats[stat].fetch_sub(n, std::memory_order_relaxed); }
+
+static inline BlockHeader* header_of(const void* ptr) { return (BlockHeader*)((char*)ptr - POOL_HEADER); }
+
+// POOL_ALIGN aligned memory from the system allocator, the header goes in its first POOL_HEADER bytes
+static char* raw_alloc(size_t bytes) {
+#if defined(_WIN32)
+  return (char*)_aligned_malloc(bytes, POOL_ALIGN);
+#else
+  void* raw = NULL;
+  return posix_memalign(&raw, POOL_ALIGN, bytes) == 0 ? (char*)raw : NULL;
+#endif
+}
+
+static void raw_free(void* raw) {
+#if defined(_WIN32)
+  _aligned_free(raw);
+#else
+  free(raw);
+#endif
+}
+
+static inline void release_block(Block* b) { raw_free((char*)b - POOL_HEADER); }
+
+static int hugepage_mode_from_env() {
+  const char* env = getenv("AXON_HUGEPAGES");
+  if (env == NULL || strcmp(env, "thp") == 0) return PAGES_THP;
+  if (strcmp(env, "off") == 0) return PAGES_DEFAULT;
+  if (strcmp(env, "explicit") == 0) return PAGES_HUGETLB;
+  fprintf(stderr, "Invalid AXON_HUGEPAGES '%s', expected off, thp or explicit\n", env);
+  return PAGES_THP;
+}
+
+static size_t hugepage_threshold_from_env() {
+  const char* env = getenv("AXON_HUGEPAGE_THRESHOLD");
+  if (env != NULL) {
+    long long n = atoll(env);
+    if (n > 0) return (size_t)n;
+    fprintf(stderr, "Invalid AXON_HUGEPAGE_THRESHOLD '%s', using %zu bytes\n", env, HUGE_PAGE_THRESHOLD);
+  }
+  return HUGE_PAGE_THRESHOLD;
+}
+
+static std::atomic<int> hugepage_mode{hugepage_mode_from_env()};
+static std::atomic<size_t> hugepage_threshold{hugepage_threshold_from_env()};
+
+// 2 MB aligned anonymous mapping for large blocks, NULL when mmap isn't available or fails
+static char* mapped_alloc(size_t bytes, size_t* length, uint32_t* pages) {
+#if defined(__linux__)
+  size_t len = (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+#if defined(MAP_HUGETLB)
+  if (hugepage_mode.load(std::memory_order_relaxed) == PAGES_HUGETLB) {
+    void* p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) {
+      *length = len;
+      *pages = PAGES_HUGETLB;
+      return (char*)p;
+    }
+  }
+#endif
+  // over-map by one huge page & trim both ends, transparent huge pages need 2 MB aligned ranges
+  size_t span = len + HUGE_PAGE_BYTES;
+  void* m = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (m == MAP_FAILED) return NULL;
+  char* base = (char*)m;
+  char* p = (char*)(((uintptr_t)base + HUGE_PAGE_BYTES - 1) & ~(uintptr_t)(HUGE_PAGE_BYTES - 1));
+  if (p > base) munmap(base, p - base);
+  if (base + span > p + len) munmap(p + len, base + span - (p + len));
+  *length = len;
+  *pages = PAGES_DEFAULT;
+#if defined(MADV_HUGEPAGE)
+  if (madvise(p, len, MADV_HUGEPAGE) == 0) *pages = PAGES_THP;
+#endif
+  return p;
+#else
+  (void)bytes; (void)length; (void)pages;
+  return NULL;
+#endif
+}
+
+// hands a chain of `n` blocks to the depot, whatever doesn't fit under its cap goes back to malloc
+static void depot_push(int c, Block* head, Block* tail, size_t n) {
+  Depot& d = depots[c];
+  Block* excess = NULL;
+  {
+    std::lock_guard<std::mutex> lock(d.lock);
+    tail->next = d.head;
+    d.head = head;
+    d.count += n;
+    size_t cap = depot_cap(c);
+    if (d.count > cap) {
+      size_t drop = d.count - cap;
+      excess = d.head;
+      Block* last = excess;
+      for (size_t i = 1; i < drop; i++) last = last->next;
+      d.head = last->next;
+      last->next = NULL;
+      d.count = cap;
+    }
+  }
+  size_t dropped = 0;
+  while (excess != NULL) {
+    Block* next = excess->next;
+    release_block(excess);
+    excess = next;
+    dropped++;
+  }
+  if (dropped) {
+    stat_add(ALLOC_STAT_RELEASED, dropped);
+    stat_sub(ALLOC_STAT_CACHED, dropped * class_bytes(c));
+  }
+}
+
+// detaches up to `want` blocks from the depot, returns how many came along
+static size_t depot_pop(int c, size_t want, Block** out) {
+  Depot& d = depots[c];
+  std::lock_guard<std::mutex> lock(d.lock);
+  if (d.head == NULL) return 0;
+  size_t n = 1;
+  Block* last = d.head;
+  while (n < want && last->next != NULL) { last = last->next; n++; }
+  *out = d.head;
+  d.head = last->next;
+  last->next = NULL;
+  d.count -= n;
+  return n;
+}
+
+ThreadCache::~ThreadCache() {
+  for (int c = 0; c < POOL_CLASSES; c++) {
+    if (head[c] == NULL) continue;
+    Block* tail = head[c];
+    while (tail->next != NULL) tail = tail->next;
+    depot_push(c, head[c], tail, count[c]);
+    head[c] = NULL;
+    count[c] = 0;
+  }
+  cache_gone = 1;
+}
+
+static Block* cache_pop(int c) {
+  if (cache_gone) {
+    Block* b = NULL;
+    return depot_pop(c, 1, &b) ? b : NULL;
+  }
+  if (cache.head[c] == NULL) {
+    cache.count[c] = (int)depot_pop(c, POOL_CACHE_BLOCKS / 2, &cache.head[c]);
+    if (cache.head[c] == NULL) return NULL;
+  }
+  Block* b = cache.head[c];
+  cache.head[c] = b->next;
+  cache.count[c]--;
+  return b;
+}
+
+static void cache_push(int c, Block* b) {
+  if (cache_gone) {
+    b->next = NULL;
+    depot_push(c, b, b, 1);
+    return;
+  }
+  b->next = cache.head[c];
+  cache.head[c] = b;
+  if (++cache.count[c] <= POOL_CACHE_BLOCKS) return;
+  // full, the older half moves to the depot for other threads
+  Block* last = cache.head[c];
+  for (int i = 1; i < POOL_CACHE_BLOCKS / 2; i++) last = last->next;
+  Block* spill = last->next;
+  Block* tail = spill;
+  size_t n = 1;
+  while (tail->next != NULL) { tail = tail->next; n++; }
+  last->next = NULL;
+  cache.count[c] -= (int)n;
+  depot_push(c, spill, tail, n);
+}
+
+void* pool_alloc(size_t bytes) {
+  if (bytes > POOL_MAX_BYTES) {
+    stat_add(ALLOC_STAT_LARGE, 1);
+    if (hugepage_mode.load(std::memory_order_relaxed) != PAGES_DEFAULT && bytes >= hugepage_threshold.load(std::memory_order_relaxed)) {
+      size_t length;
+      uint32_t pages;
+      char* raw = mapped_alloc(bytes + POOL_HEADER, &length, &pages);
+      if (raw != NULL) {
+        BlockHeader* h = (BlockHeader*)raw;
+        h->tag = POOL_MAPPED;
+        h->pages = pages;
+        h->mapped = length;
+        return raw + POOL_HEADER;
+      }
+    }
+    char* raw = raw_alloc(bytes + POOL_HEADER);
+    if (raw == NULL) return NULL;
+    ((BlockHeader*)raw)->tag = POOL_LARGE;
+    ((BlockHeader*)raw)->pages = PAGES_DEFAULT;
+    return raw + POOL_HEADER;
+  }
+  int c = size_class(bytes);
+  Block* b = cache_pop(c);
+  if (b != NULL) {
+    stat_add(ALLOC_STAT_HITS, 1);
+    stat_sub(ALLOC_STAT_CACHED, class_bytes(c));
+    return b;
+  }
+  char* raw = raw_alloc(class_bytes(c) + POOL_HEADER);
+  if (raw == NULL) return NULL;
+  ((BlockHeader*)raw)->tag = (uint32_t)c;
+  ((BlockHeader*)raw)->pages = PAGES_DEFAULT;
+  stat_add(ALLOC_STAT_MISSES, 1);
+  return raw + POOL_HEADER;
+}
+
+void pool_free(void* ptr) {
+  if (ptr == NULL) return;
+  BlockHeader* h = header_of(ptr);
+  uint32_t c = h->tag;
+  if (c == POOL_LARGE || c == POOL_MAPPED) {
+#if defined(__linux__)
+    if (c == POOL_MAPPED) munmap(h, h->mapped);
+    else raw_free(h);
+#else
+    raw_free(h);
+#endif
+    stat_add(ALLOC_STAT_RELEASED, 1);
+    return;
+  }
+  stat_add(ALLOC_STAT_RECYCLED, 1);
+  stat_add(ALLOC_STAT_CACHED, class_bytes(c));
+  cache_push((int)c, (Block*)ptr);
+}
+
+int pool_page_kind(const void* ptr) {
+  return ptr != NULL ? (int)header_of(ptr)->pages : PAGES_DEFAULT;
+}
+
+int get_hugepage_mode() { return hugepage_mode.load(std::memory_order_relaxed); }
+
+int set_hugepage_mode(int mode) {
+  if (mode >= PAGES_DEFAULT && mode <= PAGES_HUGETLB) hugepage_mode.store(mode, std::memory_order_relaxed);
+  return hugepage_mode.load(std::memory_order_relaxed);
+}
+
+size_t get_hugepage_threshold() { return hugepage_threshold.load(std::memory_order_relaxed); }
+
+size_t set_hugepage_threshold(size_t bytes) {
+  hugepage_threshold.store(bytes ? bytes : HUGE_PAGE_THRESHOLD, std::memory_order_relaxed);
+  return hugepage_threshold.load(std::memory_order_relaxed);
+}
+
+void get_alloc_stats(unsigned long long* out) {
+  for (int i = 0; i < ALLOC_STAT_COUNT; i++) out[i] = stats[i].load(std::memory_order_relaxed);
+}
+
+void reset_alloc_stats() {
+  // the cached byte count is a level, not a counter, so it stays
+  for (int i = 0; i < ALLOC_STAT_CACHED; i++) stats[i].store(0, std::memory_order_relaxed);
+}
+
+void trim_alloc_pool() {
+  for (int c = 0; c < POOL_CLASSES; c++) {
+    Block* chain = cache_gone ? NULL : cache.head[c];
+    if (!cache_gone) {
+      cache.head[c] = NULL;
+      cache.count[c] = 0;
+    }
+    {
+      Depot& d = depots[c];
+      std::lock_guard<std::mutex> lock(d.lock);
+      if (d.head != NULL) {
+        Block* tail = d.head;
+        while (tail->next != NULL) tail = tail->next;
+        tail->next = chain;
+        chain = d.head;
+        d.head = NULL;
+        d.count = 0;
+      }
+    }
+    size_t n = 0;
+    while (chain != NULL) {
+      Block* next = chain->next;
+      release_block(chain);
+      chain = next;
+      n++;
+    }
+    if (n) {
+      stat_add(ALLOC_STAT_RELEASED, n);
+      stat_sub(ALLOC_STAT_CACHED, n * class_bytes(c));
+    }
+  }
+}
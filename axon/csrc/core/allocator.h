@@ -0,0 +1,65 @@
+/**
+  @file allocator.h
+  @brief size-classed pool behind array headers, data buffers & the kernels' scratch buffers
+  * requests up to POOL_MAX_BYTES are rounded up to a power of two class (64 B .. 32 KB), freed
+    blocks go back on a per-thread free list for their class & the next request of that class
+    pops one instead of calling malloc
+  * a thread cache holding POOL_CACHE_BLOCKS of a class moves half of them to a shared depot,
+    an empty one refills from it, so blocks freed on one thread get reused on another
+  * the depot keeps at most POOL_DEPOT_BYTES per class, anything past that goes back to malloc,
+    larger requests skip the pool altogether
+  * every block carries a 64 byte header with its class, pool_free() never needs the size & every
+    payload starts on a 64 byte boundary, so a vector load never straddles a cache line
+  * requests of at least the huge page threshold (AXON_HUGEPAGE_THRESHOLD bytes, 4 MB by default)
+    are mmap'd on linux: 2 MB aligned & madvise(MADV_HUGEPAGE)'d for transparent huge pages, or
+    backed by explicit MAP_HUGETLB pages when AXON_HUGEPAGES=explicit (falling back to the former
+    when none are reserved), AXON_HUGEPAGES=off keeps them on malloc
+*/
+
+#ifndef __ALLOCATOR__H__
+#define __ALLOCATOR__H__
+
+#include <stddef.h>
+
+#define POOL_MIN_SHIFT 6            // smallest class, 64 bytes
+#define POOL_CLASSES 10             // 64 B .. 32 KB, 1K element arrays of any dtype fit
+#define POOL_MAX_BYTES ((size_t)1 << (POOL_MIN_SHIFT + POOL_CLASSES - 1))
+#define POOL_CACHE_BLOCKS 64        // blocks of one class a thread keeps before handing half to the depot
+#define POOL_DEPOT_BYTES (8 << 20)  // idle bytes the depot holds on to per class
+#define POOL_ALIGN 64               // payload alignment of every block
+#define HUGE_PAGE_BYTES ((size_t)2 << 20)
+#define HUGE_PAGE_THRESHOLD ((size_t)4 << 20)   // default size from which blocks are mmap'd
+
+// how large blocks get their pages, also what pool_page_kind() reports for a block
+enum {
+  PAGES_DEFAULT,    // malloc / regular pages
+  PAGES_THP,        // mmap'd & advised for transparent huge pages
+  PAGES_HUGETLB     // explicit 2 MB pages, as a mode it tries these first & falls back to thp
+};
+
+// indices into the buffer filled by get_alloc_stats()
+enum {
+  ALLOC_STAT_HITS,        // requests served from a free list
+  ALLOC_STAT_MISSES,      // pooled size, but nothing cached so it went to malloc
+  ALLOC_STAT_LARGE,       // larger than POOL_MAX_BYTES, straight to malloc / mmap
+  ALLOC_STAT_RECYCLED,    // frees kept for reuse
+  ALLOC_STAT_RELEASED,    // blocks handed back to malloc (large frees, depot overflow, trims)
+  ALLOC_STAT_CACHED,      // bytes currently idle in the depot & thread caches
+  ALLOC_STAT_COUNT
+};
+
+void* pool_alloc(size_t bytes);   // NULL on failure, like malloc
+void pool_free(void* ptr);        // only for pointers from pool_alloc, NULL is ignored
+int pool_page_kind(const void* ptr);    // PAGES_* the block starting at `ptr` got
+
+extern "C" {
+  void get_alloc_stats(unsigned long long* stats);    // fills ALLOC_STAT_COUNT counters
+  void reset_alloc_stats();
+  void trim_alloc_pool();   // returns the depot & the calling thread's cache to the system
+  int get_hugepage_mode();
+  int set_hugepage_mode(int mode);    // PAGES_DEFAULT turns the mmap path off, returns the mode now in use
+  size_t get_hugepage_threshold();
+  size_t set_hugepage_threshold(size_t bytes);    // 0 restores the default
+}
+
+#endif  //!__ALLOCATOR__H__
@@ -3,15 +3,21 @@
 #include <stddef.h>
 #include <string.h>
 #include "contiguous.h"
+#include "iterator.h"
+#include "dispatch.h"
 #include "../cpu/helpers.h"
+#include "../cpu/simd.h"
+#include "../cpu/parallel.h"
+
+#define TRANSPOSE_MIN 8   // both sides of a plane at least this long before it's worth tiling
 
 int is_contiguous(Array* self) {
   if (self == NULL || self->ndim == 0) return 1;
   
-  // calulating expected contiguous strides
+  // calulating expected contiguous strides, size-1 dims (from reshapes & expand_dims) can hold any stride
   int expected_stride = 1;
   for (int i = self->ndim - 1; i >= 0; i--) {
-    if (self->strides[i] != expected_stride) {
+    if (self->shape[i] != 1 && self->strides[i] != expected_stride) {
       return 0;
     }
     expected_stride *= self->shape[i];
@@ -19,58 +25,140 @@ int is_contiguous(Array* self) {
   return 1;
 }
 
-void contiguous_array_ops(void* src_data, void* dst_data, int* src_strides, int* shape, size_t ndim, size_t elem_size) {
-  if (ndim == 0) return;
+// copies `n` elements of `elem_size` bytes between strided pointers, typed for the common widths
+template <typename T> static inline void strided_copy(char* dst, ptrdiff_t dst_stride, const char* src, ptrdiff_t src_stride, size_t n) {
+  for (size_t i = 0; i < n; i++) { *(T*)(dst + i * dst_stride) = *(const T*)(src + i * src_stride); }
+}
 
-  size_t total_size = 1;
-  for (size_t i = 0; i < ndim; i++) {
-    total_size *= shape[i];
+// scalar stand-in for the simd transpose kernels, same SIMD_TRANSPOSE_BLOCK blocking without register tiles
+template <typename T> static void transpose_block(const T* src, ptrdiff_t ss, T* dst, ptrdiff_t ds, size_t rows, size_t cols) {
+  const size_t L = SIMD_TRANSPOSE_BLOCK;
+  for (size_t i0 = 0; i0 < rows; i0 += L) {
+    size_t i1 = (i0 + L < rows) ? i0 + L : rows;
+    for (size_t j0 = 0; j0 < cols; j0 += L) {
+      size_t j1 = (j0 + L < cols) ? j0 + L : cols;
+      for (size_t i = i0; i < i1; i++) { for (size_t j = j0; j < j1; j++) dst[j * ds + i] = src[i * ss + j]; }
+    }
   }
+}
 
-  int* indices = (int*)malloc(ndim * sizeof(int));
-  memset(indices, 0, ndim * sizeof(int));
-
-  char* src = (char*)src_data;
-  char* dst = (char*)dst_data;
-  for (size_t flat_idx = 0; flat_idx < total_size; flat_idx++) {
-    // calulating source offset using original strides
-    size_t src_offset = 0;
-    for (size_t dim = 0; dim < ndim; dim++) {
-      src_offset += indices[dim] * src_strides[dim] * elem_size;
+// dst[j * ds + i] = src[i * ss + j] (element strides), split over threads by column ranges so every
+// thread writes its own run of destination rows
+static void transpose_plane(const char* src, ptrdiff_t ss, char* dst, ptrdiff_t ds, size_t rows, size_t cols, size_t elem_size) {
+  const SimdKernels* k = simd_kernels();
+  size_t grain = parallel_grain(rows);
+  grain = (grain + SIMD_TRANSPOSE_BLOCK - 1) / SIMD_TRANSPOSE_BLOCK * SIMD_TRANSPOSE_BLOCK;
+  parallel_for(cols, grain, [&](size_t lo, size_t hi) {
+    const char* s = src + lo * elem_size;
+    char* d = dst + lo * ds * elem_size;
+    switch (elem_size) {
+      case 1: transpose_block((const uint8_t*)s, ss, (uint8_t*)d, ds, rows, hi - lo); break;
+      case 2: transpose_block((const uint16_t*)s, ss, (uint16_t*)d, ds, rows, hi - lo); break;
+      case 4:
+        if (k) k->transpose_32((const uint32_t*)s, ss, (uint32_t*)d, ds, rows, hi - lo);
+        else transpose_block((const uint32_t*)s, ss, (uint32_t*)d, ds, rows, hi - lo);
+        break;
+      case 8:
+        if (k) k->transpose_64((const uint64_t*)s, ss, (uint64_t*)d, ds, rows, hi - lo);
+        else transpose_block((const uint64_t*)s, ss, (uint64_t*)d, ds, rows, hi - lo);
+        break;
     }
+  });
+}
 
-    // Destination offset is simply flat_idx * elem_size (contiguous)
-    size_t dst_offset = flat_idx * elem_size;
-    memcpy(dst + dst_offset, src + src_offset, elem_size);      // copying element
+// a source whose unit stride dim `q` isn't the last dim `l` (a transposed or permuted view) would be
+// read one cache line per element by the row walk below, so each (q, l) plane is copied as a tiled
+// 2-d transpose & the remaining dims are walked by the iterator; false if the layout isn't like that
+static bool transposed_copy(void* src_data, void* dst_data, int* src_strides, int* shape, size_t ndim, size_t elem_size) {
+  if (ndim < 2 || ndim > ITER_MAX_DIMS || !(elem_size == 1 || elem_size == 2 || elem_size == 4 || elem_size == 8)) return false;
+  int l = (int)ndim - 1;
+  while (l >= 0 && shape[l] == 1) l--;
+  if (l <= 0 || src_strides[l] == 1) return false;
+  int q = -1;
+  for (int i = 0; i < l; i++) { if (shape[i] > 1 && src_strides[i] == 1) q = i; }
+  if (q < 0 || shape[q] < TRANSPOSE_MIN || shape[l] < TRANSPOSE_MIN) return false;
 
-    // increment indices (like odometer)
-    int carry = 1;
-    for (int dim = ndim - 1; dim >= 0 && carry; dim--) {
-      indices[dim] += carry;
-      if (indices[dim] >= shape[dim]) {
-        indices[dim] = 0;
-        carry = 1;
-      } else {
-        carry = 0;
-      }
+  int dst_strides[ITER_MAX_DIMS], outer_shape[ITER_MAX_DIMS];
+  int stride = 1;
+  for (int i = (int)ndim - 1; i >= 0; i--) {
+    dst_strides[i] = stride;
+    stride *= shape[i];
+    outer_shape[i] = (i == q || i == l) ? 1 : shape[i];
+  }
+  NdIter it;
+  void* data[2] = {src_data, dst_data};
+  int* strides[2] = {src_strides, dst_strides};
+  size_t elem_sizes[2] = {elem_size, elem_size};
+  iter_init(&it, 2, data, strides, elem_sizes, outer_shape, ndim);
+  do {
+    for (size_t i = 0; i < it.inner_size; i++) {
+      const char* src = it.ptrs[0] + (ptrdiff_t)i * it.inner_strides[0];
+      char* dst = it.ptrs[1] + (ptrdiff_t)i * it.inner_strides[1];
+      // plane rows run along l (strided in the source), columns along q (dense in the source)
+      transpose_plane(src, src_strides[l], dst, dst_strides[q], shape[l], shape[q], elem_size);
+    }
+  } while (iter_next(&it));
+  return true;
+}
+
+void contiguous_array_ops(void* src_data, void* dst_data, int* src_strides, int* shape, size_t ndim, size_t elem_size) {
+  if (transposed_copy(src_data, dst_data, src_strides, shape, ndim, elem_size)) return;
+  // destination is c-contiguous, so every unit-stride run of the source becomes one memcpy
+  NdIter it;
+  void* data[2] = {src_data, dst_data};
+  int* strides[2] = {src_strides, NULL};
+  size_t elem_sizes[2] = {elem_size, elem_size};
+  iter_init(&it, 2, data, strides, elem_sizes, shape, ndim);
+  do {
+    char *src = it.ptrs[0], *dst = it.ptrs[1];
+    ptrdiff_t ss = it.inner_strides[0], ds = it.inner_strides[1];
+    if (iter_inner_contiguous(&it, 0, elem_size)) { memcpy(dst, src, it.inner_size * elem_size); continue; }
+    switch (elem_size) {
+      case 1: strided_copy<uint8_t>(dst, ds, src, ss, it.inner_size); break;
+      case 2: strided_copy<uint16_t>(dst, ds, src, ss, it.inner_size); break;
+      case 4: strided_copy<uint32_t>(dst, ds, src, ss, it.inner_size); break;
+      case 8: strided_copy<uint64_t>(dst, ds, src, ss, it.inner_size); break;
+      default: for (size_t i = 0; i < it.inner_size; i++) { memcpy(dst + i * ds, src + i * ss, elem_size); }
     }
+  } while (iter_next(&it));
+}
+
+void contiguous_cast_ops(void* src_data, dtype_t src_dtype, void* dst_data, dtype_t dst_dtype, int* src_strides, int* shape, size_t ndim) {
+  if (src_dtype == dst_dtype) {
+    contiguous_array_ops(src_data, dst_data, src_strides, shape, ndim, get_dtype_size(src_dtype));
+    return;
   }
-  
-  free(indices);
+  // gathering & converting in one pass, no contiguous copy of the source in between
+  NdIter it;
+  void* data[2] = {src_data, dst_data};
+  int* strides[2] = {src_strides, NULL};
+  size_t elem_sizes[2] = {get_dtype_size(src_dtype), get_dtype_size(dst_dtype)};
+  iter_init(&it, 2, data, strides, elem_sizes, shape, ndim);
+  dispatch_dtype(src_dtype, [&](auto src_tag) {
+    typedef typename decltype(src_tag)::type S;
+    dispatch_dtype(dst_dtype, [&](auto dst_tag) {
+      typedef typename decltype(dst_tag)::type D;
+      do {
+        const char* src = it.ptrs[0];
+        ptrdiff_t ss = it.inner_strides[0];
+        D* dst = (D*)it.ptrs[1];
+        for (size_t i = 0; i < it.inner_size; i++) { dst[i] = convert_value<D>(*(const S*)(src + i * ss)); }
+      } while (iter_next(&it));
+    });
+  });
 }
 
 void make_contiguous_inplace(Array* self) {
   if (self == NULL || is_contiguous(self)) return;
   
   size_t elem_size = get_dtype_size(self->dtype);
-  void* new_data = malloc(self->size * elem_size);
+  void* new_data = allocate_dtype_array(self->dtype, self->size);
   
   // rearranging data to contiguous layout
   contiguous_array_ops(self->data, new_data, self->strides, self->shape, self->ndim, elem_size);
 
-  // freed old data and update
-  free(self->data);
-  self->data = new_data;
+  // swapping in the new buffer, the old one lives on while other views still share it
+  replace_data(self, new_data);
 
   // ipdated strides to be contiguous
   int stride = 1;
@@ -81,7 +169,6 @@ void make_contiguous_inplace(Array* self) {
   for (size_t i = 0; i < self->ndim; i++) {
     self->backstrides[self->ndim - 1 - i] = self->strides[i];
   }
-  self->is_view = 0;  // no longer a view after making contiguous
 }
 
 size_t calulating_flat_index(int* indices, int* strides, size_t ndim) {
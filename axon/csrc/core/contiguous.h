@@ -7,6 +7,8 @@ extern "C" {
   int is_contiguous(Array* self); // checking if array is contiguous in memory
   void make_contiguous_inplace(Array* self);  // making array contiguous in-place (modifies original array)
   void contiguous_array_ops(void* src_data, void* dst_data, int* src_strides, int* shape, size_t ndim, size_t elem_size); // helper function for contiguous memory layout conversion
+  // same as contiguous_array_ops but also converts every element from `src_dtype` into `dst_dtype`
+  void contiguous_cast_ops(void* src_data, dtype_t src_dtype, void* dst_data, dtype_t dst_dtype, int* src_strides, int* shape, size_t ndim);
   // calculating flat index from multi-dimensional indices using strides
   size_t calculate_flat_index(int* indices, int* strides, size_t ndim);
   // converting flat index to multi-dimensional indices
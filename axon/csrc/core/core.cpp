@@ -1,92 +1,167 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
+#include <new>
 #include "core.h"
 #include "contiguous.h"
-
-Array* create_array(float* data, size_t ndim, int* shape, size_t size, dtype_t dtype) {
-  if (data == NULL || !size) {
-    fprintf(stderr, "Invalid input parameters!\n");
+#include "allocator.h"
+
+// one data buffer & the number of arrays pointing into it, the last one to let go frees it
+struct Storage {
+  void* data;
+  std::atomic<int> refcount;
+};
+
+static Storage* storage_create(void* data) {
+  void* block = pool_alloc(sizeof(Storage));
+  if (block == NULL) {
+    fprintf(stderr, "Memory allocation failed for array storage!\n");
     exit(EXIT_FAILURE);
   }
-  
-  Array* self = (Array*)malloc(sizeof(Array));
+  Storage* storage = new (block) Storage();
+  storage->data = data;
+  storage->refcount.store(1, std::memory_order_relaxed);
+  return storage;
+}
+
+static Storage* storage_retain(Storage* storage) {
+  if (storage != NULL) storage->refcount.fetch_add(1, std::memory_order_relaxed);
+  return storage;
+}
+
+static void storage_release(Storage* storage) {
+  if (storage == NULL || storage->refcount.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  pool_free(storage->data);
+  storage->~Storage();
+  pool_free(storage);
+}
+
+// array struct from the pool, shape/strides/backstrides point into its inline `dims` unless ndim is
+// larger than that, so a typical array costs one pooled header & one pooled data buffer
+static Array* alloc_array(size_t ndim) {
+  Array* self = (Array*)pool_alloc(sizeof(Array));
   if (self == NULL) {
     fprintf(stderr, "Memory allocation failed for Array struct!\n");
     exit(EXIT_FAILURE);
   }
-
-  self->dtype = dtype;
-  self->is_view = 0;
   self->ndim = ndim;
-  self->size = size;
-  self->data = allocate_dtype_array(dtype, size); // allocating and convert to target dtype
-  convert_from_float32(data, self->data, dtype, size);
-  // handling scalar case (ndim == 0)
   if (ndim == 0) {
     self->shape = NULL;
     self->strides = NULL;
     self->backstrides = NULL;
+  } else if (ndim <= ARRAY_INLINE_DIMS) {
+    self->shape = self->dims;
+    self->strides = self->dims + ndim;
+    self->backstrides = self->dims + 2 * ndim;
   } else {
-    // copy shape and calculate strides for non-scalar arrays
     self->shape = (int*)malloc(ndim * sizeof(int));
-    self->strides = (int*)malloc(sizeof(int) * ndim);
-    self->backstrides = (int*)malloc(sizeof(int) * ndim);
-    for (size_t i = 0; i < ndim; i++) self->shape[i] = shape[i];
-    int stride = 1;
-    for (int i = ndim-1; i >= 0; i--) {
-      self->strides[i] = stride;
-      stride *= shape[i];
+    self->strides = (int*)malloc(ndim * sizeof(int));
+    self->backstrides = (int*)malloc(ndim * sizeof(int));
+    if (!self->shape || !self->strides || !self->backstrides) {
+      fprintf(stderr, "Memory allocation failed for Array shape!\n");
+      exit(EXIT_FAILURE);
     }
-    for (size_t i = 0; i < ndim; i++) self->backstrides[ndim - 1 - i] = self->strides[i];
-  } 
+  }
+  return self;
+}
+
+// frees a shape/strides vector unless it's part of the inline block
+static inline void free_dims(Array* self, int* dims) {
+  if (dims != NULL && (dims < self->dims || dims >= self->dims + 3 * ARRAY_INLINE_DIMS)) free(dims);
+}
+
+
+Array* create_array(float* data, size_t ndim, int* shape, size_t size, dtype_t dtype) {
+  if (data == NULL || !size) {
+    fprintf(stderr, "Invalid input parameters!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  Array* self = empty_array(ndim, shape, size, dtype);
+  convert_from_float32(data, self->data, dtype, size);  // converting to target dtype
+  return self;
+}
+
+Array* empty_array(size_t ndim, int* shape, size_t size, dtype_t dtype) {
+  if (!size || (ndim > 0 && shape == NULL)) {
+    fprintf(stderr, "Invalid input parameters!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  Array* self = alloc_array(ndim);
+  self->dtype = dtype;
+  self->is_view = 0;
+  self->size = size;
+  self->data = allocate_dtype_array(dtype, size); // uninitialized buffer in the native dtype
+  if (self->data == NULL) {
+    pool_free(self);
+    exit(EXIT_FAILURE);
+  }
+  self->storage = storage_create(self->data);
+  // copy shape and calculate strides
+  for (size_t i = 0; i < ndim; i++) self->shape[i] = shape[i];
+  int stride = 1;
+  for (int i = ndim-1; i >= 0; i--) {
+    self->strides[i] = stride;
+    stride *= shape[i];
+  }
+  for (size_t i = 0; i < ndim; i++) self->backstrides[ndim - 1 - i] = self->strides[i];
   return self;
 }
 
 Array* cast_array(Array* self, dtype_t new_dtype) {
   if (self == NULL) return NULL;
 
-  // converting to float for intermediate processing
-  float* temp_float = convert_to_float32(self->data, self->dtype, self->size);
-  if (temp_float == NULL) return NULL;
-  // creating new array with target dtype - create_array handles conversion
-  Array* result = create_array(temp_float, self->ndim, self->shape, self->size, new_dtype);
-
-  free(temp_float);   // Cleanup temporary float data  
+  // converting straight into the target dtype buffer, views are gathered on the way
+  Array* result = empty_array(self->ndim, self->shape, self->size, new_dtype);
+  contiguous_cast_ops(self->data, self->dtype, result->data, new_dtype, self->strides, self->shape, self->ndim);
   return result;
 }
 
-Array* cast_array_simple(Array* self, dtype_t new_dtype) {
+Array* as_dtype_array(Array* self, dtype_t dtype) {
+  if (self->dtype == dtype) return self;
+  return cast_array(self, dtype);
+}
+
+void release_dtype_array(Array* self, Array* original) {
+  if (self != NULL && self != original) delete_array(self);
+}
+
+void* as_contiguous_data(Array* self, dtype_t dtype) {
+  if (self->dtype == dtype && is_contiguous(self)) return self->data;
+  void* data = allocate_dtype_array(dtype, self->size);
+  if (data == NULL) return NULL;
+  contiguous_cast_ops(self->data, self->dtype, data, dtype, self->strides, self->shape, self->ndim);
+  return data;
+}
+
+void cast_array_inplace(Array* self, dtype_t new_dtype) {
   if (self == NULL) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
+  if (self->dtype == new_dtype) return;
+  if (self->is_view) {
+    fprintf(stderr, "Cannot cast a view in place, use cast_array() instead\n");
+    exit(EXIT_FAILURE);
+  }
 
-  // using the existing cast_array_dtype function from dtype.h
   void* new_data = cast_array_dtype(self->data, self->dtype, new_dtype, self->size);
   if (new_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
     exit(EXIT_FAILURE);
   }
-  
-  // creating array structure with new data
-  Array* result = (Array*)malloc(sizeof(Array));
-  result->data = new_data;
-  result->dtype = new_dtype;
-  result->ndim = self->ndim;
-  result->size = self->size;
-  result->is_view = 0;
-  
-  // copy shape and strides
-  result->shape = (int*)malloc(self->ndim * sizeof(int));
-  result->strides = (int*)malloc(self->ndim * sizeof(int));
-  result->backstrides = (int*)malloc(self->ndim * sizeof(int));
-  
-  memcpy(result->shape, self->shape, self->ndim * sizeof(int));
-  memcpy(result->strides, self->strides, self->ndim * sizeof(int));
-  memcpy(result->backstrides, self->backstrides, self->ndim * sizeof(int));
-  
-  return result;
+  replace_data(self, new_data);   // views of self keep the old buffer alive
+  self->dtype = new_dtype;
+}
+
+Array* cast_array_simple(Array* self, dtype_t new_dtype) {
+  if (self == NULL) {
+    fprintf(stderr, "Array value pointers are null!\n");
+    exit(EXIT_FAILURE);
+  }
+  return cast_array(self, new_dtype);
 }
 
 int is_contiguous_array(Array* self) {
@@ -99,68 +174,9 @@ Array* contiguous_array(Array* self) {
     exit(EXIT_FAILURE);
   }
 
-  // if already contiguous, return a copy
-  if (is_contiguous(self)) {
-    Array* result = (Array*)malloc(sizeof(Array));
-    result->dtype = self->dtype;
-    result->ndim = self->ndim;
-    result->size = self->size;
-    result->is_view = 0;
-
-    // allocating new data
-    size_t elem_size = get_dtype_size(self->dtype);
-    result->data = malloc(self->size * elem_size);
-    memcpy(result->data, self->data, self->size * elem_size);
-
-    // copying shape and calulating contiguous strides
-    result->shape = (int*)malloc(self->ndim * sizeof(int));
-    result->strides = (int*)malloc(self->ndim * sizeof(int));
-    result->backstrides = (int*)malloc(self->ndim * sizeof(int));
-    
-    memcpy(result->shape, self->shape, self->ndim * sizeof(int));
-    
-    // calculating contiguous strides
-    int stride = 1;
-    for (int i = self->ndim - 1; i >= 0; i--) {
-      result->strides[i] = stride;
-      stride *= self->shape[i];
-    }
-    for (size_t i = 0; i < self->ndim; i++) {
-      result->backstrides[self->ndim - 1 - i] = result->strides[i];
-    }
-    
-    return result;
-  }
-  
-  // creating new contiguous array
-  Array* result = (Array*)malloc(sizeof(Array));
-  result->dtype = self->dtype;
-  result->ndim = self->ndim;
-  result->size = self->size;
-  result->is_view = 0;
-
-  // allocating contiguous data
-  size_t elem_size = get_dtype_size(self->dtype);
-  result->data = malloc(self->size * elem_size);
-  
-  // copying shape and calulating contiguous strides
-  result->shape = (int*)malloc(self->ndim * sizeof(int));
-  result->strides = (int*)malloc(self->ndim * sizeof(int));
-  result->backstrides = (int*)malloc(self->ndim * sizeof(int));  
-  memcpy(result->shape, self->shape, self->ndim * sizeof(int));
-
-  // calculating contiguous strides
-  int stride = 1;
-  for (int i = self->ndim - 1; i >= 0; i--) {
-    result->strides[i] = stride;
-    stride *= self->shape[i];
-  }
-  for (size_t i = 0; i < self->ndim; i++) {
-    result->backstrides[self->ndim - 1 - i] = result->strides[i];
-  }
-
-  // rearranging data to contiguous layout
-  contiguous_array_ops(self->data, result->data, self->strides, self->shape, self->ndim, elem_size);
+  // fresh contiguous buffer, dense sources come across in one memcpy
+  Array* result = empty_array(self->ndim, self->shape, self->size, self->dtype);
+  contiguous_array_ops(self->data, result->data, self->strides, self->shape, self->ndim, get_dtype_size(self->dtype));
   return result;
 }
 
@@ -174,32 +190,16 @@ Array* view_array(Array* self) {
     exit(EXIT_FAILURE);
   }
   
-  Array* view = (Array*)malloc(sizeof(Array));
-  if (view == NULL) {
-    fprintf(stderr, "Memory allocation failed for Array view!\n");
-    exit(EXIT_FAILURE);
-  }
+  Array* view = alloc_array(self->ndim);
 
   // sharing the same data pointer
   view->data = self->data;
   view->dtype = self->dtype;
-  view->ndim = self->ndim;
   view->size = self->size;
   view->is_view = 1;  // Mark as view
-  
+  view->storage = storage_retain(self->storage);
+
   // copying shape and strides
-  view->shape = (int*)malloc(self->ndim * sizeof(int));
-  view->strides = (int*)malloc(self->ndim * sizeof(int));
-  view->backstrides = (int*)malloc(self->ndim * sizeof(int));
-  
-  if (!view->shape || !view->strides || !view->backstrides) {
-    if (view->shape) free(view->shape);
-    if (view->strides) free(view->strides);
-    if (view->backstrides) free(view->backstrides);
-    free(view);
-    exit(EXIT_FAILURE);
-  }
-  
   memcpy(view->shape, self->shape, self->ndim * sizeof(int));
   memcpy(view->strides, self->strides, self->ndim * sizeof(int));
   memcpy(view->backstrides, self->backstrides, self->ndim * sizeof(int));
@@ -207,6 +207,53 @@ Array* view_array(Array* self) {
   return view;
 }
 
+// walks both shapes (size-1 dims left out of `old`): each run of old dims whose product matches a
+// run of new dims has to be one dense block in the source, the new dims then just split that block
+static int match_strides(int* old_shape, int* old_strides, int old_ndim, int* new_shape, int new_ndim, int* new_strides) {
+  int oi = 0, oj = 1, ni = 0, nj = 1;
+  while (ni < new_ndim && oi < old_ndim) {
+    long long np = new_shape[ni], op = old_shape[oi];
+    while (np != op) {
+      if (np < op) {
+        if (nj == new_ndim) return 0;
+        np *= new_shape[nj++];
+      } else {
+        if (oj == old_ndim) return 0;
+        op *= old_shape[oj++];
+      }
+    }
+    for (int k = oi; k < oj - 1; k++) {
+      if (old_strides[k] != old_shape[k + 1] * old_strides[k + 1]) return 0;
+    }
+    new_strides[nj - 1] = old_strides[oj - 1];
+    for (int k = nj - 1; k > ni; k--) { new_strides[k - 1] = new_strides[k] * new_shape[k]; }
+    ni = nj++;
+    oi = oj++;
+  }
+  // trailing size-1 dims never move the pointer, any stride does
+  for (int k = ni; k < new_ndim; k++) { new_strides[k] = (k > 0) ? new_strides[k - 1] : 1; }
+  return 1;
+}
+
+static int reshape_strides(Array* self, int* new_shape, size_t new_ndim, int* new_strides) {
+  int buffer[2 * ARRAY_INLINE_DIMS];
+  int* old_shape = (self->ndim <= ARRAY_INLINE_DIMS) ? buffer : (int*)malloc(2 * self->ndim * sizeof(int));
+  if (old_shape == NULL) {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+  int* old_strides = old_shape + self->ndim;
+  int old_ndim = 0;
+  for (size_t i = 0; i < self->ndim; i++) {
+    if (self->shape[i] == 1) continue;
+    old_shape[old_ndim] = self->shape[i];
+    old_strides[old_ndim++] = self->strides[i];
+  }
+  int ok = match_strides(old_shape, old_strides, old_ndim, new_shape, (int)new_ndim, new_strides);
+  if (old_shape != buffer) free(old_shape);
+  return ok;
+}
+
 Array* reshape_view(Array* self, int* new_shape, size_t new_ndim) {
   if (self == NULL || new_shape == NULL) {
     fprintf(stderr, "Array value pointers are null!\n");
@@ -228,50 +275,27 @@ Array* reshape_view(Array* self, int* new_shape, size_t new_ndim) {
     fprintf(stderr, "Cannot reshape array of size %zu into shape with size %zu\n", self->size, new_size);
     return NULL;
   }
-  
-  // for views, the original array must be contiguous
-  if (!is_contiguous(self)) {
-    fprintf(stderr, "Cannot reshape non-contiguous array. Use contiguous() first.\n");
+
+  Array* reshaped = alloc_array(new_ndim);
+  // strided views work as long as every merged group of dims is dense in the original, no message
+  // otherwise since the shape ops fall back to a copy
+  if (!reshape_strides(self, new_shape, new_ndim, reshaped->strides)) {
+    free_dims(reshaped, reshaped->shape);
+    free_dims(reshaped, reshaped->strides);
+    free_dims(reshaped, reshaped->backstrides);
+    pool_free(reshaped);
     return NULL;
   }
 
-  Array* reshaped = (Array*)malloc(sizeof(Array));
-  if (reshaped == NULL) {
-    fprintf(stderr, "Memory allocation failed for reshaped array!\n");
-    exit(EXIT_FAILURE);
-  }
-  
   // sharing the same data
   reshaped->data = self->data;
   reshaped->dtype = self->dtype;
-  reshaped->ndim = new_ndim;
   reshaped->size = new_size;
   reshaped->is_view = 1;
-  
-  // allocating new shape and strides
-  reshaped->shape = (int*)malloc(new_ndim * sizeof(int));
-  reshaped->strides = (int*)malloc(new_ndim * sizeof(int));
-  reshaped->backstrides = (int*)malloc(new_ndim * sizeof(int));
-  
-  if (!reshaped->shape || !reshaped->strides || !reshaped->backstrides) {
-    if (reshaped->shape) free(reshaped->shape);
-    if (reshaped->strides) free(reshaped->strides);
-    if (reshaped->backstrides) free(reshaped->backstrides);
-    free(reshaped);
-    exit(EXIT_FAILURE);
-  }
-  
-  // setting new shape
+  reshaped->storage = storage_retain(self->storage);
   for (size_t i = 0; i < new_ndim; i++) {
     reshaped->shape[i] = new_shape[i];
   }
-  
-  // calculating new strides
-  int stride = 1;
-  for (int i = new_ndim - 1; i >= 0; i--) {
-    reshaped->strides[i] = stride;
-    stride *= new_shape[i];
-  }
   for (size_t i = 0; i < new_ndim; i++) {
     reshaped->backstrides[new_ndim - 1 - i] = reshaped->strides[i];
   }
@@ -286,8 +310,7 @@ Array* slice_view(Array* self, int* start, int* end, int* step) {
   }
   
   // calculating new shape and strides for sliced view
-  int* new_shape = (int*)malloc(self->ndim * sizeof(int));
-  int* new_strides = (int*)malloc(self->ndim * sizeof(int));
+  Array* sliced = alloc_array(self->ndim);
   size_t new_size = 1;
   size_t data_offset = 0;
   
@@ -302,33 +325,21 @@ Array* slice_view(Array* self, int* start, int* end, int* step) {
     if (dim_start < 0) dim_start = 0;
     
     // calculating new dimension size
-    new_shape[i] = (dim_end - dim_start + dim_step - 1) / dim_step;
-    new_strides[i] = self->strides[i] * dim_step;
-    new_size *= new_shape[i];
+    sliced->shape[i] = (dim_end - dim_start + dim_step - 1) / dim_step;
+    sliced->strides[i] = self->strides[i] * dim_step;
+    new_size *= sliced->shape[i];
     
     // calculating offset in original data
     data_offset += dim_start * self->strides[i];
   }
   
-  Array* sliced = (Array*)malloc(sizeof(Array));
-  if (sliced == NULL) {
-    free(new_shape);
-    free(new_strides);
-    exit(EXIT_FAILURE);
-  }
-  
   // point to offset data
   size_t elem_size = get_dtype_size(self->dtype);
   sliced->data = (char*)self->data + (data_offset * elem_size);
   sliced->dtype = self->dtype;
-  sliced->ndim = self->ndim;
   sliced->size = new_size;
   sliced->is_view = 1;
-  
-  sliced->shape = new_shape;
-  sliced->strides = new_strides;
-  sliced->backstrides = (int*)malloc(self->ndim * sizeof(int));
-  
+  sliced->storage = storage_retain(self->storage);
   for (size_t i = 0; i < self->ndim; i++) {
     sliced->backstrides[self->ndim - 1 - i] = sliced->strides[i];
   }
@@ -336,6 +347,44 @@ Array* slice_view(Array* self, int* start, int* end, int* step) {
   return sliced;
 }
 
+Array* permute_view(Array* self, int* axes, size_t ndim) {
+  if (self == NULL || axes == NULL) {
+    fprintf(stderr, "Array value pointers are null!\n");
+    exit(EXIT_FAILURE);
+  }
+  if (ndim != self->ndim) {
+    fprintf(stderr, "Axes don't match array: got %zu axes for %zu dims\n", ndim, self->ndim);
+    return NULL;
+  }
+
+  // every axis exactly once
+  for (size_t i = 0; i < ndim; i++) {
+    bool repeated = false;
+    for (size_t j = 0; j < i; j++) { if (axes[j] == axes[i]) repeated = true; }
+    if (axes[i] < 0 || (size_t)axes[i] >= ndim || repeated) {
+      fprintf(stderr, "Axes aren't a permutation of the array's %zu dims\n", ndim);
+      return NULL;
+    }
+  }
+
+  // only the dims move, data & storage are shared
+  Array* permuted = alloc_array(ndim);
+  permuted->data = self->data;
+  permuted->dtype = self->dtype;
+  permuted->size = self->size;
+  permuted->is_view = 1;
+  permuted->storage = storage_retain(self->storage);
+  for (size_t i = 0; i < ndim; i++) {
+    permuted->shape[i] = self->shape[axes[i]];
+    permuted->strides[i] = self->strides[axes[i]];
+  }
+  for (size_t i = 0; i < ndim; i++) {
+    permuted->backstrides[ndim - 1 - i] = permuted->strides[i];
+  }
+
+  return permuted;
+}
+
 // utility functions
 int is_view_array(Array* self) {
   return (self != NULL) ? self->is_view : 0;
@@ -347,54 +396,65 @@ Array* copy_array(Array* self) {
     exit(EXIT_FAILURE);
   }
 
-  float* temp_float = convert_to_float32(self->data, self->dtype, self->size);
-  if (temp_float == NULL) {
-    fprintf(stderr, "Couldn't allocate Array value pointers!\n");
-    exit(EXIT_FAILURE);
-  };
-  // creating new array - this will allocate new data
-  Array* copy = create_array(temp_float, self->ndim, self->shape, self->size, self->dtype);
-  free(temp_float);
+  // creating new array & copying the elements, views come out contiguous
+  Array* copy = empty_array(self->ndim, self->shape, self->size, self->dtype);
+  contiguous_array_ops(self->data, copy->data, self->strides, self->shape, self->ndim, get_dtype_size(self->dtype));
   return copy;
 }
 
 void delete_array(Array* self) {
   if (self != NULL) {
-    // only free data if it's not a view
-    if (!self->is_view && self->data) {
-      free(self->data);
-    }
-    if (self->shape) free(self->shape);
-    if (self->strides) free(self->strides);
-    if (self->backstrides) free(self->backstrides);
-    free(self);
+    // the buffer goes once the last array sharing it (base or view) is deleted
+    storage_release(self->storage);
+    free_dims(self, self->shape);
+    free_dims(self, self->strides);
+    free_dims(self, self->backstrides);
+    pool_free(self);
   }
 }
 
 void delete_shape(Array* self) {
   if (self != NULL && self->shape != NULL) {
-    free(self->shape);
+    free_dims(self, self->shape);
     self->shape = NULL;
   }
 }
 
 void delete_data(Array* self) {
   if (self != NULL) {
-    if (self->data) {
-      free(self->data);
-      self->data = NULL;
-    }
+    storage_release(self->storage);
+    self->storage = NULL;
+    self->data = NULL;
   }
 }
 
+void delete_buffer(void* ptr) {
+  free(ptr);
+}
+
+void replace_data(Array* self, void* data) {
+  storage_release(self->storage);
+  self->storage = storage_create(data);
+  self->data = data;
+  self->is_view = 0;
+}
+
+int hugepage_array(Array* self) {
+  return (self != NULL && self->storage != NULL) ? pool_page_kind(self->storage->data) : 0;
+}
+
+int storage_refcount_array(Array* self) {
+  return (self != NULL && self->storage != NULL) ? self->storage->refcount.load(std::memory_order_relaxed) : 0;
+}
+
 void delete_strides(Array* self) {
   if (self != NULL) {
     if (self->strides) {
-      free(self->strides);
+      free_dims(self, self->strides);
       self->strides = NULL;
     }
     if (self->backstrides) {
-      free(self->backstrides);
+      free_dims(self, self->backstrides);
       self->backstrides = NULL;
     }
   }
@@ -405,7 +465,12 @@ float* out_data(Array* self) {
     fprintf(stderr, "Invalid input parameters!\n");
     exit(EXIT_FAILURE);
   }
-  float* temp_float = convert_to_float32(self->data, self->dtype, self->size);
+  float* temp_float = (float*)malloc(self->size * sizeof(float));
+  if (temp_float == NULL) {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+  contiguous_cast_ops(self->data, self->dtype, temp_float, DTYPE_FLOAT32, self->strides, self->shape, self->ndim);
   return temp_float;
 }
 
@@ -587,6 +652,13 @@ void print_array(Array* self) {
     return;
   }
 
+  if (!is_contiguous(self)) {
+    // formatting walks flat offsets, so views are printed from a dense copy
+    Array* dense = contiguous_array(self);
+    print_array(dense);
+    delete_array(dense);
+    return;
+  }
   char result[8192] = "";
   format_array(self, self->shape, self->ndim, 0, 0, result);
   printf("axon.array(%s, dtype=%s)\n", result, get_dtype_name(self->dtype));
@@ -15,6 +15,10 @@
 #include <stdlib.h>
 #include "dtype.h"
 
+#define ARRAY_INLINE_DIMS 8   // shape, strides & backstrides up to this many dims live inside the struct
+
+typedef struct Storage Storage;   // refcounted data buffer shared by an array & its views (core.cpp)
+
 typedef struct Array {
   void* data;           // raw data pointer (can be any dtype)
   int* strides;
@@ -24,15 +28,22 @@ typedef struct Array {
   size_t ndim;
   dtype_t dtype;        // data type of the array
   int is_view;          // flag to indicate if this is a view of another array
+  Storage* storage;     // buffer `data` points into, views hold a reference so they can outlive their base
+  int dims[3 * ARRAY_INLINE_DIMS];    // backing for shape/strides/backstrides when ndim <= ARRAY_INLINE_DIMS
 } Array;
 
 extern "C" {
   // array initialization & deletion related function
   Array* create_array(float* data, size_t ndim, int* shape, size_t size, dtype_t dtype);
+  Array* empty_array(size_t ndim, int* shape, size_t size, dtype_t dtype);   // uninitialized array, kernels write into data directly
   void delete_array(Array* self);
   void delete_shape(Array* self);
   void delete_data(Array* self);
   void delete_strides(Array* self);
+  void delete_buffer(void* ptr);    // frees buffers handed out by out_data & the Array* lists of the decompositions
+  void replace_data(Array* self, void* data);   // drops self's reference to its storage & moves it onto `data` (from allocate_dtype_array)
+  int storage_refcount_array(Array* self);
+  int hugepage_array(Array* self);    // PAGES_* (core/allocator.h) behind self's data, nonzero when huge pages were requested
   void print_array(Array* self);
   float* out_data(Array* self);
   int* out_shape(Array* self);
@@ -50,12 +61,17 @@ extern "C" {
   
   // view operations
   Array* view_array(Array* self);
-  Array* reshape_view(Array* self, int* new_shape, size_t new_ndim);
+  Array* reshape_view(Array* self, int* new_shape, size_t new_ndim);   // NULL if self's strides can't express new_shape, copy then
   Array* slice_view(Array* self, int* start, int* end, int* step);
+  Array* permute_view(Array* self, int* axes, size_t ndim);   // dim i of the view is dim axes[i] of self, no copy
 
   // dtype casting management functions
   Array* cast_array(Array* self, dtype_t new_dtype);
   Array* cast_array_simple(Array* self, dtype_t new_dtype);
+  void cast_array_inplace(Array* self, dtype_t new_dtype);  // swaps the data buffer for one in new_dtype
+  Array* as_dtype_array(Array* self, dtype_t dtype);    // `self` itself if the dtype matches (views included), else a contiguous cast
+  void release_dtype_array(Array* self, Array* original);   // deletes an array from as_dtype_array unless it's the original
+  void* as_contiguous_data(Array* self, dtype_t dtype);   // self->data if dense & in `dtype`, else a gathered copy; free with release_dtype_data
 
   // utility functions
   int is_view_array(Array* self);
@@ -0,0 +1,93 @@
+/**
+  @file dispatch.h
+  @brief compile-time dtype dispatch for the native kernel layer
+  * maps a runtime dtype_t onto its storage type & calls a generic functor with it
+  * lets kernels run directly on Array::data instead of a float32 scratch copy
+  * C++ only: included by cpu/ kernels, never exposed through the C api
+*/
+
+#ifndef __DISPATCH__H__
+#define __DISPATCH__H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <limits>
+#include <type_traits>
+#include "dtype.h"
+
+// bool arrays are stored one byte per element holding 0/1, same as C++ bool
+static_assert(sizeof(bool) == sizeof(uint8_t), "bool must be a single byte");
+
+template <typename T> struct dtype_tag { typedef T type; };
+
+// calls fn(dtype_tag<T>()) with T being the storage type of `dtype`
+template <typename Fn> inline void dispatch_dtype(dtype_t dtype, Fn&& fn) {
+  switch (dtype) {
+    case DTYPE_FLOAT32: fn(dtype_tag<float>()); break;
+    case DTYPE_FLOAT64: fn(dtype_tag<double>()); break;
+    case DTYPE_INT8: fn(dtype_tag<int8_t>()); break;
+    case DTYPE_INT16: fn(dtype_tag<int16_t>()); break;
+    case DTYPE_INT32: fn(dtype_tag<int32_t>()); break;
+    case DTYPE_INT64: fn(dtype_tag<int64_t>()); break;
+    case DTYPE_UINT8: fn(dtype_tag<uint8_t>()); break;
+    case DTYPE_UINT16: fn(dtype_tag<uint16_t>()); break;
+    case DTYPE_UINT32: fn(dtype_tag<uint32_t>()); break;
+    case DTYPE_UINT64: fn(dtype_tag<uint64_t>()); break;
+    case DTYPE_BOOL: fn(dtype_tag<bool>()); break;
+    default:
+      fprintf(stderr, "Unsupported dtype %d for native kernel\n", (int)dtype);
+      exit(EXIT_FAILURE);
+  }
+}
+
+// same as dispatch_dtype but restricted to float32/float64 (linalg, norms)
+template <typename Fn> inline void dispatch_float_dtype(dtype_t dtype, Fn&& fn) {
+  switch (dtype) {
+    case DTYPE_FLOAT32: fn(dtype_tag<float>()); break;
+    case DTYPE_FLOAT64: fn(dtype_tag<double>()); break;
+    default:
+      fprintf(stderr, "Kernel expects float32 or float64 data, got %s\n", get_dtype_name(dtype));
+      exit(EXIT_FAILURE);
+  }
+}
+
+// type used for arithmetic against float scalars: floats keep their width, integers go through double
+template <typename T> struct compute_type { typedef double type; };
+template <> struct compute_type<float> { typedef float type; };
+
+// output type of float-valued ops (exp, sqrt, norms...): integers promote to float32
+template <typename T> struct float_type { typedef float type; };
+template <> struct float_type<double> { typedef double type; };
+
+// accumulator for reductions: floats keep their width, integers sum in 64 bits
+template <typename T> struct accum_type {
+  typedef typename std::conditional<std::is_floating_point<T>::value, T,
+    typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type>::type type;
+};
+
+// value conversion with the same semantics as float32_to_dtype: round & saturate into integers
+template <typename T, typename S> inline T convert_value(S value) {
+  if constexpr (std::is_same<T, bool>::value) {
+    return value != 0;
+  } else if constexpr (std::is_floating_point<T>::value) {
+    return (T)value;
+  } else if constexpr (std::is_floating_point<S>::value) {
+    if (value != value) return 0;   // NaN has no integer representation
+    if (value <= (S)std::numeric_limits<T>::min()) return std::numeric_limits<T>::min();
+    if (value >= (S)std::numeric_limits<T>::max()) return std::numeric_limits<T>::max();
+    return (T)round((double)value);
+  } else {
+    // integer -> integer, compared in 64 bit signed/unsigned space
+    if constexpr (std::is_signed<S>::value) {
+      if (value < 0) {
+        if constexpr (std::is_unsigned<T>::value) { return 0; }
+        else { return ((int64_t)value < (int64_t)std::numeric_limits<T>::min()) ? std::numeric_limits<T>::min() : (T)value; }
+      }
+    }
+    return ((uint64_t)value > (uint64_t)std::numeric_limits<T>::max()) ? std::numeric_limits<T>::max() : (T)value;
+  }
+}
+
+#endif  //!__DISPATCH__H__
@@ -5,6 +5,8 @@
 #include <limits.h>
 #include <float.h>
 #include "dtype.h"
+#include "dispatch.h"
+#include "allocator.h"
 
 size_t get_dtype_size(dtype_t dtype) {
   switch (dtype) {
@@ -175,7 +177,7 @@ void convert_from_float32(float* float_data, void* output_data, dtype_t dtype, s
 
 void* allocate_dtype_array(dtype_t dtype, size_t size) {
   size_t element_size = get_dtype_size(dtype);
-  void* data = malloc(size * element_size);
+  void* data = pool_alloc(size * element_size);   // recycled block for small arrays
   if (data == NULL) {
     fprintf(stderr, "Memory allocation failed for dtype array\n");
     return NULL;
@@ -184,17 +186,23 @@ void* allocate_dtype_array(dtype_t dtype, size_t size) {
 }
 
 void copy_with_dtype_conversion(void* src, dtype_t src_dtype, void* dst, dtype_t dst_dtype, size_t size) {
-  for (size_t i = 0; i < size; i++) {
-    float temp = dtype_to_float32(src, src_dtype, i);
-    float32_to_dtype(temp, dst, dst_dtype, i);
-  }
+  // converting value by value in native types, no float32 hop in between
+  dispatch_dtype(src_dtype, [&](auto src_tag) {
+    typedef typename decltype(src_tag)::type S;
+    dispatch_dtype(dst_dtype, [&](auto dst_tag) {
+      typedef typename decltype(dst_tag)::type D;
+      const S* in = (const S*)src;
+      D* out = (D*)dst;
+      for (size_t i = 0; i < size; i++) { out[i] = convert_value<D>(in[i]); }
+    });
+  });
 }
 
 void* cast_array_dtype(void* data, dtype_t src_dtype, dtype_t dst_dtype, size_t size) {
   if (src_dtype == dst_dtype) {
     // Same dtype, just copy the data
     size_t src_size = size * get_dtype_size(src_dtype);
-    void* new_data = malloc(src_size);
+    void* new_data = pool_alloc(src_size);
     if (new_data == NULL) {
       fprintf(stderr, "Memory allocation failed for array casting\n");
       return NULL;
@@ -212,6 +220,19 @@ void* cast_array_dtype(void* data, dtype_t src_dtype, dtype_t dst_dtype, size_t
   return new_data;
 }
 
+void* as_dtype_data(void* data, dtype_t src_dtype, dtype_t dst_dtype, size_t size) {
+  if (src_dtype == dst_dtype) return data;
+  return cast_array_dtype(data, src_dtype, dst_dtype, size);
+}
+
+void release_dtype_data(void* data, void* original) {
+  if (data != NULL && data != original) pool_free(data);
+}
+
+dtype_t get_float_dtype(dtype_t dtype) {
+  return (dtype == DTYPE_FLOAT64) ? DTYPE_FLOAT64 : DTYPE_FLOAT32;
+}
+
 int is_integer_dtype(dtype_t dtype) {
   switch (dtype) {
     case DTYPE_INT8:
@@ -49,9 +49,12 @@ extern "C" {
   void float32_to_dtype(float value, void* data, dtype_t dtype, size_t index);    // Convert float32 result back to original dtype
   float* convert_to_float32(void* data, dtype_t dtype, size_t size);     // Convert entire array from any dtype to float32
   void convert_from_float32(float* float_data, void* output_data, dtype_t dtype, size_t size);    // Convert float32 array back to original dtype
-  void* allocate_dtype_array(dtype_t dtype, size_t size);  // Allocate memory for specific dtype
+  void* allocate_dtype_array(dtype_t dtype, size_t size);  // Allocate memory for specific dtype, from the pool in core/allocator.h (release with pool_free)
   void copy_with_dtype_conversion(void* src, dtype_t src_dtype, void* dst, dtype_t dst_dtype, size_t size); // Copy data with dtype conversion
   void* cast_array_dtype(void* data, dtype_t src_dtype, dtype_t dst_dtype, size_t size);    // Cast array data to different dtype
+  void* as_dtype_data(void* data, dtype_t src_dtype, dtype_t dst_dtype, size_t size);   // returns `data` itself if dtypes match, else a converted copy
+  void release_dtype_data(void* data, void* original);    // frees a buffer from as_dtype_data unless it's the original
+  dtype_t get_float_dtype(dtype_t dtype);   // dtype float ops compute in: float64 stays, everything else -> float32
 
   // Helper functions for type checking and validation
   int is_integer_dtype(dtype_t dtype);
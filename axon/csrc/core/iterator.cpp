@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "iterator.h"
+
+void iter_init(NdIter* it, int nop, void** data, int** strides, size_t* elem_sizes, int* shape, size_t ndim) {
+  if (nop < 1 || nop > ITER_MAX_OPERANDS || ndim > ITER_MAX_DIMS) {
+    fprintf(stderr, "Iterator supports up to %d operands & %d dims, got %d & %zu\n", ITER_MAX_OPERANDS, ITER_MAX_DIMS, nop, ndim);
+    exit(EXIT_FAILURE);
+  }
+  memset(it, 0, sizeof(NdIter));
+  it->nop = nop;
+  it->size = 1;
+
+  // c-contiguous element strides, used for operands passed without strides
+  int contiguous[ITER_MAX_DIMS];
+  int stride = 1;
+  for (int d = (int)ndim - 1; d >= 0; d--) {
+    contiguous[d] = stride;
+    stride *= shape[d];
+  }
+
+  int nd = 0;
+  for (size_t d = 0; d < ndim; d++) {
+    it->size *= shape[d];
+    if (shape[d] == 1) continue;    // size-1 dims never move the pointers
+    ptrdiff_t s[ITER_MAX_OPERANDS];
+    for (int op = 0; op < nop; op++) {
+      s[op] = (ptrdiff_t)(strides[op] ? strides[op][d] : contiguous[d]) * (ptrdiff_t)elem_sizes[op];
+    }
+
+    // merging into the previous dim when every operand continues straight into this one
+    int merge = nd > 0;
+    for (int op = 0; op < nop && merge; op++) {
+      if (it->strides[op][nd - 1] != s[op] * shape[d]) merge = 0;
+    }
+    if (merge) {
+      it->shape[nd - 1] *= shape[d];
+      for (int op = 0; op < nop; op++) it->strides[op][nd - 1] = s[op];
+    } else {
+      it->shape[nd] = shape[d];
+      for (int op = 0; op < nop; op++) it->strides[op][nd] = s[op];
+      nd++;
+    }
+  }
+  if (nd == 0) {
+    // scalar or all size-1 dims: a single inner loop of one element
+    it->shape[0] = 1;
+    nd = 1;
+  }
+
+  it->ndim = nd;
+  it->inner_size = it->size ? it->shape[nd - 1] : 0;    // empty arrays still get one (empty) inner loop
+  it->remaining = it->size;
+  for (int op = 0; op < nop; op++) {
+    it->inner_strides[op] = it->strides[op][nd - 1];
+    it->ptrs[op] = (char*)data[op];
+  }
+}
+
+void iter_init_arrays(NdIter* it, int nop, Array** arrays) {
+  if (nop < 1 || nop > ITER_MAX_OPERANDS) {
+    fprintf(stderr, "Iterator supports up to %d operands, got %d\n", ITER_MAX_OPERANDS, nop);
+    exit(EXIT_FAILURE);
+  }
+  void* data[ITER_MAX_OPERANDS];
+  int* strides[ITER_MAX_OPERANDS];
+  size_t elem_sizes[ITER_MAX_OPERANDS];
+  for (int op = 0; op < nop; op++) {
+    int same = arrays[op]->ndim == arrays[0]->ndim;
+    for (size_t d = 0; same && d < arrays[0]->ndim; d++) same = arrays[op]->shape[d] == arrays[0]->shape[d];
+    if (!same) {
+      fprintf(stderr, "Iterator operands must have the same shape\n");
+      exit(EXIT_FAILURE);
+    }
+    data[op] = arrays[op]->data;
+    strides[op] = arrays[op]->strides;
+    elem_sizes[op] = get_dtype_size(arrays[op]->dtype);
+  }
+  iter_init(it, nop, data, strides, elem_sizes, arrays[0]->shape, arrays[0]->ndim);
+}
+
+void iter_init_unary(NdIter* it, Array* a, Array* out) {
+  Array* arrays[2] = {a, out};
+  iter_init_arrays(it, 2, arrays);
+}
+
+void iter_init_binary(NdIter* it, Array* a, Array* b, Array* out) {
+  Array* arrays[3] = {a, b, out};
+  iter_init_arrays(it, 3, arrays);
+}
+
+// element strides of `self` seen through `shape` (ndim >= self->ndim), 0 on broadcast dims
+static void broadcast_strides(Array* self, int* shape, size_t ndim, int* strides) {
+  size_t offset = ndim - self->ndim;
+  for (size_t d = 0; d < ndim; d++) {
+    if (d < offset || self->shape[d - offset] == 1) { strides[d] = 0; continue; }
+    if (self->shape[d - offset] != shape[d]) {
+      fprintf(stderr, "shapes are not compatible for broadcasting\n");
+      exit(EXIT_FAILURE);
+    }
+    strides[d] = self->strides[d - offset];
+  }
+}
+
+void iter_init_broadcast(NdIter* it, Array* a, Array* b, Array* out) {
+  if (out->ndim > ITER_MAX_DIMS || a->ndim > out->ndim || b->ndim > out->ndim) {
+    fprintf(stderr, "shapes are not compatible for broadcasting\n");
+    exit(EXIT_FAILURE);
+  }
+  int a_strides[ITER_MAX_DIMS], b_strides[ITER_MAX_DIMS];
+  broadcast_strides(a, out->shape, out->ndim, a_strides);
+  broadcast_strides(b, out->shape, out->ndim, b_strides);
+
+  void* data[3] = {a->data, b->data, out->data};
+  int* strides[3] = {a_strides, b_strides, out->strides};
+  size_t elem_sizes[3] = {get_dtype_size(a->dtype), get_dtype_size(b->dtype), get_dtype_size(out->dtype)};
+  iter_init(it, 3, data, strides, elem_sizes, out->shape, out->ndim);
+}
+
+int broadcast_shape(Array* a, Array* b, int** shape, size_t* size) {
+  size_t max_ndim = a->ndim > b->ndim ? a->ndim : b->ndim;
+  int* broadcasted_shape = (int*)malloc(max_ndim * sizeof(int));
+  if (broadcasted_shape == NULL) {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+  for (size_t i = 0; i < max_ndim; i++) {
+    int dim1 = i < a->ndim ? a->shape[a->ndim - 1 - i] : 1;
+    int dim2 = i < b->ndim ? b->shape[b->ndim - 1 - i] : 1;
+    if (dim1 != dim2 && dim1 != 1 && dim2 != 1) {
+      fprintf(stderr, "shapes are not compatible for broadcasting\n");
+      free(broadcasted_shape);
+      exit(EXIT_FAILURE);
+    }
+    broadcasted_shape[max_ndim - 1 - i] = dim1 > dim2 ? dim1 : dim2;
+  }
+
+  // calculate broadcasted size
+  size_t broadcasted_size = 1;
+  for (size_t i = 0; i < max_ndim; i++) {
+    broadcasted_size *= broadcasted_shape[i];
+  }
+  *shape = broadcasted_shape;
+  *size = broadcasted_size;
+  return (int)max_ndim;
+}
+
+int iter_next(NdIter* it) {
+  if (it->remaining <= it->inner_size) return 0;
+  it->remaining -= it->inner_size;
+  if (it->inner_offset) {
+    // a range that started mid-row, back to the start of that row
+    for (int op = 0; op < it->nop; op++) it->ptrs[op] -= it->inner_strides[op] * (ptrdiff_t)it->inner_offset;
+    it->inner_offset = 0;
+  }
+  // odometer over every dim but the inner one, rewinding a dim once it wraps around
+  for (int d = it->ndim - 2; d >= 0; d--) {
+    if (++it->index[d] < it->shape[d]) {
+      for (int op = 0; op < it->nop; op++) it->ptrs[op] += it->strides[op][d];
+      break;
+    }
+    it->index[d] = 0;
+    for (int op = 0; op < it->nop; op++) it->ptrs[op] -= it->strides[op][d] * (it->shape[d] - 1);
+  }
+  size_t row = it->shape[it->ndim - 1];
+  it->inner_size = it->remaining < row ? it->remaining : row;
+  return 1;
+}
+
+void iter_range(NdIter* it, size_t begin, size_t end) {
+  if (end > it->size) end = it->size;
+  if (begin >= end) {
+    it->inner_size = 0;
+    it->remaining = 0;
+    return;
+  }
+  size_t row = it->shape[it->ndim - 1];
+  size_t outer = begin / row, offset = begin % row;
+  // outer index -> odometer position, last outer dim moves fastest
+  for (int d = it->ndim - 2; d >= 0; d--) {
+    it->index[d] = (int)(outer % it->shape[d]);
+    outer /= it->shape[d];
+    for (int op = 0; op < it->nop; op++) it->ptrs[op] += it->strides[op][d] * it->index[d];
+  }
+  for (int op = 0; op < it->nop; op++) it->ptrs[op] += it->inner_strides[op] * (ptrdiff_t)offset;
+  it->inner_offset = offset;
+  it->remaining = end - begin;
+  it->inner_size = (row - offset < it->remaining) ? row - offset : it->remaining;
+}
+
+int iter_inner_contiguous(NdIter* it, int op, size_t elem_size) {
+  return it->inner_size == 1 || it->inner_strides[op] == (ptrdiff_t)elem_size;
+}
@@ -0,0 +1,88 @@
+/**
+  @file iterator.h
+  @brief strided n-d iterator shared by the elementwise, comparison & reduction kernels
+  * walks up to ITER_MAX_OPERANDS arrays of the same shape in lockstep, each with its own strides
+  * adjacent dims that are laid out back to back in every operand are merged, size-1 dims dropped
+  * so a contiguous array (or a slice that keeps full rows) collapses into one long inner loop
+  * kernels run their own inner loop over `inner_size` elements using `ptrs` & `inner_strides`,
+    then call iter_next() to move the outer odometer
+  * a stride of 0 repeats the same element, used for reduction outputs & broadcasting
+  * broadcasting is just stride 0 on the expanded dims, so a (m, n) + (n,) row add runs m dense
+    inner loops & a (m, n) + (m, 1) column add runs m loops against a single repeated value
+  * iter_range() narrows a fresh iterator to a flat [begin, end) slice of the visiting order, the
+    first & last inner loops come out shorter, that's how cpu/parallel.h hands slices to threads
+*/
+
+#ifndef __ITERATOR__H__
+#define __ITERATOR__H__
+
+#include <stddef.h>
+#include "core.h"
+
+#define ITER_MAX_OPERANDS 4
+#define ITER_MAX_DIMS 32
+
+typedef struct NdIter {
+  int nop;                  // no of operands
+  int ndim;                 // no of dims left after coalescing (>= 1), last one is the inner loop
+  size_t size;              // total no of elements visited
+  size_t inner_size;        // length of the current inner loop
+  size_t remaining;         // elements left to visit, counting the current inner loop
+  size_t inner_offset;      // how far into its row the current inner loop starts (only set by iter_range)
+  int shape[ITER_MAX_DIMS];
+  int index[ITER_MAX_DIMS];   // odometer over the outer dims
+  ptrdiff_t strides[ITER_MAX_OPERANDS][ITER_MAX_DIMS];    // byte strides per operand & dim
+  ptrdiff_t inner_strides[ITER_MAX_OPERANDS];   // byte strides of the inner loop
+  char* ptrs[ITER_MAX_OPERANDS];    // start of the current inner loop for each operand
+} NdIter;
+
+extern "C" {
+  // `strides` are element strides like Array::strides, a NULL entry means c-contiguous over `shape`
+  void iter_init(NdIter* it, int nop, void** data, int** strides, size_t* elem_sizes, int* shape, size_t ndim);
+  // shorthand: iterates `arrays` in their own dtype, all must share arrays[0]'s shape
+  void iter_init_arrays(NdIter* it, int nop, Array** arrays);
+  void iter_init_unary(NdIter* it, Array* a, Array* out);   // operands: a, out
+  void iter_init_binary(NdIter* it, Array* a, Array* b, Array* out);    // operands: a, b, out
+  // broadcasting: a & b are aligned to out's shape from the right, dims they lack or hold as 1 get stride 0
+  void iter_init_broadcast(NdIter* it, Array* a, Array* b, Array* out);
+  int broadcast_shape(Array* a, Array* b, int** shape, size_t* size);   // broadcasted shape of a & b, returns its ndim
+  int iter_next(NdIter* it);    // moves to the next inner loop, returns 0 once everything is visited
+  void iter_range(NdIter* it, size_t begin, size_t end);    // restricts a freshly initialized iterator to elements [begin, end)
+  int iter_inner_contiguous(NdIter* it, int op, size_t elem_size);    // 1 if operand `op` is unit-stride in the inner loop
+}
+
+// element `i` of an inner loop starting at `p` with byte stride `s`
+template <typename T> inline T& iter_at(char* p, ptrdiff_t s, size_t i) { return *(T*)(p + (ptrdiff_t)i * s); }
+
+// one inner loop of out = op(a) over operands (a: T, out: R)
+template <typename T, typename R, typename Op> inline void iter_unary_loop(NdIter* it, Op op) {
+  char** p = it->ptrs;
+  ptrdiff_t* s = it->inner_strides;
+  size_t n = it->inner_size;
+  if (s[0] == (ptrdiff_t)sizeof(T) && s[1] == (ptrdiff_t)sizeof(R)) {
+    const T* x = (const T*)p[0];
+    R* o = (R*)p[1];
+    for (size_t i = 0; i < n; i++) { o[i] = op(x[i]); }
+  } else {
+    for (size_t i = 0; i < n; i++) { iter_at<R>(p[1], s[1], i) = op(iter_at<T>(p[0], s[0], i)); }
+  }
+}
+
+// one inner loop of out = op(a, b) over operands (a: T, b: T, out: R)
+// dense & one-side broadcast (stride 0) layouts get their own tight loops, anything else walks the strides
+template <typename T, typename R, typename Op> inline void iter_binary_loop(NdIter* it, Op op) {
+  char** p = it->ptrs;
+  ptrdiff_t* s = it->inner_strides;
+  size_t n = it->inner_size;
+  const ptrdiff_t t = sizeof(T);
+  if (s[2] == (ptrdiff_t)sizeof(R)) {
+    const T *x = (const T*)p[0], *y = (const T*)p[1];
+    R* o = (R*)p[2];
+    if (s[0] == t && s[1] == t) { for (size_t i = 0; i < n; i++) { o[i] = op(x[i], y[i]); } return; }
+    if (s[0] == t && s[1] == 0) { const T yv = *y; for (size_t i = 0; i < n; i++) { o[i] = op(x[i], yv); } return; }
+    if (s[0] == 0 && s[1] == t) { const T xv = *x; for (size_t i = 0; i < n; i++) { o[i] = op(xv, y[i]); } return; }
+  }
+  for (size_t i = 0; i < n; i++) { iter_at<R>(p[2], s[2], i) = op(iter_at<T>(p[0], s[0], i), iter_at<T>(p[1], s[1], i)); }
+}
+
+#endif  //!__ITERATOR__H__
@@ -0,0 +1,956 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <limits>
+#include "factor.h"
+#include "gemm.h"
+#include "parallel.h"
+#include "simd.h"
+#include "../core/allocator.h"
+
+template <typename T> static void swap_rows(T* x, T* y, int n) {
+  for (int c = 0; c < n; c++) {
+    T t = x[c];
+    x[c] = y[c];
+    y[c] = t;
+  }
+}
+
+// unblocked solve, A(i, k) sits at a[i * rs + k * cs] so a transposed triangle is read in place:
+// row by row (each row of A read once, left to right) when its rows are contiguous, column by
+// column otherwise; b's columns are split across threads when it's wide
+template <typename T> static void trsm_block(int lower, int unit, int n, int nrhs, const T* a, ptrdiff_t rs, ptrdiff_t cs, T* b, ptrdiff_t ldb) {
+  parallel_for(nrhs, parallel_grain((size_t)n * n), [&](size_t lo, size_t hi) {
+    const SimdKernels* simd = simd_kernels();
+    int cols = (int)(hi - lo);
+    T* bb = b + lo;
+    for (int s = 0; s < n; s++) {
+      int i = lower ? s : n - 1 - s;
+      T* bi = bb + i * ldb;
+      if (cs == 1) {
+        const T* ai = a + i * rs;
+        int k0 = lower ? 0 : i + 1, k1 = lower ? i : n;
+        if (cols == 1 && ldb == 1) bi[0] -= pairwise_sum(simd, ai + k0, bb + k0, k1 - k0);   // one dense vector: a dot per row
+        else {
+          for (int k = k0; k < k1; k++) {
+            T l = ai[k];
+            if (l == 0) continue;
+            T* bk = bb + k * ldb;
+            for (int c = 0; c < cols; c++) bi[c] -= l * bk[c];
+          }
+        }
+        if (!unit) {
+          for (int c = 0; c < cols; c++) bi[c] /= ai[i];
+        }
+        continue;
+      }
+      if (!unit) {
+        T d = a[i * rs + i * cs];
+        for (int c = 0; c < cols; c++) bi[c] /= d;
+      }
+      int k0 = lower ? i + 1 : 0, k1 = lower ? n : i;
+      if (cols == 1 && ldb == 1 && rs == 1) {
+        // one dense vector against a dense column: a plain axpy
+        const T* col = a + i * cs;
+        T x = bi[0];
+        for (int k = k0; k < k1; k++) bb[k] -= col[k] * x;
+        continue;
+      }
+      for (int k = k0; k < k1; k++) {
+        T l = a[k * rs + i * cs];
+        if (l == 0) continue;
+        T* bk = bb + k * ldb;
+        for (int c = 0; c < cols; c++) bk[c] -= l * bi[c];
+      }
+    }
+  });
+}
+
+template <typename T> static void trsm_blocked(int lower, int trans, int unit, int n, int nrhs, const T* a, ptrdiff_t lda, T* b, ptrdiff_t ldb) {
+  if (n <= 0 || nrhs <= 0) return;
+  ptrdiff_t rs = trans ? 1 : lda, cs = trans ? lda : 1;
+  if (trans) lower = !lower;    // the transpose of a lower triangle is an upper one
+  if (nrhs < FACTOR_NARROW) {
+    // a gemm update would pad these few columns out to a full micro-kernel tile
+    trsm_block(lower, unit, n, nrhs, a, rs, cs, b, ldb);
+    return;
+  }
+  if (lower) {
+    for (int i0 = 0; i0 < n; i0 += FACTOR_BLOCK) {
+      int ib = (n - i0 < FACTOR_BLOCK) ? n - i0 : FACTOR_BLOCK;
+      trsm_block(1, unit, ib, nrhs, a + i0 * rs + i0 * cs, rs, cs, b + i0 * ldb, ldb);
+      gemm_update(n - i0 - ib, nrhs, ib, (T)-1, a + (i0 + ib) * rs + i0 * cs, rs, cs, b + i0 * ldb, ldb, 1, b + (i0 + ib) * ldb, ldb);
+    }
+    return;
+  }
+  for (int i0 = (n - 1) / FACTOR_BLOCK * FACTOR_BLOCK; i0 >= 0; i0 -= FACTOR_BLOCK) {
+    int ib = (n - i0 < FACTOR_BLOCK) ? n - i0 : FACTOR_BLOCK;
+    trsm_block(0, unit, ib, nrhs, a + i0 * rs + i0 * cs, rs, cs, b + i0 * ldb, ldb);
+    gemm_update(i0, nrhs, ib, (T)-1, a + i0 * cs, rs, cs, b + i0 * ldb, ldb, 1, b, ldb);
+  }
+}
+
+// columns [j, j + jb) from row j down, pivot rows are swapped across the full width n
+template <typename T> static int getrf_panel(int n, int j, int jb, T* a, ptrdiff_t lda, int* piv) {
+  int info = 0;
+  for (int k = j; k < j + jb; k++) {
+    int p = k;
+    T max_val = fabs(a[k * lda + k]);
+    for (int i = k + 1; i < n; i++) {
+      T v = fabs(a[i * lda + k]);
+      if (v > max_val) { max_val = v; p = i; }
+    }
+    piv[k] = p;
+    if (p != k) swap_rows(a + k * lda, a + p * lda, n);
+    T* uk = a + k * lda;
+    if (uk[k] == 0) {
+      if (!info) info = k + 1;
+      continue;
+    }
+    for (int i = k + 1; i < n; i++) {
+      T* ai = a + i * lda;
+      T l = ai[k] /= uk[k];
+      for (int c = k + 1; c < j + jb; c++) ai[c] -= l * uk[c];
+    }
+  }
+  return info;
+}
+
+template <typename T> static int getrf_blocked(int n, T* a, ptrdiff_t lda, int* piv) {
+  int info = 0;
+  for (int j = 0; j < n; j += FACTOR_BLOCK) {
+    int jb = (n - j < FACTOR_BLOCK) ? n - j : FACTOR_BLOCK, rest = n - j - jb;
+    int panel_info = getrf_panel(n, j, jb, a, lda, piv);
+    if (panel_info && !info) info = panel_info;
+    if (rest == 0) break;
+    // U12 = L11^-1 A12, then A22 -= L21 @ U12
+    T* a11 = a + j * lda + j;
+    trsm_block(1, 1, jb, rest, a11, lda, 1, a11 + jb, lda);
+    gemm_update(rest, rest, jb, (T)-1, a11 + jb * lda, lda, 1, a11 + jb, lda, 1, a11 + jb * lda + jb, lda);
+  }
+  return info;
+}
+
+template <typename T> static void getrs_blocked(int n, int nrhs, const T* lu, ptrdiff_t lda, const int* piv, T* b, ptrdiff_t ldb) {
+  for (int k = 0; k < n; k++) {
+    if (piv[k] != k) swap_rows(b + k * ldb, b + piv[k] * ldb, nrhs);
+  }
+  trsm_blocked(1, 0, 1, n, nrhs, lu, lda, b, ldb);
+  trsm_blocked(0, 0, 0, n, nrhs, lu, lda, b, ldb);
+}
+
+// unblocked cholesky of one diagonal block, row by row so every sum is a contiguous dot
+template <typename T> static int potrf_block(int n, T* a, ptrdiff_t lda) {
+  for (int k = 0; k < n; k++) {
+    T* ak = a + k * lda;
+    T d = ak[k];
+    for (int p = 0; p < k; p++) d -= ak[p] * ak[p];
+    if (!(d > 0)) return k + 1;   // also catches nan
+    ak[k] = sqrt(d);
+    for (int i = k + 1; i < n; i++) {
+      T* ai = a + i * lda;
+      T s = ai[k];
+      for (int p = 0; p < k; p++) s -= ai[p] * ak[p];
+      ai[k] = s / ak[k];
+    }
+  }
+  return 0;
+}
+
+template <typename T> static int potrf_blocked(int n, T* a, ptrdiff_t lda) {
+  for (int j = 0; j < n; j += FACTOR_BLOCK) {
+    int jb = (n - j < FACTOR_BLOCK) ? n - j : FACTOR_BLOCK, rest = n - j - jb;
+    T* a11 = a + j * lda + j;
+    int info = potrf_block(jb, a11, lda);
+    if (info) return j + info;
+    if (rest == 0) break;
+    // L21 = A21 L11^-T one row at a time, then A22 -= L21 @ L21^T
+    T* a21 = a11 + jb * lda;
+    parallel_for(rest, parallel_grain((size_t)jb * jb), [&](size_t lo, size_t hi) {
+      for (size_t r = lo; r < hi; r++) {
+        T* x = a21 + r * lda;
+        for (int k = 0; k < jb; k++) {
+          const T* lk = a11 + k * lda;
+          T s = x[k];
+          for (int p = 0; p < k; p++) s -= x[p] * lk[p];
+          x[k] = s / lk[k];
+        }
+      }
+    });
+    gemm_update(rest, rest, jb, (T)-1, a21, lda, 1, a21, 1, lda, a21 + jb, lda);
+  }
+  return 0;
+}
+
+template <typename T> static void potrs_blocked(int n, int nrhs, const T* l, ptrdiff_t lda, T* b, ptrdiff_t ldb) {
+  trsm_blocked(1, 0, 0, n, nrhs, l, lda, b, ldb);
+  trsm_blocked(1, 1, 0, n, nrhs, l, lda, b, ldb);
+}
+
+template <typename T> static T* factor_scratch(size_t count) {
+  T* p = (T*)pool_alloc((count ? count : 1) * sizeof(T));
+  if (p == NULL) {
+    fprintf(stderr, "Memory allocation failed for factorization workspace\n");
+    exit(EXIT_FAILURE);
+  }
+  return p;
+}
+
+// reflector H = I - tau v v^T zeroing column k of a below row k: v[0] = 1 is implicit, the rest of v
+// replaces the column below the diagonal & a[k][k] becomes beta; tau is 0 for a column already reduced
+template <typename T> static T householder(int m, int k, T* a, ptrdiff_t lda) {
+  T alpha = a[k * lda + k], ssq = 0;
+  for (int r = k + 1; r < m; r++) ssq += a[r * lda + k] * a[r * lda + k];
+  if (ssq == 0) return 0;
+  T beta = sqrt(alpha * alpha + ssq);
+  if (alpha > 0) beta = -beta;    // opposite sign to alpha, so alpha - beta never cancels
+  T scale = 1 / (alpha - beta);
+  for (int r = k + 1; r < m; r++) a[r * lda + k] *= scale;
+  a[k * lda + k] = beta;
+  return (beta - alpha) / beta;
+}
+
+// unblocked qr of columns [j, j + jb) from row j down, each reflector applied to the rest of the
+// panel a row at a time through w (jb wide)
+template <typename T> static void geqrf_panel(int m, int j, int jb, T* a, ptrdiff_t lda, T* tau, T* w) {
+  for (int k = j; k < j + jb; k++) {
+    tau[k] = householder(m, k, a, lda);
+    int c0 = k + 1, c1 = j + jb;
+    if (tau[k] == 0 || c0 >= c1) continue;
+    // w = v^T A[k:, c0:c1], then A[k:, c0:c1] -= tau v w
+    T* ak = a + k * lda;
+    for (int c = c0; c < c1; c++) w[c - c0] = ak[c];
+    for (int r = k + 1; r < m; r++) {
+      const T* ar = a + r * lda;
+      for (int c = c0; c < c1; c++) w[c - c0] += ar[k] * ar[c];
+    }
+    for (int c = c0; c < c1; c++) ak[c] -= tau[k] * w[c - c0];
+    for (int r = k + 1; r < m; r++) {
+      T* ar = a + r * lda;
+      T tv = tau[k] * ar[k];
+      for (int c = c0; c < c1; c++) ar[c] -= tv * w[c - c0];
+    }
+  }
+}
+
+// reflectors j .. j + jb - 1 as one block H = I - V T V^T (compact WY): V explicit (m - j x jb, unit
+// diagonal, zeros above) so gemm can read it, T upper triangular jb x jb
+template <typename T> static void qr_block_reflector(int m, int j, int jb, const T* a, ptrdiff_t lda, const T* tau, T* v, T* t) {
+  int mv = m - j;
+  for (int r = 0; r < mv; r++) {
+    for (int c = 0; c < jb; c++) v[r * jb + c] = (r > c) ? a[(j + r) * lda + j + c] : (r == c) ? 1 : 0;
+  }
+  for (int i = 0; i < jb; i++) {
+    // t[0:i, i] = -tau_i T[0:i, 0:i] (V[:, 0:i]^T v_i)
+    for (int p = 0; p < jb; p++) t[p * jb + i] = 0;
+    for (int r = i; r < mv; r++) {
+      const T* vr = v + r * jb;
+      for (int p = 0; p < i; p++) t[p * jb + i] += vr[p] * vr[i];
+    }
+    for (int p = 0; p < i; p++) {
+      T s = 0;
+      for (int q = p; q < i; q++) s += t[p * jb + q] * t[q * jb + i];
+      t[p * jb + i] = -tau[j + i] * s;
+    }
+    t[i * jb + i] = tau[j + i];
+  }
+}
+
+// c[mv x nc] = H c, or H^T c with `trans`, for H = I - V T V^T; w is jb x nc scratch
+template <typename T> static void apply_block_reflector(int trans, int mv, int nc, int jb, const T* v, const T* t, T* c, ptrdiff_t ldc, T* w) {
+  gemm(jb, nc, mv, v, 1, jb, c, ldc, 1, w, nc);   // w = V^T c
+  // w = T w (T^T w), in place in the order that leaves the rows still to be read untouched
+  for (int s = 0; s < jb; s++) {
+    int i = trans ? jb - 1 - s : s;
+    T* wi = w + i * nc;
+    T d = t[i * jb + i];
+    for (int col = 0; col < nc; col++) wi[col] *= d;
+    for (int p = trans ? 0 : i + 1; p < (trans ? i : jb); p++) {
+      T tp = trans ? t[p * jb + i] : t[i * jb + p];
+      const T* wp = w + p * nc;
+      for (int col = 0; col < nc; col++) wi[col] += tp * wp[col];
+    }
+  }
+  gemm_update(mv, nc, jb, (T)-1, v, jb, 1, w, nc, 1, c, ldc);   // c -= V w
+}
+
+template <typename T> static void geqrf_blocked(int m, int n, T* a, ptrdiff_t lda, T* tau) {
+  int k = (m < n) ? m : n;
+  T *v = factor_scratch<T>((size_t)m * FACTOR_BLOCK), *t = factor_scratch<T>(FACTOR_BLOCK * FACTOR_BLOCK), *w = factor_scratch<T>((size_t)FACTOR_BLOCK * n);
+  for (int j = 0; j < k; j += FACTOR_BLOCK) {
+    int jb = (k - j < FACTOR_BLOCK) ? k - j : FACTOR_BLOCK, rest = n - j - jb;
+    geqrf_panel(m, j, jb, a, lda, tau, w);
+    if (rest == 0) continue;
+    qr_block_reflector(m, j, jb, a, lda, tau, v, t);
+    apply_block_reflector(1, m - j, rest, jb, v, t, a + j * lda + j + jb, lda, w);
+  }
+  pool_free(v); pool_free(t); pool_free(w);
+}
+
+// Q^T = H_k ... H_1 applies the blocks first to last, Q = H_1 ... H_k last to first
+template <typename T> static void ormqr_blocked(int trans, int m, int nrhs, int k, const T* qr, ptrdiff_t lda, const T* tau, T* b, ptrdiff_t ldb) {
+  if (k <= 0 || nrhs <= 0) return;
+  T *v = factor_scratch<T>((size_t)m * FACTOR_BLOCK), *t = factor_scratch<T>(FACTOR_BLOCK * FACTOR_BLOCK), *w = factor_scratch<T>((size_t)FACTOR_BLOCK * nrhs);
+  int blocks = (k + FACTOR_BLOCK - 1) / FACTOR_BLOCK;
+  for (int s = 0; s < blocks; s++) {
+    int j = (trans ? s : blocks - 1 - s) * FACTOR_BLOCK, jb = (k - j < FACTOR_BLOCK) ? k - j : FACTOR_BLOCK;
+    qr_block_reflector(m, j, jb, qr, lda, tau, v, t);
+    apply_block_reflector(trans, m - j, nrhs, jb, v, t, b + j * ldb, ldb, w);
+  }
+  pool_free(v); pool_free(t); pool_free(w);
+}
+
+template <typename T> static void orgqr_blocked(int m, int ncols, int k, const T* qr, ptrdiff_t lda, const T* tau, T* q, ptrdiff_t ldq) {
+  for (int i = 0; i < m; i++) {
+    for (int c = 0; c < ncols; c++) q[i * ldq + c] = (i == c) ? 1 : 0;
+  }
+  ormqr_blocked(0, m, ncols, k, qr, lda, tau, q, ldq);
+}
+
+// householder tridiagonalization Q^T A Q = T of the symmetric a (both triangles held), reflector k
+// zeroes column k below the subdiagonal & is stored there the way geqrf stores it for a + lda; the
+// trailing matrix takes each reflector as the symmetric rank 2 update A -= v w^T + w v^T with
+// w = tau A v - (tau^2 / 2) (v^T A v) v, row by row so every pass over it is contiguous
+template <typename T> static void sytrd_unblocked(int n, T* a, ptrdiff_t lda, T* d, T* e, T* tau) {
+  T* buf = factor_scratch<T>(2 * (size_t)n);
+  T *v = buf, *w = buf + n;
+  for (int k = 0; k < n - 1; k++) {
+    d[k] = a[k * lda + k];
+    tau[k] = householder(n - 1, k, a + lda, lda);
+    e[k] = a[(k + 1) * lda + k];
+    int m = n - k - 1;
+    T t = tau[k];
+    if (t == 0) continue;
+    T* a22 = a + (k + 1) * lda + k + 1;
+    v[0] = 1;
+    for (int r = 1; r < m; r++) v[r] = a[(k + 1 + r) * lda + k];
+    parallel_for(m, parallel_grain((size_t)m), [&](size_t lo, size_t hi) {
+      const SimdKernels* simd = simd_kernels();
+      for (size_t r = lo; r < hi; r++) w[r] = t * pairwise_sum(simd, a22 + r * lda, v, m);
+    });
+    T alpha = -t / 2 * pairwise_sum(simd_kernels(), w, v, m);
+    for (int r = 0; r < m; r++) w[r] += alpha * v[r];
+    parallel_for(m, parallel_grain((size_t)m), [&](size_t lo, size_t hi) {
+      for (size_t r = lo; r < hi; r++) {
+        T *ar = a22 + r * lda, vr = v[r], wr = w[r];
+        for (int c = 0; c < m; c++) ar[c] -= vr * w[c] + wr * v[c];
+      }
+    });
+  }
+  if (n > 0) { d[n - 1] = a[(n - 1) * lda + n - 1]; e[n - 1] = 0; }
+  pool_free(buf);
+}
+
+// implicit shift ql on the symmetric tridiagonal (d, e), e[i] couples i & i + 1: each sweep chases
+// a wilkinson shifted bulge up from the bottom of an unreduced block with givens rotations; when zt
+// isn't NULL the rotations are applied to its rows (ncols wide), so row i ends up as the vector of d[i]
+template <typename T> static int steqr_ql(int n, T* d, T* e, T* zt, int ncols, ptrdiff_t ldz) {
+  const T eps = std::numeric_limits<T>::epsilon();
+  for (int l = 0; l < n; l++) {
+    int iter = 0, m;
+    do {
+      for (m = l; m < n - 1; m++) {
+        T dd = fabs(d[m]) + fabs(d[m + 1]);
+        if (fabs(e[m]) <= eps * dd) break;
+      }
+      if (m == l) break;
+      if (iter++ == 30 * (n > 1 ? n : 1)) return l + 1;
+      T g = (d[l + 1] - d[l]) / (2 * e[l]), r = hypot(g, (T)1);
+      g = d[m] - d[l] + e[l] / (g + copysign(r, g));
+      T s = 1, c = 1, p = 0;
+      int i;
+      for (i = m - 1; i >= l; i--) {
+        T f = s * e[i], b = c * e[i];
+        e[i + 1] = r = hypot(f, g);
+        if (r == 0) {
+          // the rotation decoupled the block: deflate & start over on the smaller one
+          d[i + 1] -= p; e[m] = 0;
+          break;
+        }
+        s = f / r; c = g / r; g = d[i + 1] - p;
+        r = (d[i] - g) * s + 2 * c * b;
+        p = s * r; d[i + 1] = g + p; g = c * r - b;
+        if (zt != NULL) {
+          T *zi = zt + i * ldz, *zn = zi + ldz;
+          for (int col = 0; col < ncols; col++) {
+            T zc = zn[col];
+            zn[col] = s * zi[col] + c * zc;
+            zi[col] = c * zi[col] - s * zc;
+          }
+        }
+      }
+      if (r == 0 && i >= l) continue;
+      d[l] -= p; e[l] = g; e[m] = 0;
+    } while (m != l);
+  }
+  return 0;
+}
+
+// householder reduction Q^T A Q = H to upper hessenberg form, reflector k zeroes column k below the
+// subdiagonal & is stored there like sytrd's; each is applied from the left (w = v^T A, rows k + 1 on)
+// & then from the right (y = A v, every row), both a row of a at a time
+template <typename T> static void gehrd_unblocked(int n, T* a, ptrdiff_t lda, T* tau) {
+  T* buf = factor_scratch<T>(2 * (size_t)n);
+  T *v = buf, *w = buf + n;
+  for (int k = 0; k < n - 1; k++) {
+    tau[k] = householder(n - 1, k, a + lda, lda);
+    int m = n - k - 1;
+    T t = tau[k];
+    if (t == 0) continue;
+    v[0] = 1;
+    for (int r = 1; r < m; r++) v[r] = a[(k + 1 + r) * lda + k];
+    // left: A[k + 1:, k + 1:] -= tau v (v^T A[k + 1:, k + 1:])
+    T* a22 = a + (k + 1) * lda + k + 1;
+    for (int c = 0; c < m; c++) w[c] = 0;
+    for (int r = 0; r < m; r++) {
+      const T* ar = a22 + r * lda;
+      T vr = v[r];
+      for (int c = 0; c < m; c++) w[c] += vr * ar[c];
+    }
+    parallel_for(m, parallel_grain((size_t)m), [&](size_t lo, size_t hi) {
+      for (size_t r = lo; r < hi; r++) {
+        T *ar = a22 + r * lda, tv = t * v[r];
+        for (int c = 0; c < m; c++) ar[c] -= tv * w[c];
+      }
+    });
+    // right: A[:, k + 1:] -= tau (A[:, k + 1:] v) v^T
+    parallel_for(n, parallel_grain((size_t)m), [&](size_t lo, size_t hi) {
+      const SimdKernels* simd = simd_kernels();
+      for (size_t r = lo; r < hi; r++) {
+        T* ar = a + r * lda + k + 1;
+        T y = t * pairwise_sum(simd, ar, v, m);
+        for (int c = 0; c < m; c++) ar[c] -= y * v[c];
+      }
+    });
+  }
+  pool_free(buf);
+}
+
+// Francis double shift qr on the upper hessenberg h (EISPACK hqr2): deflates one or two eigenvalues
+// at a time off the bottom of the active block, with wilkinson's exceptional shifts after 10 & 30
+// stalled sweeps. With zt the whole of h is kept up to date (it ends as the real schur form T: 2 x 2
+// blocks only for complex pairs) & the transformations are applied to the rows of zt; without it
+// only the active block is touched
+template <typename T> static int hseqr_francis(int nn, T* h, ptrdiff_t ldh, T* wr, T* wi, T* zt, ptrdiff_t ldz) {
+  auto H = [&](int i, int j) -> T& { return h[i * ldh + j]; };
+  const T eps = std::numeric_limits<T>::epsilon();
+  int n = nn - 1, iter = 0, total = 0;
+  T exshift = 0, p = 0, q = 0, r = 0, s = 0, z = 0, w, x, y, norm = 0;
+  for (int i = 0; i < nn; i++) {
+    for (int j = (i > 0 ? i - 1 : 0); j < nn; j++) norm += fabs(H(i, j));
+  }
+  while (n >= 0) {
+    // look for a single small subdiagonal element
+    int l = n;
+    while (l > 0) {
+      s = fabs(H(l - 1, l - 1)) + fabs(H(l, l));
+      if (s == 0) s = norm;
+      if (fabs(H(l, l - 1)) <= eps * s) break;
+      l--;
+    }
+    if (l == n) {
+      // one root
+      H(n, n) += exshift;
+      wr[n] = H(n, n); wi[n] = 0;
+      n--; iter = 0;
+    } else if (l == n - 1) {
+      // two roots, a real pair is split by one more rotation so T stays triangular there
+      w = H(n, n - 1) * H(n - 1, n);
+      p = (H(n - 1, n - 1) - H(n, n)) / 2;
+      q = p * p + w;
+      z = sqrt(fabs(q));
+      H(n, n) += exshift; H(n - 1, n - 1) += exshift;
+      x = H(n, n);
+      if (q >= 0) {
+        z = (p >= 0) ? p + z : p - z;
+        wr[n - 1] = x + z; wr[n] = (z != 0) ? x - w / z : x + z;
+        wi[n - 1] = wi[n] = 0;
+        if (zt != NULL) {
+          x = H(n, n - 1);
+          s = fabs(x) + fabs(z);
+          p = x / s; q = z / s;
+          r = sqrt(p * p + q * q);
+          p /= r; q /= r;
+          for (int j = n - 1; j < nn; j++) {
+            z = H(n - 1, j);
+            H(n - 1, j) = q * z + p * H(n, j);
+            H(n, j) = q * H(n, j) - p * z;
+          }
+          for (int i = 0; i <= n; i++) {
+            z = H(i, n - 1);
+            H(i, n - 1) = q * z + p * H(i, n);
+            H(i, n) = q * H(i, n) - p * z;
+          }
+          T *z0 = zt + (n - 1) * ldz, *z1 = z0 + ldz;
+          for (int i = 0; i < nn; i++) {
+            T zi = z0[i];
+            z0[i] = q * zi + p * z1[i];
+            z1[i] = q * z1[i] - p * zi;
+          }
+        }
+      } else {
+        wr[n - 1] = wr[n] = x + p;
+        wi[n - 1] = z; wi[n] = -z;
+      }
+      n -= 2; iter = 0;
+    } else {
+      if (total++ == 30 * nn) return n + 1;
+      x = H(n, n);
+      y = w = 0;
+      if (l < n) { y = H(n - 1, n - 1); w = H(n, n - 1) * H(n - 1, n); }
+      if (iter == 10) {
+        // wilkinson's exceptional shift
+        exshift += x;
+        for (int i = 0; i <= n; i++) H(i, i) -= x;
+        s = fabs(H(n, n - 1)) + fabs(H(n - 1, n - 2));
+        x = y = (T)0.75 * s;
+        w = (T)-0.4375 * s * s;
+      }
+      if (iter == 30) {
+        s = (y - x) / 2;
+        s = s * s + w;
+        if (s > 0) {
+          s = sqrt(s);
+          if (y < x) s = -s;
+          s = x - w / ((y - x) / 2 + s);
+          for (int i = 0; i <= n; i++) H(i, i) -= s;
+          exshift += s;
+          x = y = w = (T)0.964;
+        }
+      }
+      iter++;
+      // look for two consecutive small subdiagonal elements, the bulge starts at m
+      int m = n - 2;
+      while (m >= l) {
+        z = H(m, m);
+        r = x - z; s = y - z;
+        p = (r * s - w) / H(m + 1, m) + H(m, m + 1);
+        q = H(m + 1, m + 1) - z - r - s;
+        r = H(m + 2, m + 1);
+        s = fabs(p) + fabs(q) + fabs(r);
+        p /= s; q /= s; r /= s;
+        if (m == l) break;
+        if (fabs(H(m, m - 1)) * (fabs(q) + fabs(r)) < eps * (fabs(p) * (fabs(H(m - 1, m - 1)) + fabs(z) + fabs(H(m + 1, m + 1))))) break;
+        m--;
+      }
+      for (int i = m + 2; i <= n; i++) {
+        H(i, i - 2) = 0;
+        if (i > m + 2) H(i, i - 3) = 0;
+      }
+      // chase the bulge down rows l .. n with 3 x 3 reflectors
+      int jend = (zt != NULL) ? nn - 1 : n, ibeg = (zt != NULL) ? 0 : l;
+      for (int k = m; k <= n - 1; k++) {
+        bool notlast = k != n - 1;
+        if (k != m) {
+          p = H(k, k - 1); q = H(k + 1, k - 1); r = notlast ? H(k + 2, k - 1) : 0;
+          x = fabs(p) + fabs(q) + fabs(r);
+          if (x == 0) continue;
+          p /= x; q /= x; r /= x;
+        }
+        s = sqrt(p * p + q * q + r * r);
+        if (p < 0) s = -s;
+        if (s == 0) continue;
+        if (k != m) H(k, k - 1) = -s * x;
+        else if (l != m) H(k, k - 1) = -H(k, k - 1);
+        p += s;
+        x = p / s; y = q / s; z = r / s;
+        q /= p; r /= p;
+        T *h0 = h + k * ldh, *h1 = h0 + ldh, *h2 = h1 + ldh;
+        for (int j = k; j <= jend; j++) {
+          T pj = h0[j] + q * h1[j];
+          if (notlast) { pj += r * h2[j]; h2[j] -= pj * z; }
+          h0[j] -= pj * x; h1[j] -= pj * y;
+        }
+        int iend = (n < k + 3) ? n : k + 3;
+        for (int i = ibeg; i <= iend; i++) {
+          T* hi = h + i * ldh + k;
+          T pi = x * hi[0] + y * hi[1];
+          if (notlast) { pi += z * hi[2]; hi[2] -= pi * r; }
+          hi[0] -= pi; hi[1] -= pi * q;
+        }
+        if (zt != NULL) {
+          T *z0 = zt + k * ldz, *z1 = z0 + ldz, *z2 = z1 + ldz;
+          for (int i = 0; i < nn; i++) {
+            T pi = x * z0[i] + y * z1[i];
+            if (notlast) { pi += z * z2[i]; z2[i] -= pi * r; }
+            z0[i] -= pi; z1[i] -= pi * q;
+          }
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+// (xr + i xi) / (yr + i yi) without overflowing in the intermediate products
+template <typename T> static void complex_div(T xr, T xi, T yr, T yi, T* qr, T* qi) {
+  if (fabs(yr) > fabs(yi)) {
+    T r = yi / yr, d = yr + r * yi;
+    *qr = (xr + r * xi) / d; *qi = (xi - r * xr) / d;
+  } else {
+    T r = yr / yi, d = yi + r * yr;
+    *qr = (r * xr + xi) / d; *qi = (r * xi - xr) / d;
+  }
+}
+
+// eigenvectors of the real schur form t by back substitution (the second half of hqr2), in place:
+// column j of t becomes the vector of eigenvalue j, a complex pair j, j + 1 (wi[j] > 0) becomes its
+// real & imaginary part, every vector only reaching down to its own row
+template <typename T> static void trevc_backsub(int nn, T* t, ptrdiff_t ldt, const T* wr, const T* wi) {
+  auto H = [&](int i, int j) -> T& { return t[i * ldt + j]; };
+  const T eps = std::numeric_limits<T>::epsilon();
+  T norm = 0, p, q, r = 0, s = 0, w, x, y, z = 0, tt;
+  for (int i = 0; i < nn; i++) {
+    for (int j = (i > 0 ? i - 1 : 0); j < nn; j++) norm += fabs(H(i, j));
+  }
+  if (norm == 0) {
+    // T = 0, every vector will do: take the unit ones
+    for (int i = 0; i < nn; i++) { for (int j = 0; j < nn; j++) H(i, j) = (i == j) ? 1 : 0; }
+    return;
+  }
+  for (int n = nn - 1; n >= 0; n--) {
+    p = wr[n]; q = wi[n];
+    if (q == 0) {
+      int l = n;
+      H(n, n) = 1;
+      for (int i = n - 1; i >= 0; i--) {
+        w = H(i, i) - p;
+        r = 0;
+        for (int j = l; j <= n; j++) r += H(i, j) * H(j, n);
+        if (wi[i] < 0) { z = w; s = r; continue; }
+        l = i;
+        if (wi[i] == 0) H(i, n) = (w != 0) ? -r / w : -r / (eps * norm);
+        else {
+          // a 2 x 2 block of a complex pair: solve its real equations
+          x = H(i, i + 1); y = H(i + 1, i);
+          q = (wr[i] - p) * (wr[i] - p) + wi[i] * wi[i];
+          tt = (x * s - z * r) / q;
+          H(i, n) = tt;
+          H(i + 1, n) = (fabs(x) > fabs(z)) ? (-r - w * tt) / x : (-s - y * tt) / z;
+        }
+        tt = fabs(H(i, n));
+        if ((eps * tt) * tt > 1) {
+          for (int j = i; j <= n; j++) H(j, n) /= tt;
+        }
+      }
+    } else if (q < 0) {
+      // the pair n - 1, n: last component imaginary, so the leading block is triangular
+      int l = n - 1;
+      if (fabs(H(n, n - 1)) > fabs(H(n - 1, n))) {
+        H(n - 1, n - 1) = q / H(n, n - 1);
+        H(n - 1, n) = -(H(n, n) - p) / H(n, n - 1);
+      } else complex_div((T)0, -H(n - 1, n), H(n - 1, n - 1) - p, q, &H(n - 1, n - 1), &H(n - 1, n));
+      H(n, n - 1) = 0; H(n, n) = 1;
+      for (int i = n - 2; i >= 0; i--) {
+        T ra = 0, sa = 0, vr, vi;
+        for (int j = l; j <= n; j++) { ra += H(i, j) * H(j, n - 1); sa += H(i, j) * H(j, n); }
+        w = H(i, i) - p;
+        if (wi[i] < 0) { z = w; r = ra; s = sa; continue; }
+        l = i;
+        if (wi[i] == 0) complex_div(-ra, -sa, w, q, &H(i, n - 1), &H(i, n));
+        else {
+          x = H(i, i + 1); y = H(i + 1, i);
+          vr = (wr[i] - p) * (wr[i] - p) + wi[i] * wi[i] - q * q;
+          vi = (wr[i] - p) * 2 * q;
+          if (vr == 0 && vi == 0) vr = eps * norm * (fabs(w) + fabs(q) + fabs(x) + fabs(y) + fabs(z));
+          complex_div(x * r - z * ra + q * sa, x * s - z * sa - q * ra, vr, vi, &H(i, n - 1), &H(i, n));
+          if (fabs(x) > fabs(z) + fabs(q)) {
+            H(i + 1, n - 1) = (-ra - w * H(i, n - 1) + q * H(i, n)) / x;
+            H(i + 1, n) = (-sa - w * H(i, n) - q * H(i, n - 1)) / x;
+          } else complex_div(-r - y * H(i, n - 1), -s - y * H(i, n), z, q, &H(i + 1, n - 1), &H(i + 1, n));
+        }
+        tt = fmax(fabs(H(i, n - 1)), fabs(H(i, n)));
+        if ((eps * tt) * tt > 1) {
+          for (int j = i; j <= n; j++) { H(j, n - 1) /= tt; H(j, n) /= tt; }
+        }
+      }
+    }
+  }
+  // below each vector's reach is what's left of the schur form (deflated subdiagonals), clear it
+  for (int i = 1; i < nn; i++) {
+    for (int j = 0; j < i; j++) H(i, j) = 0;
+  }
+}
+
+// Golub-Kahan-Reinsch svd of a tall m x n (m >= n) matrix held transposed (LINPACK dsvdc): householder
+// bidiagonalization, then implicit shift qr on the bidiagonal, chasing the bulge with givens rotations.
+// Every column of A, U & V is a row of at, ut & vtt here, so the householder dots & the rotations
+// run along contiguous memory. ut gets ncu (n or m) left vectors as rows, vtt the n right ones, either
+// can be NULL; returns 0, or the count of singular values left unconverged
+template <typename T> static int svd_tall(int m, int n, T* at, T* s, T* ut, int ncu, T* vtt) {
+  const T eps = std::numeric_limits<T>::epsilon(), tiny = std::numeric_limits<T>::min() / eps;
+  T *e = factor_scratch<T>((size_t)n + m), *work = e + n;
+  auto A = [&](int j) { return at + (size_t)j * m; };
+  auto U = [&](int j) { return ut + (size_t)j * m; };
+  auto V = [&](int j) { return vtt + (size_t)j * n; };
+  int nct = (m - 1 < n) ? m - 1 : n, nrt = (n - 2 < m) ? n - 2 : m;
+  if (nrt < 0) nrt = 0;
+  // bidiagonalize: a column reflector puts s[k] on the diagonal, a row reflector e[k] above it
+  for (int k = 0; k < (nct > nrt ? nct : nrt); k++) {
+    T* ak = A(k);
+    if (k < nct) {
+      T nrm = 0;
+      for (int i = k; i < m; i++) nrm = hypot(nrm, ak[i]);
+      if (nrm != 0) {
+        if (ak[k] < 0) nrm = -nrm;
+        for (int i = k; i < m; i++) ak[i] /= nrm;
+        ak[k] += 1;
+      }
+      s[k] = -nrm;
+    }
+    bool reflect = k < nct && s[k] != 0;
+    parallel_for(n - k - 1, parallel_grain((size_t)(m - k)), [&](size_t lo, size_t hi) {
+      for (size_t jj = lo; jj < hi; jj++) {
+        T* aj = A(k + 1 + (int)jj);
+        if (reflect) {
+          T t = 0;
+          for (int i = k; i < m; i++) t += ak[i] * aj[i];
+          t = -t / ak[k];
+          for (int i = k; i < m; i++) aj[i] += t * ak[i];
+        }
+        e[k + 1 + jj] = aj[k];
+      }
+    });
+    if (ut != NULL && k < nct) { T* uk = U(k); for (int i = k; i < m; i++) uk[i] = ak[i]; }
+    if (k < nrt) {
+      T nrm = 0;
+      for (int i = k + 1; i < n; i++) nrm = hypot(nrm, e[i]);
+      if (nrm != 0) {
+        if (e[k + 1] < 0) nrm = -nrm;
+        for (int i = k + 1; i < n; i++) e[i] /= nrm;
+        e[k + 1] += 1;
+      }
+      e[k] = -nrm;
+      if (k + 1 < m && e[k] != 0) {
+        for (int i = k + 1; i < m; i++) work[i] = 0;
+        for (int j = k + 1; j < n; j++) {
+          const T* aj = A(j);
+          for (int i = k + 1; i < m; i++) work[i] += e[j] * aj[i];
+        }
+        parallel_for(n - k - 1, parallel_grain((size_t)(m - k)), [&](size_t lo, size_t hi) {
+          for (size_t jj = lo; jj < hi; jj++) {
+            int j = k + 1 + (int)jj;
+            T *aj = A(j), t = -e[j] / e[k + 1];
+            for (int i = k + 1; i < m; i++) aj[i] += t * work[i];
+          }
+        });
+      }
+      if (vtt != NULL) { T* vk = V(k); for (int i = k + 1; i < n; i++) vk[i] = e[i]; }
+    }
+  }
+  int p = n;
+  if (nct < n) s[nct] = A(nct)[nct];
+  if (nrt + 1 < p) e[nrt] = A(p - 1)[nrt];
+  e[p - 1] = 0;
+  // accumulate the reflectors backwards into U & V
+  if (ut != NULL) {
+    for (int j = nct; j < ncu; j++) {
+      T* uj = U(j);
+      for (int i = 0; i < m; i++) uj[i] = 0;
+      uj[j] = 1;
+    }
+    for (int k = nct - 1; k >= 0; k--) {
+      T* uk = U(k);
+      if (s[k] != 0) {
+        parallel_for(ncu - k - 1, parallel_grain((size_t)(m - k)), [&](size_t lo, size_t hi) {
+          for (size_t jj = lo; jj < hi; jj++) {
+            T *uj = U(k + 1 + (int)jj), t = 0;
+            for (int i = k; i < m; i++) t += uk[i] * uj[i];
+            t = -t / uk[k];
+            for (int i = k; i < m; i++) uj[i] += t * uk[i];
+          }
+        });
+        for (int i = k; i < m; i++) uk[i] = -uk[i];
+        uk[k] += 1;
+        for (int i = 0; i < k; i++) uk[i] = 0;
+      } else {
+        for (int i = 0; i < m; i++) uk[i] = 0;
+        uk[k] = 1;
+      }
+    }
+  }
+  if (vtt != NULL) {
+    for (int k = n - 1; k >= 0; k--) {
+      T* vk = V(k);
+      if (k < nrt && e[k] != 0) {
+        parallel_for(n - k - 1, parallel_grain((size_t)(n - k)), [&](size_t lo, size_t hi) {
+          for (size_t jj = lo; jj < hi; jj++) {
+            T *vj = V(k + 1 + (int)jj), t = 0;
+            for (int i = k + 1; i < n; i++) t += vk[i] * vj[i];
+            t = -t / vk[k + 1];
+            for (int i = k + 1; i < n; i++) vj[i] += t * vk[i];
+          }
+        });
+      }
+      for (int i = 0; i < n; i++) vk[i] = 0;
+      vk[k] = 1;
+    }
+  }
+  // rows x & y of a vector set turned by (c, s): x = c x + s y, y = c y - s x
+  auto rotate = [](T* x, T* y, int len, T c, T sn) {
+    for (int i = 0; i < len; i++) {
+      T t = c * x[i] + sn * y[i];
+      y[i] = c * y[i] - sn * x[i];
+      x[i] = t;
+    }
+  };
+  int pp = p - 1, steps = 0;
+  while (p > 0) {
+    // find the trailing unreduced block [k, p): kase 1 deflates a zero s[p - 1], 2 splits at a zero
+    // s[k], 3 runs a qr step on it & 4 means s[p - 1] has converged
+    int k, kase;
+    for (k = p - 2; k >= 0; k--) {
+      if (fabs(e[k]) <= tiny + eps * (fabs(s[k]) + fabs(s[k + 1]))) { e[k] = 0; break; }
+    }
+    if (k == p - 2) kase = 4;
+    else {
+      int ks;
+      for (ks = p - 1; ks > k; ks--) {
+        T t = (ks != p ? fabs(e[ks]) : 0) + (ks != k + 1 ? fabs(e[ks - 1]) : 0);
+        if (fabs(s[ks]) <= tiny + eps * t) { s[ks] = 0; break; }
+      }
+      if (ks == k) kase = 3;
+      else if (ks == p - 1) kase = 1;
+      else { kase = 2; k = ks; }
+    }
+    k++;
+    if (kase == 1) {
+      T f = e[p - 2];
+      e[p - 2] = 0;
+      for (int j = p - 2; j >= k; j--) {
+        T t = hypot(s[j], f), cs = s[j] / t, sn = f / t;
+        s[j] = t;
+        if (j != k) { f = -sn * e[j - 1]; e[j - 1] = cs * e[j - 1]; }
+        if (vtt != NULL) rotate(V(j), V(p - 1), n, cs, sn);
+      }
+    } else if (kase == 2) {
+      T f = e[k - 1];
+      e[k - 1] = 0;
+      for (int j = k; j < p; j++) {
+        T t = hypot(s[j], f), cs = s[j] / t, sn = f / t;
+        s[j] = t;
+        f = -sn * e[j]; e[j] = cs * e[j];
+        if (ut != NULL) rotate(U(j), U(k - 1), m, cs, sn);
+      }
+    } else if (kase == 3) {
+      if (steps++ == 75 * n) { pool_free(e); return p; }
+      // shift from the trailing 2 x 2 of B^T B, everything scaled to dodge over/underflow
+      T scale = fmax(fmax(fmax(fmax(fabs(s[p - 1]), fabs(s[p - 2])), fabs(e[p - 2])), fabs(s[k])), fabs(e[k]));
+      T sp = s[p - 1] / scale, spm1 = s[p - 2] / scale, epm1 = e[p - 2] / scale, sk = s[k] / scale, ek = e[k] / scale;
+      T b = ((spm1 + sp) * (spm1 - sp) + epm1 * epm1) / 2, c = (sp * epm1) * (sp * epm1), shift = 0;
+      if (b != 0 || c != 0) {
+        shift = sqrt(b * b + c);
+        if (b < 0) shift = -shift;
+        shift = c / (b + shift);
+      }
+      T f = (sk + sp) * (sk - sp) + shift, g = sk * ek;
+      for (int j = k; j < p - 1; j++) {
+        T t = hypot(f, g), cs = f / t, sn = g / t;
+        if (j != k) e[j - 1] = t;
+        f = cs * s[j] + sn * e[j];
+        e[j] = cs * e[j] - sn * s[j];
+        g = sn * s[j + 1];
+        s[j + 1] = cs * s[j + 1];
+        if (vtt != NULL) rotate(V(j), V(j + 1), n, cs, sn);
+        t = hypot(f, g); cs = f / t; sn = g / t;
+        s[j] = t;
+        f = cs * e[j] + sn * s[j + 1];
+        s[j + 1] = -sn * e[j] + cs * s[j + 1];
+        g = sn * e[j + 1];
+        e[j + 1] = cs * e[j + 1];
+        if (ut != NULL && j < m - 1) rotate(U(j), U(j + 1), m, cs, sn);
+      }
+      e[p - 2] = f;
+    } else {
+      // converged: make s[k] nonnegative & bubble it into descending order
+      if (s[k] <= 0) {
+        s[k] = (s[k] < 0) ? -s[k] : 0;
+        if (vtt != NULL) { T* vk = V(k); for (int i = 0; i <= pp; i++) vk[i] = -vk[i]; }
+      }
+      for (; k < pp && s[k] < s[k + 1]; k++) {
+        T t = s[k]; s[k] = s[k + 1]; s[k + 1] = t;
+        if (vtt != NULL) swap_rows(V(k), V(k + 1), n);
+        if (ut != NULL) swap_rows(U(k), U(k + 1), m);
+      }
+      p--;
+    }
+  }
+  pool_free(e);
+  return 0;
+}
+
+// any m x n a: a tall one is worked on as is (transposed for svd_tall), a wide one through the svd of
+// a^T = V S U^T, with U & V trading places
+template <typename T> static int gesvd_any(int m, int n, const T* a, ptrdiff_t lda, T* s, T* u, ptrdiff_t ldu, int ucols, T* vt, ptrdiff_t ldvt, int vrows) {
+  if (m == 0 || n == 0) return 0;
+  bool tall = m >= n;
+  int mt = tall ? m : n, nt = tall ? n : m, ncu = tall ? ucols : vrows;
+  bool want_left = tall ? u != NULL : vt != NULL, want_right = tall ? vt != NULL : u != NULL;
+  T *at = factor_scratch<T>((size_t)mt * nt), *lt = want_left ? factor_scratch<T>((size_t)ncu * mt) : NULL, *rt = want_right ? factor_scratch<T>((size_t)nt * nt) : NULL;
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      if (tall) at[(size_t)j * m + i] = a[i * lda + j];
+      else at[(size_t)i * n + j] = a[i * lda + j];
+    }
+  }
+  int info = svd_tall(mt, nt, at, s, lt, ncu, rt);
+  // tall: U = lt^T & V^T = rt, wide: U = rt^T & V^T = lt
+  T *ut_rows = tall ? lt : rt, *vt_rows = tall ? rt : lt;
+  int urows = tall ? ucols : m;
+  if (u != NULL) {
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < urows; j++) u[i * ldu + j] = ut_rows[(size_t)j * m + i];
+    }
+  }
+  if (vt != NULL) {
+    for (int i = 0; i < vrows; i++) {
+      for (int j = 0; j < n; j++) vt[i * ldvt + j] = vt_rows[(size_t)i * n + j];
+    }
+  }
+  pool_free(at);
+  if (lt) pool_free(lt);
+  if (rt) pool_free(rt);
+  return info;
+}
+
+int sgetrf(int n, float* a, ptrdiff_t lda, int* piv) { return getrf_blocked(n, a, lda, piv); }
+int dgetrf(int n, double* a, ptrdiff_t lda, int* piv) { return getrf_blocked(n, a, lda, piv); }
+
+void strsm(int lower, int trans, int unit, int n, int nrhs, const float* a, ptrdiff_t lda, float* b, ptrdiff_t ldb) { trsm_blocked(lower, trans, unit, n, nrhs, a, lda, b, ldb); }
+void dtrsm(int lower, int trans, int unit, int n, int nrhs, const double* a, ptrdiff_t lda, double* b, ptrdiff_t ldb) { trsm_blocked(lower, trans, unit, n, nrhs, a, lda, b, ldb); }
+
+void sgetrs(int n, int nrhs, const float* lu, ptrdiff_t lda, const int* piv, float* b, ptrdiff_t ldb) { getrs_blocked(n, nrhs, lu, lda, piv, b, ldb); }
+void dgetrs(int n, int nrhs, const double* lu, ptrdiff_t lda, const int* piv, double* b, ptrdiff_t ldb) { getrs_blocked(n, nrhs, lu, lda, piv, b, ldb); }
+
+int spotrf(int n, float* a, ptrdiff_t lda) { return potrf_blocked(n, a, lda); }
+int dpotrf(int n, double* a, ptrdiff_t lda) { return potrf_blocked(n, a, lda); }
+
+void spotrs(int n, int nrhs, const float* l, ptrdiff_t lda, float* b, ptrdiff_t ldb) { potrs_blocked(n, nrhs, l, lda, b, ldb); }
+void dpotrs(int n, int nrhs, const double* l, ptrdiff_t lda, double* b, ptrdiff_t ldb) { potrs_blocked(n, nrhs, l, lda, b, ldb); }
+
+void sgeqrf(int m, int n, float* a, ptrdiff_t lda, float* tau) { geqrf_blocked(m, n, a, lda, tau); }
+void dgeqrf(int m, int n, double* a, ptrdiff_t lda, double* tau) { geqrf_blocked(m, n, a, lda, tau); }
+
+void sormqr(int trans, int m, int nrhs, int k, const float* qr, ptrdiff_t lda, const float* tau, float* b, ptrdiff_t ldb) { ormqr_blocked(trans, m, nrhs, k, qr, lda, tau, b, ldb); }
+void dormqr(int trans, int m, int nrhs, int k, const double* qr, ptrdiff_t lda, const double* tau, double* b, ptrdiff_t ldb) { ormqr_blocked(trans, m, nrhs, k, qr, lda, tau, b, ldb); }
+
+void sorgqr(int m, int ncols, int k, const float* qr, ptrdiff_t lda, const float* tau, float* q, ptrdiff_t ldq) { orgqr_blocked(m, ncols, k, qr, lda, tau, q, ldq); }
+void dorgqr(int m, int ncols, int k, const double* qr, ptrdiff_t lda, const double* tau, double* q, ptrdiff_t ldq) { orgqr_blocked(m, ncols, k, qr, lda, tau, q, ldq); }
+
+void ssytrd(int n, float* a, ptrdiff_t lda, float* d, float* e, float* tau) { sytrd_unblocked(n, a, lda, d, e, tau); }
+void dsytrd(int n, double* a, ptrdiff_t lda, double* d, double* e, double* tau) { sytrd_unblocked(n, a, lda, d, e, tau); }
+
+int ssteqr(int n, float* d, float* e, float* zt, ptrdiff_t ldz) { return steqr_ql(n, d, e, zt, n, ldz); }
+int dsteqr(int n, double* d, double* e, double* zt, ptrdiff_t ldz) { return steqr_ql(n, d, e, zt, n, ldz); }
+
+void sgehrd(int n, float* a, ptrdiff_t lda, float* tau) { gehrd_unblocked(n, a, lda, tau); }
+void dgehrd(int n, double* a, ptrdiff_t lda, double* tau) { gehrd_unblocked(n, a, lda, tau); }
+
+int shseqr(int n, float* h, ptrdiff_t ldh, float* wr, float* wi, float* zt, ptrdiff_t ldz) { return hseqr_francis(n, h, ldh, wr, wi, zt, ldz); }
+int dhseqr(int n, double* h, ptrdiff_t ldh, double* wr, double* wi, double* zt, ptrdiff_t ldz) { return hseqr_francis(n, h, ldh, wr, wi, zt, ldz); }
+
+void strevc(int n, float* t, ptrdiff_t ldt, const float* wr, const float* wi) { trevc_backsub(n, t, ldt, wr, wi); }
+void dtrevc(int n, double* t, ptrdiff_t ldt, const double* wr, const double* wi) { trevc_backsub(n, t, ldt, wr, wi); }
+
+int sgesvd(int m, int n, const float* a, ptrdiff_t lda, float* s, float* u, ptrdiff_t ldu, int ucols, float* vt, ptrdiff_t ldvt, int vrows) { return gesvd_any(m, n, a, lda, s, u, ldu, ucols, vt, ldvt, vrows); }
+int dgesvd(int m, int n, const double* a, ptrdiff_t lda, double* s, double* u, ptrdiff_t ldu, int ucols, double* vt, ptrdiff_t ldvt, int vrows) { return gesvd_any(m, n, a, lda, s, u, ldu, ucols, vt, ldvt, vrows); }
@@ -0,0 +1,120 @@
+/**
+  @file factor.h
+  @brief blocked dense factorizations & triangular solves behind det, inv, solve, lu, cholesky, qr, lstsq, eig, eigh & svd
+  * right-looking lu with partial pivoting (getrf): an unblocked FACTOR_BLOCK wide panel, its row
+    swaps applied across the whole row, a triangular solve for the block row of U & the trailing
+    submatrix updated through the gemm engine, where nearly all of the O(n^3) work ends up
+  * cholesky (potrf) is the same loop for a symmetric positive definite matrix, without pivots
+  * householder qr (geqrf) keeps its reflectors below the diagonal, a panel's worth of them is
+    applied to the rest of the matrix at once as I - V T V^T (compact WY), two gemms & a small
+    triangular product; Q is only ever applied (ormqr) or built (orgqr) from them, never stored
+  * symmetric eigenproblems reduce the matrix to tridiagonal form with householder reflectors
+    (sytrd) & finish with implicit shift ql (steqr), O(n^2) for the values alone; the vectors are
+    the ql rotations pushed back through the same reflectors with ormqr
+  * general eigenproblems reduce to upper hessenberg form (gehrd), run Francis double shift qr down
+    to the real schur form (hseqr) & back substitute for its eigenvectors (trevc)
+  * the svd (gesvd) bidiagonalizes with householder reflectors & runs implicit shift qr on the
+    bidiagonal, never forming A^T A; U & V are accumulated only when asked for
+  * triangular solves (trsm) go block by block the same way: a small solve on the diagonal block,
+    then one gemm update of everything below (or above) it, a few right-hand sides (FACTOR_NARROW)
+    skip the blocking & read the triangle once in whichever order its layout favours
+  * everything is row-major & in place, a matrix is addressed through its row stride, so the
+    factors of one matrix of a batch are worked on right where they sit
+*/
+
+#ifndef __FACTOR__H__
+#define __FACTOR__H__
+
+#include <stddef.h>
+
+#define FACTOR_BLOCK 64     // panel width of getrf & geqrf, diagonal block of trsm
+#define FACTOR_NARROW 8     // right-hand sides below which trsm runs unblocked
+
+extern "C" {
+  // P A = L U in place for the n x n a: unit L below the diagonal, U on & above it, piv[k] is the row
+  // swapped with row k at step k; returns 0, or k + 1 for the first exactly zero pivot U[k][k]
+  int sgetrf(int n, float* a, ptrdiff_t lda, int* piv);
+  int dgetrf(int n, double* a, ptrdiff_t lda, int* piv);
+  // b[n x nrhs] = A^-1 b (A^-T b with `trans`) for the lower or upper triangle of a, `unit` takes its diagonal as ones
+  void strsm(int lower, int trans, int unit, int n, int nrhs, const float* a, ptrdiff_t lda, float* b, ptrdiff_t ldb);
+  void dtrsm(int lower, int trans, int unit, int n, int nrhs, const double* a, ptrdiff_t lda, double* b, ptrdiff_t ldb);
+  // b[n x nrhs] = A^-1 b from the getrf factors of A
+  void sgetrs(int n, int nrhs, const float* lu, ptrdiff_t lda, const int* piv, float* b, ptrdiff_t ldb);
+  void dgetrs(int n, int nrhs, const double* lu, ptrdiff_t lda, const int* piv, double* b, ptrdiff_t ldb);
+  // A = L L^T in place for the n x n symmetric a: L on & below the diagonal, the upper triangle is left as
+  // scratch; returns 0, or k + 1 when the leading k + 1 x k + 1 minor isn't positive definite
+  int spotrf(int n, float* a, ptrdiff_t lda);
+  int dpotrf(int n, double* a, ptrdiff_t lda);
+  // b[n x nrhs] = A^-1 b from the potrf factor of A
+  void spotrs(int n, int nrhs, const float* l, ptrdiff_t lda, float* b, ptrdiff_t ldb);
+  void dpotrs(int n, int nrhs, const double* l, ptrdiff_t lda, double* b, ptrdiff_t ldb);
+  // A = Q R in place for the m x n a: R on & above the diagonal, the householder vectors below it with
+  // their scalars in tau[min(m, n)]
+  void sgeqrf(int m, int n, float* a, ptrdiff_t lda, float* tau);
+  void dgeqrf(int m, int n, double* a, ptrdiff_t lda, double* tau);
+  // b[m x nrhs] = Q^T b (`trans`) or Q b for the Q of the first k reflectors of geqrf factors
+  void sormqr(int trans, int m, int nrhs, int k, const float* qr, ptrdiff_t lda, const float* tau, float* b, ptrdiff_t ldb);
+  void dormqr(int trans, int m, int nrhs, int k, const double* qr, ptrdiff_t lda, const double* tau, double* b, ptrdiff_t ldb);
+  // q[m x ncols] = the leading ncols columns of that Q, ncols = k is the reduced Q, ncols = m the full one
+  void sorgqr(int m, int ncols, int k, const float* qr, ptrdiff_t lda, const float* tau, float* q, ptrdiff_t ldq);
+  void dorgqr(int m, int ncols, int k, const double* qr, ptrdiff_t lda, const double* tau, double* q, ptrdiff_t ldq);
+  // Q^T A Q = T for the symmetric n x n a (both triangles): T's diagonal in d[n] & off diagonal in e[n - 1],
+  // the reflectors of Q below the subdiagonal with tau[n - 1], a + lda is then geqrf factors of n - 1 columns
+  void ssytrd(int n, float* a, ptrdiff_t lda, float* d, float* e, float* tau);
+  void dsytrd(int n, double* a, ptrdiff_t lda, double* d, double* e, double* tau);
+  // eigenvalues of the tridiagonal (d, e) into d (unordered), e is destroyed; the rotations are applied to
+  // the rows of zt (n x n, NULL for values only), start from I to get the eigenvectors of T as rows
+  // returns 0, or l + 1 when eigenvalue l didn't converge
+  int ssteqr(int n, float* d, float* e, float* zt, ptrdiff_t ldz);
+  int dsteqr(int n, double* d, double* e, double* zt, ptrdiff_t ldz);
+  // Q^T A Q = H upper hessenberg in place for the n x n a, the reflectors of Q below the subdiagonal with
+  // tau[n - 1] as in sytrd
+  void sgehrd(int n, float* a, ptrdiff_t lda, float* tau);
+  void dgehrd(int n, double* a, ptrdiff_t lda, double* tau);
+  // eigenvalues wr + i wi of the hessenberg h (zeros below the subdiagonal), a complex pair as adjacent
+  // conjugates with the positive imaginary part first; with zt (NULL for values only) h becomes the real
+  // schur form T = Z^T H Z & Z^T is applied to zt from the left; returns 0, or k + 1 when k didn't converge
+  int shseqr(int n, float* h, ptrdiff_t ldh, float* wr, float* wi, float* zt, ptrdiff_t ldz);
+  int dhseqr(int n, double* h, ptrdiff_t ldh, double* wr, double* wi, double* zt, ptrdiff_t ldz);
+  // eigenvectors of the real schur form t (from hseqr) in place as its upper triangle, unnormalized: column j
+  // for a real eigenvalue, columns j & j + 1 the real & imaginary part of the vector of wr[j] + i wi[j]
+  void strevc(int n, float* t, ptrdiff_t ldt, const float* wr, const float* wi);
+  void dtrevc(int n, double* t, ptrdiff_t ldt, const double* wr, const double* wi);
+  // A = U S V^T for the m x n a (left untouched): s[min(m, n)] descending & nonnegative, u gets ucols (min(m, n)
+  // or m) left vectors as columns & vt vrows (min(m, n) or n) right ones as rows, NULL skips either;
+  // returns 0, or the count of singular values that didn't converge
+  int sgesvd(int m, int n, const float* a, ptrdiff_t lda, float* s, float* u, ptrdiff_t ldu, int ucols, float* vt, ptrdiff_t ldvt, int vrows);
+  int dgesvd(int m, int n, const double* a, ptrdiff_t lda, double* s, double* u, ptrdiff_t ldu, int ucols, double* vt, ptrdiff_t ldvt, int vrows);
+}
+
+inline int getrf(int n, float* a, ptrdiff_t lda, int* piv) { return sgetrf(n, a, lda, piv); }
+inline int getrf(int n, double* a, ptrdiff_t lda, int* piv) { return dgetrf(n, a, lda, piv); }
+inline void trsm(int lower, int trans, int unit, int n, int nrhs, const float* a, ptrdiff_t lda, float* b, ptrdiff_t ldb) { strsm(lower, trans, unit, n, nrhs, a, lda, b, ldb); }
+inline void trsm(int lower, int trans, int unit, int n, int nrhs, const double* a, ptrdiff_t lda, double* b, ptrdiff_t ldb) { dtrsm(lower, trans, unit, n, nrhs, a, lda, b, ldb); }
+inline void getrs(int n, int nrhs, const float* lu, ptrdiff_t lda, const int* piv, float* b, ptrdiff_t ldb) { sgetrs(n, nrhs, lu, lda, piv, b, ldb); }
+inline void getrs(int n, int nrhs, const double* lu, ptrdiff_t lda, const int* piv, double* b, ptrdiff_t ldb) { dgetrs(n, nrhs, lu, lda, piv, b, ldb); }
+
+inline int potrf(int n, float* a, ptrdiff_t lda) { return spotrf(n, a, lda); }
+inline int potrf(int n, double* a, ptrdiff_t lda) { return dpotrf(n, a, lda); }
+inline void potrs(int n, int nrhs, const float* l, ptrdiff_t lda, float* b, ptrdiff_t ldb) { spotrs(n, nrhs, l, lda, b, ldb); }
+inline void potrs(int n, int nrhs, const double* l, ptrdiff_t lda, double* b, ptrdiff_t ldb) { dpotrs(n, nrhs, l, lda, b, ldb); }
+inline void geqrf(int m, int n, float* a, ptrdiff_t lda, float* tau) { sgeqrf(m, n, a, lda, tau); }
+inline void geqrf(int m, int n, double* a, ptrdiff_t lda, double* tau) { dgeqrf(m, n, a, lda, tau); }
+inline void ormqr(int trans, int m, int nrhs, int k, const float* qr, ptrdiff_t lda, const float* tau, float* b, ptrdiff_t ldb) { sormqr(trans, m, nrhs, k, qr, lda, tau, b, ldb); }
+inline void ormqr(int trans, int m, int nrhs, int k, const double* qr, ptrdiff_t lda, const double* tau, double* b, ptrdiff_t ldb) { dormqr(trans, m, nrhs, k, qr, lda, tau, b, ldb); }
+inline void orgqr(int m, int ncols, int k, const float* qr, ptrdiff_t lda, const float* tau, float* q, ptrdiff_t ldq) { sorgqr(m, ncols, k, qr, lda, tau, q, ldq); }
+inline void orgqr(int m, int ncols, int k, const double* qr, ptrdiff_t lda, const double* tau, double* q, ptrdiff_t ldq) { dorgqr(m, ncols, k, qr, lda, tau, q, ldq); }
+inline void sytrd(int n, float* a, ptrdiff_t lda, float* d, float* e, float* tau) { ssytrd(n, a, lda, d, e, tau); }
+inline void sytrd(int n, double* a, ptrdiff_t lda, double* d, double* e, double* tau) { dsytrd(n, a, lda, d, e, tau); }
+inline int steqr(int n, float* d, float* e, float* zt, ptrdiff_t ldz) { return ssteqr(n, d, e, zt, ldz); }
+inline int steqr(int n, double* d, double* e, double* zt, ptrdiff_t ldz) { return dsteqr(n, d, e, zt, ldz); }
+inline void gehrd(int n, float* a, ptrdiff_t lda, float* tau) { sgehrd(n, a, lda, tau); }
+inline void gehrd(int n, double* a, ptrdiff_t lda, double* tau) { dgehrd(n, a, lda, tau); }
+inline int hseqr(int n, float* h, ptrdiff_t ldh, float* wr, float* wi, float* zt, ptrdiff_t ldz) { return shseqr(n, h, ldh, wr, wi, zt, ldz); }
+inline int hseqr(int n, double* h, ptrdiff_t ldh, double* wr, double* wi, double* zt, ptrdiff_t ldz) { return dhseqr(n, h, ldh, wr, wi, zt, ldz); }
+inline void trevc(int n, float* t, ptrdiff_t ldt, const float* wr, const float* wi) { strevc(n, t, ldt, wr, wi); }
+inline void trevc(int n, double* t, ptrdiff_t ldt, const double* wr, const double* wi) { dtrevc(n, t, ldt, wr, wi); }
+inline int gesvd(int m, int n, const float* a, ptrdiff_t lda, float* s, float* u, ptrdiff_t ldu, int ucols, float* vt, ptrdiff_t ldvt, int vrows) { return sgesvd(m, n, a, lda, s, u, ldu, ucols, vt, ldvt, vrows); }
+inline int gesvd(int m, int n, const double* a, ptrdiff_t lda, double* s, double* u, ptrdiff_t ldu, int ucols, double* vt, ptrdiff_t ldvt, int vrows) { return dgesvd(m, n, a, lda, s, u, ldu, ucols, vt, ldvt, vrows); }
+
+#endif  //!__FACTOR__H__
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gemm.h"
+#include "simd.h"
+#include "parallel.h"
+#include "../core/allocator.h"
+
+#define GEMM_MAX_MR 16
+#define GEMM_MAX_NR 32
+#define GEMM_PARALLEL_MNK (1 << 18)    // m * n * k below which a product stays on the calling thread
+
+// scalar level micro-kernel, same contract as the simd ones
+template <typename T, int MR, int NR> static void gemm_micro_ref(size_t kc, const T* a, const T* b, T* c, size_t ldc, int accumulate) {
+  T acc[MR][NR] = {};
+  for (size_t p = 0; p < kc; p++) {
+    for (int r = 0; r < MR; r++) {
+      for (int j = 0; j < NR; j++) acc[r][j] += a[r] * b[j];
+    }
+    a += MR;
+    b += NR;
+  }
+  for (int r = 0; r < MR; r++) {
+    for (int j = 0; j < NR; j++) c[r * ldc + j] = accumulate ? c[r * ldc + j] + acc[r][j] : acc[r][j];
+  }
+}
+
+static const GemmMicro<float> ref_gemm_f32 = {4, 8, gemm_micro_ref<float, 4, 8>};
+static const GemmMicro<double> ref_gemm_f64 = {4, 8, gemm_micro_ref<double, 4, 8>};
+
+static const GemmMicro<float>& gemm_micro(float) {
+  const SimdKernels* k = simd_kernels();
+  return k ? k->gemm_f32 : ref_gemm_f32;
+}
+
+static const GemmMicro<double>& gemm_micro(double) {
+  const SimdKernels* k = simd_kernels();
+  return k ? k->gemm_f64 : ref_gemm_f64;
+}
+
+// mc x kc block of a (scaled by alpha) into mr tall slivers, k-major inside a sliver, short slivers padded with zeros
+template <typename T> static void pack_a(int mc, int kc, const T* a, ptrdiff_t rs, ptrdiff_t cs, int mr, T alpha, T* buf) {
+  for (int i = 0; i < mc; i += mr) {
+    int rows = (mc - i < mr) ? mc - i : mr;
+    for (int p = 0; p < kc; p++) {
+      const T* src = a + i * rs + p * cs;
+      for (int r = 0; r < rows; r++) *buf++ = alpha * src[r * rs];
+      for (int r = rows; r < mr; r++) *buf++ = 0;
+    }
+  }
+}
+
+// kc x nc panel of b into nr wide slivers, row-major inside a sliver, narrow slivers padded with zeros
+template <typename T> static void pack_b(int kc, int nc, const T* b, ptrdiff_t rs, ptrdiff_t cs, int nr, T* buf) {
+  for (int j = 0; j < nc; j += nr) {
+    int cols = (nc - j < nr) ? nc - j : nr;
+    for (int p = 0; p < kc; p++) {
+      const T* src = b + p * rs + j * cs;
+      if (cs == 1) {
+        memcpy(buf, src, cols * sizeof(T));
+        buf += cols;
+      } else {
+        for (int c = 0; c < cols; c++) *buf++ = src[c * cs];
+      }
+      for (int c = cols; c < nr; c++) *buf++ = 0;
+    }
+  }
+}
+
+// one ic block of a against slivers [s0, s1) of the packed b panel: packs its own copy of the a block,
+// so blocks of the same panel run on different threads without sharing anything but b_pack
+template <typename T> static void gemm_macro(const GemmMicro<T>& micro, int ic, int mc, int kc, int nc, int s0, int s1, const T* a, ptrdiff_t rsa, ptrdiff_t csa, const T* b_pack, T* c, ptrdiff_t ldc, T alpha, int accumulate, T* a_pack) {
+  const int mr = micro.mr, nr = micro.nr;
+  T tile[GEMM_MAX_MR * GEMM_MAX_NR];
+  pack_a(mc, kc, a + ic * rsa, rsa, csa, mr, alpha, a_pack);
+  for (int jr = s0 * nr; jr < nc && jr < s1 * nr; jr += nr) {
+    int cols = (nc - jr < nr) ? nc - jr : nr;
+    for (int ir = 0; ir < mc; ir += mr) {
+      int rows = (mc - ir < mr) ? mc - ir : mr;
+      const T* ap = a_pack + (size_t)ir * kc;
+      const T* bp = b_pack + (size_t)jr * kc;
+      T* cp = c + (ic + ir) * ldc + jr;
+      if (rows == mr && cols == nr) {
+        micro.kernel(kc, ap, bp, cp, ldc, accumulate);
+        continue;
+      }
+      // edge tile: full tile into scratch, only the valid part reaches c
+      micro.kernel(kc, ap, bp, tile, nr, 0);
+      for (int r = 0; r < rows; r++) {
+        for (int j = 0; j < cols; j++) cp[r * ldc + j] = accumulate ? cp[r * ldc + j] + tile[r * nr + j] : tile[r * nr + j];
+      }
+    }
+  }
+}
+
+// c = alpha * a @ b, or c += alpha * a @ b with `update` set
+template <typename T> static void gemm_blocked(int m, int n, int k, T alpha, const T* a, ptrdiff_t rsa, ptrdiff_t csa, const T* b, ptrdiff_t rsb, ptrdiff_t csb, T* c, ptrdiff_t ldc, int update) {
+  if (m <= 0 || n <= 0 || (k <= 0 && update)) return;
+  if (k <= 0) {
+    for (int i = 0; i < m; i++) memset(c + i * ldc, 0, n * sizeof(T));
+    return;
+  }
+  const GemmMicro<T>& micro = gemm_micro(T());
+  const int mr = micro.mr, nr = micro.nr;
+  const int KC = GEMM_KC_BYTES / (int)sizeof(T);
+  int kc_max = k < KC ? k : KC;
+  int mc_max = m < GEMM_MC ? m : GEMM_MC, nc_max = n < GEMM_NC ? n : GEMM_NC;
+  size_t a_pack_size = (size_t)((mc_max + mr - 1) / mr * mr) * kc_max;
+  T* b_pack = (T*)pool_alloc((size_t)((nc_max + nr - 1) / nr * nr) * kc_max * sizeof(T));
+  if (b_pack == NULL) {
+    fprintf(stderr, "Memory allocation failed for gemm packing buffers\n");
+    exit(EXIT_FAILURE);
+  }
+
+  // every (ic block, column slice) of a packed panel is a task, columns are sliced only as far as
+  // it takes to give each thread a couple of tasks when m alone doesn't
+  int threads = ((double)m * n * k >= GEMM_PARALLEL_MNK) ? get_num_threads() : 1;
+  int m_blocks = (m + GEMM_MC - 1) / GEMM_MC;
+
+  for (int jc = 0; jc < n; jc += GEMM_NC) {
+    int nc = (n - jc < GEMM_NC) ? n - jc : GEMM_NC;
+    int slivers = (nc + nr - 1) / nr;
+    int slices = (threads > 1) ? (2 * threads + m_blocks - 1) / m_blocks : 1;
+    if (slices > slivers) slices = slivers;
+    size_t tasks = (size_t)m_blocks * slices;
+    for (int pc = 0; pc < k; pc += KC) {
+      int kc = (k - pc < KC) ? k - pc : KC;
+      int accumulate = update || pc > 0;    // first k block writes c, later ones add onto it
+      pack_b(kc, nc, b + pc * rsb + jc * csb, rsb, csb, nr, b_pack);
+      parallel_for(tasks, threads > 1 ? 1 : tasks, [&](size_t lo, size_t hi) {
+        T* a_pack = (T*)pool_alloc(a_pack_size * sizeof(T));
+        if (a_pack == NULL) {
+          fprintf(stderr, "Memory allocation failed for gemm packing buffers\n");
+          exit(EXIT_FAILURE);
+        }
+        for (size_t t = lo; t < hi; t++) {
+          int ic = (int)(t / slices) * GEMM_MC, slice = (int)(t % slices);
+          int mc = (m - ic < GEMM_MC) ? m - ic : GEMM_MC;
+          int s0 = (int)((size_t)slivers * slice / slices), s1 = (int)((size_t)slivers * (slice + 1) / slices);
+          gemm_macro(micro, ic, mc, kc, nc, s0, s1, a + pc * csa, rsa, csa, b_pack, c + jc, ldc, alpha, accumulate, a_pack);
+        }
+        pool_free(a_pack);
+      });
+    }
+  }
+  pool_free(b_pack);
+}
+
+void sgemm(int m, int n, int k, const float* a, ptrdiff_t rsa, ptrdiff_t csa, const float* b, ptrdiff_t rsb, ptrdiff_t csb, float* c, ptrdiff_t ldc) {
+  gemm_blocked(m, n, k, 1.0f, a, rsa, csa, b, rsb, csb, c, ldc, 0);
+}
+
+void dgemm(int m, int n, int k, const double* a, ptrdiff_t rsa, ptrdiff_t csa, const double* b, ptrdiff_t rsb, ptrdiff_t csb, double* c, ptrdiff_t ldc) {
+  gemm_blocked(m, n, k, 1.0, a, rsa, csa, b, rsb, csb, c, ldc, 0);
+}
+
+void sgemm_update(int m, int n, int k, float alpha, const float* a, ptrdiff_t rsa, ptrdiff_t csa, const float* b, ptrdiff_t rsb, ptrdiff_t csb, float* c, ptrdiff_t ldc) {
+  gemm_blocked(m, n, k, alpha, a, rsa, csa, b, rsb, csb, c, ldc, 1);
+}
+
+void dgemm_update(int m, int n, int k, double alpha, const double* a, ptrdiff_t rsa, ptrdiff_t csa, const double* b, ptrdiff_t rsb, ptrdiff_t csb, double* c, ptrdiff_t ldc) {
+  gemm_blocked(m, n, k, alpha, a, rsa, csa, b, rsb, csb, c, ldc, 1);
+}
+
+// one dot per row of a, the rows split across threads
+template <typename T> static void gemv_rows(int m, int n, const T* a, ptrdiff_t lda, const T* x, T* y) {
+  parallel_for(m, parallel_grain((size_t)n), [&](size_t lo, size_t hi) {
+    const SimdKernels* simd = simd_kernels();
+    for (size_t i = lo; i < hi; i++) y[i] = pairwise_sum(simd, a + i * lda, x, n);
+  });
+}
+
+void sgemv(int m, int n, const float* a, ptrdiff_t lda, const float* x, float* y) { gemv_rows(m, n, a, lda, x, y); }
+void dgemv(int m, int n, const double* a, ptrdiff_t lda, const double* x, double* y) { gemv_rows(m, n, a, lda, x, y); }
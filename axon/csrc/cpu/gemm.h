@@ -0,0 +1,41 @@
+/**
+  @file gemm.h
+  @brief cache-blocked gemm engine behind matmul, batch_matmul & broadcasted_matmul, plus the gemv of the krylov solvers
+  * goto-style loop nest: B is packed into a KC x NC panel of NR wide slivers (stays in L3/L2),
+    A into an MC x KC block of MR tall slivers (stays in L2), and the micro-kernel keeps an MR x NR
+    tile of C in registers while it streams one sliver of each from L1
+  * micro-kernels come from the active cpu/simd.h table (6x8 sse4, 6x16 avx2/fma, 12x32 avx-512
+    for float32, half as wide for float64), a plain 4x8 C++ kernel covers the scalar level
+  * operands are read through row & column strides, so transposed or batched operands are packed
+    straight from where they live without a copy
+*/
+
+#ifndef __GEMM__H__
+#define __GEMM__H__
+
+#include <stddef.h>
+
+#define GEMM_KC_BYTES 1024    // KC * sizeof(T): 256 floats, 128 doubles, one A & B sliver fit L1 together
+#define GEMM_MC 144           // multiple of every MR
+#define GEMM_NC 2048          // multiple of every NR
+
+extern "C" {
+  // c[m x n] = a[m x k] @ b[k x n]; a element (i, p) sits at a[i * rsa + p * csa], same for b, c is dense with row stride ldc
+  void sgemm(int m, int n, int k, const float* a, ptrdiff_t rsa, ptrdiff_t csa, const float* b, ptrdiff_t rsb, ptrdiff_t csb, float* c, ptrdiff_t ldc);
+  void dgemm(int m, int n, int k, const double* a, ptrdiff_t rsa, ptrdiff_t csa, const double* b, ptrdiff_t rsb, ptrdiff_t csb, double* c, ptrdiff_t ldc);
+  // c[m x n] += alpha * a[m x k] @ b[k x n], the trailing updates of the blocked factorizations
+  void sgemm_update(int m, int n, int k, float alpha, const float* a, ptrdiff_t rsa, ptrdiff_t csa, const float* b, ptrdiff_t rsb, ptrdiff_t csb, float* c, ptrdiff_t ldc);
+  void dgemm_update(int m, int n, int k, double alpha, const double* a, ptrdiff_t rsa, ptrdiff_t csa, const double* b, ptrdiff_t rsb, ptrdiff_t csb, double* c, ptrdiff_t ldc);
+  // y[m] = a[m x n] @ x for rows of a lda apart, the matrix-vector products of the krylov solvers
+  void sgemv(int m, int n, const float* a, ptrdiff_t lda, const float* x, float* y);
+  void dgemv(int m, int n, const double* a, ptrdiff_t lda, const double* x, double* y);
+}
+
+inline void gemm(int m, int n, int k, const float* a, ptrdiff_t rsa, ptrdiff_t csa, const float* b, ptrdiff_t rsb, ptrdiff_t csb, float* c, ptrdiff_t ldc) { sgemm(m, n, k, a, rsa, csa, b, rsb, csb, c, ldc); }
+inline void gemm(int m, int n, int k, const double* a, ptrdiff_t rsa, ptrdiff_t csa, const double* b, ptrdiff_t rsb, ptrdiff_t csb, double* c, ptrdiff_t ldc) { dgemm(m, n, k, a, rsa, csa, b, rsb, csb, c, ldc); }
+inline void gemm_update(int m, int n, int k, float alpha, const float* a, ptrdiff_t rsa, ptrdiff_t csa, const float* b, ptrdiff_t rsb, ptrdiff_t csb, float* c, ptrdiff_t ldc) { sgemm_update(m, n, k, alpha, a, rsa, csa, b, rsb, csb, c, ldc); }
+inline void gemm_update(int m, int n, int k, double alpha, const double* a, ptrdiff_t rsa, ptrdiff_t csa, const double* b, ptrdiff_t rsb, ptrdiff_t csb, double* c, ptrdiff_t ldc) { dgemm_update(m, n, k, alpha, a, rsa, csa, b, rsb, csb, c, ldc); }
+inline void gemv(int m, int n, const float* a, ptrdiff_t lda, const float* x, float* y) { sgemv(m, n, a, lda, x, y); }
+inline void gemv(int m, int n, const double* a, ptrdiff_t lda, const double* x, double* y) { dgemv(m, n, a, lda, x, y); }
+
+#endif  //!__GEMM__H__
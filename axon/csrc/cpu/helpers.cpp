@@ -31,6 +31,14 @@ void fill_randn(float* out, size_t size) {
   rng_randn(&global_rng, out, size);
 }
 
+void fill_randn_seeded(float* out, size_t size, int64_t seed) {
+  if (seed < 0) { fill_randn(out, size); return; }
+  // a private stream, so the global one (& whatever else draws from it) is left alone
+  RNG rng;
+  rng_state(&rng, (uint64_t)seed);
+  rng_randn(&rng, out, size);
+}
+
 void fill_uniform(float* out, float low, float high, size_t size) {
   if (!out || high <= low) return;
   ensure_rng_initialized();
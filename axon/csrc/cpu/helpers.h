@@ -19,6 +19,7 @@ extern "C" {
 
   // random array generation functions
   void fill_randn(float* out, size_t size);
+  void fill_randn_seeded(float* out, size_t size, int64_t seed);   // own stream from `seed`, the global one when seed < 0
   void fill_uniform(float* out, float low, float high, size_t size);
   void fill_randint(float* out, int low, int high, size_t size);
 
@@ -1,90 +1,134 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <stddef.h>
 #include <math.h>
 #include "ops_array.h"
-#include "ops_shape.h"
+#include "gemm.h"
+#include "parallel.h"
+#include "simd.h"
+#include "ops_redux.h"
+#include "../core/allocator.h"
+#include "../core/dispatch.h"
 
-// Optimized matrix multiplication using transposed second matrix
-// A: shape_a[0] x shape_a[1], B^T: shape_b[1] x shape_b[0], C: shape_a[0] x shape_b[0]
-// This computes C = A @ B where B is provided in transposed form
-void matmul_array_ops(float* a, float* b, float* out, int* shape_a, int* shape_b) {
-  int rows_a = shape_a[0];    // rows in 'a'
-  int cols_a = shape_a[1];    // cols in 'a' 
-  int rows_b = shape_b[0];    // rows in 'b' (original 'b' before transpose)
-  int cols_b = shape_b[1];    // cols in 'b' (original 'b' before transpose)
-  float* b_transposed = (float*)malloc(rows_b * cols_b * sizeof(float));
-  if (b_transposed == NULL) {
-    fprintf(stderr, "Memory allocation failed for transpose buffer\n");
-    exit(EXIT_FAILURE);
-  }
-  transpose_2d_array_ops(b, b_transposed, shape_b);
-  // for a @ b^T: a(rows_a × cols_a) @ b^T(cols_b × rows_b) = out(rows_a × rows_b)
-  // we need cols_a == cols_b for this to work
-  for (int i = 0; i < rows_a; i++) {
-    for (int j = 0; j < cols_b; j++) {
-      float sum = 0.0f;
-      // dot product between row i of A and row j of B^T (which is column j of original B)
-      for (int k = 0; k < cols_a; k++) { sum += a[i * cols_a + k] * b_transposed[j * cols_a + k]; }
-      out[i * cols_b + j] = sum;
-    }
+// c[m x n] = a[m x k] @ b[k x n], a (i, p) at a[i * rsa + p * csa] & b likewise, c dense row-major
+// float32/float64 run on the blocked gemm engine; integers accumulate a whole output row in
+// accum_type (64 bits) while streaming rows of b, then round/saturate it back into T
+// both split their rows over the thread pool once the product is big enough
+template <typename T> static void matmul_kernel(const T* a, ptrdiff_t rsa, ptrdiff_t csa, const T* b, ptrdiff_t rsb, ptrdiff_t csb, T* out, int m, int n, int k) {
+  if constexpr (std::is_floating_point<T>::value) {
+    gemm(m, n, k, a, rsa, csa, b, rsb, csb, out, n);
+  } else {
+    typedef typename accum_type<T>::type A;
+    parallel_for(m, parallel_grain((size_t)n * k), [&](size_t lo, size_t hi) {
+      A* row = (A*)pool_alloc((n > 0 ? n : 1) * sizeof(A));
+      if (row == NULL) {
+        fprintf(stderr, "Memory allocation failed for matmul row buffer\n");
+        exit(EXIT_FAILURE);
+      }
+      for (size_t i = lo; i < hi; i++) {
+        for (int j = 0; j < n; j++) row[j] = 0;
+        for (int p = 0; p < k; p++) {
+          A x = (A)a[(ptrdiff_t)i * rsa + p * csa];
+          const T* b_row = b + p * rsb;
+          for (int j = 0; j < n; j++) row[j] += x * (A)b_row[j * csb];
+        }
+        for (int j = 0; j < n; j++) out[i * n + j] = convert_value<T>(row[j]);
+      }
+      pool_free(row);
+    });
   }
-  free(b_transposed);
+}
+
+// batches of products go to the pool when there are enough of them to keep every thread busy,
+// otherwise they run one after another & each product is split inside matmul_kernel
+static inline size_t batch_grain(size_t batches, size_t work) {
+  return batches >= (size_t)get_num_threads() ? parallel_grain(work) : batches;
 }
 
 // batch matrix multiplication: batched A @ batched B
-// A: shape1[0] x shape1[1] x shape1[2], B: shape2[0] x shape2[1] x shape2[2]
+// A: shape1[0] x shape1[1] x shape1[2], B: shape2[0] x shape2[1] x shape2[2], read through their element strides
 // output: shape1[0] x shape1[1] x shape2[2] (assuming shape1[0] == shape2[0])
-void batch_matmul_array_ops(float* a, float* b, float* out, int* shape1, int* shape2, int* strides1, int* strides2) {
-  int batch_size = shape1[0], out_stride = shape1[1] * shape2[2];
-
-  for (int batch = 0; batch < batch_size; batch++) {
-    for (int i = 0; i < shape1[1]; i++) {
-      for (int j = 0; j < shape2[2]; j++) {
-        float sum = 0.0f;
-        for (int k = 0; k < shape1[2]; k++) {
-          float a_val = a[batch * strides1[0] + i * shape1[2] + k], b_val = b[batch * strides2[0] + k * shape2[2] + j];
-          sum += a_val * b_val;
-        } out[batch * out_stride + i * shape2[2] + j] = sum;
-      }
+template <typename T> static void batch_matmul_kernel(const T* a, const T* b, T* out, int* shape1, int* shape2, int* strides1, int* strides2) {
+  int m = shape1[1], k = shape1[2], n = shape2[2];
+  size_t out_stride = (size_t)m * n;
+  parallel_for(shape1[0], batch_grain(shape1[0], out_stride * k), [&](size_t lo, size_t hi) {
+    for (size_t batch = lo; batch < hi; batch++) {
+      matmul_kernel(a + (ptrdiff_t)batch * strides1[0], strides1[1], strides1[2], b + (ptrdiff_t)batch * strides2[0], strides2[1], strides2[2], out + batch * out_stride, m, n, k);
     }
-  }
+  });
 }
 
 // broadcasted matrix multiplication: single A * batched B
-// A: shape1[0] x shape1[1], B: shape2[0] x shape2[1] x shape2[2]
+// A: shape1[0] x shape1[1], B: shape2[0] x shape2[1] x shape2[2], read through their element strides
 // output: shape2[0] x shape1[0] x shape2[2]
-void broadcasted_matmul_array_ops(float* a, float* b, float* out, int* shape1, int* shape2, int* strides1, int* strides2) {
-  int out_stride = shape1[0] * shape2[2];
+template <typename T> static void broadcasted_matmul_kernel(const T* a, const T* b, T* out, int* shape1, int* shape2, int* strides1, int* strides2) {
+  int m = shape1[0], k = shape1[1], n = shape2[2];
+  size_t out_stride = (size_t)m * n;
+  parallel_for(shape2[0], batch_grain(shape2[0], out_stride * k), [&](size_t lo, size_t hi) {
+    for (size_t batch = lo; batch < hi; batch++) {
+      matmul_kernel(a, strides1[0], strides1[1], b + (ptrdiff_t)batch * strides2[0], strides2[1], strides2[2], out + batch * out_stride, m, n, k);
+    }
+  });
+}
 
-  for (int batch = 0; batch < shape2[0]; batch++) {
-    for (int i = 0; i < shape1[0]; i++) {
-      for (int j = 0; j < shape2[2]; j++) {
-        float sum = 0.0f;
-        for (int k = 0; k < shape1[1]; k++) {
-          // A is broadcasted across batches, B is batched
-          float a_val = a[i * shape1[1] + k], b_val = b[batch * strides2[0] + k * shape2[2] + j];
-          sum += a_val * b_val;
-        } out[batch * out_stride + i * shape2[2] + j] = sum; }
+// batch dot product of multiple pairs of 1D vectors, a single dot is a batch of one
+// a: batch_count x vector_size, dense rows stride_a apart, b: the same with stride_b
+// out: batch_count (output array of dot products)
+// floats add their products like float sums do (get_sum_mode(): pairwise or compensated)
+template <typename T> static void batch_dot_kernel(const T* a, const T* b, T* out, size_t batch_count, size_t vector_size, ptrdiff_t stride_a, ptrdiff_t stride_b) {
+  typedef typename accum_type<T>::type A;
+  const SimdKernels* k = simd_kernels();
+  const bool kahan = get_sum_mode() == SUM_KAHAN;
+  parallel_for(batch_count, parallel_grain(vector_size), [&](size_t lo, size_t hi) {
+    for (size_t batch = lo; batch < hi; batch++) {
+      const T* x = a + (ptrdiff_t)batch * stride_a;
+      const T* y = b + (ptrdiff_t)batch * stride_b;
+      if constexpr (std::is_floating_point<T>::value) {
+        T sum = 0, comp = 0;
+        if (kahan) { compensated_sum(k, x, y, vector_size, &sum, &comp); out[batch] = sum + comp; }
+        else { out[batch] = pairwise_sum(k, x, y, vector_size); }
+      } else {
+        A sum = 0;
+        for (size_t i = 0; i < vector_size; i++) { sum += (A)x[i] * (A)y[i]; }
+        out[batch] = convert_value<T>(sum);
+      }
     }
-  }
+  });
+}
+
+void matmul_array_ops(void* a, void* b, void* out, int* shape_a, int* shape_b, int* strides_a, int* strides_b, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    matmul_kernel((const T*)a, strides_a[0], strides_a[1], (const T*)b, strides_b[0], strides_b[1], (T*)out, shape_a[0], shape_b[1], shape_a[1]);
+  });
+}
+
+void batch_matmul_array_ops(void* a, void* b, void* out, int* shape1, int* shape2, int* strides1, int* strides2, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batch_matmul_kernel((const T*)a, (const T*)b, (T*)out, shape1, shape2, strides1, strides2);
+  });
+}
+
+void broadcasted_matmul_array_ops(void* a, void* b, void* out, int* shape1, int* shape2, int* strides1, int* strides2, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    broadcasted_matmul_kernel((const T*)a, (const T*)b, (T*)out, shape1, shape2, strides1, strides2);
+  });
 }
 
 // Dot product of two 1D vectors
 // computes sum(a[i] * b[i]) for i = 0 to size-1
-void dot_array_ops(float* a, float* b, float* out, size_t size) {
-  float sum = 0.0f;
-  for (size_t i = 0; i < size; i++) { sum += a[i] * b[i]; }
-  *out = sum;
+void dot_array_ops(void* a, void* b, void* out, size_t size, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batch_dot_kernel((const T*)a, (const T*)b, (T*)out, 1, size, 0, 0);
+  });
 }
 
-// batch dot product of multiple pairs of 1D vectors
-// a: batch_count x vector_size (flattened), b: batch_count x vector_size (flattened)
-// out: batch_count (output array of dot products)
-void batch_dot_array_ops(float* a, float* b, float* out, size_t batch_count, size_t vector_size) {
-  for (size_t batch = 0; batch < batch_count; batch++) {
-    float sum = 0.0f;
-    size_t batch_offset = batch * vector_size;
-    for (size_t i = 0; i < vector_size; i++) { sum += a[batch_offset + i] * b[batch_offset + i]; }
-    out[batch] = sum;
-  }
-}
\ No newline at end of file
+void batch_dot_array_ops(void* a, void* b, void* out, size_t batch_count, size_t vector_size, int stride_a, int stride_b, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batch_dot_kernel((const T*)a, (const T*)b, (T*)out, batch_count, vector_size, stride_a, stride_b);
+  });
+}
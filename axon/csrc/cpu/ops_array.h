@@ -2,13 +2,18 @@
 #define __OPS_ARRAY__H__
 
 #include <stddef.h>
+#include "../core/dtype.h"
 
+// all operands & the output share `dtype`, integer products accumulate in 64 bits
+// float dot products add up like float sums, see the sum modes of ops_redux.h
+// matmul operands are read through their element strides (strides1/strides2), batch dots through the
+// row strides of dense rows, so views need no copy
 extern "C" {
-  void matmul_array_ops(float* a, float* b, float* out, int* shape1, int* shape2);
-  void batch_matmul_array_ops(float* a, float* b, float* out, int* shape1, int* shape2, int* strides1, int* strides2);
-  void broadcasted_matmul_array_ops(float* a, float* b, float* out, int* shape1, int* shape2, int* strides1, int* strides2);
-  void dot_array_ops(float* a, float* b, float* out, size_t size);
-  void batch_dot_array_ops(float* a, float* b, float* out, size_t batch_count, size_t vector_size);
+  void matmul_array_ops(void* a, void* b, void* out, int* shape1, int* shape2, int* strides1, int* strides2, dtype_t dtype);
+  void batch_matmul_array_ops(void* a, void* b, void* out, int* shape1, int* shape2, int* strides1, int* strides2, dtype_t dtype);
+  void broadcasted_matmul_array_ops(void* a, void* b, void* out, int* shape1, int* shape2, int* strides1, int* strides2, dtype_t dtype);
+  void dot_array_ops(void* a, void* b, void* out, size_t size, dtype_t dtype);
+  void batch_dot_array_ops(void* a, void* b, void* out, size_t batch_count, size_t vector_size, int stride_a, int stride_b, dtype_t dtype);
 }
 
 #endif  //!__BINARY_OPS__H__
\ No newline at end of file
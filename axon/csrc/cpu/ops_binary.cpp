@@ -2,74 +2,108 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <math.h>
+#include <limits>
 #include "ops_binary.h"
-#include "ops_shape.h"
+#include "../core/dispatch.h"
+#include "../core/iterator.h"
+#include "simd.h"
+#include "parallel.h"
 
-void add_ops(float* a, float* b, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = a[i] + b[i]; } }
-void add_scalar_ops(float* a, float b, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = a[i] + b; } }
-void sub_ops(float* a, float* b, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = a[i] - b[i]; } }
-void sub_scalar_ops(float* a, float b, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = a[i] - b; } }
-void mul_ops(float* a, float* b, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = a[i] * b[i]; } }
-void mul_scalar_ops(float* a, float b, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = a[i] * b; } }
-void div_ops(float* a, float* b, float* out, size_t size) {
-  for (size_t i = 0; i < size; i++) {
-    if (b[i] == 0.0f) {
-      if (a[i] > 0.0f) { out[i] = INFINITY; }
-      else if (a[i] < 0.0f) { out[i] = -INFINITY; }
-      else { out[i] = NAN; } // 0/0 case
-    } else { out[i] = a[i] / b[i]; }
-  }
+// integer division goes through double & rounds like the rest of the int conversions
+// x/0 follows IEEE for floats: +inf, -inf or nan (0/0), saturated for integers
+template <typename T> static inline T div_value(T x, T y) {
+  if constexpr (std::is_floating_point<T>::value) { return x / y; }
+  else { return convert_value<T>((double)x / (double)y); }
 }
 
-void div_scalar_ops(float* a, float b, float* out, size_t size) {
-  if (b == 0.0f) {
-    for (size_t i = 0; i < size; i++) {
-      if (a[i] > 0.0f) { out[i] = INFINITY; }
-      else if (a[i] < 0.0f) { out[i] = -INFINITY; }
-      else { out[i] = NAN; } // 0/0 case
-    } } else { for (size_t i = 0; i < size; i++) { out[i] = a[i] / b; }
+// integer add/sub/mul saturate at the limits of the dtype, on arrays & against scalars alike (the scalar
+// path gets there through convert_value); checked builtins, since a plain signed overflow is undefined
+// behaviour; bool keeps its logical or/xor/and
+template <typename T> static inline T add_value(T x, T y) {
+  if constexpr (std::is_floating_point<T>::value || std::is_same<T, bool>::value) { return (T)(x + y); }
+  else {
+    T r;
+    if (!__builtin_add_overflow(x, y, &r)) return r;
+    return (y > 0) ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
   }
 }
 
-void pow_array_ops(float* a, float exp, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = powf(a[i], exp); } }
-void pow_scalar_ops(float a, float* exp, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = powf(a, exp[i]); } }
-
-void add_broadcasted_array_ops(float* a, float* b, float* out, int* broadcasted_shape, int broadcasted_size, int a_ndim, int b_ndim, int* a_shape, int* b_shape) {
-  int max_ndim = a_ndim > b_ndim ? a_ndim : b_ndim;
-  for (int i = 0; i < broadcasted_size; i++) {
-    int index_a, index_b;
-    compute_broadcast_indices(i, broadcasted_shape, max_ndim, a_ndim, b_ndim, a_shape, b_shape, &index_a, &index_b);
-    out[i] = a[index_a] + b[index_b];
+template <typename T> static inline T sub_value(T x, T y) {
+  if constexpr (std::is_floating_point<T>::value || std::is_same<T, bool>::value) { return (T)(x - y); }
+  else {
+    T r;
+    if (!__builtin_sub_overflow(x, y, &r)) return r;
+    return (y < 0) ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
   }
 }
 
-void sub_broadcasted_array_ops(float* a, float* b, float* out, int* broadcasted_shape, int broadcasted_size, int a_ndim, int b_ndim, int* a_shape, int* b_shape) {
-  int max_ndim = a_ndim > b_ndim ? a_ndim : b_ndim;
-  for (int i = 0; i < broadcasted_size; i++) {
-    int index_a, index_b;
-    compute_broadcast_indices(i, broadcasted_shape, max_ndim, a_ndim, b_ndim, a_shape, b_shape, &index_a, &index_b);
-    out[i] = a[index_a] - b[index_b];
+template <typename T> static inline T mul_value(T x, T y) {
+  if constexpr (std::is_floating_point<T>::value || std::is_same<T, bool>::value) { return (T)(x * y); }
+  else {
+    T r;
+    if (!__builtin_mul_overflow(x, y, &r)) return r;
+    return ((x < 0) != (y < 0)) ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
   }
 }
 
-void mul_broadcasted_array_ops(float* a, float* b, float* out, int* broadcasted_shape, int broadcasted_size, int a_ndim, int b_ndim, int* a_shape, int* b_shape) {
-  int max_ndim = a_ndim > b_ndim ? a_ndim : b_ndim;  // Fixed: was using min instead of max
-  for (int i = 0; i < broadcasted_size; i++) {
-    int index_a, index_b;
-    compute_broadcast_indices(i, broadcasted_shape, max_ndim, a_ndim, b_ndim, a_shape, b_shape, &index_a, &index_b);
-    out[i] = a[index_a] * b[index_b];
-  }
+// operands: a, b & out in `dtype`, shared by the same-shape & broadcasted ops (which only differ in strides)
+// float32/float64 inner loops go to the vector kernels when the layout allows, `simd_op` is their simd_arith_t
+// large arrays are split into slices across the thread pool, every slice walks its own iterator
+template <typename Op> static void binary_kernel(NdIter* it, dtype_t dtype, int simd_op, Op op) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    parallel_iter(it, PARALLEL_GRAIN, [&](NdIter* it) {
+      do {
+        if (simd_binary_loop<T, T>(it, simd_op)) continue;
+        iter_binary_loop<T, T>(it, [&](T x, T y) { return (T)op(x, y); });
+      } while (iter_next(it));
+    });
+  });
 }
 
-void div_broadcasted_array_ops(float* a, float* b, float* out, int* broadcasted_shape, int broadcasted_size, int a_ndim, int b_ndim, int* a_shape, int* b_shape) {
-  int max_ndim = a_ndim > b_ndim ? a_ndim : b_ndim;
-  for (int i = 0; i < broadcasted_size; i++) {
-    int index_a, index_b;
-    compute_broadcast_indices(i, broadcasted_shape, max_ndim, a_ndim, b_ndim, a_shape, b_shape, &index_a, &index_b);
-    if (b[index_b] == 0.0f) {
-      if (a[index_a] > 0.0f) { out[i] = INFINITY; }
-      else if (a[index_a] < 0.0f) { out[i] = -INFINITY; }
-      else { out[i] = NAN; }  // 0/0 case
-    } else { out[i] = a[index_a] / b[index_b]; }
-  }
-}
\ No newline at end of file
+// scalar is a float, so math happens in compute_type<T> & is rounded/saturated back into T
+// operands: a & out in `dtype`
+template <typename Op> static void scalar_kernel(NdIter* it, float b, dtype_t dtype, int simd_op, Op op) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    typedef typename compute_type<T>::type C;
+    C y = (C)b;
+    parallel_iter(it, PARALLEL_GRAIN, [&](NdIter* it) {
+      do {
+        if (simd_scalar_loop<T, T>(it, simd_op, (T)y)) continue;
+        iter_unary_loop<T, T>(it, [&](T x) { return convert_value<T>(op((C)x, y)); });
+      } while (iter_next(it));
+    });
+  });
+}
+
+void add_ops(NdIter* it, dtype_t dtype) { binary_kernel(it, dtype, SIMD_ADD, [](auto x, auto y) { return add_value(x, y); }); }
+void add_scalar_ops(NdIter* it, float b, dtype_t dtype) { scalar_kernel(it, b, dtype, SIMD_ADD, [](auto x, auto y) { return add_value(x, y); }); }
+void sub_ops(NdIter* it, dtype_t dtype) { binary_kernel(it, dtype, SIMD_SUB, [](auto x, auto y) { return sub_value(x, y); }); }
+void sub_scalar_ops(NdIter* it, float b, dtype_t dtype) { scalar_kernel(it, b, dtype, SIMD_SUB, [](auto x, auto y) { return sub_value(x, y); }); }
+void mul_ops(NdIter* it, dtype_t dtype) { binary_kernel(it, dtype, SIMD_MUL, [](auto x, auto y) { return mul_value(x, y); }); }
+void mul_scalar_ops(NdIter* it, float b, dtype_t dtype) { scalar_kernel(it, b, dtype, SIMD_MUL, [](auto x, auto y) { return mul_value(x, y); }); }
+void div_ops(NdIter* it, dtype_t dtype) { binary_kernel(it, dtype, SIMD_DIV, [](auto x, auto y) { return div_value(x, y); }); }
+void div_scalar_ops(NdIter* it, float b, dtype_t dtype) { scalar_kernel(it, b, dtype, SIMD_DIV, [](auto x, auto y) { return x / y; }); }
+
+// operands: a in `dtype` & out in float_type
+void pow_array_ops(NdIter* it, float exp, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    typedef typename float_type<T>::type R;
+    parallel_iter(it, PARALLEL_GRAIN_MATH, [&](NdIter* it) {
+      do { iter_unary_loop<T, R>(it, [&](T x) { return (R)pow((R)x, (R)exp); }); } while (iter_next(it));
+    });
+  });
+}
+
+// operands: exp in `dtype` & out in float_type
+void pow_scalar_ops(float a, NdIter* it, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    typedef typename float_type<T>::type R;
+    parallel_iter(it, PARALLEL_GRAIN_MATH, [&](NdIter* it) {
+      do { iter_unary_loop<T, R>(it, [&](T e) { return (R)pow((R)a, (R)e); }); } while (iter_next(it));
+    });
+  });
+}
@@ -2,23 +2,25 @@
 #define __OPS_BINARY__H__
 
 #include <stddef.h>
+#include "../core/dtype.h"
+#include "../core/iterator.h"
 
+// kernels run natively on buffers that are all in `dtype`, callers promote operands beforehand
+// ops walk strided operands through an NdIter (a, b, out / a, out), broadcasting is set up by iter_init_broadcast
+// pow ops write float32 for integer dtypes, same precision for float dtypes
+// integer add/sub/mul/div saturate at the limits of the dtype, for array & scalar operands alike
 extern "C" {
-  void add_ops(float* a, float* b, float* out, size_t size);
-  void add_scalar_ops(float* a, float b, float* out, size_t size);
-  void sub_ops(float* a, float* b, float* out, size_t size);
-  void sub_scalar_ops(float* a, float b, float* out, size_t size);
-  void mul_ops(float* a, float* b, float* out, size_t size);
-  void mul_scalar_ops(float* a, float b, float* out, size_t size);
-  void div_ops(float* a, float* b, float* out, size_t size);
-  void div_scalar_ops(float* a, float b, float* out, size_t size);
-  void pow_array_ops(float* a, float exp, float* out, size_t size);
-  void pow_scalar_ops(float a, float* exp, float* out, size_t size);
+  void add_ops(NdIter* it, dtype_t dtype);
+  void add_scalar_ops(NdIter* it, float b, dtype_t dtype);
+  void sub_ops(NdIter* it, dtype_t dtype);
+  void sub_scalar_ops(NdIter* it, float b, dtype_t dtype);
+  void mul_ops(NdIter* it, dtype_t dtype);
+  void mul_scalar_ops(NdIter* it, float b, dtype_t dtype);
+  void div_ops(NdIter* it, dtype_t dtype);
+  void div_scalar_ops(NdIter* it, float b, dtype_t dtype);
+  void pow_array_ops(NdIter* it, float exp, dtype_t dtype);
+  void pow_scalar_ops(float a, NdIter* it, dtype_t dtype);
 
-  void add_broadcasted_array_ops(float* a, float* b, float* out, int* broadcasted_shape, int broadcasted_size, int a_ndim, int b_ndim, int* a_shape, int* b_shape); 
-  void sub_broadcasted_array_ops(float* a, float* b, float* out, int* broadcasted_shape, int broadcasted_size, int a_ndim, int b_ndim, int* a_shape, int* b_shape); 
-  void mul_broadcasted_array_ops(float* a, float* b, float* out, int* broadcasted_shape, int broadcasted_size, int a_ndim, int b_ndim, int* a_shape, int* b_shape); 
-  void div_broadcasted_array_ops(float* a, float* b, float* out, int* broadcasted_shape, int broadcasted_size, int a_ndim, int b_ndim, int* a_shape, int* b_shape); 
 }
 
-#endif  //!__OPS_BINARY__H__
\ No newline at end of file
+#endif  //!__OPS_BINARY__H__
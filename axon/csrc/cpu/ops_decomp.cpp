@@ -3,179 +3,95 @@
 #include <math.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits>
 #include "ops_decomp.h"
 #include "ops_array.h"
 #include "ops_shape.h"
-
-static void compute_svd(float* a, float* u, float* s, float* vt, int m, int n) {
-  int min_mn = (m < n) ? m : n;
-  float *aat = (float*)malloc(m * m * sizeof(float)), *ata = (float*)malloc(n * n * sizeof(float)), *temp_u = (float*)malloc(m * m * sizeof(float)), *temp_v = (float*)malloc(n * n * sizeof(float));
-  for (int i = 0; i < m; ++i) {
-    for (int j = 0; j < m; ++j) {
-      aat[i * m + j] = 0.0f;
-      for (int k = 0; k < n; ++k) aat[i * m + j] += a[i * n + k] * a[j * n + k];
-    }
-  }
-
-  for (int i = 0; i < n; ++i) {
-    for (int j = 0; j < n; ++j) {
-      ata[i * n + j] = 0.0f;
-      for (int k = 0; k < m; ++k) ata[i * n + j] += a[k * n + i] * a[k * n + j];
-    }
-  }
-  float *eigenvals_u = (float*)malloc(m * sizeof(float)), *eigenvals_v = (float*)malloc(n * sizeof(float));
-  eigenvecs_h_ops_array(aat, temp_u, m);
-  eigenvals_h_ops_array(aat, eigenvals_u, m);
-  eigenvecs_h_ops_array(ata, temp_v, n);
-  eigenvals_h_ops_array(ata, eigenvals_v, n);
-  for (int i = 0; i < n; ++i) {
-    for (int j = 0; j < n; ++j) vt[i * n + j] = temp_v[j * n + i];
-  }
-
-  for (int i = 0; i < min_mn; ++i) {
-    float val = (i < n) ? eigenvals_v[n - 1 - i] : 0.0f;
-    s[i] = (val > 1e-12f) ? sqrtf(val) : 0.0f;
-  }
-
-  for (int i = 0; i < m; ++i) {
-    for (int j = 0; j < m; ++j) u[i * m + j] = temp_u[i * m + (m - 1 - j)];
-  }
-  
-  for (int i = 0; i < min_mn - 1; ++i) {
-    for (int j = i + 1; j < min_mn; ++j) {
-      if (s[i] < s[j]) {
-        float temp_s = s[i]; s[i] = s[j]; s[j] = temp_s;
-        for (int k = 0; k < m; ++k) {
-          float temp_u_val = u[k * m + i]; u[k * m + i] = u[k * m + j]; u[k * m + j] = temp_u_val;
-        }
-        for (int k = 0; k < n; ++k) {
-          float temp_v_val = vt[i * n + k]; vt[i * n + k] = vt[j * n + k]; vt[j * n + k] = temp_v_val;
-        }
-      }
-    }
-  }
-
-  for (int j = 0; j < min_mn; ++j) {
-    if (u[0 * m + j] > 0.0f) {
-      for (int i = 0; i < m; ++i) u[i * m + j] *= -1.0f;
-    }
+#include "../core/dispatch.h"
+#include "factor.h"
+#include "gemm.h"
+#include "helpers.h"
+#include "parallel.h"
+#include "simd.h"
+
+#define SVD_TOPK_OVERSAMPLE 10      // random directions the range finder samples beyond k
+#define LANCZOS_MAX_RESTARTS 1000
+
+// u (m x m, or m x k with k = min(m, n) when not `full`) & vt (n x n, or k x n) can be NULL for values only
+template <typename T> static void compute_svd(T* a, T* u, T* s, T* vt, int m, int n, int full) {
+  int k = (m < n) ? m : n;
+  int info = gesvd(m, n, a, n, s, u, full ? m : k, full ? m : k, vt, n, full ? n : k);
+  if (info) {
+    fprintf(stderr, "svd failed to converge, %d singular values left\n", info);
+    exit(EXIT_FAILURE);
   }
-  free(aat); free(ata); free(temp_u); free(temp_v); free(eigenvals_u); free(eigenvals_v);
 }
 
-static void compute_eigenvecs_h(float* a, float* eigenvecs, size_t size) {
-  float *temp;
-  size_t i, j, k, iter, mat_size = size * size;
-  temp = (float*)malloc(mat_size * sizeof(float));
-  if (!temp) { 
-    for (i = 0; i < mat_size; ++i) eigenvecs[i] = 0.0f; 
-    return; 
+// symmetric eigenproblem: householder tridiagonalization, then implicit shift ql; w gets the
+// eigenvalues ascending & z (NULL for values only) the matching eigenvectors as columns, each with
+// a nonnegative first component
+template <typename T> static void compute_eigh(const T* a, T* w, T* z, int n) {
+  if (n <= 0) return;
+  size_t mat_size = (size_t)n * n;
+  T* work = (T*)malloc((mat_size * (z ? 2 : 1) + 2 * (size_t)n) * sizeof(T));
+  if (work == NULL) {
+    fprintf(stderr, "Memory allocation failed for eigh workspace\n");
+    exit(EXIT_FAILURE);
   }
-  for (i = 0; i < mat_size; ++i) {
-    temp[i] = a[i];
-    eigenvecs[i] = 0.0f;
+  T *t = work, *e = work + mat_size, *tau = e + n, *zt = z ? tau + n : NULL;
+  memcpy(t, a, mat_size * sizeof(T));
+  sytrd(n, t, n, w, e, tau);
+  if (zt) {
+    memset(zt, 0, mat_size * sizeof(T));
+    for (int i = 0; i < n; i++) zt[(size_t)i * n + i] = 1;
   }
-  for (i = 0; i < size; ++i) eigenvecs[i * size + i] = 1.0f;
-  for (iter = 0; iter < 1000; ++iter) {
-    float max_val = 0.0f;
-    size_t p = 0, q = 1;
-    for (i = 0; i < size; ++i) {
-      for (j = i + 1; j < size; ++j) {
-        float val = fabsf(temp[i * size + j]);
-        if (val > max_val) {
-          max_val = val;
-          p = i; q = j;
-        }
-      }
-    }
-    if (max_val < 1e-14f) break;
-    float app = temp[p * size + p], aqq = temp[q * size + q], apq = temp[p * size + q];
-    float theta, t, c, s;
-    if (fabsf(apq) < 1e-15f) {
-      c = 1.0f; s = 0.0f;
-    } else {
-      theta = (aqq - app) / (2.0f * apq);
-      t = (theta >= 0.0f) ? 1.0f / (theta + sqrtf(theta * theta + 1.0f)) : 1.0f / (theta - sqrtf(theta * theta + 1.0f));
-      c = 1.0f / sqrtf(t * t + 1.0f);
-      s = t * c;
-    }
-    for (k = 0; k < size; ++k) {
-      if (k != p && k != q) {
-        float akp = temp[k * size + p], akq = temp[k * size + q];
-        temp[k * size + p] = temp[p * size + k] = c * akp - s * akq;
-        temp[k * size + q] = temp[q * size + k] = s * akp + c * akq;
-      }
-    }
-    temp[p * size + p] = c * c * app + s * s * aqq - 2.0f * s * c * apq;
-    temp[q * size + q] = s * s * app + c * c * aqq + 2.0f * s * c * apq;
-    temp[p * size + q] = temp[q * size + p] = 0.0f;
-    for (k = 0; k < size; ++k) {
-      float vkp = eigenvecs[k * size + p], vkq = eigenvecs[k * size + q];
-      eigenvecs[k * size + p] = c * vkp - s * vkq;
-      eigenvecs[k * size + q] = s * vkp + c * vkq;
-    }
-  }
-  float* eigenvals = (float*)malloc(size * sizeof(float));
-  size_t* indices = (size_t*)malloc(size * sizeof(size_t));
-  for (i = 0; i < size; ++i) {
-    eigenvals[i] = temp[i * size + i];
-    indices[i] = i;
+  int info = steqr(n, w, e, zt, n);
+  if (info) {
+    fprintf(stderr, "eigh failed to converge for eigenvalue %d\n", info - 1);
+    exit(EXIT_FAILURE);
   }
-  for (i = 0; i < size - 1; ++i) {
-    for (j = i + 1; j < size; ++j) {
-      if (eigenvals[indices[i]] > eigenvals[indices[j]]) {
-        size_t tmp_idx = indices[i];
-        indices[i] = indices[j];
-        indices[j] = tmp_idx;
-      }
+  // selection sort: n swaps at most, each moving one whole vector row of zt
+  for (int i = 0; i < n - 1; i++) {
+    int k = i;
+    for (int j = i + 1; j < n; j++) { if (w[j] < w[k]) k = j; }
+    if (k == i) continue;
+    T tmp = w[i]; w[i] = w[k]; w[k] = tmp;
+    if (zt) {
+      T *zi = zt + (size_t)i * n, *zk = zt + (size_t)k * n;
+      for (int c = 0; c < n; c++) { T v = zi[c]; zi[c] = zk[c]; zk[c] = v; }
     }
   }
-  float* temp_vecs = (float*)malloc(mat_size * sizeof(float));
-  for (i = 0; i < mat_size; ++i) temp_vecs[i] = eigenvecs[i];
-  for (j = 0; j < size; ++j) {
-    size_t src_col = indices[j];
-    for (i = 0; i < size; ++i) eigenvecs[i * size + j] = temp_vecs[i * size + src_col];
-  }
-
-  for (j = 0; j < size; ++j) {
-    if (eigenvecs[0 * size + j] < 0.0f) {
-      for (i = 0; i < size; ++i) eigenvecs[i * size + j] *= -1.0f;
+  if (z) {
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) z[(size_t)i * n + j] = zt[(size_t)j * n + i];
+    }
+    // back to the vectors of A: z = Q z, Q's reflectors act on rows 1 .. n - 1
+    if (n > 1) ormqr(0, n - 1, n, n - 1, t + n, n, tau, z + n, n);
+    for (int j = 0; j < n; j++) {
+      if (z[j] >= 0) continue;
+      for (int i = 0; i < n; i++) z[(size_t)i * n + j] = -z[(size_t)i * n + j];
     }
   }
-
-  free(eigenvals); free(indices); free(temp_vecs); free(temp);
+  free(work);
 }
 
-static void compute_chol(float* a, float* l, int n) {
-  memset(l, 0, n * n * sizeof(float));
-
-  for (int i = 0; i < n; ++i) {
-    for (int j = 0; j <= i; ++j) {
-      if (i == j) {
-        float sum = 0.0f;
-        for (int k = 0; k < j; ++k) sum += l[i * n + k] * l[i * n + k];
-        float val = a[i * n + i] - sum;
-        if (val <= 1e-12f) {
-          l[i * n + j] = 0.0f;
-          return;
-        }
-        l[i * n + j] = sqrtf(val);
-      } else {
-        float sum = 0.0f;
-        for (int k = 0; k < j; ++k) sum += l[i * n + k] * l[j * n + k];
-        if (fabsf(l[j * n + j]) < 1e-12f) l[i * n + j] = 0.0f;
-        else l[i * n + j] = (a[i * n + j] - sum) / l[j * n + j];
-      }
-    }
+// lower factor with zeros above the diagonal, returns the potrf info
+template <typename T> static int compute_chol(const T* a, T* l, int n) {
+  memcpy(l, a, (size_t)n * n * sizeof(T));
+  int info = potrf(n, l, n);
+  for (int i = 0; i < n; i++) {
+    // a failed factorization keeps the rows before the failing pivot, like it always has
+    if (info && i >= info - 1) memset(l + i * n, 0, n * sizeof(T));
+    else memset(l + i * n + i + 1, 0, (n - i - 1) * sizeof(T));
   }
+  return info;
 }
 
-void svd_ops(float* a, float* u, float* s, float* vt, int* shape) {
+template <typename T> static void svd_ops_kernel(T* a, T* u, T* s, T* vt, int* shape, int full) {
   int m = shape[0], n = shape[1];
-  compute_svd(a, u, s, vt, m, n);
+  compute_svd(a, u, s, vt, m, n, full);
 }
-
-void batched_svd_ops(float* a, float* u, float* s, float* vt, int* shape, int ndim) {
+template <typename T> static void batched_svd_ops_kernel(T* a, T* u, T* s, T* vt, int* shape, int ndim, int full) {
   if (ndim < 2) {
     fprintf(stderr, "error: svd requires at least 2 dimensions\n");
     exit(EXIT_FAILURE);
@@ -185,21 +101,22 @@ void batched_svd_ops(float* a, float* u, float* s, float* vt, int* shape, int nd
   int min_mn = (m < n) ? m : n, batch_size = 1;
   for (int i = 0; i < ndim - 2; i++) batch_size *= shape[i];
 
-  int a_matrix_size = m * n, u_matrix_size = m * m, s_vector_size = min_mn, vt_matrix_size = n * n;  
-  for (int batch = 0; batch < batch_size; batch++) {
-    float *a_batch = a + batch * a_matrix_size, *u_batch = u + batch * u_matrix_size;
-    float *s_batch = s + batch * s_vector_size, *vt_batch = vt + batch * vt_matrix_size;
-    int matrix_shape[2] = {m, n};
-    svd_ops(a_batch, u_batch, s_batch, vt_batch, matrix_shape);
-  }
+  size_t a_matrix_size = (size_t)m * n, u_matrix_size = (size_t)m * (full ? m : min_mn), s_vector_size = min_mn, vt_matrix_size = (size_t)(full ? n : min_mn) * n;
+  parallel_for(batch_size, parallel_grain(a_matrix_size * (m > n ? m : n)), [&](size_t lo, size_t hi) {
+    for (size_t batch = lo; batch < hi; batch++) {
+      T *u_batch = u ? u + batch * u_matrix_size : NULL, *vt_batch = vt ? vt + batch * vt_matrix_size : NULL;
+      int matrix_shape[2] = {m, n};
+      svd_ops_kernel(a + batch * a_matrix_size, u_batch, s + batch * s_vector_size, vt_batch, matrix_shape, full);
+    }
+  });
 }
 
-void chol_ops(float* a, float* l, int* shape) {
+template <typename T> static void chol_ops_kernel(T* a, T* l, int* shape) {
   int n = shape[0];
   compute_chol(a, l, n);
 }
 
-void batched_chol_ops(float* a, float* l, int* shape, int ndim) {
+template <typename T> static void batched_chol_ops_kernel(T* a, T* l, int* shape, int ndim) {
   if (ndim < 2) {
     fprintf(stderr, "error: cholesky decomposition requires at least 2 dimensions\n");
     exit(EXIT_FAILURE);
@@ -209,43 +126,33 @@ void batched_chol_ops(float* a, float* l, int* shape, int ndim) {
   for (int i = 0; i < ndim - 2; i++) batch_size *= shape[i];
   int matrix_size = n * n;
 
-  for (int batch = 0; batch < batch_size; batch++) {
-    float *a_batch = a + batch * matrix_size, *l_batch = l + batch * matrix_size;
-    int matrix_shape[2] = {n, n};
-    chol_ops(a_batch, l_batch, matrix_shape);
-  }
+  parallel_for(batch_size, parallel_grain((size_t)matrix_size * n), [&](size_t lo, size_t hi) {
+    for (size_t batch = lo; batch < hi; batch++) {
+      T *a_batch = a + batch * matrix_size, *l_batch = l + batch * matrix_size;
+      int matrix_shape[2] = {n, n};
+      chol_ops_kernel(a_batch, l_batch, matrix_shape);
+    }
+  });
 }
 
-void qr_decomp_ops(float* a, float* q, float* r, int* shape) {
-  int m = shape[0], n = shape[1];  // rows, cols
-  float* work = (float*)malloc(m * n * sizeof(float));
-  memcpy(work, a, m * n * sizeof(float));
-  memset(q, 0, m * m * sizeof(float));  // initialize q as identity matrix (m x m)
-  for (int i = 0; i < m; i++) q[i * m + i] = 1.0f;
-  memset(r, 0, m * n * sizeof(float));    // initialize r as zero matrix (m x n)
-  for (int k = 0; k < n && k < m; k++) {  // modified gram-schmidt process
-    float norm = 0.0f;  // compute column norm for r[k][k]
-    for (int i = 0; i < m; i++) {
-      float val = work[i * n + k];
-      norm += val * val;
-    }
-    norm = sqrtf(norm);
-    r[k * n + k] = norm;
-
-    // normalize column k to get q_k
-    if (norm > 1e-6f) { for (int i = 0; i < m; i++) { q[i * m + k] = work[i * n + k] / norm; } }
-    for (int j = k + 1; j < n; j++) { // orthogonalize remaining columns
-      float dot = 0.0f; // compute r[k][j] = q_k^T * a_j (dot product)
-      for (int i = 0; i < m; i++) dot += q[i * m + k] * work[i * n + j];
-      r[k * n + j] = dot;
-      for (int i = 0; i < m; i++) work[i * n + j] -= dot * q[i * m + k]; // subtract projection: a_j = a_j - r[k][j] * q_k
-    }
-  }  
+// householder qr: q is m x m & r m x n, or m x k & k x n (k = min(m, n)) when `reduced`
+template <typename T> static void qr_decomp_ops_kernel(T* a, T* q, T* r, int* shape, int reduced) {
+  int m = shape[0], n = shape[1], k = (m < n) ? m : n, q_cols = reduced ? k : m, r_rows = reduced ? k : m;
+  T *work = (T*)malloc(((size_t)m * n + k + 1) * sizeof(T)), *tau = work + (size_t)m * n;
+  if (work == NULL) {
+    fprintf(stderr, "Memory allocation failed for qr factors\n");
+    exit(EXIT_FAILURE);
+  }
+  memcpy(work, a, (size_t)m * n * sizeof(T));
+  geqrf(m, n, work, n, tau);
+  for (int i = 0; i < r_rows; i++) {
+    for (int j = 0; j < n; j++) r[i * n + j] = (j >= i) ? work[i * n + j] : 0;
+  }
+  orgqr(m, q_cols, k, work, n, tau, q, q_cols);
   free(work);
 }
 
-// batched qr decomposition for n-dimensional arrays, processes matrices along the last two dimensions
-void batched_qr_decomp_ops(float* a, float* q, float* r, int* shape, int ndim) {
+template <typename T> static void batched_qr_decomp_ops_kernel(T* a, T* q, T* r, int* shape, int ndim, int reduced) {
   if (ndim < 2) {
     fprintf(stderr, "error: qr decomposition requires at least 2 dimensions\n");
     exit(EXIT_FAILURE);
@@ -254,57 +161,42 @@ void batched_qr_decomp_ops(float* a, float* q, float* r, int* shape, int ndim) {
   int m = shape[ndim - 2], n = shape[ndim - 1]; // rows, cols
   int batch_size = 1; // compute batch size (product of all leading dimensions)
   for (int i = 0; i < ndim - 2; i++) { batch_size *= shape[i]; }
-  int a_matrix_size = m * n, q_matrix_size = m * m, r_matrix_size = m * n;
-  // process each matrix in the batch
-  for (int batch = 0; batch < batch_size; batch++) {
-    float *a_batch = a + batch * a_matrix_size, *q_batch = q + batch * q_matrix_size, *r_batch = r + batch * r_matrix_size;
-    int matrix_shape[2] = {m, n};
-    qr_decomp_ops(a_batch, q_batch, r_batch, matrix_shape);
-  }
+  int k = (m < n) ? m : n, a_matrix_size = m * n, q_matrix_size = m * (reduced ? k : m), r_matrix_size = (reduced ? k : m) * n;
+  // process each matrix in the batch, independent matrices are spread over the thread pool
+  parallel_for(batch_size, parallel_grain((size_t)a_matrix_size * m), [&](size_t lo, size_t hi) {
+    for (size_t batch = lo; batch < hi; batch++) {
+      T *a_batch = a + batch * a_matrix_size, *q_batch = q + batch * q_matrix_size, *r_batch = r + batch * r_matrix_size;
+      int matrix_shape[2] = {m, n};
+      qr_decomp_ops_kernel(a_batch, q_batch, r_batch, matrix_shape, reduced);
+    }
+  });
 }
 
-void lu_decomp_ops(float* a, float* l, float* u, int* p, int* shape) {
+template <typename T> static void lu_decomp_ops_kernel(T* a, T* l, T* u, int* p, int* shape) {
   int n = shape[0];  // assuming square matrix n x n
-  memcpy(u, a, n * n * sizeof(float));    // copy input to u matrix
-  memset(l, 0, n * n * sizeof(float));    // initialize l as identity matrix
-  for (int i = 0; i < n; i++) l[i * n + i] = 1.0f;
-  for (int i = 0; i < n; i++) p[i] = i; // initialize permutation array
-  // gaussian elimination with partial pivoting
-  for (int k = 0; k < n - 1; k++) {
-    int pivot_row = k;
-    float max_val = fabsf(u[k * n + k]);
-    for (int i = k + 1; i < n; i++) {
-      if (fabsf(u[i * n + k]) > max_val) {
-        max_val = fabsf(u[i * n + k]);
-        pivot_row = i;
-      }
-    }
-    if (pivot_row != k) { // swap rows in u matrix
-      for (int j = 0; j < n; j++) {
-        float temp = u[k * n + j];
-        u[k * n + j] = u[pivot_row * n + j];
-        u[pivot_row * n + j] = temp;
-      }
-      for (int j = 0; j < k; j++) { // swap rows in l matrix (only lower part)
-        float temp = l[k * n + j];
-        l[k * n + j] = l[pivot_row * n + j];
-        l[pivot_row * n + j] = temp;
-      }
-      int temp_p = p[k];  // update permutation
-      p[k] = p[pivot_row];
-      p[pivot_row] = temp_p;
-    }
-    for (int i = k + 1; i < n; i++) {
-      if (fabsf(u[k * n + k]) > 1e-9f) {
-        float factor = u[i * n + k] / u[k * n + k];
-        l[i * n + k] = factor;
-        for (int j = k; j < n; j++) u[i * n + j] -= factor * u[k * n + j];
-      }
+  memcpy(u, a, n * n * sizeof(T));    // factored in place in u, then split into l & u
+  getrf(n, u, n, p);
+  // p[k] turns from "row swapped with k at step k" into the source row of row k of P A
+  int* perm = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+  if (perm == NULL) {
+    fprintf(stderr, "Memory allocation failed for lu permutation\n");
+    exit(EXIT_FAILURE);
+  }
+  for (int i = 0; i < n; i++) perm[i] = i;
+  for (int k = 0; k < n; k++) {
+    int t = perm[k]; perm[k] = perm[p[k]]; perm[p[k]] = t;
+  }
+  memcpy(p, perm, n * sizeof(int));
+  free(perm);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      if (j < i) { l[i * n + j] = u[i * n + j]; u[i * n + j] = 0; }
+      else l[i * n + j] = (i == j) ? 1 : 0;
     }
   }
 }
 
-void batched_lu_decomp_ops(float* a, float* l, float* u, int* p, int* shape, int ndim) {
+template <typename T> static void batched_lu_decomp_ops_kernel(T* a, T* l, T* u, int* p, int* shape, int ndim) {
   if (ndim < 2) {
     fprintf(stderr, "error: lu decomposition requires at least 2 dimensions\n");
     exit(EXIT_FAILURE);
@@ -313,212 +205,538 @@ void batched_lu_decomp_ops(float* a, float* l, float* u, int* p, int* shape, int
   int n = shape[ndim - 1], batch_size = 1;
   for (int i = 0; i < ndim - 2; i++) { batch_size *= shape[i]; }
   int matrix_size = n * n;
-  for (int batch = 0; batch < batch_size; batch++) {
-    float *a_batch = a + batch * matrix_size, *l_batch = l + batch * matrix_size, *u_batch = u + batch * matrix_size;
-    int* p_batch = p + batch * n;
-    int matrix_shape[2] = {n, n};
-    lu_decomp_ops(a_batch, l_batch, u_batch, p_batch, matrix_shape);
-  }
+  parallel_for(batch_size, parallel_grain((size_t)matrix_size * n), [&](size_t lo, size_t hi) {
+    for (size_t batch = lo; batch < hi; batch++) {
+      T *a_batch = a + batch * matrix_size, *l_batch = l + batch * matrix_size, *u_batch = u + batch * matrix_size;
+      int* p_batch = p + batch * n;
+      int matrix_shape[2] = {n, n};
+      lu_decomp_ops_kernel(a_batch, l_batch, u_batch, p_batch, matrix_shape);
+    }
+  });
+}
+
+template <typename T> static void lu_factor_ops_kernel(T* a, T* lu, int* piv, int n, size_t batch) {
+  size_t matrix_size = (size_t)n * n;
+  memcpy(lu, a, batch * matrix_size * sizeof(T));
+  parallel_for(batch, parallel_grain(matrix_size * n), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; b++) getrf(n, lu + b * matrix_size, n, piv + b * n);
+  });
 }
 
-static void compute_eigenvals(float* a, float* eigenvals, size_t size) {
-  float *temp, *q, *r;
-  size_t i, j, iter, mat_size = size * size;
-  temp = (float*)malloc(3 * mat_size * sizeof(float));
-  if (!temp) { 
-    for (i = 0; i < size; ++i) eigenvals[i] = 0.0f; 
-    return; 
+template <typename T> static void cho_factor_ops_kernel(T* a, T* l, int n, size_t batch) {
+  size_t matrix_size = (size_t)n * n;
+  parallel_for(batch, parallel_grain(matrix_size * n), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; b++) {
+      int info = compute_chol(a + b * matrix_size, l + b * matrix_size, n);
+      if (info) {
+        fprintf(stderr, "Matrix %zu isn't positive definite, leading minor %d fails cholesky\n", b, info);
+        exit(EXIT_FAILURE);
+      }
+    }
+  });
+}
+
+// general eigenproblem: hessenberg reduction, Francis double shift qr & back substitution; wr/wi get
+// the eigenvalues (conjugate pairs adjacent, positive imaginary part first, wi NULL drops the imaginary
+// parts), v (NULL for values only) the unit norm eigenvectors as columns, a complex pair as its real &
+// imaginary part in two adjacent columns like LAPACK's geev
+template <typename T> static void compute_eig(const T* a, T* wr, T* wi, T* v, int n) {
+  if (n <= 0) return;
+  size_t mat_size = (size_t)n * n;
+  T* work = (T*)malloc((mat_size * (v ? 2 : 1) + 2 * (size_t)n) * sizeof(T));
+  if (work == NULL) {
+    fprintf(stderr, "Memory allocation failed for eig workspace\n");
+    exit(EXIT_FAILURE);
   }
-  q = temp;
-  r = temp + mat_size;
-  float* curr_a = temp + 2 * mat_size;
-  for (i = 0; i < mat_size; ++i) curr_a[i] = a[i];
-  for (iter = 0; iter < 200; ++iter) {
-    float shift = 0.0f;
-    if (size > 1) {
-      float a11 = curr_a[(size-2) * size + (size-2)], a12 = curr_a[(size-2) * size + (size-1)], a21 = curr_a[(size-1) * size + (size-2)], a22 = curr_a[(size-1) * size + (size-1)];
-      float trace = a11 + a22;
-      float det = a11 * a22 - a12 * a21;
-      float disc = trace * trace - 4.0f * det;
-      if (disc >= 0.0f) {
-        float sqrt_disc = sqrtf(disc);
-        float lambda1 = (trace + sqrt_disc) / 2.0f, lambda2 = (trace - sqrt_disc) / 2.0f;
-        shift = (fabsf(lambda1 - a22) < fabsf(lambda2 - a22)) ? lambda1 : lambda2;
-      } else { shift = trace / 2.0f; }
+  T *h = work, *tau = work + mat_size, *im = tau + n, *zt = v ? im + n : NULL;
+  memcpy(h, a, mat_size * sizeof(T));
+  gehrd(n, h, n, tau);
+  if (zt) {
+    // Q = diag(1, the n - 1 x n - 1 Q of the reflectors), built in v & kept transposed in zt so the qr
+    // sweeps rotate contiguous rows
+    memset(v, 0, mat_size * sizeof(T));
+    v[0] = 1;
+    if (n > 1) orgqr(n - 1, n - 1, n - 1, h + n, n, tau, v + n + 1, n);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) zt[(size_t)j * n + i] = v[(size_t)i * n + j];
     }
-    for (i = 0; i < size; ++i) curr_a[i * size + i] -= shift;
-    int qr_shape[2] = {(int)size, (int)size};
-    qr_decomp_ops(curr_a, q, r, qr_shape);
-    for (i = 0; i < mat_size; ++i) curr_a[i] = 0.0f;
-    for (i = 0; i < size; ++i) {
-      for (j = 0; j < size; ++j) {
-        for (size_t k = 0; k < size; ++k) { curr_a[i * size + j] += r[i * size + k] * q[k * size + j]; }
+  }
+  for (int i = 2; i < n; i++) memset(h + (size_t)i * n, 0, (i - 1) * sizeof(T));
+  int info = hseqr(n, h, n, wr, im, zt, n);
+  if (info) {
+    fprintf(stderr, "eig failed to converge for eigenvalue %d\n", info - 1);
+    exit(EXIT_FAILURE);
+  }
+  if (wi) memcpy(wi, im, n * sizeof(T));
+  if (v) {
+    // v = Z X for the schur vectors Z (zt read transposed) & the eigenvectors X of T
+    trevc(n, h, n, wr, im);
+    memset(v, 0, mat_size * sizeof(T));
+    gemm_update(n, n, n, (T)1, zt, 1, n, h, n, 1, v, n);
+    for (int j = 0; j < n; j++) {
+      int cols = (im[j] > 0 && j + 1 < n) ? 2 : 1;
+      T ss = 0;
+      for (int i = 0; i < n; i++) {
+        for (int c = 0; c < cols; c++) ss += v[(size_t)i * n + j + c] * v[(size_t)i * n + j + c];
       }
+      T scale = (ss > 0) ? 1 / sqrt(ss) : 1;
+      for (int i = 0; i < n; i++) {
+        for (int c = 0; c < cols; c++) v[(size_t)i * n + j + c] *= scale;
+      }
+      j += cols - 1;
     }
-    for (i = 0; i < size; ++i) curr_a[i * size + i] += shift;
-    float off_diag = 0.0f;
-    for (i = 0; i < size; ++i) {
-      for (j = 0; j < size; ++j) { if (i != j) off_diag += fabsf(curr_a[i * size + j]); }
-    }
-    if (off_diag < 1e-8f) break;
   }
-  for (i = 0; i < size; ++i) eigenvals[i] = curr_a[i * size + i];
-  free(temp);
+  free(work);
+}
+
+template <typename T> static void eigenvals_ops_array_kernel(T* a, T* eigenvals, size_t size) { compute_eig(a, eigenvals, (T*)NULL, (T*)NULL, (int)size); }
+
+template <typename T> static void batched_eigenvals_ops_kernel(T* a, T* eigenvals, size_t size, size_t batch) {
+  size_t mat_size = size * size;
+  parallel_for(batch, parallel_grain(mat_size * size), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; ++b) {
+      T *mat = &a[b * mat_size], *vals = &eigenvals[b * size];
+      eigenvals_ops_array_kernel(mat, vals, size);
+    }
+  });
+}
+
+// values (& vectors unless v is NULL) out of one solve per matrix, wi NULL drops the imaginary parts
+template <typename T> static void eig_pairs_ops_kernel(T* a, T* wr, T* wi, T* v, int n, size_t batch) {
+  size_t matrix_size = (size_t)n * n;
+  parallel_for(batch, parallel_grain(matrix_size * n), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; b++) compute_eig(a + b * matrix_size, wr + b * n, wi ? wi + b * n : NULL, v ? v + b * matrix_size : NULL, n);
+  });
+}
+
+template <typename T> static void eigh_pairs_ops_kernel(T* a, T* w, T* z, int n, size_t batch) {
+  size_t matrix_size = (size_t)n * n;
+  parallel_for(batch, parallel_grain(matrix_size * n), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; b++) compute_eigh(a + b * matrix_size, w + b * n, z + b * matrix_size, n);
+  });
+}
+
+template <typename T> static void eigenvecs_ops_array_kernel(T* a, T* eigenvecs, size_t size) {
+  T* eigenvals = (T*)malloc((size ? size : 1) * sizeof(T));
+  compute_eig(a, eigenvals, (T*)NULL, eigenvecs, (int)size);
+  free(eigenvals);
+}
+
+template <typename T> static void batched_eigenvecs_ops_kernel(T* a, T* eigenvecs, size_t size, size_t batch) {
+  size_t mat_size = size * size;
+  parallel_for(batch, parallel_grain(mat_size * size), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; ++b) {
+      T *mat = &a[b * mat_size], *vecs = &eigenvecs[b * mat_size];
+      eigenvecs_ops_array_kernel(mat, vecs, size);
+    }
+  });
 }
 
-static void compute_eigenvecs(float* a, float* eigenvecs, size_t size) {
-  float *temp, *q, *r, *qt, *v_acc;
-  size_t i, j, iter, mat_size = size * size;
-  temp = (float*)malloc(5 * mat_size * sizeof(float));
-  if (!temp) { 
-    for (i = 0; i < mat_size; ++i) eigenvecs[i] = 0.0f; 
+template <typename T> static void eigenvals_h_ops_array_kernel(T* a, T* eigenvals, size_t size) { compute_eigh(a, eigenvals, (T*)NULL, (int)size); }
+
+template <typename T> static void batched_eigenvals_h_ops_kernel(T* a, T* eigenvals, size_t size, size_t batch) {
+  size_t mat_size = size * size;
+  const SimdKernels* k = simd_kernels();
+  if (k != NULL && (size == 2 || size == 3)) {
+    // closed form across the batch, one matrix per vector lane
+    parallel_for(batch, (parallel_grain(mat_size * size) + SIMD_SMALL_BLOCK - 1) / SIMD_SMALL_BLOCK * SIMD_SMALL_BLOCK, [&](size_t lo, size_t hi) {
+      simd_small_batch(k, SIMD_SMALL_EIGH, (int)size, 0, a + lo * mat_size, (const T*)NULL, eigenvals + lo * size, hi - lo);
+    });
     return;
   }
-  q = temp, r = temp + mat_size, qt = temp + 2 * mat_size, v_acc = temp + 3 * mat_size;
-  float* curr_a = temp + 4 * mat_size;
-  for (i = 0; i < mat_size; ++i) {
-    curr_a[i] = a[i];
-    eigenvecs[i] = 0.0f;
-    v_acc[i] = 0.0f;
+  parallel_for(batch, parallel_grain(mat_size * size), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; ++b) {
+      T *mat = &a[b * mat_size], *vals = &eigenvals[b * size];
+      eigenvals_h_ops_array_kernel(mat, vals, size);
+    }
+  });
+}
+
+template <typename T> static void eigenvecs_h_ops_array_kernel(T* a, T* eigenvecs, size_t size) {
+  T* eigenvals = (T*)malloc((size ? size : 1) * sizeof(T));
+  compute_eigh(a, eigenvals, eigenvecs, (int)size);
+  free(eigenvals);
+}
+
+template <typename T> static void batched_eigenvecs_h_ops_kernel(T* a, T* eigenvecs, size_t size, size_t batch) {
+  size_t mat_size = size * size;
+  parallel_for(batch, parallel_grain(mat_size * size), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; ++b) {
+      T *mat = &a[b * mat_size], *vecs = &eigenvecs[b * mat_size];
+      eigenvecs_h_ops_array_kernel(mat, vecs, size);
+    }
+  });
+}
+
+// q[m x l] = an orthonormal basis for the columns of y, which is left holding their geqrf factors
+template <typename T> static void orth_range(int m, int l, T* y, T* tau, T* q) {
+  geqrf(m, l, y, l, tau);
+  orgqr(m, l, l, y, l, tau, q, l);
+}
+
+static int svd_topk_width(int m, int n, int k) {
+  int min_mn = (m < n) ? m : n;
+  return (k + SVD_TOPK_OVERSAMPLE < min_mn) ? k + SVD_TOPK_OVERSAMPLE : min_mn;
+}
+
+// randomized range finder (Halko, Martinsson & Tropp): Q spans A omega after `iters` power iterations,
+// the small svd of Q^T A then gives the leading k triplets; omega is n x l gaussian, u (m x k) & vt
+// (k x n) can be NULL for values only
+template <typename T> static void compute_svd_topk(const T* a, T* u, T* s, T* vt, int m, int n, int k, int iters, const float* omega) {
+  int l = svd_topk_width(m, n, k);
+  size_t tall = (size_t)(m > n ? m : n) * l;
+  T* work = (T*)malloc((4 * tall + (size_t)l * n + (size_t)l * l + 2 * (size_t)l) * sizeof(T));
+  if (work == NULL) {
+    fprintf(stderr, "Memory allocation failed for svd range finder\n");
+    exit(EXIT_FAILURE);
   }
-  for (i = 0; i < size; ++i) {
-    eigenvecs[i * size + i] = 1.0f;
-    v_acc[i * size + i] = 1.0f;
+  // y & q are m x l, z & zq n x l, b is l x n & ub l x l
+  T *y = work, *q = y + tall, *z = q + tall, *zq = z + tall, *b = zq + tall, *ub = b + (size_t)l * n, *sb = ub + (size_t)l * l, *tau = sb + l;
+  for (size_t i = 0; i < (size_t)n * l; i++) zq[i] = (T)omega[i];
+  gemm(m, l, n, a, n, 1, zq, l, 1, y, l);
+  orth_range(m, l, y, tau, q);
+  // each power step re-orthonormalizes, the small singular values would drown in rounding otherwise
+  for (int it = 0; it < iters; it++) {
+    gemm(n, l, m, a, 1, n, q, l, 1, z, l);
+    orth_range(n, l, z, tau, zq);
+    gemm(m, l, n, a, n, 1, zq, l, 1, y, l);
+    orth_range(m, l, y, tau, q);
+  }
+  gemm(l, n, m, q, 1, l, a, n, 1, b, n);
+  // l <= n, so the l x n right vectors of b fit in z
+  int info = gesvd(l, n, b, n, sb, u ? ub : NULL, l, l, vt ? z : NULL, n, l);
+  if (info) {
+    fprintf(stderr, "svd failed to converge, %d singular values left\n", info);
+    exit(EXIT_FAILURE);
   }
-  for (iter = 0; iter < 200; ++iter) {
-    float shift = 0.0f;
-    if (size > 1) {
-      float a11 = curr_a[(size-2) * size + (size-2)], a12 = curr_a[(size-2) * size + (size-1)], a21 = curr_a[(size-1) * size + (size-2)], a22 = curr_a[(size-1) * size + (size-1)];
-      float trace = a11 + a22;
-      float det = a11 * a22 - a12 * a21;
-      float disc = trace * trace - 4.0f * det;
-      if (disc >= 0.0f) {
-        float sqrt_disc = sqrtf(disc);
-        float lambda1 = (trace + sqrt_disc) / 2.0f, lambda2 = (trace - sqrt_disc) / 2.0f;
-        shift = (fabsf(lambda1 - a22) < fabsf(lambda2 - a22)) ? lambda1 : lambda2;
-      } else { shift = trace / 2.0f; }
+  memcpy(s, sb, k * sizeof(T));
+  if (u) gemm(m, k, l, q, l, 1, ub, l, 1, u, k);
+  if (vt) memcpy(vt, z, (size_t)k * n * sizeof(T));
+  free(work);
+}
+
+template <typename T> static T vec_norm(const T* x, int n) {
+  T ss = 0;
+  for (int i = 0; i < n; i++) ss += x[i] * x[i];
+  return sqrt(ss);
+}
+
+// thick restart lanczos (Wu & Simon) for the k eigenpairs of largest magnitude of the symmetric a: a
+// basis of nb vectors grows by fully reorthogonalized gemv steps, & while the ritz pairs of the projected
+// matrix miss their residual tolerance the best k + (nb - k) / 2 of them restart the next basis; w gets
+// the eigenvalues ascending & z (n x k, NULL for values only) the vectors, first component nonnegative
+template <typename T> static void compute_eigh_topk(const T* a, T* w, T* z, int n, int k, const float* start) {
+  if (k <= 0) return;
+  int nb = (2 * k + 1 > k + 20) ? 2 * k + 1 : k + 20;
+  if (nb >= n) {
+    // the basis would span (nearly) everything anyway, the dense solver is cheaper
+    T* work = (T*)malloc(((size_t)n * (z ? n + 1 : 1)) * sizeof(T));
+    if (work == NULL) {
+      fprintf(stderr, "Memory allocation failed for eigh workspace\n");
+      exit(EXIT_FAILURE);
     }
-    for (i = 0; i < size; ++i) curr_a[i * size + i] -= shift;
-    int qr_shape[2] = {(int)size, (int)size};
-    qr_decomp_ops(curr_a, q, r, qr_shape);
-    for (i = 0; i < mat_size; ++i) qt[i] = 0.0f;
-    for (i = 0; i < size; ++i) {
-      for (j = 0; j < size; ++j) {
-        for (size_t k = 0; k < size; ++k) { qt[i * size + j] += v_acc[i * size + k] * q[k * size + j]; }
-      }
+    T *wa = work, *za = z ? work + n : NULL;
+    compute_eigh(a, wa, za, n);
+    // the largest magnitudes sit at the two ends of the ascending spectrum
+    int lo = 0, hi = n - 1;
+    for (int c = 0; c < k; c++) {
+      if (fabs(wa[lo]) > fabs(wa[hi])) lo++;
+      else hi--;
     }
-    for (i = 0; i < mat_size; ++i) v_acc[i] = qt[i];
-    for (i = 0; i < mat_size; ++i) curr_a[i] = 0.0f;
-    for (i = 0; i < size; ++i) {
-      for (j = 0; j < size; ++j) {
-        for (size_t k = 0; k < size; ++k) { curr_a[i * size + j] += r[i * size + k] * q[k * size + j]; }
-      }
+    for (int i = 0, c = 0; i < n; i++) {
+      if (i >= lo && i <= hi) continue;
+      w[c] = wa[i];
+      if (z) { for (int r = 0; r < n; r++) z[(size_t)r * k + c] = za[(size_t)r * n + i]; }
+      c++;
     }
-    for (i = 0; i < size; ++i) curr_a[i * size + i] += shift;
-    float off_diag = 0.0f;
-    for (i = 0; i < size; ++i) { for (j = 0; j < size; ++j) { if (i != j) off_diag += fabsf(curr_a[i * size + j]); } }
-    if (off_diag < 1e-8f) break;
+    free(work);
+    return;
   }
-  for (i = 0; i < mat_size; ++i) eigenvecs[i] = v_acc[i];
-  free(temp);
-}
 
-static void compute_eigenvals_h(float* a, float* eigenvals, size_t size) {
-  float *temp;
-  size_t i, j, k, iter, mat_size = size * size;
-  temp = (float*)malloc(mat_size * sizeof(float));
-  if (!temp) { 
-    for (i = 0; i < size; ++i) eigenvals[i] = 0.0f; 
-    return; 
+  size_t nn = n, nbs = nb;
+  // v holds the nb + 1 basis vectors as rows & h the (nb + 1) x nb projections, column j from step j;
+  // t is the symmetric projected matrix, y its eigenvectors & sel the rows of y^T kept on a restart
+  T* work = (T*)malloc(((2 * nbs + 1) * nn + (nbs + 1) * nbs + 3 * nbs * nbs + 2 * nbs + 1) * sizeof(T));
+  int* idx = (int*)malloc(nb * sizeof(int));
+  if (work == NULL || idx == NULL) {
+    fprintf(stderr, "Memory allocation failed for lanczos workspace\n");
+    exit(EXIT_FAILURE);
   }
-  for (i = 0; i < mat_size; ++i) temp[i] = a[i];
-  for (iter = 0; iter < 1000; ++iter) {
-    float max_val = 0.0f;
-    size_t p = 0, q = 1;
-    for (i = 0; i < size; ++i) {
-      for (j = i + 1; j < size; ++j) {
-        float val = fabsf(temp[i * size + j]);
-        if (val > max_val) {
-          max_val = val;
-          p = i; q = j;
+  T *v = work, *ritz = v + (nbs + 1) * nn, *h = ritz + nbs * nn, *t = h + (nbs + 1) * nbs, *y = t + nbs * nbs, *sel = y + nbs * nbs, *theta = sel + nbs * nbs, *proj = theta + nbs;
+  for (int i = 0; i < n; i++) v[i] = (T)start[i];
+  T v0_norm = vec_norm(v, n);
+  for (int i = 0; i < n; i++) v[i] /= v0_norm;
+
+  const T eps = std::numeric_limits<T>::epsilon(), tol = pow(eps, (T)0.75);
+  T anorm = 0;
+  int first = 0, keep = 0;
+  memset(h, 0, (nbs + 1) * nbs * sizeof(T));
+  for (int restart = 0; ; restart++) {
+    for (int j = first; j < nb; j++) {
+      T *r = v + (size_t)(j + 1) * nn;
+      gemv(n, n, a, n, v + (size_t)j * nn, r);
+      T r_norm = vec_norm(r, n);
+      if (r_norm > anorm) anorm = r_norm;
+      for (int i = 0; i <= j; i++) h[(size_t)i * nb + j] = 0;
+      // classical gram-schmidt against the whole basis, the second pass mops up what the first lost
+      for (int pass = 0; pass < 2; pass++) {
+        gemv(j + 1, n, v, n, r, proj);
+        gemm_update(1, n, j + 1, (T)-1, proj, j + 1, 1, v, n, 1, r, n);
+        for (int i = 0; i <= j; i++) h[(size_t)i * nb + j] += proj[i];
+      }
+      T beta = vec_norm(r, n);
+      if (beta <= n * eps * anorm) {
+        // invariant subspace: carry on from a fresh direction orthogonal to the basis
+        beta = 0;
+        for (int i = 0; i < n; i++) r[i] = (T)start[(i + j + 1) % n];
+        for (int pass = 0; pass < 2; pass++) {
+          gemv(j + 1, n, v, n, r, proj);
+          gemm_update(1, n, j + 1, (T)-1, proj, j + 1, 1, v, n, 1, r, n);
         }
       }
+      h[(size_t)(j + 1) * nb + j] = beta;
+      T r_scale = vec_norm(r, n);
+      for (int i = 0; i < n; i++) r[i] /= r_scale;
     }
-    if (max_val < 1e-14f) break;
-    float app = temp[p * size + p], aqq = temp[q * size + q], apq = temp[p * size + q];
-    float theta, t, c, s;
-    if (fabsf(apq) < 1e-15f) {
-      c = 1.0f; s = 0.0f;
-    } else {
-      theta = (aqq - app) / (2.0f * apq);
-      t = (theta >= 0.0f) ? 1.0f / (theta + sqrtf(theta * theta + 1.0f)) : 1.0f / (theta - sqrtf(theta * theta + 1.0f));
-      c = 1.0f / sqrtf(t * t + 1.0f);
-      s = t * c;
+
+    for (int i = 0; i < nb; i++) {
+      for (int j = 0; j < nb; j++) t[(size_t)i * nb + j] = (i <= j) ? h[(size_t)i * nb + j] : h[(size_t)j * nb + i];
     }
-    for (k = 0; k < size; ++k) {
-      if (k != p && k != q) {
-        float akp = temp[k * size + p], akq = temp[k * size + q];
-        temp[k * size + p] = temp[p * size + k] = c * akp - s * akq;
-        temp[k * size + q] = temp[q * size + k] = s * akp + c * akq;
-      }
+    compute_eigh(t, theta, y, nb);
+    for (int i = 0; i < nb; i++) {
+      int c = i;
+      while (c > 0 && fabs(theta[idx[c - 1]]) < fabs(theta[i])) { idx[c] = idx[c - 1]; c--; }
+      idx[c] = i;
+    }
+    // the residual of a ritz pair is beta_nb times the last component of its y vector
+    T beta_nb = h[nbs * nb + nb - 1], res_tol = tol * fabs(theta[idx[0]]);
+    int converged = 1;
+    for (int c = 0; c < k && converged; c++) converged = fabs(beta_nb * y[(nbs - 1) * nb + idx[c]]) <= res_tol;
+    if (!converged && restart == LANCZOS_MAX_RESTARTS) {
+      fprintf(stderr, "eigh failed to converge for the top %d eigenpairs after %d restarts\n", k, restart);
+      exit(EXIT_FAILURE);
+    }
+    keep = converged ? k : k + (nb - k) / 2;
+    for (int r = 0; r < keep; r++) {
+      for (int c = 0; c < nb; c++) sel[(size_t)r * nb + c] = y[(size_t)c * nb + idx[r]];
     }
-    temp[p * size + p] = c * c * app + s * s * aqq - 2.0f * s * c * apq;
-    temp[q * size + q] = s * s * app + c * c * aqq + 2.0f * s * c * apq;
-    temp[p * size + q] = temp[q * size + p] = 0.0f;
+    if (converged && z == NULL) break;
+    gemm(keep, n, nb, sel, nb, 1, v, n, 1, ritz, n);
+    if (converged) break;
+    memcpy(v, ritz, (size_t)keep * nn * sizeof(T));
+    memcpy(v + (size_t)keep * nn, v + nbs * nn, nn * sizeof(T));
+    memset(h, 0, (nbs + 1) * nbs * sizeof(T));
+    for (int r = 0; r < keep; r++) h[(size_t)r * nb + r] = theta[idx[r]];
+    first = keep;
+  }
+
+  // the k converged pairs go out ascending by value, their order kept in the spare tail of idx
+  int* order = idx + k;
+  for (int r = 0; r < k; r++) {
+    int c = r;
+    while (c > 0 && theta[idx[order[c - 1]]] > theta[idx[r]]) { order[c] = order[c - 1]; c--; }
+    order[c] = r;
+  }
+  for (int c = 0; c < k; c++) {
+    w[c] = theta[idx[order[c]]];
+    if (z == NULL) continue;
+    const T* x = ritz + (size_t)order[c] * nn;
+    T sign = (x[0] < 0) ? -1 : 1;
+    for (int i = 0; i < n; i++) z[(size_t)i * k + c] = sign * x[i];
+  }
+  free(idx);
+  free(work);
+}
+
+// the random draws are made up front & in batch order, so one seed gives the same result on any thread count
+template <typename T> static void svd_topk_ops_kernel(T* a, T* u, T* s, T* vt, int m, int n, int k, int iters, size_t batch, int64_t seed) {
+  int l = svd_topk_width(m, n, k);
+  size_t omega_size = (size_t)n * l, a_matrix_size = (size_t)m * n;
+  float* omega = (float*)malloc((batch * omega_size + 1) * sizeof(float));
+  if (omega == NULL) {
+    fprintf(stderr, "Memory allocation failed for svd test matrix\n");
+    exit(EXIT_FAILURE);
   }
-  for (i = 0; i < size; ++i) eigenvals[i] = temp[i * size + i];
-  for (i = 0; i < size - 1; ++i) {
-    for (j = i + 1; j < size; ++j) {
-      if (eigenvals[i] > eigenvals[j]) {
-        float tmp = eigenvals[i];
-        eigenvals[i] = eigenvals[j];
-        eigenvals[j] = tmp;
-      }
+  fill_randn_seeded(omega, batch * omega_size, seed);
+  parallel_for(batch, parallel_grain(a_matrix_size * l * (2 * iters + 2)), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; b++) {
+      T *u_batch = u ? u + b * m * k : NULL, *vt_batch = vt ? vt + b * k * n : NULL;
+      compute_svd_topk(a + b * a_matrix_size, u_batch, s + b * k, vt_batch, m, n, k, iters, omega + b * omega_size);
     }
+  });
+  free(omega);
+}
+
+template <typename T> static void eigh_topk_ops_kernel(T* a, T* w, T* z, int n, int k, size_t batch, int64_t seed) {
+  size_t matrix_size = (size_t)n * n;
+  float* start = (float*)malloc((batch * n + 1) * sizeof(float));
+  if (start == NULL) {
+    fprintf(stderr, "Memory allocation failed for lanczos start vectors\n");
+    exit(EXIT_FAILURE);
   }
-  free(temp);
+  fill_randn_seeded(start, batch * n, seed);
+  parallel_for(batch, parallel_grain(matrix_size * k * 4), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; b++) compute_eigh_topk(a + b * matrix_size, w + b * k, z ? z + b * n * k : NULL, n, k, start + b * n);
+  });
+  free(start);
 }
 
-void eigenvals_ops_array(float* a, float* eigenvals, size_t size) {
-  compute_eigenvals(a, eigenvals, size);
+void svd_ops(void* a, void* u, void* s, void* vt, int* shape, int full, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    svd_ops_kernel((T*)a, (T*)u, (T*)s, (T*)vt, shape, full);
+  });
 }
 
-void batched_eigenvals_ops(float* a, float* eigenvals, size_t size, size_t batch) {
-  size_t mat_size = size * size;
-  for (size_t b = 0; b < batch; ++b) {
-    float *mat = &a[b * mat_size], *vals = &eigenvals[b * size];
-    eigenvals_ops_array(mat, vals, size);
-  }
+void batched_svd_ops(void* a, void* u, void* s, void* vt, int* shape, int ndim, int full, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_svd_ops_kernel((T*)a, (T*)u, (T*)s, (T*)vt, shape, ndim, full);
+  });
 }
 
-void eigenvecs_ops_array(float* a, float* eigenvecs, size_t size) {
-  compute_eigenvecs(a, eigenvecs, size);
+void chol_ops(void* a, void* l, int* shape, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    chol_ops_kernel((T*)a, (T*)l, shape);
+  });
 }
 
-void batched_eigenvecs_ops(float* a, float* eigenvecs, size_t size, size_t batch) {
-  size_t mat_size = size * size;
-  for (size_t b = 0; b < batch; ++b) {
-    float *mat = &a[b * mat_size], *vecs = &eigenvecs[b * mat_size];
-    eigenvecs_ops_array(mat, vecs, size);
-  }
+void batched_chol_ops(void* a, void* l, int* shape, int ndim, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_chol_ops_kernel((T*)a, (T*)l, shape, ndim);
+  });
 }
 
-void eigenvals_h_ops_array(float* a, float* eigenvals, size_t size) { compute_eigenvals_h(a, eigenvals, size); }
+void qr_decomp_ops(void* a, void* q, void* r, int* shape, int reduced, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    qr_decomp_ops_kernel((T*)a, (T*)q, (T*)r, shape, reduced);
+  });
+}
 
-void batched_eigenvals_h_ops(float* a, float* eigenvals, size_t size, size_t batch) {
-  size_t mat_size = size * size;
-  for (size_t b = 0; b < batch; ++b) {
-    float *mat = &a[b * mat_size], *vals = &eigenvals[b * size];
-    eigenvals_h_ops_array(mat, vals, size);
-  }
+void batched_qr_decomp_ops(void* a, void* q, void* r, int* shape, int ndim, int reduced, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_qr_decomp_ops_kernel((T*)a, (T*)q, (T*)r, shape, ndim, reduced);
+  });
+}
+
+void lu_decomp_ops(void* a, void* l, void* u, int* p, int* shape, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    lu_decomp_ops_kernel((T*)a, (T*)l, (T*)u, p, shape);
+  });
 }
 
-void eigenvecs_h_ops_array(float* a, float* eigenvecs, size_t size) { compute_eigenvecs_h(a, eigenvecs, size); }
+void batched_lu_decomp_ops(void* a, void* l, void* u, int* p, int* shape, int ndim, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_lu_decomp_ops_kernel((T*)a, (T*)l, (T*)u, p, shape, ndim);
+  });
+}
 
-void batched_eigenvecs_h_ops(float* a, float* eigenvecs, size_t size, size_t batch) {
-  size_t mat_size = size * size;
-  for (size_t b = 0; b < batch; ++b) {
-    float *mat = &a[b * mat_size], *vecs = &eigenvecs[b * mat_size];
-    eigenvecs_h_ops_array(mat, vecs, size);
-  }
-}
\ No newline at end of file
+void lu_factor_ops(void* a, void* lu, int* piv, int n, size_t batch, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    lu_factor_ops_kernel((T*)a, (T*)lu, piv, n, batch);
+  });
+}
+
+void cho_factor_ops(void* a, void* l, int n, size_t batch, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    cho_factor_ops_kernel((T*)a, (T*)l, n, batch);
+  });
+}
+
+void eigenvals_ops_array(void* a, void* eigenvals, size_t size, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    eigenvals_ops_array_kernel((T*)a, (T*)eigenvals, size);
+  });
+}
+
+void batched_eigenvals_ops(void* a, void* eigenvals, size_t size, size_t batch, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_eigenvals_ops_kernel((T*)a, (T*)eigenvals, size, batch);
+  });
+}
+
+void eig_parts_ops(void* a, void* wr, void* wi, int n, size_t batch, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    eig_pairs_ops_kernel((T*)a, (T*)wr, (T*)wi, (T*)NULL, n, batch);
+  });
+}
+
+void eig_pairs_ops(void* a, void* wr, void* wi, void* v, int n, size_t batch, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    eig_pairs_ops_kernel((T*)a, (T*)wr, (T*)wi, (T*)v, n, batch);
+  });
+}
+
+void eigh_pairs_ops(void* a, void* w, void* z, int n, size_t batch, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    eigh_pairs_ops_kernel((T*)a, (T*)w, (T*)z, n, batch);
+  });
+}
+
+void eigenvecs_ops_array(void* a, void* eigenvecs, size_t size, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    eigenvecs_ops_array_kernel((T*)a, (T*)eigenvecs, size);
+  });
+}
+
+void batched_eigenvecs_ops(void* a, void* eigenvecs, size_t size, size_t batch, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_eigenvecs_ops_kernel((T*)a, (T*)eigenvecs, size, batch);
+  });
+}
+
+void eigenvals_h_ops_array(void* a, void* eigenvals, size_t size, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    eigenvals_h_ops_array_kernel((T*)a, (T*)eigenvals, size);
+  });
+}
+
+void batched_eigenvals_h_ops(void* a, void* eigenvals, size_t size, size_t batch, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_eigenvals_h_ops_kernel((T*)a, (T*)eigenvals, size, batch);
+  });
+}
+
+void eigenvecs_h_ops_array(void* a, void* eigenvecs, size_t size, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    eigenvecs_h_ops_array_kernel((T*)a, (T*)eigenvecs, size);
+  });
+}
+
+void batched_eigenvecs_h_ops(void* a, void* eigenvecs, size_t size, size_t batch, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_eigenvecs_h_ops_kernel((T*)a, (T*)eigenvecs, size, batch);
+  });
+}
+void svd_topk_ops(void* a, void* u, void* s, void* vt, int m, int n, int k, int iters, size_t batch, int64_t seed, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    svd_topk_ops_kernel((T*)a, (T*)u, (T*)s, (T*)vt, m, n, k, iters, batch, seed);
+  });
+}
+
+void eigh_topk_ops(void* a, void* w, void* z, int n, int k, size_t batch, int64_t seed, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    eigh_topk_ops_kernel((T*)a, (T*)w, (T*)z, n, k, batch, seed);
+  });
+}
@@ -2,24 +2,39 @@
 #define __OPS_DECOMP__H__
 
 #include <stddef.h>
+#include <stdint.h>
+#include "../core/dtype.h"
 
+// float32/float64 kernels, `dtype` is the dtype of every float buffer
 extern "C" {
-  void svd_ops(float* a, float* u, float* s, float* vt, int* shape);
-  void batched_svd_ops(float* a, float* u, float* s, float* vt, int* shape, int ndim);
-  void chol_ops(float* a, float* l, int* shape);
-  void batched_chol_ops(float* a, float* l, int* shape, int ndim);
-  void qr_decomp_ops(float* a, float* q, float* r, int* shape);
-  void batched_qr_decomp_ops(float* a, float* q, float* r, int* shape, int ndim);
-  void lu_decomp_ops(float* a, float* l, float* u, int* p, int* shape);
-  void batched_lu_decomp_ops(float* a, float* l, float* u, int* p, int* shape, int ndim);
-  void eigenvals_ops_array(float* a, float* eigenvals, size_t size);
-  void batched_eigenvals_ops(float* a, float* eigenvals, size_t size, size_t batch);
-  void eigenvecs_ops_array(float* a, float* eigenvecs, size_t size);
-  void batched_eigenvecs_ops(float* a, float* eigenvecs, size_t size, size_t batch);
-  void eigenvals_h_ops_array(float* a, float* eigenvals, size_t size);
-  void batched_eigenvals_h_ops(float* a, float* eigenvals, size_t size, size_t batch);
-  void eigenvecs_h_ops_array(float* a, float* eigenvecs, size_t size);
-  void batched_eigenvecs_h_ops(float* a, float* eigenvecs, size_t size, size_t batch);
+  void svd_ops(void* a, void* u, void* s, void* vt, int* shape, int full, dtype_t dtype);   // u & vt NULL for values only
+  void batched_svd_ops(void* a, void* u, void* s, void* vt, int* shape, int ndim, int full, dtype_t dtype);
+  void chol_ops(void* a, void* l, int* shape, dtype_t dtype);
+  void batched_chol_ops(void* a, void* l, int* shape, int ndim, dtype_t dtype);
+  // `reduced` gives the economy m x k q & k x n r (k = min(m, n)) instead of m x m & m x n
+  void qr_decomp_ops(void* a, void* q, void* r, int* shape, int reduced, dtype_t dtype);
+  void batched_qr_decomp_ops(void* a, void* q, void* r, int* shape, int ndim, int reduced, dtype_t dtype);
+  void lu_decomp_ops(void* a, void* l, void* u, int* p, int* shape, dtype_t dtype);
+  void batched_lu_decomp_ops(void* a, void* l, void* u, int* p, int* shape, int ndim, dtype_t dtype);
+  // `batch` n x n matrices factored for reuse: packed getrf factors & pivots, or the lower cholesky factor
+  void lu_factor_ops(void* a, void* lu, int* piv, int n, size_t batch, dtype_t dtype);
+  void cho_factor_ops(void* a, void* l, int n, size_t batch, dtype_t dtype);
+  void eigenvals_ops_array(void* a, void* eigenvals, size_t size, dtype_t dtype);
+  void batched_eigenvals_ops(void* a, void* eigenvals, size_t size, size_t batch, dtype_t dtype);
+  void eig_parts_ops(void* a, void* wr, void* wi, int n, size_t batch, dtype_t dtype);   // real & imaginary parts of the eigenvalues
+  // eigenvalues & eigenvectors of `batch` matrices from a single solve each, wi NULL drops the imaginary parts
+  void eig_pairs_ops(void* a, void* wr, void* wi, void* v, int n, size_t batch, dtype_t dtype);
+  void eigh_pairs_ops(void* a, void* w, void* z, int n, size_t batch, dtype_t dtype);
+  void eigenvecs_ops_array(void* a, void* eigenvecs, size_t size, dtype_t dtype);
+  void batched_eigenvecs_ops(void* a, void* eigenvecs, size_t size, size_t batch, dtype_t dtype);
+  void eigenvals_h_ops_array(void* a, void* eigenvals, size_t size, dtype_t dtype);
+  void batched_eigenvals_h_ops(void* a, void* eigenvals, size_t size, size_t batch, dtype_t dtype);
+  void eigenvecs_h_ops_array(void* a, void* eigenvecs, size_t size, dtype_t dtype);
+  void batched_eigenvecs_h_ops(void* a, void* eigenvecs, size_t size, size_t batch, dtype_t dtype);
+  // leading k singular triplets (randomized range finder, `iters` power steps) & the k eigenpairs of largest
+  // magnitude (thick restart lanczos) of `batch` matrices; seed < 0 draws from the global rng, u/vt/z NULL for values only
+  void svd_topk_ops(void* a, void* u, void* s, void* vt, int m, int n, int k, int iters, size_t batch, int64_t seed, dtype_t dtype);
+  void eigh_topk_ops(void* a, void* w, void* z, int n, int k, size_t batch, int64_t seed, dtype_t dtype);
 }
 
 #endif  //!__OPS_DECOMP__H__
\ No newline at end of file
@@ -1,193 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <atomic>
 #include "ops_matrix.h"
+#include "../core/dispatch.h"
+#include "factor.h"
+#include "parallel.h"
+#include "simd.h"
 
-void det_ops_array(float* a, float* out, size_t size) {
-  float det = 1.0f;
-  float* temp = (float*)malloc(size * size * sizeof(float));
-  if (!temp) { *out = 0.0f; return; }
-  for (size_t i = 0; i < size * size; ++i) temp[i] = a[i];
-  for (size_t i = 0; i < size; ++i) {   // gaussian elimination with partial pivoting
-    // finding pivot
-    size_t pivot_row = i;
-    float max_val = fabsf(temp[i * size + i]);
-    for (size_t row = i + 1; row < size; ++row) {
-      float val = fabsf(temp[row * size + i]);
-      if (val > max_val) { max_val = val; pivot_row = row; }
-    }
-    // swapping rows if needed
-    if (pivot_row != i) {
-      for (size_t col = 0; col < size; ++col) {
-        float tmp = temp[i * size + col];
-        temp[i * size + col] = temp[pivot_row * size + col];
-        temp[pivot_row * size + col] = tmp;
-      }
-      det = -det; // row swap changes sign
-    }
-    float pivot = temp[i * size + i];
-    if (fabsf(pivot) < 1e-6f) { det = 0.0f; break; }
-    det *= pivot;
-    // eliminating column
-    for (size_t j = i + 1; j < size; ++j) {
-      float factor = temp[j * size + i] / pivot;
-      for (size_t k = i; k < size; ++k) temp[j * size + k] -= factor * temp[i * size + k];
-    }
+// lu copy of the n x n a & its pivots, the caller frees both
+template <typename T> static T* lu_factor_copy(const T* a, int n, int** piv, int* info) {
+  T* lu = (T*)malloc((size_t)n * n * sizeof(T));
+  *piv = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+  if (lu == NULL || *piv == NULL) {
+    fprintf(stderr, "Memory allocation failed for lu factors\n");
+    exit(EXIT_FAILURE);
   }
-  free(temp);
-  *out = det;
+  memcpy(lu, a, (size_t)n * n * sizeof(T));
+  *info = getrf(n, lu, n, *piv);
+  return lu;
 }
 
-void batched_det_ops(float* a, float* out, size_t size, size_t batch) {
-  size_t mat_size = size * size;
-  for (size_t b = 0; b < batch; ++b) {
-    float* mat = &a[b * mat_size];
-    det_ops_array(mat, &out[b], size);
-  }
+// out[n x nrhs] = a^-1 b, returns the getrf info so callers decide what a singular a means
+template <typename T> static int lu_solve(const T* a, const T* b, T* out, int n, int nrhs) {
+  int *piv, info;
+  T* lu = lu_factor_copy(a, n, &piv, &info);
+  memcpy(out, b, (size_t)n * nrhs * sizeof(T));
+  getrs(n, nrhs, lu, n, piv, out, nrhs);
+  free(lu); free(piv);
+  return info;
 }
 
-void inv_ops(float* a, float* out, int* shape) {
-  int n = shape[0];
-  int size = n * n; 
-  memcpy(out, a, size * sizeof(float));
-  float* temp = (float*)malloc(n * n * 2 * sizeof(float));
-  for (int i = 0; i < n; i++) {
-    for (int j = 0; j < n; j++) {
-      temp[i * n * 2 + j] = out[i * n + j];
-      temp[i * n * 2 + j + n] = (i == j) ? 1.0f : 0.0f;
-    }
+template <typename T> static void det_ops_array_kernel(T* a, T* out, size_t size) {
+  int n = (int)size, *piv, info;
+  T* lu = lu_factor_copy(a, n, &piv, &info);
+  T det = 1;
+  for (int k = 0; k < n; k++) {
+    det *= lu[k * n + k];
+    if (piv[k] != k) det = -det;   // every row swap flips the sign
   }
+  free(lu); free(piv);
+  *out = det;
+}
 
-  for (int i = 0; i < n; i++) {
-    int pivot = i;
-    for (int k = i + 1; k < n; k++) {
-      if (fabs(temp[k * n * 2 + i]) > fabs(temp[pivot * n * 2 + i])) pivot = k;
-    }
+// tiny matrices skip the general routines: the batch goes through the vector kernels, one matrix per
+// lane, in SIMD_SMALL_BLOCK runs; false on the scalar level or past SIMD_SMALL_MAX, *singular gets
+// 1 + the first matrix that hit a zero pivot
+template <typename T> static bool small_batched(int op, int n, int nrhs, const T* a, const T* b, T* out, size_t batch, size_t* singular) {
+  const SimdKernels* k = simd_kernels();
+  if (k == NULL || n < 2 || n > SIMD_SMALL_MAX) return false;
+  size_t a_size = (size_t)n * n, b_size = (size_t)n * nrhs, out_size = (op == SIMD_SMALL_DET) ? 1 : (op == SIMD_SMALL_INV) ? a_size : b_size;
+  size_t grain = parallel_grain(a_size * n);
+  grain = (grain + SIMD_SMALL_BLOCK - 1) / SIMD_SMALL_BLOCK * SIMD_SMALL_BLOCK;
+  std::atomic<size_t> first{0};   // 1 + the lowest singular index over all slices, 0 while none
+  parallel_for(batch, grain, [&](size_t lo, size_t hi) {
+    size_t s = simd_small_batch(k, op, n, nrhs, a + lo * a_size, b ? b + lo * b_size : NULL, out + lo * out_size, hi - lo);
+    if (!s) return;
+    size_t cur = first.load(std::memory_order_relaxed);
+    while ((cur == 0 || lo + s < cur) && !first.compare_exchange_weak(cur, lo + s, std::memory_order_relaxed)) {}
+  });
+  *singular = first.load();
+  return true;
+}
 
-    if (pivot != i) {
-      for (int j = 0; j < n * 2; j++) {
-        float t = temp[i * n * 2 + j];
-        temp[i * n * 2 + j] = temp[pivot * n * 2 + j];
-        temp[pivot * n * 2 + j] = t;
-      }
+template <typename T> static void batched_det_ops_kernel(T* a, T* out, size_t size, size_t batch) {
+  size_t mat_size = size * size, singular;
+  if (small_batched(SIMD_SMALL_DET, (int)size, 0, a, (T*)NULL, out, batch, &singular)) return;
+  parallel_for(batch, parallel_grain(mat_size * size), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; ++b) {
+      T* mat = &a[b * mat_size];
+      det_ops_array_kernel(mat, &out[b], size);
     }
+  });
+}
 
-    float diag = temp[i * n * 2 + i];
-    for (int j = 0; j < n * 2; j++) temp[i * n * 2 + j] /= diag;
-    for (int k = 0; k < n; k++) {
-      if (k != i) {
-        float factor = temp[k * n * 2 + i];
-        for (int j = 0; j < n * 2; j++) temp[k * n * 2 + j] -= factor * temp[i * n * 2 + j];
-      }
-    }
-  }
-  
-  for (int i = 0; i < n; i++) {
-    for (int j = 0; j < n; j++) out[i * n + j] = temp[i * n * 2 + j + n];
+template <typename T> static void inv_ops_kernel(T* a, T* out, int* shape) {
+  int n = shape[0], *piv, info;
+  T* lu = lu_factor_copy(a, n, &piv, &info);
+  if (info) {
+    fprintf(stderr, "Matrix is singular and can't be inverted, U[%d][%d] == 0\n", info - 1, info - 1);
+    exit(EXIT_FAILURE);
   }
-
-  free(temp);
+  memset(out, 0, (size_t)n * n * sizeof(T));
+  for (int i = 0; i < n; i++) out[i * n + i] = 1;
+  getrs(n, n, lu, n, piv, out, n);
+  free(lu); free(piv);
 }
 
-void batched_inv_ops(float* a, float* out, int* shape, int ndim) {
+template <typename T> static void batched_inv_ops_kernel(T* a, T* out, int* shape, int ndim) {
   if (ndim < 2) return;  
   int batch_size = 1;
   for (int i = 0; i < ndim - 2; i++) batch_size *= shape[i];
   int matrix_size = shape[ndim - 2] * shape[ndim - 1];
   int matrix_shape[2] = {shape[ndim - 2], shape[ndim - 1]};
+  size_t singular;
+  if (small_batched(SIMD_SMALL_INV, shape[ndim - 1], 0, a, (T*)NULL, out, batch_size, &singular)) {
+    // the general path reports which pivot vanished
+    if (singular) inv_ops_kernel(a + (singular - 1) * matrix_size, out, matrix_shape);
+    return;
+  }
 
-  for (int b = 0; b < batch_size; b++) inv_ops(a + b * matrix_size, out + b * matrix_size, matrix_shape);
+  parallel_for(batch_size, parallel_grain((size_t)matrix_size * shape[ndim - 1]), [&](size_t lo, size_t hi) {
+    for (size_t b = lo; b < hi; b++) inv_ops_kernel(a + b * matrix_size, out + b * matrix_size, matrix_shape);
+  });
 }
 
-void solve_ops(float* a, float* b, float* out, int* shape_a, int* shape_b) {
-  int n = shape_a[0];
-  int nrhs = (shape_b[1] > 0) ? shape_b[1] : 1;
-  float *temp_a = (float*)malloc(n * n * sizeof(float)), *temp_b = (float*)malloc(n * nrhs * sizeof(float));
-  memcpy(temp_a, a, n * n * sizeof(float));
-  memcpy(temp_b, b, n * nrhs * sizeof(float));
-  int* piv = (int*)malloc(n * sizeof(int));
-  for (int i = 0; i < n; i++) {
-    int pivot = i;
-    for (int k = i + 1; k < n; k++) {
-      if (fabs(temp_a[k * n + i]) > fabs(temp_a[pivot * n + i])) pivot = k;
-    }
-    piv[i] = pivot;
-
-    if (pivot != i) {
-      for (int j = 0; j < n; j++) {
-        float t = temp_a[i * n + j];
-        temp_a[i * n + j] = temp_a[pivot * n + j];
-        temp_a[pivot * n + j] = t;
-      }
-      for (int j = 0; j < nrhs; j++) {
-        float t = temp_b[i * nrhs + j];
-        temp_b[i * nrhs + j] = temp_b[pivot * nrhs + j];
-        temp_b[pivot * nrhs + j] = t;
-      }
-    }
-    
-    for (int k = i + 1; k < n; k++) {
-      float factor = temp_a[k * n + i] / temp_a[i * n + i];
-      for (int j = i + 1; j < n; j++) temp_a[k * n + j] -= factor * temp_a[i * n + j];
-      for (int j = 0; j < nrhs; j++) temp_b[k * nrhs + j] -= factor * temp_b[i * nrhs + j];
-    }
+template <typename T> static void solve_ops_kernel(T* a, T* b, T* out, int* shape_a, int* shape_b) {
+  int n = shape_a[0], nrhs = (shape_b[1] > 0) ? shape_b[1] : 1;
+  if (lu_solve(a, b, out, n, nrhs)) {
+    fprintf(stderr, "Matrix 'a' is singular, solve() has no unique solution\n");
+    exit(EXIT_FAILURE);
   }
-  
-  for (int j = 0; j < nrhs; j++) {
-    for (int i = n - 1; i >= 0; i--) {
-      float sum = temp_b[i * nrhs + j];
-      for (int k = i + 1; k < n; k++) sum -= temp_a[i * n + k] * out[k * nrhs + j];
-      out[i * nrhs + j] = sum / temp_a[i * n + i];
-    }
-  }
-  
-  free(temp_a);
-  free(temp_b);
-  free(piv);
 }
 
-void batched_solve_ops(float* a, float* b, float* out, int* shape_a, int* shape_b, int ndim) {
+template <typename T> static void batched_solve_ops_kernel(T* a, T* b, T* out, int* shape_a, int* shape_b, int ndim) {
   if (ndim < 2) return;
   int batch_size = 1;
   for (int i = 0; i < ndim - 2; i++) batch_size *= shape_a[i];
   int matrix_size_a = shape_a[ndim - 2] * shape_a[ndim - 1], matrix_size_b = shape_b[ndim - 2] * shape_b[ndim - 1];
   int matrix_shape_a[2] = {shape_a[ndim - 2], shape_a[ndim - 1]}, matrix_shape_b[2] = {shape_b[ndim - 2], shape_b[ndim - 1]};
-  for (int batch = 0; batch < batch_size; batch++) solve_ops(a + batch * matrix_size_a, b + batch * matrix_size_b, out + batch * matrix_size_b, matrix_shape_a, matrix_shape_b);
-}
-
-void lstsq_ops(float* a, float* b, float* out, int* shape_a, int* shape_b) {
-  int m = shape_a[0];
-  int n = shape_a[1];
-  int nrhs = (shape_b[1] > 0) ? shape_b[1] : 1;
-  
-  float* at = (float*)malloc(n * m * sizeof(float));
-  float* ata = (float*)malloc(n * n * sizeof(float));
-  float* atb = (float*)malloc(n * nrhs * sizeof(float));
-  for (int i = 0; i < m; i++) {
-    for (int j = 0; j < n; j++) at[j * m + i] = a[i * n + j];
-  }
-  for (int i = 0; i < n; i++) {
-    for (int j = 0; j < n; j++) {
-      float sum = 0.0f;
-      for (int k = 0; k < m; k++) sum += at[i * m + k] * a[k * n + j];
-      ata[i * n + j] = sum;
+  size_t singular;
+  if (small_batched(SIMD_SMALL_SOLVE, shape_a[ndim - 1], shape_b[ndim - 1], a, b, out, batch_size, &singular)) {
+    if (singular) {
+      fprintf(stderr, "Matrix 'a' is singular, solve() has no unique solution\n");
+      exit(EXIT_FAILURE);
     }
+    return;
   }
-  for (int i = 0; i < n; i++) {
-    for (int j = 0; j < nrhs; j++) {
-      float sum = 0.0f;
-      for (int k = 0; k < m; k++) sum += at[i * m + k] * b[k * nrhs + j];
-      atb[i * nrhs + j] = sum;
+  parallel_for(batch_size, parallel_grain((size_t)matrix_size_a * shape_a[ndim - 1]), [&](size_t lo, size_t hi) {
+    for (size_t batch = lo; batch < hi; batch++) solve_ops_kernel(a + batch * matrix_size_a, b + batch * matrix_size_b, out + batch * matrix_size_b, matrix_shape_a, matrix_shape_b);
+  });
+}
+
+// least squares through householder qr, never a^T a: x = R^-1 (Q^T b)[:n] for a tall a, the minimum
+// norm x = Q [R^-T b; 0] from a^T = Q R for a wide one
+template <typename T> static void lstsq_ops_kernel(T* a, T* b, T* out, int* shape_a, int* shape_b) {
+  int m = shape_a[0], n = shape_a[1], nrhs = (shape_b[1] > 0) ? shape_b[1] : 1, k = (m < n) ? m : n;
+  T* work = (T*)malloc(((size_t)m * n + k + (size_t)m * nrhs + 1) * sizeof(T));
+  if (work == NULL) {
+    fprintf(stderr, "Memory allocation failed for lstsq factors\n");
+    exit(EXIT_FAILURE);
+  }
+  T *tau = work + (size_t)m * n, *qb = tau + k;
+  if (m >= n) {
+    memcpy(work, a, (size_t)m * n * sizeof(T));
+    geqrf(m, n, work, n, tau);
+    memcpy(qb, b, (size_t)m * nrhs * sizeof(T));
+    ormqr(1, m, nrhs, n, work, n, tau, qb, nrhs);
+    trsm(0, 0, 0, n, nrhs, work, n, qb, nrhs);
+    memcpy(out, qb, (size_t)n * nrhs * sizeof(T));
+  } else {
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < n; j++) work[j * m + i] = a[i * n + j];
     }
+    geqrf(n, m, work, m, tau);
+    memcpy(out, b, (size_t)m * nrhs * sizeof(T));
+    memset(out + (size_t)m * nrhs, 0, (size_t)(n - m) * nrhs * sizeof(T));
+    trsm(0, 1, 0, m, nrhs, work, m, out, nrhs);
+    ormqr(0, n, nrhs, m, work, m, tau, out, nrhs);
   }
-
-  int shape_ata[2] = {n, n}, shape_atb[2] = {n, nrhs};
-  solve_ops(ata, atb, out, shape_ata, shape_atb);
-  free(at);
-  free(ata);
-  free(atb);
+  free(work);
 }
 
-void batched_lstsq_ops(float* a, float* b, float* out, int* shape_a, int* shape_b, int ndim) {
+template <typename T> static void batched_lstsq_ops_kernel(T* a, T* b, T* out, int* shape_a, int* shape_b, int ndim) {
   if (ndim < 2) return;
 
   int batch_size = 1;
@@ -195,5 +171,119 @@ void batched_lstsq_ops(float* a, float* b, float* out, int* shape_a, int* shape_
   int matrix_size_a = shape_a[ndim - 2] * shape_a[ndim - 1], matrix_size_b = shape_b[ndim - 2] * shape_b[ndim - 1];
   int output_size = shape_a[ndim - 1] * shape_b[ndim - 1];
   int matrix_shape_a[2] = {shape_a[ndim - 2], shape_a[ndim - 1]}, matrix_shape_b[2] = {shape_b[ndim - 2], shape_b[ndim - 1]};
-  for (int batch = 0; batch < batch_size; batch++) lstsq_ops(a + batch * matrix_size_a, b + batch * matrix_size_b, out + batch * output_size, matrix_shape_a, matrix_shape_b);
-}
\ No newline at end of file
+  parallel_for(batch_size, parallel_grain((size_t)matrix_size_a * shape_a[ndim - 1]), [&](size_t lo, size_t hi) {
+    for (size_t batch = lo; batch < hi; batch++) lstsq_ops_kernel(a + batch * matrix_size_a, b + batch * matrix_size_b, out + batch * output_size, matrix_shape_a, matrix_shape_b);
+  });
+}
+
+// `batch` right-hand sides of n x nrhs against `factors` factorizations, one shared by all when it's 1,
+// solve(f, x, cols, ldx) solves the n x cols x in place against factor f
+template <typename T, typename F> static void factor_solve(T* b, T* out, int n, int nrhs, size_t batch, size_t factors, const F& solve) {
+  size_t rhs_size = (size_t)n * nrhs;
+  if (factors == 1 && batch > 1) {
+    // many right-hand sides against one factor go side by side into one wide solve, so the
+    // triangular solves run through gemm updates instead of one narrow solve each
+    size_t width = batch * nrhs;
+    T* wide = (T*)malloc((rhs_size ? rhs_size : 1) * batch * sizeof(T));
+    if (wide == NULL) {
+      fprintf(stderr, "Memory allocation failed for right-hand sides\n");
+      exit(EXIT_FAILURE);
+    }
+    for (size_t t = 0; t < batch; t++) {
+      for (int i = 0; i < n; i++) memcpy(wide + i * width + t * nrhs, b + t * rhs_size + i * nrhs, nrhs * sizeof(T));
+    }
+    solve(0, wide, (int)width, (ptrdiff_t)width);
+    for (size_t t = 0; t < batch; t++) {
+      for (int i = 0; i < n; i++) memcpy(out + t * rhs_size + i * nrhs, wide + i * width + t * nrhs, nrhs * sizeof(T));
+    }
+    free(wide);
+    return;
+  }
+  memcpy(out, b, batch * rhs_size * sizeof(T));
+  parallel_for(batch, parallel_grain(rhs_size * n), [&](size_t lo, size_t hi) {
+    for (size_t t = lo; t < hi; t++) solve(factors == 1 ? 0 : t, out + t * rhs_size, nrhs, (ptrdiff_t)nrhs);
+  });
+}
+
+template <typename T> static void lu_solve_ops_kernel(T* lu, int* piv, T* b, T* out, int n, int nrhs, size_t batch, size_t factors) {
+  size_t matrix_size = (size_t)n * n;
+  factor_solve(b, out, n, nrhs, batch, factors, [&](size_t f, T* x, int cols, ptrdiff_t ldx) {
+    getrs(n, cols, lu + f * matrix_size, n, piv + f * n, x, ldx);
+  });
+}
+
+template <typename T> static void cho_solve_ops_kernel(T* l, T* b, T* out, int n, int nrhs, size_t batch, size_t factors) {
+  size_t matrix_size = (size_t)n * n;
+  factor_solve(b, out, n, nrhs, batch, factors, [&](size_t f, T* x, int cols, ptrdiff_t ldx) {
+    potrs(n, cols, l + f * matrix_size, n, x, ldx);
+  });
+}
+
+void det_ops_array(void* a, void* out, size_t size, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    det_ops_array_kernel((T*)a, (T*)out, size);
+  });
+}
+
+void batched_det_ops(void* a, void* out, size_t size, size_t batch, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_det_ops_kernel((T*)a, (T*)out, size, batch);
+  });
+}
+
+void inv_ops(void* a, void* out, int* shape, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    inv_ops_kernel((T*)a, (T*)out, shape);
+  });
+}
+
+void batched_inv_ops(void* a, void* out, int* shape, int ndim, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_inv_ops_kernel((T*)a, (T*)out, shape, ndim);
+  });
+}
+
+void solve_ops(void* a, void* b, void* out, int* shape_a, int* shape_b, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    solve_ops_kernel((T*)a, (T*)b, (T*)out, shape_a, shape_b);
+  });
+}
+
+void batched_solve_ops(void* a, void* b, void* out, int* shape_a, int* shape_b, int ndim, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_solve_ops_kernel((T*)a, (T*)b, (T*)out, shape_a, shape_b, ndim);
+  });
+}
+
+void lstsq_ops(void* a, void* b, void* out, int* shape_a, int* shape_b, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    lstsq_ops_kernel((T*)a, (T*)b, (T*)out, shape_a, shape_b);
+  });
+}
+
+void batched_lstsq_ops(void* a, void* b, void* out, int* shape_a, int* shape_b, int ndim, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    batched_lstsq_ops_kernel((T*)a, (T*)b, (T*)out, shape_a, shape_b, ndim);
+  });
+}
+void lu_solve_ops(void* lu, int* piv, void* b, void* out, int n, int nrhs, size_t batch, size_t factors, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    lu_solve_ops_kernel((T*)lu, piv, (T*)b, (T*)out, n, nrhs, batch, factors);
+  });
+}
+
+void cho_solve_ops(void* l, void* b, void* out, int n, int nrhs, size_t batch, size_t factors, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    cho_solve_ops_kernel((T*)l, (T*)b, (T*)out, n, nrhs, batch, factors);
+  });
+}
@@ -2,16 +2,21 @@
 #define __OPS_MATRIX__H__
 
 #include <stddef.h>
+#include "../core/dtype.h"
 
+// float32/float64 kernels, `dtype` is the dtype of every float buffer
 extern "C" {
-  void det_ops_array(float* a, float* out, size_t size);
-  void batched_det_ops(float* a, float* out, size_t size, size_t batch);
-  void inv_ops(float* a, float* out, int* shape);
-  void batched_inv_ops(float* a, float* out, int* shape, int ndim);
-  void solve_ops(float* a, float* b, float* out, int* shape_a, int* shape_b);
-  void batched_solve_ops(float* a, float* b, float* out, int* shape_a, int* shape_b, int ndim);
-  void lstsq_ops(float* a, float* b, float* out, int* shape_a, int* shape_b);
-  void batched_lstsq_ops(float* a, float* b, float* out, int* shape_a, int* shape_b, int ndim);
+  void det_ops_array(void* a, void* out, size_t size, dtype_t dtype);
+  void batched_det_ops(void* a, void* out, size_t size, size_t batch, dtype_t dtype);
+  void inv_ops(void* a, void* out, int* shape, dtype_t dtype);
+  void batched_inv_ops(void* a, void* out, int* shape, int ndim, dtype_t dtype);
+  void solve_ops(void* a, void* b, void* out, int* shape_a, int* shape_b, dtype_t dtype);
+  void batched_solve_ops(void* a, void* b, void* out, int* shape_a, int* shape_b, int ndim, dtype_t dtype);
+  void lstsq_ops(void* a, void* b, void* out, int* shape_a, int* shape_b, dtype_t dtype);
+  void batched_lstsq_ops(void* a, void* b, void* out, int* shape_a, int* shape_b, int ndim, dtype_t dtype);
+  // `batch` n x nrhs right-hand sides against factors from lu_factor_ops / cho_factor_ops, `factors` is 1 or `batch`
+  void lu_solve_ops(void* lu, int* piv, void* b, void* out, int n, int nrhs, size_t batch, size_t factors, dtype_t dtype);
+  void cho_solve_ops(void* l, void* b, void* out, int n, int nrhs, size_t batch, size_t factors, dtype_t dtype);
 }
 
 #endif
\ No newline at end of file
@@ -2,116 +2,91 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include "ops_norm.h"
 #include "ops_redux.h"
-#include "ops_binary.h"
-#include "ops_unary.h"
+#include "parallel.h"
+#include "../core/dispatch.h"
 
-void clip_array_ops(float* a, float* out, float max_val, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = (a[i] > max_val) ? max_val : ((a[i] < -max_val) ? -max_val : a[i]); } }
-void clamp_array_ops(float* a, float* out, float min_val, float max_val, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = (a[i] > max_val) ? max_val : ((a[i] < min_val) ? min_val : a[i]); } }
+// out = (a - shift) / scale, zeros when the scale collapses to 0
+template <typename T> static void shift_scale(const T* a, T* out, T shift, T scale, size_t size) {
+  parallel_for(size, PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+    if (scale == (T)0) { for (size_t i = begin; i < end; i++) out[i] = 0; }
+    else { for (size_t i = begin; i < end; i++) out[i] = (a[i] - shift) / scale; }
+  });
+}
 
-void mm_norm_array_ops(float* a, float* out, size_t size) {
-  float min_val = a[0], max_val = a[0];
-  for (size_t i = 1; i < size; i++) {
-    if (a[i] < min_val) min_val = a[i];
-    if (a[i] > max_val) max_val = a[i];
-  }
-  float range = max_val - min_val;
-  if (range == 0.0f) { for (size_t i = 0; i < size; i++) out[i] = 0.0f; }
-  else {
-    sub_scalar_ops(a, min_val, out, size);
-    div_scalar_ops(out, range, out, size);
+template <typename T> static void sort_values(T* temp, size_t size) {
+  for (size_t i = 0; i < size - 1; i++) {
+    for (size_t j = i + 1; j < size; j++) {
+      if (temp[i] > temp[j]) {
+        T swap = temp[i];
+        temp[i] = temp[j];
+        temp[j] = swap;
+      }
+    }
   }
 }
 
-void std_norm_array_ops(float* a, float* out, size_t size) {
-  float sum = 0.0f;
-  for (size_t i = 0; i < size; i++) sum += a[i];
-  float mean = sum / size;
-
-  float* temp = (float*)malloc(size * sizeof(float));
-  sub_scalar_ops(a, mean, temp, size);
-  mul_ops(temp, temp, temp, size);
-
-  float var_sum = 0.0f;
-  for (size_t i = 0; i < size; i++) var_sum += temp[i];
-  float std_dev = sqrtf(var_sum / size);
+template <typename T> static void clip_kernel(const T* a, T* out, T max_val, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = (a[i] > max_val) ? max_val : ((a[i] < -max_val) ? -max_val : a[i]); } }
+template <typename T> static void clamp_kernel(const T* a, T* out, T min_val, T max_val, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = (a[i] > max_val) ? max_val : ((a[i] < min_val) ? min_val : a[i]); } }
 
-  if (std_dev == 0.0f) { for (size_t i = 0; i < size; i++) out[i] = 0.0f; }
-  else {
-    sub_scalar_ops(a, mean, out, size);
-    div_scalar_ops(out, std_dev, out, size);
+template <typename T> static void mm_norm_kernel(const T* a, T* out, size_t size) {
+  T min_val = a[0], max_val = a[0];
+  for (size_t i = 1; i < size; i++) {
+    if (a[i] < min_val) min_val = a[i];
+    if (a[i] > max_val) max_val = a[i];
   }
-  free(temp);
+  shift_scale(a, out, min_val, max_val - min_val, size);
 }
 
-void rms_norm_array_ops(float* a, float* out, size_t size) {
-  float* temp = (float*)malloc(size * sizeof(float));
-  mul_ops(a, a, temp, size);
-
-  float sum = 0.0f;
-  for (size_t i = 0; i < size; i++) sum += temp[i];
-  float rms = sqrtf(sum / size);
-  if (rms == 0.0f) { for (size_t i = 0; i < size; i++) out[i] = 0.0f; }
-  else { div_scalar_ops(a, rms, out, size); }
-  free(temp);
+// mean & population std come from one parallel Welford/Chan pass of the reduction kernels
+template <typename T> static void std_norm_kernel(const T* a, T* out, size_t size, dtype_t dtype) {
+  T mean = 0, var = 0;
+  int shape[1] = {(int)size}, strides[1] = {1};
+  mean_var_array_ops((void*)a, &mean, &var, shape, strides, 1, NULL, 0, 0, dtype);
+  shift_scale(a, out, mean, (T)sqrt(var), size);
 }
 
-void l1_norm_array_ops(float* a, float* out, size_t size) {
-  float* temp = (float*)malloc(size * sizeof(float));
-  abs_array_ops(a, temp, size);
-  float sum = 0.0f;
-  for (size_t i = 0; i < size; i++) sum += temp[i];
-  if (sum == 0.0f) { for (size_t i = 0; i < size; i++) out[i] = 0.0f; }
-  else { div_scalar_ops(a, sum, out, size); }
-  free(temp);
+template <typename T> static void rms_norm_kernel(const T* a, T* out, size_t size) {
+  T sum = 0;
+  for (size_t i = 0; i < size; i++) sum += a[i] * a[i];
+  shift_scale(a, out, (T)0, (T)sqrt(sum / size), size);
 }
 
-void l2_norm_array_ops(float* a, float* out, size_t size) {
-  float* temp = (float*)malloc(size * sizeof(float));
-  mul_ops(a, a, temp, size);
+template <typename T> static void l1_norm_kernel(const T* a, T* out, size_t size) {
+  T sum = 0;
+  for (size_t i = 0; i < size; i++) sum += fabs(a[i]);
+  shift_scale(a, out, (T)0, sum, size);
+}
 
-  float sum = 0.0f;
-  for (size_t i = 0; i < size; i++) sum += temp[i];
-  float l2_norm = sqrtf(sum);
+template <typename T> static void l2_norm_kernel(const T* a, T* out, size_t size) {
+  T sum = 0;
+  for (size_t i = 0; i < size; i++) sum += a[i] * a[i];
+  shift_scale(a, out, (T)0, (T)sqrt(sum), size);
+}
 
-  if (l2_norm == 0.0f) { for (size_t i = 0; i < size; i++) out[i] = 0.0f; }
-  else { div_scalar_ops(a, l2_norm, out, size); }
+template <typename T> static void robust_norm_kernel(const T* a, T* out, size_t size) {
+  T* temp = (T*)malloc(size * sizeof(T));
+  for (size_t i = 0; i < size; i++) temp[i] = a[i];
+  sort_values(temp, size);
+  T median = (size % 2 == 0) ? (temp[size/2 - 1] + temp[size/2]) / 2 : temp[size/2];
+  for (size_t i = 0; i < size; i++) temp[i] = fabs(a[i] - median);
+  sort_values(temp, size);
+  T mad = (size % 2 == 0) ? (temp[size/2 - 1] + temp[size/2]) / 2 : temp[size/2];
+  shift_scale(a, out, median, mad, size);
   free(temp);
 }
 
-void unit_norm_array_ops(float* a, float* out, size_t size) { l2_norm_array_ops(a, out, size); }
-
-void robust_norm_array_ops(float* a, float* out, size_t size) {
-  float* temp = (float*)malloc(size * sizeof(float));
-  for (size_t i = 0; i < size; i++) temp[i] = a[i];  
-  for (size_t i = 0; i < size - 1; i++) {
-    for (size_t j = i + 1; j < size; j++) {
-      if (temp[i] > temp[j]) {
-        float swap = temp[i];
-        temp[i] = temp[j];
-        temp[j] = swap;
-      }
-    }
-  }
+#define NORM_DISPATCH(dtype, call) \
+  dispatch_float_dtype(dtype, [&](auto tag) { typedef typename decltype(tag)::type T; call; })
 
-  float median = (size % 2 == 0) ? (temp[size/2 - 1] + temp[size/2]) / 2.0f : temp[size/2];
-  sub_scalar_ops(a, median, temp, size);
-  abs_array_ops(temp, temp, size);
-  for (size_t i = 0; i < size - 1; i++) {
-    for (size_t j = i + 1; j < size; j++) {
-      if (temp[i] > temp[j]) {
-        float swap = temp[i];
-        temp[i] = temp[j];
-        temp[j] = swap;
-      }
-    }
-  }
-  float mad = (size % 2 == 0) ? (temp[size/2 - 1] + temp[size/2]) / 2.0f : temp[size/2];
-  if (mad == 0.0f) { for (size_t i = 0; i < size; i++) out[i] = 0.0f; }
-  else {
-    sub_scalar_ops(a, median, out, size);
-    div_scalar_ops(out, mad, out, size);
-  }
-  free(temp);
-}
\ No newline at end of file
+void clip_array_ops(void* a, void* out, float max_val, size_t size, dtype_t dtype) { NORM_DISPATCH(dtype, clip_kernel((const T*)a, (T*)out, (T)max_val, size)); }
+void clamp_array_ops(void* a, void* out, float min_val, float max_val, size_t size, dtype_t dtype) { NORM_DISPATCH(dtype, clamp_kernel((const T*)a, (T*)out, (T)min_val, (T)max_val, size)); }
+void mm_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype) { NORM_DISPATCH(dtype, mm_norm_kernel((const T*)a, (T*)out, size)); }
+void std_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype) { NORM_DISPATCH(dtype, std_norm_kernel((const T*)a, (T*)out, size, dtype)); }
+void rms_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype) { NORM_DISPATCH(dtype, rms_norm_kernel((const T*)a, (T*)out, size)); }
+void l1_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype) { NORM_DISPATCH(dtype, l1_norm_kernel((const T*)a, (T*)out, size)); }
+void l2_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype) { NORM_DISPATCH(dtype, l2_norm_kernel((const T*)a, (T*)out, size)); }
+void unit_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype) { l2_norm_array_ops(a, out, size, dtype); }
+void robust_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype) { NORM_DISPATCH(dtype, robust_norm_kernel((const T*)a, (T*)out, size)); }
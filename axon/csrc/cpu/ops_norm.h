@@ -2,17 +2,19 @@
 #define __OPS_NORM__H__
 
 #include <stddef.h>
+#include "../core/dtype.h"
 
+// float32/float64 kernels, `a` & `out` are both in `dtype`
 extern "C" {
-  void clip_array_ops(float* a, float* out, float max_val, size_t size);
-  void clamp_array_ops(float* a, float* out, float min_val, float max_val, size_t size);
-  void mm_norm_array_ops(float* a, float* out, size_t size);
-  void std_norm_array_ops(float* a, float* out, size_t size);
-  void rms_norm_array_ops(float* a, float* out, size_t size);
-  void l1_norm_array_ops(float* a, float* out, size_t size);
-  void l2_norm_array_ops(float* a, float* out, size_t size);
-  void unit_norm_array_ops(float* a, float* out, size_t size);
-  void robust_norm_array_ops(float* a, float* out, size_t size);
+  void clip_array_ops(void* a, void* out, float max_val, size_t size, dtype_t dtype);
+  void clamp_array_ops(void* a, void* out, float min_val, float max_val, size_t size, dtype_t dtype);
+  void mm_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype);
+  void std_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype);
+  void rms_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype);
+  void l1_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype);
+  void l2_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype);
+  void unit_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype);
+  void robust_norm_array_ops(void* a, void* out, size_t size, dtype_t dtype);
 }
 
 #endif  //!__OPS_NORM__H__
\ No newline at end of file
@@ -2,337 +2,569 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
 #include "ops_redux.h"
+#include "../core/dispatch.h"
+#include "../core/iterator.h"
+#include "parallel.h"
+#include "simd.h"
+#include "../core/allocator.h"
 
-void max_array_ops(float* a, float* out, size_t size, int* shape, int* strides, int* res_shape, int axis, int ndim) {
-  if (axis == -1) {
-    // global min - find minimum of all elements
-    float min_val = a[0];  // initialize with first element instead of INFINITY
-    for (int i = 1; i < size; i++) { min_val = fmax(min_val, a[i]); }
-    *out = min_val;
-  } else {
-    // axis-specific min
-    if (axis < 0 || axis >= ndim) {
-      printf("Invalid axis\n");
-      return;
-    }
-
-    // calculate output size (product of all dimensions except the axis dimension)
-    int out_size = 1;
-    for (int i = 0; i < ndim; i++) { if (i != axis) { out_size *= shape[i]; } }
-    for (int i = 0; i < out_size; i++) { out[i] = -INFINITY; } // initialize output tensor to positive infinity
-    // iterate through all elements in the input tensor
-    for (int i = 0; i < size; i++) {
-      // convert linear index to multi-dimensional coordinates
-      int coords[ndim];
-      int temp_i = i;
-      for (int d = ndim - 1; d >= 0; d--) {
-        coords[d] = temp_i % shape[d];
-        temp_i /= shape[d];
-      }
+// a reduction of `a` (read through shape & strides) over the dims flagged in `reduced`, every
+// output slot folds `count` elements & the `out_size` slots are laid out densely over the kept dims
+typedef struct Reduction {
+  void* a;
+  size_t elem_size;
+  int* shape;
+  int* strides;
+  int ndim;
+  bool reduced[ITER_MAX_DIMS];
+  size_t out_size;
+  size_t count;
+} Reduction;
 
-      // calculate output index by removing the axis dimension
-      int out_idx = 0;
-      int multiplier = 1;
-      for (int d = ndim - 1; d >= 0; d--) {
-        if (d != axis) {
-          out_idx += coords[d] * multiplier;
-          multiplier *= shape[d];
-        }
-      }      
-     out[out_idx] = fmax(out[out_idx], a[i]);
-    }
+// `axes` are already validated by the caller, naxes 0 reduces every dim
+static void reduction_init(Reduction* r, void* a, size_t elem_size, int* shape, int* strides, int ndim, int* axes, int naxes) {
+  if (ndim > ITER_MAX_DIMS) {
+    fprintf(stderr, "Reduction over %d dims is not supported\n", ndim);
+    exit(EXIT_FAILURE);
+  }
+  r->a = a;
+  r->elem_size = elem_size;
+  r->shape = shape;
+  r->strides = strides;
+  r->ndim = ndim;
+  for (int d = 0; d < ndim; d++) r->reduced[d] = (naxes == 0);
+  for (int k = 0; k < naxes; k++) r->reduced[axes[k]] = true;
+  r->out_size = 1;
+  r->count = 1;
+  for (int d = 0; d < ndim; d++) {
+    if (r->reduced[d]) r->count *= shape[d];
+    else r->out_size *= shape[d];
   }
 }
 
-void min_array_ops(float* a, float* out, size_t size, int* shape, int* strides, int* res_shape, int axis, int ndim) {
-  if (axis == -1) {
-    // global min - find minimum of all elements
-    float min_val = a[0];  // initialize with first element instead of INFINITY
-    for (int i = 1; i < size; i++) { min_val = fmin(min_val, a[i]); }
-    *out = min_val;
-  } else {
-    // axis-specific min
-    if (axis < 0 || axis >= ndim) {
-      printf("Invalid axis\n");
-      return;
-    }
+// iterator over the (possibly strided) input plus `nout` dense reduced buffers
+// the buffers get stride 0 along every reduced dim, so each input element lands on its output slot
+// `split` >= 0 narrows the iteration to [lo, hi) of that kept dim, the slice of the work one thread gets
+static void reduce_iter_init(NdIter* it, const Reduction* r, int nout, void** outs, size_t* out_sizes, int split = -1, int lo = 0, int hi = 0) {
+  if (nout + 1 > ITER_MAX_OPERANDS) {
+    fprintf(stderr, "Reduction with %d outputs is not supported\n", nout);
+    exit(EXIT_FAILURE);
+  }
+  int ndim = r->ndim;
+  int out_strides[ITER_MAX_DIMS];
+  int stride = 1;
+  for (int d = ndim - 1; d >= 0; d--) {
+    if (r->reduced[d]) { out_strides[d] = 0; continue; }
+    out_strides[d] = stride;
+    stride *= r->shape[d];
+  }
+  ptrdiff_t a_skip = 0, out_skip = 0;   // elements of `a` & of the outputs before the slice
+  if (split >= 0) {
+    a_skip = (ptrdiff_t)lo * r->strides[split];
+    out_skip = (ptrdiff_t)lo * out_strides[split];
+  }
 
-    // calculate output size (product of all dimensions except the axis dimension)
-    int out_size = 1;
-    for (int i = 0; i < ndim; i++) { if (i != axis) { out_size *= shape[i]; } }
-    for (int i = 0; i < out_size; i++) { out[i] = INFINITY; } // initialize output tensor to positive infinity
-    // iterate through all elements in the input tensor
-    for (int i = 0; i < size; i++) {
-      // convert linear index to multi-dimensional coordinates
-      int coords[ndim];
-      int temp_i = i;
-      for (int d = ndim - 1; d >= 0; d--) {
-        coords[d] = temp_i % shape[d];
-        temp_i /= shape[d];
-      }
+  // dims go outermost to innermost by input stride, so the inner loop runs along the dim that's
+  // dense in memory whichever axes are reduced & whatever the view's layout: along a reduced dim
+  // it folds a dense run into one slot, along a kept dim it folds it into a dense row of slots;
+  // reduced dims that end up next to each other in memory are merged by the iterator, so (0, 2)
+  // of a (n, c, h*w) batch is one sweep
+  int order[ITER_MAX_DIMS];
+  for (int d = 0; d < ndim; d++) {
+    int k = d;
+    for (; k > 0 && abs(r->strides[order[k - 1]]) < abs(r->strides[d]); k--) order[k] = order[k - 1];
+    order[k] = d;
+  }
+  int sorted_shape[ITER_MAX_DIMS], sorted_strides[ITER_MAX_DIMS], sorted_out[ITER_MAX_DIMS];
+  for (int k = 0; k < ndim; k++) {
+    int d = order[k];
+    sorted_shape[k] = (d == split) ? hi - lo : r->shape[d];
+    sorted_strides[k] = r->strides[d];
+    sorted_out[k] = out_strides[d];
+  }
 
-      // calculate output index by removing the axis dimension
-      int out_idx = 0;
-      int multiplier = 1;
-      for (int d = ndim - 1; d >= 0; d--) {
-        if (d != axis) {
-          out_idx += coords[d] * multiplier;
-          multiplier *= shape[d];
-        }
-      }      
-     out[out_idx] = fmin(out[out_idx], a[i]);
-    }
+  void* data[ITER_MAX_OPERANDS] = {(char*)r->a + a_skip * (ptrdiff_t)r->elem_size};
+  int* op_strides[ITER_MAX_OPERANDS] = {sorted_strides};
+  size_t elem_sizes[ITER_MAX_OPERANDS] = {r->elem_size};
+  for (int k = 0; k < nout; k++) {
+    data[k + 1] = (char*)outs[k] + out_skip * (ptrdiff_t)out_sizes[k];
+    op_strides[k + 1] = sorted_out;
+    elem_sizes[k + 1] = out_sizes[k];
   }
+  iter_init(it, nout + 1, data, op_strides, elem_sizes, sorted_shape, ndim);
 }
 
-void sum_array_ops(float* a, float* out, int* shape, int* strides, int size, int* res_shape, int axis, int ndim) {
-  if (axis == -1) {
-    // global sum - sum all elements
-    float sum = 0.0;
-    for (int i = 0; i < size; i++) { sum += a[i]; }
-    *out = sum;
-  } else {
-    // axis-specific sum
-    if (axis < 0 || axis >= ndim) {
-      printf("Invalid Axis\n");
-      return;
-    }
-    // calculate output size (product of all dimensions except the axis dimension)
-    int out_size = 1;
-    for (int i = 0; i < ndim; i++) { if (i != axis) { out_size *= shape[i]; } }
-    // initialize output tensor to zero
-    for (int i = 0; i < out_size; i++) { out[i] = 0.0; }
-    // iterate through all elements in the input tensor
-    for (int i = 0; i < size; i++) {
-      // convert linear index to multi-dimensional coordinates
-      int coords[ndim];
-      int temp_i = i;
-      for (int d = ndim - 1; d >= 0; d--) {
-        coords[d] = temp_i % shape[d];
-        temp_i /= shape[d];
-      }
-      int out_idx = 0;
-      int multiplier = 1;
-      for (int d = ndim - 1; d >= 0; d--) {
-        if (d != axis) {
-          out_idx += coords[d] * multiplier;
-          multiplier *= shape[d];
-        }
+// kept dim the threads split a reduction along (the longest one), -1 when every dim is reduced
+static int reduce_split_dim(const Reduction* r) {
+  int split = -1;
+  for (int d = 0; d < r->ndim; d++) {
+    if (r->reduced[d]) continue;
+    if (split < 0 || r->shape[d] > r->shape[split]) split = d;
+  }
+  return split;
+}
+
+// output slots per result: full reductions fold fixed size chunks into slots of their own, so the
+// association order (& the rounding) is the same for any thread count; axis reductions need one
+static size_t reduce_parts(const Reduction* r) {
+  if (reduce_split_dim(r) >= 0) return 1;
+  return r->count > PARALLEL_GRAIN ? (r->count + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN : 1;
+}
+
+// runs fold(NdIter*) over the whole reduction through the thread pool
+// axis reductions hand each thread a slice of the longest kept dim, so its outputs are its own;
+// full reductions run chunk c into slot c of every output (reduce_parts() slots), callers combine them
+template <typename Fold> static void reduce_run(const Reduction* r, int nout, void** outs, size_t* out_sizes, Fold fold) {
+  int split = reduce_split_dim(r);
+  if (split < 0) {
+    parallel_for(reduce_parts(r), 1, [&](size_t begin, size_t end) {
+      for (size_t c = begin; c < end; c++) {
+        void* slots[ITER_MAX_OPERANDS];
+        for (int k = 0; k < nout; k++) slots[k] = (char*)outs[k] + c * out_sizes[k];
+        NdIter it;
+        reduce_iter_init(&it, r, nout, slots, out_sizes);
+        iter_range(&it, c * PARALLEL_GRAIN, (c + 1) * PARALLEL_GRAIN);
+        fold(&it);
       }
-      out[out_idx] += a[i];
-    }
+    });
+    return;
   }
+  size_t row = (r->out_size / r->shape[split]) * r->count;   // elements per step along the split dim
+  size_t grain = (row > 0 && row < PARALLEL_GRAIN) ? (PARALLEL_GRAIN + row - 1) / row : 1;
+  parallel_for(r->shape[split], grain, [&](size_t lo, size_t hi) {
+    NdIter it;
+    reduce_iter_init(&it, r, nout, outs, out_sizes, split, (int)lo, (int)hi);
+    fold(&it);
+  });
 }
 
-void mean_array_ops(float* a, float* out, int* shape, int* strides, int size, int* res_shape, int axis, int ndim) {
-  if (axis == -1) {
-    float sum = 0.0;
-    for (int i = 0; i < size; i++) { sum += a[i]; }
-    *out = sum / size;
+// folds one inner loop of operand 0 (T) into operand 1 (A), keeping the accumulator in a register when it stays put
+// dense runs of float32/float64 go through the simd_redux_t `simd_op` kernels, other dense runs get
+// plain pointer loops the compiler can vectorize, strided ones the generic loops
+template <typename T, typename A, typename Op> static inline void reduce_inner(NdIter* it, int simd_op, Op op) {
+  char** p = it->ptrs;
+  ptrdiff_t* s = it->inner_strides;
+  size_t n = it->inner_size;
+  const bool dense = s[0] == (ptrdiff_t)sizeof(T);
+  if constexpr (std::is_floating_point<T>::value && std::is_same<T, A>::value) {
+    const SimdKernels* k = simd_kernels();
+    if (k != NULL && dense && s[1] == 0) { *(A*)p[1] = simd_reduce(k, simd_op, (const T*)p[0], n, *(A*)p[1]); return; }
+    if (k != NULL && dense && s[1] == (ptrdiff_t)sizeof(A)) { simd_fold(k, simd_op, (const T*)p[0], (A*)p[1], n); return; }
+  }
+  if (dense && s[1] == 0) {
+    const T* x = (const T*)p[0];
+    A acc = *(A*)p[1];
+    for (size_t i = 0; i < n; i++) { acc = op(acc, x[i]); }
+    *(A*)p[1] = acc;
+  } else if (dense && s[1] == (ptrdiff_t)sizeof(A)) {
+    const T* x = (const T*)p[0];
+    A* acc = (A*)p[1];
+    for (size_t i = 0; i < n; i++) { acc[i] = op(acc[i], x[i]); }
+  } else if (s[1] == 0) {
+    A acc = *(A*)p[1];
+    for (size_t i = 0; i < n; i++) { acc = op(acc, iter_at<T>(p[0], s[0], i)); }
+    *(A*)p[1] = acc;
   } else {
-    if (axis < 0 || axis >= ndim) {
-      printf("Invalid Axis\n");
-      return;
+    for (size_t i = 0; i < n; i++) {
+      A& acc = iter_at<A>(p[1], s[1], i);
+      acc = op(acc, iter_at<T>(p[0], s[0], i));
     }
-    int out_size = 1;
-    for (int i = 0; i < ndim; i++) { if (i != axis) { out_size *= shape[i]; } }
-    for (int i = 0; i < out_size; i++) { out[i] = 0.0; }
-    for (int i = 0; i < size; i++) {
-      int coords[ndim];
-      int temp_i = i;
-      for (int d = ndim - 1; d >= 0; d--) {
-        coords[d] = temp_i % shape[d];
-        temp_i /= shape[d];
-      }
-      int out_idx = 0;
-      int multiplier = 1;
-      for (int d = ndim - 1; d >= 0; d--) {
-        if (d != axis) {
-          out_idx += coords[d] * multiplier;
-          multiplier *= shape[d];
-        }
-      }
-      out[out_idx] += a[i];
-    }
-    int axis_size = shape[axis];
-    for (int i = 0; i < out_size; i++) { out[i] /= axis_size; }
   }
 }
 
-void var_array_ops(float* a, float* out, size_t size, int* shape, int* strides, int* res_shape, int axis, int ndim, int ddof) {
-  if (axis == -1) {
-    // global variance - calculate variance of all elements
-    float mean = 0.0;   // first pass: calculate mean
-    for (int i = 0; i < size; i++) { mean += a[i]; }
-    mean /= size;
-    float variance = 0.0;     // second pass: calculate variance
-    for (int i = 0; i < size; i++) {
-      float diff = a[i] - mean;
-      variance += diff * diff;
-    }
+template <typename T> static inline T max_value(T x, T y) {
+  if constexpr (std::is_floating_point<T>::value) { return fmax(x, y); }
+  else { return (x > y) ? x : y; }
+}
 
-    // divide by (N - ddof) for sample variance, or N for population variance
-    int denominator = size - ddof;
-    if (denominator <= 0) {
-      printf("Warning: ddof >= sample size, setting variance to 0\n");
-      *out = 0.0;
-    } else { *out = variance / denominator; }
-  } else {
-    // axis-specific variance
-    if (axis < 0 || axis >= ndim) {
-      printf("Invalid axis\n");
-      return;
-    }
-    // calculate output size (product of all dimensions except the axis dimension)
-    int out_size = 1;
-    for (int i = 0; i < ndim; i++) { if (i != axis) { out_size *= shape[i]; } }
-    int axis_size = shape[axis];
-    float* means = (float*)calloc(out_size, sizeof(float)); // initialize output tensors
-    if (means == NULL) {
-      printf("Memory allocation failed for means\n");
-      return;
-    }
-    for (int i = 0; i < out_size; i++) { out[i] = 0.0; }
-    // first pass: calculate means for each output position
-    for (int i = 0; i < size; i++) {
-      // convert linear index to multi-dimensional coordinates
-      int coords[ndim];
-      int temp_i = i;
-      for (int d = ndim - 1; d >= 0; d--) {
-        coords[d] = temp_i % shape[d];
-        temp_i /= shape[d];
-      }      
-      // calculate output index by removing the axis dimension
-      int out_idx = 0;
-      int multiplier = 1;
-      for (int d = ndim - 1; d >= 0; d--) {
-        if (d != axis) {
-          out_idx += coords[d] * multiplier;
-          multiplier *= shape[d];
-        }
-      }
-      means[out_idx] += a[i];       // accumulate sum for mean calculation
-    }
+template <typename T> static inline T min_value(T x, T y) {
+  if constexpr (std::is_floating_point<T>::value) { return fmin(x, y); }
+  else { return (x < y) ? x : y; }
+}
 
-    // divide by axis size to get means
-    for (int i = 0; i < out_size; i++) { means[i] /= axis_size; }
-    // second pass: calculate variance for each output position
-    for (int i = 0; i < size; i++) {
-      // convert linear index to multi-dimensional coordinates
-      int coords[ndim];
-      int temp_i = i;
-      for (int d = ndim - 1; d >= 0; d--) {
-        coords[d] = temp_i % shape[d];
-        temp_i /= shape[d];
-      }
+// lowest/highest value of T, used as identity of max/min along an axis
+template <typename T> static inline T lowest_value() {
+  if constexpr (std::is_floating_point<T>::value) { return -INFINITY; }
+  else { return std::numeric_limits<T>::lowest(); }
+}
 
-      int out_idx = 0, multiplier = 1;  // calculate output index by removing the axis dimension
-      for (int d = ndim - 1; d >= 0; d--) {
-        if (d != axis) {
-          out_idx += coords[d] * multiplier;
-          multiplier *= shape[d];
-        }
-      }
-      float diff = a[i] - means[out_idx]; // accumulate squared differences
-      out[out_idx] += diff * diff;
-    }
+template <typename T> static inline T highest_value() {
+  if constexpr (std::is_floating_point<T>::value) { return INFINITY; }
+  else { return std::numeric_limits<T>::max(); }
+}
 
-    // divide by (axis_size - ddof) to get final variance
-    int denominator = axis_size - ddof;
-    if (denominator <= 0) {
-      printf("Warning: ddof >= sample size, setting variance to 0\n");
-      for (int i = 0; i < out_size; i++) { out[i] = 0.0; }
-    }
-    else { for (int i = 0; i < out_size; i++) { out[i] /= denominator; } }
-    free(means);
+template <typename T, typename Op> static void extreme_kernel(const Reduction* r, T* out, T init, int simd_op, Op op) {
+  bool full = reduce_split_dim(r) < 0;
+  size_t parts = reduce_parts(r);
+  T* part = (parts > 1) ? (T*)pool_alloc(parts * sizeof(T)) : out;
+  if (part == NULL) {
+    printf("Memory allocation failed for partial results\n");
+    return;
+  }
+  // initialize with first element instead of +/-INFINITY for full reductions
+  for (size_t i = 0; i < r->out_size * parts; i++) { part[i] = full ? *(const T*)r->a : init; }
+
+  void* outs[1] = {part};
+  size_t out_sizes[1] = {sizeof(T)};
+  reduce_run(r, 1, outs, out_sizes, [&](NdIter* it) {
+    do { reduce_inner<T, T>(it, simd_op, op); } while (iter_next(it));
+  });
+  if (parts > 1) {
+    *out = part[0];
+    for (size_t c = 1; c < parts; c++) { *out = op(*out, part[c]); }
+    pool_free(part);
   }
 }
 
-void std_array_ops(float* a, float* out, size_t size, int* shape, int* strides, int* res_shape, int axis, int ndim, int ddof) {
-  if (axis == -1) {
-    // global standard deviation - calculate std of all elements
-    float mean = 0.0; // first pass: calculate mean
-    for (int i = 0; i < size; i++) { mean += a[i]; }
-    mean /= size;
-    float variance = 0.0; // second pass: calculate variance
-    for (int i = 0; i < size; i++) {
-      float diff = a[i] - mean;
-      variance += diff * diff;
-    }
+// set_sum_mode() may run while pool workers read it
+static std::atomic<int> sum_mode{SUM_PAIRWISE};
 
-    // divide by (N - ddof) for sample variance, or N for population variance
-    int denominator = size - ddof;
-    if (denominator <= 0) {
-      printf("Warning: ddof >= sample size, setting std to 0\n");
-      *out = 0.0; }
-    else { *out = sqrtf(variance / denominator); }
-  } else {
-    if (axis < 0 || axis >= ndim) { printf("Invalid axis\n"); return; } // axis-specific standard deviation
-    int out_size = 1; // calculate output size (product of all dimensions except the axis dimension)
-    for (int i = 0; i < ndim; i++) { if (i != axis) { out_size *= shape[i]; } }
-    int axis_size = shape[axis];
-    float* means = (float*)calloc(out_size, sizeof(float)); // initialize output tensors
-    if (means == NULL) {
-      printf("Memory allocation failed for means\n");
+int get_sum_mode() { return sum_mode.load(std::memory_order_relaxed); }
+
+int set_sum_mode(int mode) {
+  mode = (mode == SUM_KAHAN) ? SUM_KAHAN : SUM_PAIRWISE;
+  sum_mode.store(mode, std::memory_order_relaxed);
+  return mode;
+}
+
+// float sums: a dense run folding into one slot is summed pairwise, the other layouts add one
+// element per step like reduce_inner
+template <typename T, typename A> static inline void sum_inner(NdIter* it) {
+  if constexpr (std::is_floating_point<T>::value) {
+    if (it->inner_strides[0] == (ptrdiff_t)sizeof(T) && it->inner_strides[1] == 0) {
+      *(A*)it->ptrs[1] += pairwise_sum(simd_kernels(), (const T*)it->ptrs[0], (const T*)NULL, it->inner_size);
       return;
     }
+  }
+  reduce_inner<T, A>(it, SIMD_SUM, [](A x, T y) { return (A)(x + y); });
+}
+
+// SUM_PAIRWISE along an axis: the rows a slot adds one after another (every reduced dim but a dense
+// innermost one, which sum_inner already sums pairwise) are halved along the outermost reduced dim
+// until a slice holds at most PAIRWISE_BLOCK of them; slices fold into partial outputs of their own
+// & the partials add up as a tree, so a tall column's error grows with log(rows) as well
+template <typename T, typename A> static void sum_fold_pairwise(const Reduction* r, A* acc) {
+  int inner = -1, outer = -1;
+  for (int d = 0; d < r->ndim; d++) {
+    if (r->shape[d] > 1 && (inner < 0 || abs(r->strides[d]) < abs(r->strides[inner]))) inner = d;
+  }
+  size_t rows = r->count;
+  if (inner >= 0 && r->reduced[inner] && abs(r->strides[inner]) == 1) rows /= r->shape[inner];
+  for (int d = 0; d < r->ndim; d++) {
+    if (!r->reduced[d] || r->shape[d] < 2 || (d == inner && abs(r->strides[d]) == 1)) continue;
+    if (outer < 0 || abs(r->strides[d]) > abs(r->strides[outer])) outer = d;
+  }
+  if (rows <= PAIRWISE_BLOCK || outer < 0) {
+    void* outs[1] = {acc};
+    size_t out_sizes[1] = {sizeof(A)};
+    reduce_run(r, 1, outs, out_sizes, [](NdIter* it) {
+      do { sum_inner<T, A>(it); } while (iter_next(it));
+    });
+    return;
+  }
+  A* part = (A*)pool_alloc(r->out_size * sizeof(A));
+  if (part == NULL) {
+    printf("Memory allocation failed for partial sums\n");
+    return;
+  }
+  memset(part, 0, r->out_size * sizeof(A));
+  int shape[ITER_MAX_DIMS];
+  memcpy(shape, r->shape, r->ndim * sizeof(int));
+  Reduction half = *r;
+  int len = r->shape[outer], mid = len / 2;
+  half.shape = shape;
+  shape[outer] = mid;
+  half.count = r->count / len * mid;
+  sum_fold_pairwise<T, A>(&half, acc);
+  shape[outer] = len - mid;
+  half.count = r->count / len * (len - mid);
+  half.a = (char*)r->a + (ptrdiff_t)mid * r->strides[outer] * (ptrdiff_t)r->elem_size;
+  sum_fold_pairwise<T, A>(&half, part);
+  for (size_t i = 0; i < r->out_size; i++) { acc[i] += part[i]; }
+  pool_free(part);
+}
+
+// SUM_KAHAN: operands (x, sum, comp), every add's rounding error is kept in comp
+template <typename T> static inline void kahan_inner(NdIter* it) {
+  char** p = it->ptrs;
+  ptrdiff_t* s = it->inner_strides;
+  size_t n = it->inner_size;
+  const SimdKernels* k = simd_kernels();
+  const bool dense = s[0] == (ptrdiff_t)sizeof(T);
+  if (dense && s[1] == 0) { compensated_sum(k, (const T*)p[0], (const T*)NULL, n, (T*)p[1], (T*)p[2]); }
+  else if (dense && s[1] == (ptrdiff_t)sizeof(T)) { compensated_fold(k, (const T*)p[0], (T*)p[1], (T*)p[2], n); }
+  else {
+    T e;
+    for (size_t i = 0; i < n; i++) {
+      T& acc = iter_at<T>(p[1], s[1], i);
+      acc = two_sum(acc, iter_at<T>(p[0], s[0], i), &e);
+      iter_at<T>(p[2], s[2], i) += e;
+    }
+  }
+}
 
-    for (int i = 0; i < out_size; i++) { out[i] = 0.0; }
-    // first pass: calculate means for each output position
-    for (int i = 0; i < size; i++) {
-      // convert linear index to multi-dimensional coordinates
-      int coords[ndim];
-      int temp_i = i;
-      for (int d = ndim - 1; d >= 0; d--) {
-        coords[d] = temp_i % shape[d];
-        temp_i /= shape[d];
-      }
-      // calculate output index by removing the axis dimension
-      int out_idx = 0;
-      int multiplier = 1;
-      for (int d = ndim - 1; d >= 0; d--) {
-        if (d != axis) {
-          out_idx += coords[d] * multiplier;
-          multiplier *= shape[d];
-        }
+// sums in accum_type<T> (int64/uint64 for integers, exact), mean divides the accumulated sum by `count`
+// floats follow sum_mode: pairwise partial sums, or compensated sums with an error term per slot
+template <typename T> static void sum_kernel(const Reduction* r, T* out, bool mean) {
+  typedef typename accum_type<T>::type A;
+  const bool kahan = std::is_floating_point<T>::value && get_sum_mode() == SUM_KAHAN;
+  size_t parts = reduce_parts(r), len = r->out_size * parts;
+  A* acc = (A*)pool_alloc((kahan ? 2 : 1) * len * sizeof(A));
+  if (acc == NULL) {
+    printf("Memory allocation failed for accumulator\n");
+    return;
+  }
+  memset(acc, 0, (kahan ? 2 : 1) * len * sizeof(A));
+
+  void* outs[2] = {acc, acc + len};
+  size_t out_sizes[2] = {sizeof(A), sizeof(A)};
+  if constexpr (std::is_floating_point<T>::value) {
+    if (kahan) {
+      A* comp = acc + len;
+      reduce_run(r, 2, outs, out_sizes, [](NdIter* it) {
+        do { kahan_inner<A>(it); } while (iter_next(it));
+      });
+      A e;
+      for (size_t c = 1; c < parts; c++) {
+        acc[0] = two_sum(acc[0], acc[c], &e);
+        comp[0] += e + comp[c];
       }
-      // accumulate sum for mean calculation
-      means[out_idx] += a[i];
+      for (size_t i = 0; i < r->out_size; i++) { acc[i] += comp[i]; }
+    } else if (reduce_split_dim(r) >= 0) {
+      sum_fold_pairwise<T, A>(r, acc);
+    } else {
+      reduce_run(r, 1, outs, out_sizes, [](NdIter* it) {
+        do { sum_inner<T, A>(it); } while (iter_next(it));
+      });
+      if (parts > 1) acc[0] = pairwise_sum((const SimdKernels*)NULL, acc, (const A*)NULL, parts);
     }
+  } else {
+    reduce_run(r, 1, outs, out_sizes, [](NdIter* it) {
+      do { sum_inner<T, A>(it); } while (iter_next(it));
+    });
+    for (size_t c = 1; c < parts; c++) { acc[0] += acc[c]; }
+  }
 
-    // divide by axis size to get means
-    for (int i = 0; i < out_size; i++) { means[i] /= axis_size; }
-    // second pass: calculate variance for each output position
-    for (int i = 0; i < size; i++) {
-      // convert linear index to multi-dimensional coordinates
-      int coords[ndim];
-      int temp_i = i;
-      for (int d = ndim - 1; d >= 0; d--) {
-        coords[d] = temp_i % shape[d];
-        temp_i /= shape[d];
-      }
-      // calculate output index by removing the axis dimension
-      int out_idx = 0;
-      int multiplier = 1;
-      for (int d = ndim - 1; d >= 0; d--) {
-        if (d != axis) {
-          out_idx += coords[d] * multiplier;
-          multiplier *= shape[d];
-        }
+  double count = (double)r->count;
+  for (size_t i = 0; i < r->out_size; i++) { out[i] = mean ? convert_value<T>((double)acc[i] / count) : convert_value<T>(acc[i]); }
+  pool_free(acc);
+}
+
+#define MOMENTS_BLOCK 1024    // elements of a dense run summarized at a time before they're merged into a slot
+
+// Chan's update: folds (b_mean, b_m2) of `b_n` elements into the running (mean, m2) of `n` elements,
+// b_n = 1 with b_m2 = 0 is Welford's single element step
+static inline void moments_merge(double& mean, double& m2, size_t& n, double b_mean, double b_m2, size_t b_n) {
+  if (b_n == 0) return;
+  size_t total = n + b_n;
+  double delta = b_mean - mean;
+  mean += delta * ((double)b_n / (double)total);
+  m2 += b_m2 + delta * delta * ((double)n * (double)b_n / (double)total);
+  n = total;
+}
+
+// mean & centered sum of squares of a short dense run in compute_type<T>, two sweeps while it's still in L1
+template <typename T> static inline void block_moments(const T* x, size_t n, double* mean, double* m2) {
+  typedef typename compute_type<T>::type C;
+  C s[4] = {0, 0, 0, 0};
+  size_t i = 0;
+  if constexpr (std::is_same<T, C>::value) {
+    const SimdKernels* k = simd_kernels();
+    if (k != NULL) { s[0] = simd_reduce(k, SIMD_SUM, x, n, (C)0); i = n; }
+  }
+  for (; i + 4 <= n; i += 4) { for (int j = 0; j < 4; j++) s[j] += (C)x[i + j]; }
+  for (; i < n; i++) s[0] += (C)x[i];
+  C m = ((s[0] + s[1]) + (s[2] + s[3])) / (C)n;
+  C q[4] = {0, 0, 0, 0};
+  for (i = 0; i + 4 <= n; i += 4) {
+    for (int j = 0; j < 4; j++) { C d = (C)x[i + j] - m; q[j] += d * d; }
+  }
+  for (; i < n; i++) { C d = (C)x[i] - m; q[0] += d * d; }
+  *mean = (double)m;
+  *m2 = (double)((q[0] + q[1]) + (q[2] + q[3]));
+}
+
+// folds one inner loop of operand 0 (T) into the (mean, m2, count) slots of operands 1, 2 & 3
+// a run that stays on one slot is merged block by block; a run along a kept dim gives every slot one
+// element, & those slots have all been visited the same number of times (they differ only in the
+// innermost index), so the first slot's count is every slot's count & the update needs no division
+// running moments stay in double: a float32 Welford step loses ~eps * |mean| / std of the variance
+template <typename T> static inline void moments_inner(NdIter* it) {
+  char** p = it->ptrs;
+  ptrdiff_t* s = it->inner_strides;
+  size_t n = it->inner_size;
+  if (s[1] == 0) {
+    double mean = *(double*)p[1], m2 = *(double*)p[2];
+    size_t count = *(size_t*)p[3];
+    if (s[0] == (ptrdiff_t)sizeof(T)) {
+      const T* x = (const T*)p[0];
+      for (size_t i = 0; i < n; i += MOMENTS_BLOCK) {
+        size_t len = (n - i < MOMENTS_BLOCK) ? n - i : MOMENTS_BLOCK;
+        double b_mean, b_m2;
+        block_moments<T>(x + i, len, &b_mean, &b_m2);
+        moments_merge(mean, m2, count, b_mean, b_m2, len);
       }
-      // accumulate squared differences
-      float diff = a[i] - means[out_idx];
-      out[out_idx] += diff * diff;
+    } else {
+      for (size_t i = 0; i < n; i++) { moments_merge(mean, m2, count, (double)iter_at<T>(p[0], s[0], i), 0.0, 1); }
     }
-    // divide by (axis_size - ddof) and take square root to get final standard deviation
-    int denominator = axis_size - ddof;
-    if (denominator <= 0) {
-      printf("Warning: ddof >= sample size, setting std to 0\n");
-      for (int i = 0; i < out_size; i++) { out[i] = 0.0; }
+    *(double*)p[1] = mean;
+    *(double*)p[2] = m2;
+    *(size_t*)p[3] = count;
+    return;
+  }
+  size_t count = *(size_t*)p[3];
+  double inv = 1.0 / (double)(count + 1), scale = (double)count / (double)(count + 1);
+  if (s[0] == (ptrdiff_t)sizeof(T) && s[1] == (ptrdiff_t)sizeof(double)) {
+    const T* x = (const T*)p[0];
+    double* mean = (double*)p[1];
+    double* m2 = (double*)p[2];
+    for (size_t i = 0; i < n; i++) {
+      double delta = (double)x[i] - mean[i];
+      mean[i] += delta * inv;
+      m2[i] += delta * delta * scale;
     }
-    else { for (int i = 0; i < out_size; i++) { out[i] = sqrtf(out[i] / denominator); } }
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      double delta = (double)iter_at<T>(p[0], s[0], i) - iter_at<double>(p[1], s[1], i);
+      iter_at<double>(p[1], s[1], i) += delta * inv;
+      iter_at<double>(p[2], s[2], i) += delta * delta * scale;
+    }
+  }
+  for (size_t i = 0; i < n; i++) { iter_at<size_t>(p[3], s[3], i) = count + 1; }
+}
+
+// single pass mean & centered sum of squares of every output slot
+// each thread or chunk keeps its own partial moments, full reductions merge theirs in chunk order
+// so the result doesn't depend on the thread count
+template <typename T> static bool moments_kernel(const Reduction* r, double* mean, double* m2) {
+  size_t parts = reduce_parts(r), len = r->out_size * parts;
+  double* part_mean = (parts > 1) ? (double*)pool_alloc(2 * len * sizeof(double)) : mean;
+  double* part_m2 = (parts > 1) ? part_mean + len : m2;
+  size_t* counts = (size_t*)pool_alloc(len * sizeof(size_t));
+  if (part_mean == NULL || counts == NULL) {
+    printf("Memory allocation failed for moments\n");
+    if (parts > 1) pool_free(part_mean);
+    pool_free(counts);
+    return false;
+  }
+  memset(part_mean, 0, len * sizeof(double));
+  memset(part_m2, 0, len * sizeof(double));
+  memset(counts, 0, len * sizeof(size_t));
+
+  void* outs[3] = {part_mean, part_m2, counts};
+  size_t out_sizes[3] = {sizeof(double), sizeof(double), sizeof(size_t)};
+  reduce_run(r, 3, outs, out_sizes, [](NdIter* it) {
+    do { moments_inner<T>(it); } while (iter_next(it));
+  });
+  if (parts > 1) {
+    for (size_t c = 1; c < parts; c++) { moments_merge(part_mean[0], part_m2[0], counts[0], part_mean[c], part_m2[c], counts[c]); }
+    *mean = part_mean[0];
+    *m2 = part_m2[0];
+    pool_free(part_mean);
+  }
+  pool_free(counts);
+  return true;
+}
+
+// m2 / (count - ddof), zeros (with a warning) when ddof leaves no degrees of freedom
+template <typename O> static void moments_var(const Reduction* r, const double* m2, O* out, int ddof, bool take_sqrt) {
+  ptrdiff_t denominator = (ptrdiff_t)r->count - ddof;
+  if (denominator <= 0) {
+    printf("Warning: ddof >= sample size, setting %s to 0\n", take_sqrt ? "std" : "variance");
+    for (size_t i = 0; i < r->out_size; i++) { out[i] = (O)0; }
+  }
+  else { for (size_t i = 0; i < r->out_size; i++) { out[i] = (O)(take_sqrt ? sqrt(m2[i] / denominator) : m2[i] / denominator); } }
+}
 
-    free(means);
+// one pass variance (or std), written out as float32
+template <typename T> static void var_kernel(const Reduction* r, float* out, int ddof, bool take_sqrt) {
+  double* buf = (double*)pool_alloc(2 * r->out_size * sizeof(double));
+  if (buf == NULL) {
+    printf("Memory allocation failed for moments\n");
+    return;
   }
-}
\ No newline at end of file
+  if (moments_kernel<T>(r, buf, buf + r->out_size)) moments_var(r, buf + r->out_size, out, ddof, take_sqrt);
+  pool_free(buf);
+}
+
+// mean & variance from the same pass, both written in float_type<T>
+template <typename T> static void mean_var_kernel(const Reduction* r, void* mean, void* var, int ddof) {
+  typedef typename float_type<T>::type F;
+  double* buf = (double*)pool_alloc(2 * r->out_size * sizeof(double));
+  if (buf == NULL) {
+    printf("Memory allocation failed for moments\n");
+    return;
+  }
+  if (moments_kernel<T>(r, buf, buf + r->out_size)) {
+    for (size_t i = 0; i < r->out_size; i++) { ((F*)mean)[i] = (F)buf[i]; }
+    moments_var(r, buf + r->out_size, (F*)var, ddof, false);
+  }
+  pool_free(buf);
+}
+
+void max_array_ops(void* a, void* out, int* shape, int* strides, int ndim, int* axes, int naxes, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    Reduction r;
+    reduction_init(&r, a, sizeof(T), shape, strides, ndim, axes, naxes);
+    extreme_kernel(&r, (T*)out, lowest_value<T>(), SIMD_MAX, [](T x, T y) { return max_value(x, y); });
+  });
+}
+
+void min_array_ops(void* a, void* out, int* shape, int* strides, int ndim, int* axes, int naxes, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    Reduction r;
+    reduction_init(&r, a, sizeof(T), shape, strides, ndim, axes, naxes);
+    extreme_kernel(&r, (T*)out, highest_value<T>(), SIMD_MIN, [](T x, T y) { return min_value(x, y); });
+  });
+}
+
+void sum_array_ops(void* a, void* out, int* shape, int* strides, int ndim, int* axes, int naxes, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    Reduction r;
+    reduction_init(&r, a, sizeof(T), shape, strides, ndim, axes, naxes);
+    sum_kernel(&r, (T*)out, false);
+  });
+}
+
+void mean_array_ops(void* a, void* out, int* shape, int* strides, int ndim, int* axes, int naxes, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    Reduction r;
+    reduction_init(&r, a, sizeof(T), shape, strides, ndim, axes, naxes);
+    sum_kernel(&r, (T*)out, true);
+  });
+}
+
+void var_array_ops(void* a, float* out, int* shape, int* strides, int ndim, int* axes, int naxes, int ddof, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    Reduction r;
+    reduction_init(&r, a, sizeof(T), shape, strides, ndim, axes, naxes);
+    var_kernel<T>(&r, out, ddof, false);
+  });
+}
+
+void std_array_ops(void* a, float* out, int* shape, int* strides, int ndim, int* axes, int naxes, int ddof, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    Reduction r;
+    reduction_init(&r, a, sizeof(T), shape, strides, ndim, axes, naxes);
+    var_kernel<T>(&r, out, ddof, true);
+  });
+}
+
+void mean_var_array_ops(void* a, void* mean, void* var, int* shape, int* strides, int ndim, int* axes, int naxes, int ddof, dtype_t dtype) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    Reduction r;
+    reduction_init(&r, a, sizeof(T), shape, strides, ndim, axes, naxes);
+    mean_var_kernel<T>(&r, mean, var, ddof);
+  });
+}
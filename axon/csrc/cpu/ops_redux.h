@@ -7,14 +7,29 @@
 #define __OPS_REDUX__H__
 
 #include <stdlib.h>
+#include "../core/dtype.h"
+
+// sum/mean/max/min read & write `dtype`, var/std read `dtype` & always write float32, mean_var
+// writes both moments in float64 for float64 input & float32 otherwise; var/std/mean_var take one
+// numerically stable (Welford/Chan) pass over `a`
+// `a` is read through `shape` & `strides`, so strided views are reduced in place; the `naxes` dims
+// in `axes` (all of them for naxes 0, no repeats) are reduced in one sweep, outputs are dense over the rest
+// how float32/float64 sums, means & dot products (ops_array.h) add up: SUM_PAIRWISE sums blocks as a
+// balanced tree (error grows with log(n), about the speed of a plain loop), SUM_KAHAN carries every
+// rounding error in a compensation term (near exact totals, slower); integers always sum exactly in 64 bits
+typedef enum { SUM_PAIRWISE, SUM_KAHAN } sum_mode_t;
 
 extern "C" {
-  void sum_array_ops(float* a, float* out, int* shape, int* strides, int size, int* res_shape, int axis, int ndim);
-  void mean_array_ops(float* a, float* out, int* shape, int* strides, int size, int* res_shape, int axis, int ndim);
-  void max_array_ops(float* a, float* out, size_t size, int* shape, int* strides, int* res_shape, int axis, int ndim);
-  void min_array_ops(float* a, float* out, size_t size, int* shape, int* strides, int* res_shape, int axis, int ndim);
-  void var_array_ops(float* a, float* out, size_t size, int* shape, int* strides, int* res_shape, int axis, int ndim, int ddof);
-  void std_array_ops(float* a, float* out, size_t size, int* shape, int* strides, int* res_shape, int axis, int ndim, int ddof);
+  int get_sum_mode();
+  int set_sum_mode(int mode);   // returns the mode now in use
+
+  void sum_array_ops(void* a, void* out, int* shape, int* strides, int ndim, int* axes, int naxes, dtype_t dtype);
+  void mean_array_ops(void* a, void* out, int* shape, int* strides, int ndim, int* axes, int naxes, dtype_t dtype);
+  void max_array_ops(void* a, void* out, int* shape, int* strides, int ndim, int* axes, int naxes, dtype_t dtype);
+  void min_array_ops(void* a, void* out, int* shape, int* strides, int ndim, int* axes, int naxes, dtype_t dtype);
+  void var_array_ops(void* a, float* out, int* shape, int* strides, int ndim, int* axes, int naxes, int ddof, dtype_t dtype);
+  void std_array_ops(void* a, float* out, int* shape, int* strides, int ndim, int* axes, int naxes, int ddof, dtype_t dtype);
+  void mean_var_array_ops(void* a, void* mean, void* var, int* shape, int* strides, int ndim, int* axes, int naxes, int ddof, dtype_t dtype);
 }
 
 #endif  //!__RED_OPS__H__
\ No newline at end of file
@@ -2,27 +2,25 @@
 #define __OPS_SHAPE__H__
 
 #include <stdlib.h>
+#include "../core/dtype.h"
+#include "../core/iterator.h"
 
 extern "C" {
-  void reassign_array_ops(float* a, float* out, size_t size);
-  void equal_array_ops(float* a, float* b, float* out, size_t size);
-  void equal_scalar_ops(float* a, float b, float* out, size_t size);
-  void not_equal_array_ops(float* a, float* b, float* out, size_t size);
-  void not_equal_scalar_ops(float* a, float b, float* out, size_t size);
-  void greater_array_ops(float* a, float* b, float* out, size_t size);
-  void greater_scalar_ops(float* a, float b, float* out, size_t size);
-  void greater_equal_array_ops(float* a, float* b, float* out, size_t size);
-  void greater_equal_scalar_ops(float* a, float b, float* out, size_t size);
-  void smaller_array_ops(float* a, float* b, float* out, size_t size);
-  void smaller_scalar_ops(float* a, float b, float* out, size_t size);
-  void smaller_equal_array_ops(float* a, float* b, float* out, size_t size);
-  void smaller_equal_scalar_ops(float* a, float b, float* out, size_t size);
-  void transpose_1d_array_ops(float* a, float* out, int* shape);
-  void transpose_2d_array_ops(float* a, float* out, int* shape);
-  void transpose_3d_array_ops(float* a, float* out, int* shape);
-  void transpose_ndim_array_ops(float* a, float* out, int* shape, int ndim);
-  void compute_broadcast_indices(int linear_index, int* broadcasted_shape, int max_ndim,
-    int a_ndim, int b_ndim, int* a_shape, int* b_shape, int* index_a, int* index_b);
+  void reassign_array_ops(void* a, void* out, size_t size, dtype_t dtype);
+  // comparisons read `dtype` & always write bool (one byte per element)
+  // iterator operands are (a, b, out) for array ops & (a, out) for scalar ops
+  void equal_array_ops(NdIter* it, dtype_t dtype);
+  void equal_scalar_ops(NdIter* it, float b, dtype_t dtype);
+  void not_equal_array_ops(NdIter* it, dtype_t dtype);
+  void not_equal_scalar_ops(NdIter* it, float b, dtype_t dtype);
+  void greater_array_ops(NdIter* it, dtype_t dtype);
+  void greater_scalar_ops(NdIter* it, float b, dtype_t dtype);
+  void greater_equal_array_ops(NdIter* it, dtype_t dtype);
+  void greater_equal_scalar_ops(NdIter* it, float b, dtype_t dtype);
+  void smaller_array_ops(NdIter* it, dtype_t dtype);
+  void smaller_scalar_ops(NdIter* it, float b, dtype_t dtype);
+  void smaller_equal_array_ops(NdIter* it, dtype_t dtype);
+  void smaller_equal_scalar_ops(NdIter* it, float b, dtype_t dtype);
 }
 
 #endif
\ No newline at end of file
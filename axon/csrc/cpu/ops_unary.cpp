@@ -1,17 +1,79 @@
 #include <stdio.h>
 #include <stddef.h>
 #include <math.h>
+#include <atomic>
 #include "ops_unary.h"
+#include "../core/dispatch.h"
+#include "../core/iterator.h"
+#include "simd.h"
+#include "parallel.h"
 
-void sqrt_array_ops(float* a, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = sqrtf(a[i]); } }
-void neg_array_ops(float* a, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = -a[i]; } }
-void exp_array_ops(float* a, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = expf(a[i]); } }
-void log_array_ops(float* a, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = logf(a[i]); } }
-void abs_array_ops(float* a, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = fabsf(a[i]); } }
-void sign_array_ops(float* a, float* out, size_t size) {for (size_t i = 0; i < size; i++) { out[i] = (a[i] > 0) ? 1.0f : ((a[i] < 0) ? -1.0f : 0.0f); } }
-void sin_ops(float* a, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = sinf(a[i]); } }
-void cos_ops(float* a, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = cosf(a[i]); } }
-void tan_ops(float* a, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = tanf(a[i]); } }
-void sinh_ops(float* a, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = sinhf(a[i]); } }
-void cosh_ops(float* a, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = coshf(a[i]); } }
-void tanh_ops(float* a, float* out, size_t size) { for (size_t i = 0; i < size; i++) { out[i] = tanhf(a[i]); } }
\ No newline at end of file
+// set_math_mode() may run while pool workers read it
+static std::atomic<int> math_mode{MATH_EXACT};
+
+int get_math_mode() { return math_mode.load(std::memory_order_relaxed); }
+
+int set_math_mode(int mode) {
+  mode = (mode == MATH_FAST) ? MATH_FAST : MATH_EXACT;
+  math_mode.store(mode, std::memory_order_relaxed);
+  return mode;
+}
+
+// float valued ops: reads T, writes float_type<T> (float for ints & float32, double for float64)
+// operands: a & out, both walked through the iterator so views are read in place
+// float32 loops take the vector math kernels in fast mode, sqrt always does (it's exact either way)
+// transcendentals cost far more per element than a load, so they go parallel at a smaller size
+template <typename Op> static void float_unary_kernel(NdIter* it, dtype_t dtype, int simd_op, Op op) {
+  const bool vector = simd_op == SIMD_SQRT || get_math_mode() == MATH_FAST;
+  const size_t grain = simd_op == SIMD_SQRT ? PARALLEL_GRAIN : PARALLEL_GRAIN_MATH;
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    typedef typename float_type<T>::type R;
+    parallel_iter(it, grain, [&](NdIter* it) {
+      do {
+        if (vector && simd_math_loop<T, R>(it, simd_op)) continue;
+        iter_unary_loop<T, R>(it, [&](T x) { return (R)op((R)x); });
+      } while (iter_next(it));
+    });
+  });
+}
+
+// dtype preserving ops: reads & writes T
+template <typename Op> static void same_unary_kernel(NdIter* it, dtype_t dtype, Op op) {
+  dispatch_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    parallel_iter(it, PARALLEL_GRAIN, [&](NdIter* it) {
+      do { iter_unary_loop<T, T>(it, [&](T x) { return (T)op(x); }); } while (iter_next(it));
+    });
+  });
+}
+
+// unsigned values saturate at 0 when negated, matching the clamped float conversion
+template <typename T> static inline T neg_value(T x) {
+  if constexpr (std::is_unsigned<T>::value && !std::is_same<T, bool>::value) { return 0; }
+  else { return (T)-x; }
+}
+
+template <typename T> static inline T abs_value(T x) {
+  if constexpr (std::is_floating_point<T>::value) { return fabs(x); }
+  else if constexpr (std::is_signed<T>::value) { return (x < 0) ? (T)-x : x; }
+  else { return x; }
+}
+
+template <typename T> static inline T sign_value(T x) {
+  if constexpr (std::is_same<T, bool>::value) { return x; }
+  else { return (T)((x > 0) ? 1 : ((x < 0) ? -1 : 0)); }
+}
+
+void sqrt_array_ops(NdIter* it, dtype_t dtype) { float_unary_kernel(it, dtype, SIMD_SQRT, [](auto x) { return sqrt(x); }); }
+void neg_array_ops(NdIter* it, dtype_t dtype) { same_unary_kernel(it, dtype, [](auto x) { return neg_value(x); }); }
+void exp_array_ops(NdIter* it, dtype_t dtype) { float_unary_kernel(it, dtype, SIMD_EXP, [](auto x) { return exp(x); }); }
+void log_array_ops(NdIter* it, dtype_t dtype) { float_unary_kernel(it, dtype, SIMD_LOG, [](auto x) { return log(x); }); }
+void abs_array_ops(NdIter* it, dtype_t dtype) { same_unary_kernel(it, dtype, [](auto x) { return abs_value(x); }); }
+void sign_array_ops(NdIter* it, dtype_t dtype) { same_unary_kernel(it, dtype, [](auto x) { return sign_value(x); }); }
+void sin_ops(NdIter* it, dtype_t dtype) { float_unary_kernel(it, dtype, SIMD_SIN, [](auto x) { return sin(x); }); }
+void cos_ops(NdIter* it, dtype_t dtype) { float_unary_kernel(it, dtype, SIMD_COS, [](auto x) { return cos(x); }); }
+void tan_ops(NdIter* it, dtype_t dtype) { float_unary_kernel(it, dtype, SIMD_TAN, [](auto x) { return tan(x); }); }
+void sinh_ops(NdIter* it, dtype_t dtype) { float_unary_kernel(it, dtype, SIMD_SINH, [](auto x) { return sinh(x); }); }
+void cosh_ops(NdIter* it, dtype_t dtype) { float_unary_kernel(it, dtype, SIMD_COSH, [](auto x) { return cosh(x); }); }
+void tanh_ops(NdIter* it, dtype_t dtype) { float_unary_kernel(it, dtype, SIMD_TANH, [](auto x) { return tanh(x); }); }
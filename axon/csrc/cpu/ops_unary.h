@@ -2,21 +2,37 @@
 #define __OPS_UNARY__H__
 
 #include <stddef.h>
+#include "../core/dtype.h"
+#include "../core/iterator.h"
+
+// `dtype` is the input dtype; neg, abs & sign write the same dtype, rest of the
+// ops write float32 for integer inputs & keep float32/float64 precision otherwise
+// operands of the iterator are (a, out), strided views are fine on either side
+
+// MATH_EXACT calls libm per element; MATH_FAST runs float32 exp, log, sin, cos, tan, sinh, cosh &
+// tanh through the vector kernels of cpu/simd.h: within 1 ulp of the correctly rounded result over
+// the whole float range & 2 ulp of glibc's float functions (|x| > 2^19 trig lanes still go to libm)
+// float64, integer inputs & cpus without sse4.1 stay on libm in both modes, sqrt is vectorized in
+// both since it's correctly rounded
+typedef enum { MATH_EXACT, MATH_FAST } math_mode_t;
 
 extern "C" {
-  void sqrt_array_ops(float* a, float* out, size_t size);
-  void neg_array_ops(float* a, float* out, size_t size);
-  void exp_array_ops(float* a, float* out, size_t size);
-  void log_array_ops(float* a, float* out, size_t size);
-  void abs_array_ops(float* a, float* out, size_t size);
-  void sign_array_ops(float* a, float* out, size_t size);
+  int get_math_mode();
+  int set_math_mode(int mode);    // returns the mode now in use
+
+  void sqrt_array_ops(NdIter* it, dtype_t dtype);
+  void neg_array_ops(NdIter* it, dtype_t dtype);
+  void exp_array_ops(NdIter* it, dtype_t dtype);
+  void log_array_ops(NdIter* it, dtype_t dtype);
+  void abs_array_ops(NdIter* it, dtype_t dtype);
+  void sign_array_ops(NdIter* it, dtype_t dtype);
 
-  void sin_ops(float* a, float* out, size_t size);
-  void cos_ops(float* a, float* out, size_t size);
-  void tan_ops(float* a, float* out, size_t size);
-  void sinh_ops(float* a, float* out, size_t size);
-  void cosh_ops(float* a, float* out, size_t size);
-  void tanh_ops(float* a, float* out, size_t size);
+  void sin_ops(NdIter* it, dtype_t dtype);
+  void cos_ops(NdIter* it, dtype_t dtype);
+  void tan_ops(NdIter* it, dtype_t dtype);
+  void sinh_ops(NdIter* it, dtype_t dtype);
+  void cosh_ops(NdIter* it, dtype_t dtype);
+  void tanh_ops(NdIter* it, dtype_t dtype);
 }
 
-#endif  //!__UNARY_OPS__H__
\ No newline at end of file
+#endif  //!__UNARY_OPS__H__
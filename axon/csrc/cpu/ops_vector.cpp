@@ -3,13 +3,14 @@
 #include <stdio.h>
 #include "ops_vector.h"
 #include "ops_array.h"
+#include "../core/dispatch.h"
 
-void vector_dot_ops(float* a, float* b, float* out, size_t size) { dot_array_ops(a, b, out, size); }
-void vector_inner_product_ops(float* a, float* b, float* out, size_t size) { dot_array_ops(a, b, out, size); }
+void vector_dot_ops(void* a, void* b, void* out, size_t size, dtype_t dtype) { dot_array_ops(a, b, out, size, dtype); }
+void vector_inner_product_ops(void* a, void* b, void* out, size_t size, dtype_t dtype) { dot_array_ops(a, b, out, size, dtype); }
 
 // Vector-matrix multiplication: out = vec * mat
 // vec is 1 x size_n, mat is size_n x size_m, out is 1 x size_m
-void vector_matrix_dot_ops(float* vec, float* mat, float* out, size_t size_v, size_t size_m) {
+template <typename T> static void vector_matrix_dot_ops_kernel(T* vec, T* mat, T* out, size_t size_v, size_t size_m) {
   size_t cols = size_m / size_v;
   for (size_t j = 0; j < cols; j++) {
     out[j] = 0.0f;
@@ -18,7 +19,7 @@ void vector_matrix_dot_ops(float* vec, float* mat, float* out, size_t size_v, si
 }
 
 // matrix-vector multiplication: out = mat * vec
-void matrix_vector_dot_ops(float* mat, float* vec, float* out, size_t size_m, size_t size_v) {
+template <typename T> static void matrix_vector_dot_ops_kernel(T* mat, T* vec, T* out, size_t size_m, size_t size_v) {
   size_t rows = size_m / size_v;
   for (size_t i = 0; i < rows; i++) {
     out[i] = 0.0f;
@@ -28,7 +29,7 @@ void matrix_vector_dot_ops(float* mat, float* vec, float* out, size_t size_m, si
 
 // Vector outer product: out = a @ b
 // a is nx1, b is mx1, out is nxm matrix
-void vector_outer_product_ops(float* a, float* b, float* out, size_t size_n, size_t size_m) {
+template <typename T> static void vector_outer_product_ops_kernel(T* a, T* b, T* out, size_t size_n, size_t size_m) {
   for (size_t i = 0; i < size_n; i++) {
     for (size_t j = 0; j < size_m; j++) {
       out[i * size_m + j] = a[i] * b[j];  // out stored in row-major order
@@ -36,7 +37,7 @@ void vector_outer_product_ops(float* a, float* b, float* out, size_t size_n, siz
   }
 }
 
-void cross_product_ops(float* a, float* b, float* out, size_t* shape, size_t ndim, size_t axis, size_t* a_stride, size_t* b_stride) {
+template <typename T> static void cross_product_ops_kernel(T* a, T* b, T* out, size_t* shape, size_t ndim, size_t axis, size_t* a_stride, size_t* b_stride) {
   size_t axis_size = shape[axis];
   // Calculate total number of elements excluding the axis dimension
   size_t total_elements = 1;
@@ -55,8 +56,8 @@ void cross_product_ops(float* a, float* b, float* out, size_t* shape, size_t ndi
           b_idx += coord * b_stride[dim];
         }
       }
-      float a0 = a[a_idx], a1 = a[a_idx + a_stride[axis]];
-      float b0 = b[b_idx], b1 = b[b_idx + b_stride[axis]];
+      T a0 = a[a_idx], a1 = a[a_idx + a_stride[axis]];
+      T b0 = b[b_idx], b1 = b[b_idx + b_stride[axis]];
       out[i] = a0 * b1 - a1 * b0;
     }
   }
@@ -74,8 +75,8 @@ void cross_product_ops(float* a, float* b, float* out, size_t* shape, size_t ndi
         }
       }
 
-      float a0 = a[a_idx]; float a1 = a[a_idx + a_stride[axis]]; float a2 = a[a_idx + 2 * a_stride[axis]];
-      float b0 = b[b_idx]; float b1 = b[b_idx + b_stride[axis]]; float b2 = b[b_idx + 2 * b_stride[axis]];
+      T a0 = a[a_idx]; T a1 = a[a_idx + a_stride[axis]]; T a2 = a[a_idx + 2 * a_stride[axis]];
+      T b0 = b[b_idx]; T b1 = b[b_idx + b_stride[axis]]; T b2 = b[b_idx + 2 * b_stride[axis]];
       out[i * 3 + 0] = a1 * b2 - a2 * b1;
       out[i * 3 + 1] = a2 * b0 - a0 * b2;
       out[i * 3 + 2] = a0 * b1 - a1 * b0;
@@ -83,7 +84,7 @@ void cross_product_ops(float* a, float* b, float* out, size_t* shape, size_t ndi
   }
 }
 
-void cross_1d_ops(float* a, float* b, float* out, size_t size) {
+template <typename T> static void cross_1d_ops_kernel(T* a, T* b, T* out, size_t size) {
   if (size == 2) { out[0] = a[0] * b[1] - a[1] * b[0]; } // 2D cross product returns scalar
   else if (size == 3) { // 3D cross product returns vector
     out[0] = a[1] * b[2] - a[2] * b[1]; out[1] = a[2] * b[0] - a[0] * b[2]; out[2] = a[0] * b[1] - a[1] * b[0];
@@ -91,15 +92,64 @@ void cross_1d_ops(float* a, float* b, float* out, size_t size) {
 }
 
 // Cross product for 2D arrays (matrix of vectors)
-void cross_2d_ops(float* a, float* b, float* out, size_t rows, size_t cols, size_t axis) {
+template <typename T> static void cross_2d_ops_kernel(T* a, T* b, T* out, size_t rows, size_t cols, size_t axis) {
   size_t shape[2] = {rows, cols};
   size_t stride[2] = {cols, 1};  // Row-major stride
-  cross_product_ops(a, b, out, shape, 2, axis, stride, stride);
+  cross_product_ops_kernel(a, b, out, shape, 2, axis, stride, stride);
 }
 
 // Cross product for 3D arrays (tensor of vectors)
-void cross_3d_ops(float* a, float* b, float* out, size_t dim0, size_t dim1, size_t dim2, size_t axis) {
+template <typename T> static void cross_3d_ops_kernel(T* a, T* b, T* out, size_t dim0, size_t dim1, size_t dim2, size_t axis) {
   size_t shape[3] = {dim0, dim1, dim2};
   size_t stride[3] = {dim1 * dim2, dim2, 1};  // Row-major stride
-  cross_product_ops(a, b, out, shape, 3, axis, stride, stride);
+  cross_product_ops_kernel(a, b, out, shape, 3, axis, stride, stride);
+}
+
+void vector_matrix_dot_ops(void* vec, void* mat, void* out, size_t size_v, size_t size_m, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    vector_matrix_dot_ops_kernel((T*)vec, (T*)mat, (T*)out, size_v, size_m);
+  });
+}
+
+void matrix_vector_dot_ops(void* mat, void* vec, void* out, size_t size_m, size_t size_v, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    matrix_vector_dot_ops_kernel((T*)mat, (T*)vec, (T*)out, size_m, size_v);
+  });
+}
+
+void vector_outer_product_ops(void* a, void* b, void* out, size_t size_n, size_t size_m, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    vector_outer_product_ops_kernel((T*)a, (T*)b, (T*)out, size_n, size_m);
+  });
+}
+
+void cross_product_ops(void* a, void* b, void* out, size_t* shape, size_t ndim, size_t axis, size_t* a_stride, size_t* b_stride, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    cross_product_ops_kernel((T*)a, (T*)b, (T*)out, shape, ndim, axis, a_stride, b_stride);
+  });
+}
+
+void cross_1d_ops(void* a, void* b, void* out, size_t size, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    cross_1d_ops_kernel((T*)a, (T*)b, (T*)out, size);
+  });
+}
+
+void cross_2d_ops(void* a, void* b, void* out, size_t rows, size_t cols, size_t axis, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    cross_2d_ops_kernel((T*)a, (T*)b, (T*)out, rows, cols, axis);
+  });
+}
+
+void cross_3d_ops(void* a, void* b, void* out, size_t dim0, size_t dim1, size_t dim2, size_t axis, dtype_t dtype) {
+  dispatch_float_dtype(dtype, [&](auto tag) {
+    typedef typename decltype(tag)::type T;
+    cross_3d_ops_kernel((T*)a, (T*)b, (T*)out, dim0, dim1, dim2, axis);
+  });
 }
\ No newline at end of file
@@ -2,16 +2,18 @@
 #define __OPS_VECTOR__H__
 
 #include <stddef.h>
+#include "../core/dtype.h"
 
+// float32/float64 kernels, `dtype` is the dtype of every float buffer
 extern "C" {
-  void vector_dot_ops(float* a, float* b, float* out, size_t size);
-  void vector_matrix_dot_ops(float* vec, float* mat, float* out, size_t size_v, size_t size_m);
-  void matrix_vector_dot_ops(float* vec, float* mat, float* out, size_t size_v, size_t size_m);
-  void vector_outer_product_ops(float* a, float* b, float* out, size_t size_n, size_t size_m);
-  void vector_inner_product_ops(float* a, float* b, float* out, size_t size);
-  void cross_1d_ops(float* a, float* b, float* out, size_t size);
-  void cross_2d_ops(float* a, float* b, float* out, size_t rows, size_t cols, size_t axis);
-  void cross_3d_ops(float* a, float* b, float* out, size_t dim0, size_t dim1, size_t dim2, size_t axis);
+  void vector_dot_ops(void* a, void* b, void* out, size_t size, dtype_t dtype);
+  void vector_matrix_dot_ops(void* vec, void* mat, void* out, size_t size_v, size_t size_m, dtype_t dtype);
+  void matrix_vector_dot_ops(void* vec, void* mat, void* out, size_t size_v, size_t size_m, dtype_t dtype);
+  void vector_outer_product_ops(void* a, void* b, void* out, size_t size_n, size_t size_m, dtype_t dtype);
+  void vector_inner_product_ops(void* a, void* b, void* out, size_t size, dtype_t dtype);
+  void cross_1d_ops(void* a, void* b, void* out, size_t size, dtype_t dtype);
+  void cross_2d_ops(void* a, void* b, void* out, size_t rows, size_t cols, size_t axis, dtype_t dtype);
+  void cross_3d_ops(void* a, void* b, void* out, size_t dim0, size_t dim1, size_t dim2, size_t axis, dtype_t dtype);
 }
 
 #endif  //!__OPS_VECTOR__H__
\ No newline at end of file
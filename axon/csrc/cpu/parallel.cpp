@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+#include "parallel.h"
+
+#define PARALLEL_SPIN 2000    // polls of a parked worker before it sleeps on the condition variable
+
+// chunk indices [begin, end) of one participant packed into a word, the owner pops the front &
+// thieves cut off the back half, both through compare-exchange so a chunk is handed out once
+struct alignas(64) TaskRange {
+  std::atomic<uint64_t> range;
+};
+
+static inline uint64_t pack_range(uint64_t begin, uint64_t end) { return (begin << 32) | end; }
+
+typedef struct Pool {
+  std::mutex run_lock;    // held by the thread running a region, others run inline
+  std::mutex wake_lock;
+  std::condition_variable wake;
+  std::atomic<uint64_t> region{0};    // region no << 16 | participants, bumped to start a region
+  std::atomic<int> busy{0};           // workers still inside the current region
+  int spawned = 0;
+  // current region
+  parallel_fn fn = NULL;
+  void* ctx = NULL;
+  size_t n = 0, chunk = 0;
+  int participants = 0;
+  TaskRange ranges[PARALLEL_MAX_THREADS];
+} Pool;
+
+// never freed: detached workers may still be parked on it while the process exits
+static Pool* pool = new Pool();
+static thread_local int in_region = 0;
+
+static inline void cpu_relax() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  __builtin_ia32_pause();
+#else
+  std::this_thread::yield();
+#endif
+}
+
+static void run_chunk(Pool* p, uint64_t c) {
+  size_t begin = c * p->chunk, end = begin + p->chunk;
+  p->fn(p->ctx, begin, end < p->n ? end : p->n);
+}
+
+// back half of another participant's run, the first chunk of it is returned & the rest becomes ours
+static bool steal(Pool* p, int self, uint64_t* chunk) {
+  for (int i = 1; i < p->participants; i++) {
+    TaskRange& victim = p->ranges[(self + i) % p->participants];
+    uint64_t r = victim.range.load(std::memory_order_acquire);
+    while (true) {
+      uint64_t begin = r >> 32, end = r & 0xFFFFFFFFu;
+      if (begin >= end) break;
+      uint64_t mid = begin + (end - begin) / 2;
+      if (victim.range.compare_exchange_weak(r, pack_range(begin, mid), std::memory_order_acq_rel)) {
+        p->ranges[self].range.store(pack_range(mid + 1, end), std::memory_order_release);
+        *chunk = mid;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void run_tasks(Pool* p, int self) {
+  TaskRange& own = p->ranges[self];
+  while (true) {
+    uint64_t r = own.range.load(std::memory_order_acquire);
+    uint64_t begin = r >> 32, end = r & 0xFFFFFFFFu, chunk;
+    if (begin < end) {
+      if (own.range.compare_exchange_weak(r, pack_range(begin + 1, end), std::memory_order_acq_rel)) run_chunk(p, begin);
+      continue;
+    }
+    if (!steal(p, self, &chunk)) return;
+    run_chunk(p, chunk);
+  }
+}
+
+static void worker_main(Pool* p, int id, uint64_t seen) {
+  in_region = 1;    // tasks opening regions of their own run them inline
+  while (true) {
+    uint64_t r = p->region.load(std::memory_order_acquire);
+    for (int i = 0; i < PARALLEL_SPIN && (r >> 16) == (seen >> 16); i++) {
+      cpu_relax();
+      r = p->region.load(std::memory_order_acquire);
+    }
+    if ((r >> 16) == (seen >> 16)) {
+      std::unique_lock<std::mutex> lock(p->wake_lock);
+      p->wake.wait(lock, [&] { return (p->region.load(std::memory_order_acquire) >> 16) != (seen >> 16); });
+      r = p->region.load(std::memory_order_acquire);
+    }
+    seen = r;
+    // the region can't move on until every participant checked out, so `r` is the one running
+    if (id < (int)(r & 0xFFFF)) {
+      run_tasks(p, id);
+      p->busy.fetch_sub(1, std::memory_order_acq_rel);
+    }
+  }
+}
+
+static int default_num_threads() {
+  const char* env = getenv("AXON_NUM_THREADS");
+  if (env != NULL) {
+    int n = atoi(env);
+    if (n > 0) return n < PARALLEL_MAX_THREADS ? n : PARALLEL_MAX_THREADS;
+    fprintf(stderr, "Invalid AXON_NUM_THREADS '%s', using the hardware thread count\n", env);
+  }
+  int n = (int)std::thread::hardware_concurrency();
+  if (n < 1) n = 1;
+  return n < PARALLEL_MAX_THREADS ? n : PARALLEL_MAX_THREADS;
+}
+
+#if !defined(_WIN32)
+// workers don't survive fork(), the child starts over with an empty pool
+static void reset_pool_in_child() { pool = new Pool(); }
+static const int fork_handler = pthread_atfork(NULL, NULL, reset_pool_in_child);
+#endif
+
+// written by set_num_threads() while pool workers may be reading it, hence atomic
+static std::atomic<int> num_threads{default_num_threads()};
+
+int get_num_threads() { return num_threads.load(std::memory_order_relaxed); }
+
+int set_num_threads(int n) {
+  if (n <= 0) n = default_num_threads();
+  n = n < PARALLEL_MAX_THREADS ? n : PARALLEL_MAX_THREADS;
+  num_threads.store(n, std::memory_order_relaxed);
+  return n;
+}
+
+void parallel_run(size_t n, size_t grain, parallel_fn fn, void* ctx) {
+  if (n == 0) return;
+  if (grain == 0) grain = 1;
+  size_t chunks = (n + grain - 1) / grain;
+  if (chunks > 0xFFFFFFFFu) {
+    grain = (n + 0xFFFFFFFEu) / 0xFFFFFFFFu;
+    chunks = (n + grain - 1) / grain;
+  }
+  int active = num_threads.load(std::memory_order_relaxed);
+  int threads = (size_t)active < chunks ? active : (int)chunks;
+  Pool* p = pool;
+  if (threads <= 1 || in_region || !p->run_lock.try_lock()) {
+    fn(ctx, 0, n);
+    return;
+  }
+
+  uint64_t region = p->region.load(std::memory_order_relaxed);
+  for (; p->spawned < threads - 1; p->spawned++) std::thread(worker_main, p, p->spawned + 1, region).detach();
+  p->fn = fn;
+  p->ctx = ctx;
+  p->n = n;
+  p->chunk = grain;
+  p->participants = threads;
+  for (int t = 0; t < threads; t++) p->ranges[t].range.store(pack_range(chunks * t / threads, chunks * (t + 1) / threads), std::memory_order_relaxed);
+  p->busy.store(threads - 1, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(p->wake_lock);
+    p->region.store(((region >> 16) + 1) << 16 | (uint64_t)threads, std::memory_order_release);
+  }
+  p->wake.notify_all();
+
+  in_region = 1;
+  run_tasks(p, 0);
+  while (p->busy.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+  in_region = 0;
+  p->run_lock.unlock();
+}
@@ -0,0 +1,53 @@
+/**
+  @file parallel.h
+  @brief persistent thread pool behind the elementwise, comparison, reduction & batched linalg kernels
+  * workers are started on first use & parked between regions (a short spin, then a condition
+    variable), the calling thread always takes part so a region of N threads wakes N - 1 workers
+  * a region splits [0, n) into grain sized chunks, each participant owns a contiguous run of chunk
+    indices & takes from its front, once it runs dry it steals the back half of someone else's run
+  * anything that fits in one chunk, every region opened from inside a task & any region while
+    another thread is already running one execute inline on the caller, so small arrays never pay
+    for a wake up & nesting (batched matmul -> gemm) can't deadlock
+  * thread count: AXON_NUM_THREADS from the environment, otherwise the hardware concurrency,
+    set_num_threads() changes it at runtime (workers are kept, only the participant count moves)
+*/
+
+#ifndef __PARALLEL__H__
+#define __PARALLEL__H__
+
+#include <stddef.h>
+#include "../core/iterator.h"
+
+#define PARALLEL_MAX_THREADS 256
+#define PARALLEL_GRAIN 32768        // elements per chunk for memory bound loops (arithmetic, compares, sums)
+#define PARALLEL_GRAIN_MATH 4096    // elements per chunk for libm bound loops (exp, sin, pow, ...)
+
+// items per chunk for a loop over independent items costing about `work` scalar ops each
+inline size_t parallel_grain(size_t work) { return work >= PARALLEL_GRAIN ? 1 : PARALLEL_GRAIN / (work ? work : 1); }
+
+typedef void (*parallel_fn)(void* ctx, size_t begin, size_t end);
+
+extern "C" {
+  int get_num_threads();
+  int set_num_threads(int n);   // n <= 0 restores the default, returns the count now in use
+}
+
+// runs fn(ctx, begin, end) over grain sized pieces of [0, n), returns once all of them are done
+void parallel_run(size_t n, size_t grain, parallel_fn fn, void* ctx);
+
+// f(begin, end) over grain sized pieces of [0, n), a single call with (0, n) when it runs inline
+template <typename F> inline void parallel_for(size_t n, size_t grain, const F& f) {
+  parallel_run(n, grain, [](void* ctx, size_t begin, size_t end) { (*(const F*)ctx)(begin, end); }, (void*)&f);
+}
+
+// body(NdIter*) over slices of a freshly initialized iterator, each slice walks its own copy
+template <typename F> inline void parallel_iter(NdIter* it, size_t grain, const F& body) {
+  if (it->size <= grain || get_num_threads() == 1) { body(it); return; }
+  parallel_for(it->size, grain, [&](size_t begin, size_t end) {
+    NdIter slice = *it;
+    iter_range(&slice, begin, end);
+    body(&slice);
+  });
+}
+
+#endif  //!__PARALLEL__H__
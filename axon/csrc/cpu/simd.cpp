@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include "simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+extern const SimdKernels simd_sse4_kernels;
+extern const SimdKernels simd_avx2_kernels;
+extern const SimdKernels simd_avx512_kernels;
+#endif
+
+// byte k of entry b is 1 when bit k of b is set, little endian so it lands on bool k
+struct MaskBytes {
+  uint64_t v[256];
+  constexpr MaskBytes() : v() {
+    for (int b = 0; b < 256; b++) {
+      for (int k = 0; k < 8; k++) {
+        if ((b >> k) & 1) v[b] |= (uint64_t)1 << (8 * k);
+      }
+    }
+  }
+};
+static constexpr MaskBytes mask_bytes;
+extern const uint64_t* const simd_mask_bytes = mask_bytes.v;
+
+static const char* level_names[] = {"scalar", "sse4", "avx2", "avx512"};
+
+static int detect_simd_level() {
+#ifdef SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SIMD_AVX2;
+  if (__builtin_cpu_supports("sse4.1")) return SIMD_SSE4;
+#endif
+  return SIMD_SCALAR;
+}
+
+static const SimdKernels* level_kernels(int level) {
+#ifdef SIMD_X86
+  switch (level) {
+    case SIMD_SSE4: return &simd_sse4_kernels;
+    case SIMD_AVX2: return &simd_avx2_kernels;
+    case SIMD_AVX512: return &simd_avx512_kernels;
+  }
+#endif
+  return NULL;
+}
+
+// detected level, lowered by AXON_SIMD when set
+static int initial_simd_level() {
+  int level = detect_simd_level();
+  const char* env = getenv("AXON_SIMD");
+  if (env == NULL) return level;
+  for (int l = SIMD_SCALAR; l <= SIMD_AVX512; l++) {
+    if (strcmp(env, level_names[l]) == 0) return l < level ? l : level;
+  }
+  fprintf(stderr, "Unknown AXON_SIMD level '%s', using %s\n", env, level_names[level]);
+  return level;
+}
+
+// picked once when the library is loaded, set_simd_level() may switch them while workers read them
+static const int max_level = detect_simd_level();
+static std::atomic<int> active_level{initial_simd_level()};
+static std::atomic<const SimdKernels*> active_kernels{level_kernels(active_level.load())};
+
+const SimdKernels* simd_kernels() { return active_kernels.load(std::memory_order_relaxed); }
+
+int get_simd_level() { return active_level.load(std::memory_order_relaxed); }
+
+const char* get_simd_name() { return level_names[get_simd_level()]; }
+
+int set_simd_level(int level) {
+  if (level < SIMD_SCALAR) level = SIMD_SCALAR;
+  if (level > max_level) level = max_level;
+  active_level.store(level, std::memory_order_relaxed);
+  active_kernels.store(level_kernels(level), std::memory_order_relaxed);
+  return level;
+}
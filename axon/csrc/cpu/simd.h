@@ -0,0 +1,253 @@
+/**
+  @file simd.h
+  @brief runtime dispatched vector kernels for the elementwise float32/float64 ops
+  * simd_sse4.cpp, simd_avx2.cpp & simd_avx512.cpp compile the same loops (simd_kernels.h)
+    for their ISA through target pragmas, so the library builds without any -march flag
+  * the best level the cpu supports is picked once at load via cpuid, AXON_SIMD=scalar|sse4|avx2|avx512
+    caps it from the environment & set_simd_level() from code (tests, benchmarks)
+  * kernels work on contiguous inner loops: both operands dense, or one of them a single
+    broadcast value (stride 0), every other layout stays on the generic iterator loops
+  * gemm_f32/gemm_f64 are the register-tiled micro-kernels driven by cpu/gemm.cpp
+  * transpose_32/transpose_64 copy a strided 2-d block into its transpose through in-register
+    tiles, core/contiguous.cpp uses them to materialize transposed views (bits are moved, not
+    converted, so any 4 or 8 byte dtype goes through them)
+  * reduce_f32/f64 & fold_f32/f64 are the two inner loops of a reduction: a dense run folded into
+    one value (reducing along the contiguous axis) or into a dense row of accumulators (reducing
+    along an outer axis), see cpu/ops_redux.cpp
+  * dot_f32/f64 & the compensated ksum/kfold entries back the float sums & dot products, which
+    add PAIRWISE_BLOCK sized blocks as a balanced tree (pairwise_sum below) or, in the kahan sum
+    mode of ops_redux.h, carry every rounding error on the side
+  * math_f32 holds the float32 transcendentals behind the "fast" math mode of ops_unary, they're
+    evaluated in float64 lanes so results stay within 1 ulp of libm (see ops_unary.h for bounds)
+  * small_f32/f64 are the batched tiny matrix kernels (2 <= n <= SIMD_SMALL_MAX): the batch is
+    transposed to one matrix per lane (simd_small_batch below), so det, inv, solve & the symmetric
+    eigenvalues run across matrices in registers: closed form 2x2 & 3x3 det/inv, an unrolled pivoted
+    lu past that & the analytic 2x2/3x3 symmetric eigenvalues
+*/
+
+#ifndef __SIMD__H__
+#define __SIMD__H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include "../core/iterator.h"
+
+#define SIMD_TRANSPOSE_BLOCK 32   // square block the transpose kernels work through, both sides stay in L1
+#define PAIRWISE_BLOCK 1024       // leaf of pairwise_sum, summed by a single vector kernel call
+#define SIMD_SMALL_MAX 8          // largest n with a register resident kernel for batched tiny matrices
+#define SIMD_SMALL_BLOCK 64       // matrices per structure-of-arrays block, a multiple of every vector width
+
+typedef enum { SIMD_SCALAR, SIMD_SSE4, SIMD_AVX2, SIMD_AVX512 } simd_level_t;
+typedef enum { SIMD_VV, SIMD_VS, SIMD_SV } simd_mode_t;   // vector op vector, vector op scalar, scalar op vector
+typedef enum { SIMD_ADD, SIMD_SUB, SIMD_MUL, SIMD_DIV } simd_arith_t;
+typedef enum { SIMD_EQ, SIMD_NE, SIMD_GT, SIMD_GE, SIMD_LT, SIMD_LE } simd_cmp_t;
+typedef enum { SIMD_SUM, SIMD_MAX, SIMD_MIN } simd_redux_t;   // max/min skip NaNs like fmax/fmin
+typedef enum { SIMD_SMALL_DET, SIMD_SMALL_INV, SIMD_SMALL_SOLVE, SIMD_SMALL_EIGH } simd_small_t;
+typedef enum { SIMD_SQRT, SIMD_EXP, SIMD_LOG, SIMD_SIN, SIMD_COS, SIMD_TAN, SIMD_SINH, SIMD_COSH, SIMD_TANH } simd_math_t;
+
+// c[mr x nr] (+)= a_sliver @ b_sliver over `kc` steps, a packed mr values per step & b nr values per step
+// `accumulate` 0 overwrites c, 1 adds onto it; c rows are `ldc` elements apart
+template <typename T> struct GemmMicro {
+  int mr, nr;
+  void (*kernel)(size_t kc, const T* a, const T* b, T* c, size_t ldc, int accumulate);
+};
+
+// one table per ISA level, `x`/`y` point at a single value on the broadcast side of SIMD_VS/SIMD_SV
+typedef struct SimdKernels {
+  const char* name;
+  void (*arith_f32)(int op, int mode, const float* x, const float* y, float* out, size_t n);
+  void (*arith_f64)(int op, int mode, const double* x, const double* y, double* out, size_t n);
+  void (*compare_f32)(int op, int mode, const float* x, const float* y, bool* out, size_t n);
+  void (*compare_f64)(int op, int mode, const double* x, const double* y, bool* out, size_t n);
+  void (*math_f32)(int op, const float* x, float* out, size_t n);   // dense x & out
+  GemmMicro<float> gemm_f32;
+  GemmMicro<double> gemm_f64;
+  // dst[j * ds + i] = src[i * ss + j] for i < rows, j < cols, strides in elements
+  void (*transpose_32)(const uint32_t* src, ptrdiff_t ss, uint32_t* dst, ptrdiff_t ds, size_t rows, size_t cols);
+  void (*transpose_64)(const uint64_t* src, ptrdiff_t ss, uint64_t* dst, ptrdiff_t ds, size_t rows, size_t cols);
+  // simd_redux_t over dense x: reduce folds x[0..n) into `init`, fold does acc[i] = op(acc[i], x[i])
+  float (*reduce_f32)(int op, const float* x, size_t n, float init);
+  double (*reduce_f64)(int op, const double* x, size_t n, double init);
+  void (*fold_f32)(int op, const float* x, float* acc, size_t n);
+  void (*fold_f64)(int op, const double* x, double* acc, size_t n);
+  // sum of x[i] * y[i] over dense x & y
+  float (*dot_f32)(const float* x, const float* y, size_t n);
+  double (*dot_f64)(const double* x, const double* y, size_t n);
+  // compensated (TwoSum) versions of reduce/fold for SUM_KAHAN: ksum adds x[i] (x[i] * y[i] when y
+  // isn't NULL) into (*sum, *comp), kfold does acc[i] += x[i] with the rounding errors kept in comp[i]
+  void (*ksum_f32)(const float* x, const float* y, size_t n, float* sum, float* comp);
+  void (*ksum_f64)(const double* x, const double* y, size_t n, double* sum, double* comp);
+  void (*kfold_f32)(const float* x, float* acc, float* comp, size_t n);
+  void (*kfold_f64)(const double* x, double* acc, double* comp, size_t n);
+  // simd_small_t over structure-of-arrays n x n matrices, element e of lane l at a[e * count + l]: b & out
+  // are n x nrhs (solve), out n x n (inv), n values ascending (eigh, n <= 3) or one (det); returns
+  // 1 + the first lane with a zero pivot (inv & solve), else 0
+  int (*small_f32)(int op, int n, int nrhs, const float* a, const float* b, float* out, size_t count);
+  int (*small_f64)(int op, int n, int nrhs, const double* a, const double* b, double* out, size_t count);
+} SimdKernels;
+
+extern const uint64_t* const simd_mask_bytes;   // 8 comparison bits -> 8 bool bytes
+const SimdKernels* simd_kernels();    // active table, NULL on the scalar level
+
+extern "C" {
+  int get_simd_level();   // simd_level_t in use
+  const char* get_simd_name();
+  int set_simd_level(int level);    // capped at what the cpu supports, returns the level now in use
+}
+
+inline void simd_arith(const SimdKernels* k, int op, int mode, const float* x, const float* y, float* out, size_t n) { k->arith_f32(op, mode, x, y, out, n); }
+inline void simd_arith(const SimdKernels* k, int op, int mode, const double* x, const double* y, double* out, size_t n) { k->arith_f64(op, mode, x, y, out, n); }
+inline void simd_compare(const SimdKernels* k, int op, int mode, const float* x, const float* y, bool* out, size_t n) { k->compare_f32(op, mode, x, y, out, n); }
+inline void simd_compare(const SimdKernels* k, int op, int mode, const double* x, const double* y, bool* out, size_t n) { k->compare_f64(op, mode, x, y, out, n); }
+inline float simd_reduce(const SimdKernels* k, int op, const float* x, size_t n, float init) { return k->reduce_f32(op, x, n, init); }
+inline double simd_reduce(const SimdKernels* k, int op, const double* x, size_t n, double init) { return k->reduce_f64(op, x, n, init); }
+inline void simd_fold(const SimdKernels* k, int op, const float* x, float* acc, size_t n) { k->fold_f32(op, x, acc, n); }
+inline void simd_fold(const SimdKernels* k, int op, const double* x, double* acc, size_t n) { k->fold_f64(op, x, acc, n); }
+
+// the sums below take a NULL table (scalar level) & fall back to plain loops
+inline float simd_dot(const SimdKernels* k, const float* x, const float* y, size_t n) { return k->dot_f32(x, y, n); }
+inline double simd_dot(const SimdKernels* k, const double* x, const double* y, size_t n) { return k->dot_f64(x, y, n); }
+
+// sum of dense x[0..n) (of x[i] * y[i] when y isn't NULL), blocks of PAIRWISE_BLOCK go through one
+// kernel call & are added as a balanced tree, so the rounding error grows with log(n) instead of n
+template <typename T> inline T pairwise_sum(const SimdKernels* k, const T* x, const T* y, size_t n) {
+  if (n <= PAIRWISE_BLOCK) {
+    if (k != NULL) return y ? simd_dot(k, x, y, n) : simd_reduce(k, SIMD_SUM, x, n, (T)0);
+    T s[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) { for (int j = 0; j < 4; j++) s[j] += y ? x[i + j] * y[i + j] : x[i + j]; }
+    for (; i < n; i++) s[0] += y ? x[i] * y[i] : x[i];
+    return (s[0] + s[1]) + (s[2] + s[3]);
+  }
+  // split on a block boundary, capped so the right half keeps at least a block
+  size_t half = (n / 2 + PAIRWISE_BLOCK - 1) / PAIRWISE_BLOCK * PAIRWISE_BLOCK;
+  half = half < n - PAIRWISE_BLOCK ? half : n - PAIRWISE_BLOCK;
+  return pairwise_sum(k, x, y, half) + pairwise_sum(k, x + half, y ? y + half : NULL, n - half);
+}
+
+// Knuth's TwoSum: s + x == result + *err exactly
+template <typename T> inline T two_sum(T s, T x, T* err) {
+  T t = s + x, z = t - s;
+  *err = (s - (t - z)) + (x - z);
+  return t;
+}
+
+template <typename T> inline void compensated_sum(const SimdKernels* k, const T* x, const T* y, size_t n, T* sum, T* comp) {
+  if (k != NULL) {
+    if constexpr (std::is_same<T, float>::value) { k->ksum_f32(x, y, n, sum, comp); }
+    else { k->ksum_f64(x, y, n, sum, comp); }
+    return;
+  }
+  T s = *sum, c = *comp, e;
+  for (size_t i = 0; i < n; i++) {
+    s = two_sum(s, y ? x[i] * y[i] : x[i], &e);
+    c += e;
+  }
+  *sum = s;
+  *comp = c;
+}
+
+template <typename T> inline void compensated_fold(const SimdKernels* k, const T* x, T* acc, T* comp, size_t n) {
+  if (k != NULL) {
+    if constexpr (std::is_same<T, float>::value) { k->kfold_f32(x, acc, comp, n); }
+    else { k->kfold_f64(x, acc, comp, n); }
+    return;
+  }
+  T e;
+  for (size_t i = 0; i < n; i++) {
+    acc[i] = two_sum(acc[i], x[i], &e);
+    comp[i] += e;
+  }
+}
+
+// `count` row-major n x n matrices (& n x nrhs right-hand sides for solve) through small_f32/f64,
+// SIMD_SMALL_BLOCK at a time: transposed to one matrix per lane, the spare lanes padded with identities,
+// & the results transposed back; returns 1 + the first matrix with a zero pivot, else 0
+template <typename T> inline size_t simd_small_batch(const SimdKernels* k, int op, int n, int nrhs, const T* a, const T* b, T* out, size_t count) {
+  typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type E;
+  const size_t L = SIMD_SMALL_BLOCK, nn = (size_t)n * n, nb = (op == SIMD_SMALL_SOLVE) ? (size_t)n * nrhs : 0;
+  const size_t nout = (op == SIMD_SMALL_DET) ? 1 : (op == SIMD_SMALL_EIGH) ? n : (op == SIMD_SMALL_INV) ? nn : nb;
+  T* work = (T*)malloc((nn + nb + nout) * L * sizeof(T));
+  if (work == NULL) {
+    fprintf(stderr, "Memory allocation failed for small matrix block\n");
+    exit(EXIT_FAILURE);
+  }
+  T *sa = work, *sb = sa + nn * L, *so = sb + nb * L;
+  auto transpose = [&](const T* src, ptrdiff_t ss, T* dst, ptrdiff_t ds, size_t rows, size_t cols) {
+    if constexpr (sizeof(T) == 4) k->transpose_32((const E*)src, ss, (E*)dst, ds, rows, cols);
+    else k->transpose_64((const E*)src, ss, (E*)dst, ds, rows, cols);
+  };
+  size_t singular = 0;
+  for (size_t i0 = 0; i0 < count && !singular; i0 += L) {
+    size_t lanes = (count - i0 < L) ? count - i0 : L;
+    transpose(a + i0 * nn, nn, sa, L, lanes, nn);
+    if (nb) transpose(b + i0 * nb, nb, sb, L, lanes, nb);
+    for (size_t e = 0; e < nn; e++) {
+      for (size_t l = lanes; l < L; l++) sa[e * L + l] = (e % (n + 1) == 0) ? 1 : 0;
+    }
+    for (size_t e = 0; e < nb; e++) {
+      for (size_t l = lanes; l < L; l++) sb[e * L + l] = 0;
+    }
+    int s;
+    if constexpr (sizeof(T) == 4) s = k->small_f32(op, n, nrhs, sa, sb, so, L);
+    else s = k->small_f64(op, n, nrhs, sa, sb, so, L);
+    if (s) { singular = i0 + (size_t)s; break; }
+    transpose(so, L, out + i0 * nout, nout, nout, lanes);
+  }
+  free(work);
+  return singular;
+}
+
+// simd_mode_t of the current inner loop of (a, b, out), -1 when it isn't one the kernels handle
+template <typename T, typename R> inline int simd_mode(NdIter* it) {
+  ptrdiff_t* s = it->inner_strides;
+  const ptrdiff_t t = sizeof(T);
+  if (s[2] != (ptrdiff_t)sizeof(R)) return -1;
+  if (s[0] == t && s[1] == t) return SIMD_VV;
+  if (s[0] == t && s[1] == 0) return SIMD_VS;
+  if (s[0] == 0 && s[1] == t) return SIMD_SV;
+  return -1;
+}
+
+// runs the current inner loop of (a, b, out) through the vector kernels, false if T or the layout isn't covered
+template <typename T, typename R> inline bool simd_binary_loop(NdIter* it, int op) {
+  if constexpr (!std::is_floating_point<T>::value) { return false; }
+  else {
+    const SimdKernels* k = simd_kernels();
+    int mode = k ? simd_mode<T, R>(it) : -1;
+    if (mode < 0) return false;
+    const T *x = (const T*)it->ptrs[0], *y = (const T*)it->ptrs[1];
+    if constexpr (std::is_same<R, bool>::value) { simd_compare(k, op, mode, x, y, (bool*)it->ptrs[2], it->inner_size); }
+    else { simd_arith(k, op, mode, x, y, (R*)it->ptrs[2], it->inner_size); }
+    return true;
+  }
+}
+
+// same for (a, out) against a scalar `y` already in T
+template <typename T, typename R> inline bool simd_scalar_loop(NdIter* it, int op, T y) {
+  if constexpr (!std::is_floating_point<T>::value) { return false; }
+  else {
+    const SimdKernels* k = simd_kernels();
+    if (k == NULL || it->inner_strides[0] != (ptrdiff_t)sizeof(T) || it->inner_strides[1] != (ptrdiff_t)sizeof(R)) return false;
+    const T* x = (const T*)it->ptrs[0];
+    if constexpr (std::is_same<R, bool>::value) { simd_compare(k, op, SIMD_VS, x, &y, (bool*)it->ptrs[1], it->inner_size); }
+    else { simd_arith(k, op, SIMD_VS, x, &y, (R*)it->ptrs[1], it->inner_size); }
+    return true;
+  }
+}
+
+// same for a unary simd_math_t over (a, out), only float32 -> float32 with dense inner loops
+template <typename T, typename R> inline bool simd_math_loop(NdIter* it, int op) {
+  if constexpr (!std::is_same<T, float>::value || !std::is_same<R, float>::value) { return false; }
+  else {
+    const SimdKernels* k = simd_kernels();
+    if (k == NULL || it->inner_strides[0] != (ptrdiff_t)sizeof(float) || it->inner_strides[1] != (ptrdiff_t)sizeof(float)) return false;
+    k->math_f32(op, (const float*)it->ptrs[0], (float*)it->ptrs[1], it->inner_size);
+    return true;
+  }
+}
+
+#endif  //!__SIMD__H__
@@ -0,0 +1,152 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+
+// everything below is compiled for avx2, only reached through the table once cpuid reports it
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+namespace {
+
+struct F32 {
+  typedef float T;
+  typedef __m256 vec;
+  static const size_t width = 8;
+  static vec load(const T* p) { return _mm256_loadu_ps(p); }
+  static void store(T* p, vec v) { _mm256_storeu_ps(p, v); }
+  static vec set1(T v) { return _mm256_set1_ps(v); }
+  static vec add(vec a, vec b) { return _mm256_add_ps(a, b); }
+  static vec sub(vec a, vec b) { return _mm256_sub_ps(a, b); }
+  static vec mul(vec a, vec b) { return _mm256_mul_ps(a, b); }
+  static vec div(vec a, vec b) { return _mm256_div_ps(a, b); }
+  static unsigned cmp_eq(vec a, vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+  static unsigned cmp_ne(vec a, vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_NEQ_UQ)); }
+  static unsigned cmp_gt(vec a, vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+  static unsigned cmp_ge(vec a, vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ)); }
+  static unsigned cmp_lt(vec a, vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+  static unsigned cmp_le(vec a, vec b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ)); }
+  static vec fmadd(vec a, vec b, vec c) { return _mm256_fmadd_ps(a, b, c); }
+  static vec sqrt(vec a) { return _mm256_sqrt_ps(a); }
+  static vec abs(vec a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+  typedef __m256 mask;
+  static mask gt(vec a, vec b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+  static vec min(vec a, vec b) { return _mm256_min_ps(a, b); }
+  static vec max(vec a, vec b) { return _mm256_max_ps(a, b); }
+  static mask isnan(vec a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+  static vec select(mask m, vec a, vec b) { return _mm256_blendv_ps(b, a, m); }
+  static __m256d to_f64_lo(vec a) { return _mm256_cvtps_pd(_mm256_castps256_ps128(a)); }
+  static __m256d to_f64_hi(vec a) { return _mm256_cvtps_pd(_mm256_extractf128_ps(a, 1)); }
+  static vec from_f64(__m256d lo, __m256d hi) { return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(lo)), _mm256_cvtpd_ps(hi), 1); }
+};
+
+struct F64 {
+  typedef double T;
+  typedef __m256d vec;
+  static const size_t width = 4;
+  static vec load(const T* p) { return _mm256_loadu_pd(p); }
+  static void store(T* p, vec v) { _mm256_storeu_pd(p, v); }
+  static vec set1(T v) { return _mm256_set1_pd(v); }
+  static vec add(vec a, vec b) { return _mm256_add_pd(a, b); }
+  static vec sub(vec a, vec b) { return _mm256_sub_pd(a, b); }
+  static vec mul(vec a, vec b) { return _mm256_mul_pd(a, b); }
+  static vec div(vec a, vec b) { return _mm256_div_pd(a, b); }
+  static unsigned cmp_eq(vec a, vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+  static unsigned cmp_ne(vec a, vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_UQ)); }
+  static unsigned cmp_gt(vec a, vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+  static unsigned cmp_ge(vec a, vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ)); }
+  static unsigned cmp_lt(vec a, vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)); }
+  static unsigned cmp_le(vec a, vec b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ)); }
+  typedef __m256d mask;
+  static vec fmadd(vec a, vec b, vec c) { return _mm256_fmadd_pd(a, b, c); }
+  static vec sqrt(vec a) { return _mm256_sqrt_pd(a); }
+  static vec min(vec a, vec b) { return _mm256_min_pd(a, b); }
+  static vec max(vec a, vec b) { return _mm256_max_pd(a, b); }
+  static vec abs(vec a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+  static vec round(vec a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+  static vec floor(vec a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+  static mask lt(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+  static mask gt(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+  static mask eq(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+  static mask isnan(vec a) { return _mm256_cmp_pd(a, a, _CMP_UNORD_Q); }
+  static vec select(mask m, vec a, vec b) { return _mm256_blendv_pd(b, a, m); }
+  static bool any(mask m) { return _mm256_movemask_pd(m) != 0; }
+  // 2^n for integral n in [-1022, 1023]: n + 1023 lands in the low mantissa bits of n + 2^52 + 1023
+  static vec exp2i(vec n) { return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(4503599627371519.0))), 52)); }
+  // unbiased exponent & [1, 2) mantissa of positive normal values
+  static vec exponent(vec a) {
+    __m256i e = _mm256_or_si256(_mm256_srli_epi64(_mm256_castpd_si256(a), 52), _mm256_castpd_si256(_mm256_set1_pd(4503599627370496.0)));
+    return _mm256_sub_pd(_mm256_castsi256_pd(e), _mm256_set1_pd(4503599627371519.0));
+  }
+  static vec mantissa(vec a) {
+    __m256i m = _mm256_and_si256(_mm256_castpd_si256(a), _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+    return _mm256_castsi256_pd(_mm256_or_si256(m, _mm256_set1_epi64x(0x3FF0000000000000LL)));
+  }
+};
+
+// 8x8 & 4x4 tiles, floats & doubles are only used as bit containers here
+struct T32 {
+  typedef uint32_t E;
+  static const size_t B = 8;
+  static void tile(const E* s, ptrdiff_t ss, E* d, ptrdiff_t ds) {
+    __m256 r[8], t[8];
+    for (int i = 0; i < 8; i++) r[i] = _mm256_loadu_ps((const float*)(s + i * ss));
+    for (int i = 0; i < 8; i += 2) {
+      t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+      t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+    }
+    for (int i = 0; i < 8; i += 4) {
+      r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+      r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+      r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+      r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    for (int i = 0; i < 4; i++) {
+      _mm256_storeu_ps((float*)(d + i * ds), _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+      _mm256_storeu_ps((float*)(d + (i + 4) * ds), _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+    }
+  }
+};
+
+struct T64 {
+  typedef uint64_t E;
+  static const size_t B = 4;
+  static void tile(const E* s, ptrdiff_t ss, E* d, ptrdiff_t ds) {
+    __m256d r0 = _mm256_loadu_pd((const double*)s), r1 = _mm256_loadu_pd((const double*)(s + ss));
+    __m256d r2 = _mm256_loadu_pd((const double*)(s + 2 * ss)), r3 = _mm256_loadu_pd((const double*)(s + 3 * ss));
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+    _mm256_storeu_pd((double*)d, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd((double*)(d + ds), _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd((double*)(d + 2 * ds), _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd((double*)(d + 3 * ds), _mm256_permute2f128_pd(t1, t3, 0x31));
+  }
+};
+
+}
+
+#include "simd_kernels.h"
+
+extern const SimdKernels simd_avx2_kernels = {
+  "avx2", arith_kernel<F32>, arith_kernel<F64>, compare_kernel<F32>, compare_kernel<F64>,
+  math_kernel<F32, F64>, {6, 2 * F32::width, gemm_micro<F32, 6, 2>}, {6, 2 * F64::width, gemm_micro<F64, 6, 2>},
+  transpose_kernel<T32>, transpose_kernel<T64>, reduce_kernel<F32>, reduce_kernel<F64>, fold_kernel<F32>, fold_kernel<F64>,
+  dot_kernel<F32>, dot_kernel<F64>, ksum_kernel<F32>, ksum_kernel<F64>, kfold_kernel<F32>, kfold_kernel<F64>,
+  small_kernel<F32>, small_kernel<F64>
+};
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif
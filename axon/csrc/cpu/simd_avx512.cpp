@@ -0,0 +1,165 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// gcc 12 flags the self-initialized __Y in _mm512_undefined_*, a false positive inside the header
+#if !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// everything below is compiled for avx512f, only reached through the table once cpuid reports it
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+#endif
+
+namespace {
+
+// avx512 compares straight into a k-mask, no movemask needed
+struct F32 {
+  typedef float T;
+  typedef __m512 vec;
+  static const size_t width = 16;
+  static vec load(const T* p) { return _mm512_loadu_ps(p); }
+  static void store(T* p, vec v) { _mm512_storeu_ps(p, v); }
+  static vec set1(T v) { return _mm512_set1_ps(v); }
+  static vec add(vec a, vec b) { return _mm512_add_ps(a, b); }
+  static vec sub(vec a, vec b) { return _mm512_sub_ps(a, b); }
+  static vec mul(vec a, vec b) { return _mm512_mul_ps(a, b); }
+  static vec div(vec a, vec b) { return _mm512_div_ps(a, b); }
+  static unsigned cmp_eq(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+  static unsigned cmp_ne(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ); }
+  static unsigned cmp_gt(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+  static unsigned cmp_ge(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+  static unsigned cmp_lt(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+  static unsigned cmp_le(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+  static vec fmadd(vec a, vec b, vec c) { return _mm512_fmadd_ps(a, b, c); }
+  static vec sqrt(vec a) { return _mm512_sqrt_ps(a); }
+  static vec abs(vec a) { return _mm512_abs_ps(a); }
+  typedef __mmask16 mask;
+  static mask gt(vec a, vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+  static vec min(vec a, vec b) { return _mm512_min_ps(a, b); }
+  static vec max(vec a, vec b) { return _mm512_max_ps(a, b); }
+  static mask isnan(vec a) { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+  static vec select(mask m, vec a, vec b) { return _mm512_mask_blend_ps(m, b, a); }
+  static __m512d to_f64_lo(vec a) { return _mm512_cvtps_pd(_mm512_castps512_ps256(a)); }
+  static __m512d to_f64_hi(vec a) { return _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a), 1))); }
+  static vec from_f64(__m512d lo, __m512d hi) {
+    __m512d l = _mm512_castps_pd(_mm512_castps256_ps512(_mm512_cvtpd_ps(lo)));
+    return _mm512_castpd_ps(_mm512_insertf64x4(l, _mm256_castps_pd(_mm512_cvtpd_ps(hi)), 1));
+  }
+};
+
+struct F64 {
+  typedef double T;
+  typedef __m512d vec;
+  static const size_t width = 8;
+  static vec load(const T* p) { return _mm512_loadu_pd(p); }
+  static void store(T* p, vec v) { _mm512_storeu_pd(p, v); }
+  static vec set1(T v) { return _mm512_set1_pd(v); }
+  static vec add(vec a, vec b) { return _mm512_add_pd(a, b); }
+  static vec sub(vec a, vec b) { return _mm512_sub_pd(a, b); }
+  static vec mul(vec a, vec b) { return _mm512_mul_pd(a, b); }
+  static vec div(vec a, vec b) { return _mm512_div_pd(a, b); }
+  static unsigned cmp_eq(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+  static unsigned cmp_ne(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_NEQ_UQ); }
+  static unsigned cmp_gt(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+  static unsigned cmp_ge(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+  static unsigned cmp_lt(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+  static unsigned cmp_le(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+  typedef __mmask8 mask;
+  static vec fmadd(vec a, vec b, vec c) { return _mm512_fmadd_pd(a, b, c); }
+  static vec sqrt(vec a) { return _mm512_sqrt_pd(a); }
+  static vec min(vec a, vec b) { return _mm512_min_pd(a, b); }
+  static vec max(vec a, vec b) { return _mm512_max_pd(a, b); }
+  static vec abs(vec a) { return _mm512_abs_pd(a); }
+  static vec round(vec a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+  static vec floor(vec a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+  static mask lt(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+  static mask gt(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+  static mask eq(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+  static mask isnan(vec a) { return _mm512_cmp_pd_mask(a, a, _CMP_UNORD_Q); }
+  static vec select(mask m, vec a, vec b) { return _mm512_mask_blend_pd(m, b, a); }
+  static bool any(mask m) { return m != 0; }
+  // 2^n for integral n in [-1022, 1023]: n + 1023 lands in the low mantissa bits of n + 2^52 + 1023
+  static vec exp2i(vec n) { return _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_castpd_si512(_mm512_add_pd(n, _mm512_set1_pd(4503599627371519.0))), 52)); }
+  // unbiased exponent & [1, 2) mantissa of positive normal values
+  static vec exponent(vec a) {
+    __m512i e = _mm512_or_si512(_mm512_srli_epi64(_mm512_castpd_si512(a), 52), _mm512_castpd_si512(_mm512_set1_pd(4503599627370496.0)));
+    return _mm512_sub_pd(_mm512_castsi512_pd(e), _mm512_set1_pd(4503599627371519.0));
+  }
+  static vec mantissa(vec a) {
+    __m512i m = _mm512_and_si512(_mm512_castpd_si512(a), _mm512_set1_epi64(0x000FFFFFFFFFFFFFLL));
+    return _mm512_castsi512_pd(_mm512_or_si512(m, _mm512_set1_epi64(0x3FF0000000000000LL)));
+  }
+};
+
+// 8x8 & 4x4 tiles on the 256-bit registers, floats & doubles are only used as bit containers here
+struct T32 {
+  typedef uint32_t E;
+  static const size_t B = 8;
+  static void tile(const E* s, ptrdiff_t ss, E* d, ptrdiff_t ds) {
+    __m256 r[8], t[8];
+    for (int i = 0; i < 8; i++) r[i] = _mm256_loadu_ps((const float*)(s + i * ss));
+    for (int i = 0; i < 8; i += 2) {
+      t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+      t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+    }
+    for (int i = 0; i < 8; i += 4) {
+      r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+      r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+      r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+      r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    for (int i = 0; i < 4; i++) {
+      _mm256_storeu_ps((float*)(d + i * ds), _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+      _mm256_storeu_ps((float*)(d + (i + 4) * ds), _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+    }
+  }
+};
+
+struct T64 {
+  typedef uint64_t E;
+  static const size_t B = 4;
+  static void tile(const E* s, ptrdiff_t ss, E* d, ptrdiff_t ds) {
+    __m256d r0 = _mm256_loadu_pd((const double*)s), r1 = _mm256_loadu_pd((const double*)(s + ss));
+    __m256d r2 = _mm256_loadu_pd((const double*)(s + 2 * ss)), r3 = _mm256_loadu_pd((const double*)(s + 3 * ss));
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1), t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3), t3 = _mm256_unpackhi_pd(r2, r3);
+    _mm256_storeu_pd((double*)d, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd((double*)(d + ds), _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd((double*)(d + 2 * ds), _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd((double*)(d + 3 * ds), _mm256_permute2f128_pd(t1, t3, 0x31));
+  }
+};
+
+}
+
+#include "simd_kernels.h"
+
+extern const SimdKernels simd_avx512_kernels = {
+  "avx512", arith_kernel<F32>, arith_kernel<F64>, compare_kernel<F32>, compare_kernel<F64>,
+  math_kernel<F32, F64>, {12, 2 * F32::width, gemm_micro<F32, 12, 2>}, {12, 2 * F64::width, gemm_micro<F64, 12, 2>},
+  transpose_kernel<T32>, transpose_kernel<T64>, reduce_kernel<F32>, reduce_kernel<F64>, fold_kernel<F32>, fold_kernel<F64>,
+  dot_kernel<F32>, dot_kernel<F64>, ksum_kernel<F32>, ksum_kernel<F64>, kfold_kernel<F32>, kfold_kernel<F64>,
+  small_kernel<F32>, small_kernel<F64>
+};
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif
@@ -0,0 +1,737 @@
+/**
+  @file simd_kernels.h
+  @brief ISA independent vector loops, included by each simd_<isa>.cpp after its target pragma
+  * the including file defines the F32/F64 traits (vec type, width, load/store/set1, arithmetic,
+    comparisons returning a lane bitmask) with its own intrinsics, plus what the math kernels need:
+    F32 <-> F64 half conversions, rounding, lane masks & select, and a few exponent bit tricks on F64
+  * gemm_micro only needs zero/load/store/set1/fmadd, so F32 carries fmadd too, the reductions
+    need min/max/isnan/select on both
+  * transpose_kernel takes T32/T64 traits instead: an element type, a tile size B & a tile()
+    that transposes one B x B tile in registers
+  * the including file also brings in <math.h> before its pragma, libm handles the lanes the
+    vector trig reduction can't & the acos/cos of the 3x3 symmetric eigenvalues
+  * the tiny matrix kernels (small_kernel) also need sqrt, abs, a gt mask & select on both F32 & F64
+  * everything here sits in an anonymous namespace so every ISA gets its own private copy,
+    nothing compiled for avx2/avx512 can be picked by the linker for a baseline caller
+  * no includes on purpose: anything pulled in here would be compiled for the ISA too
+*/
+
+#ifndef __SIMD_KERNELS__H__
+#define __SIMD_KERNELS__H__
+
+namespace {
+
+struct AddOp {
+  template <typename V> static typename V::vec vec(typename V::vec a, typename V::vec b) { return V::add(a, b); }
+  template <typename T> static T one(T a, T b) { return a + b; }
+};
+struct SubOp {
+  template <typename V> static typename V::vec vec(typename V::vec a, typename V::vec b) { return V::sub(a, b); }
+  template <typename T> static T one(T a, T b) { return a - b; }
+};
+struct MulOp {
+  template <typename V> static typename V::vec vec(typename V::vec a, typename V::vec b) { return V::mul(a, b); }
+  template <typename T> static T one(T a, T b) { return a * b; }
+};
+struct DivOp {
+  template <typename V> static typename V::vec vec(typename V::vec a, typename V::vec b) { return V::div(a, b); }
+  template <typename T> static T one(T a, T b) { return a / b; }
+};
+
+// comparisons give one bit per lane; NE is unordered (true against NaN) like C's !=, the rest are ordered
+struct EqOp {
+  template <typename V> static unsigned vec(typename V::vec a, typename V::vec b) { return V::cmp_eq(a, b); }
+  template <typename T> static bool one(T a, T b) { return a == b; }
+};
+struct NeOp {
+  template <typename V> static unsigned vec(typename V::vec a, typename V::vec b) { return V::cmp_ne(a, b); }
+  template <typename T> static bool one(T a, T b) { return a != b; }
+};
+struct GtOp {
+  template <typename V> static unsigned vec(typename V::vec a, typename V::vec b) { return V::cmp_gt(a, b); }
+  template <typename T> static bool one(T a, T b) { return a > b; }
+};
+struct GeOp {
+  template <typename V> static unsigned vec(typename V::vec a, typename V::vec b) { return V::cmp_ge(a, b); }
+  template <typename T> static bool one(T a, T b) { return a >= b; }
+};
+struct LtOp {
+  template <typename V> static unsigned vec(typename V::vec a, typename V::vec b) { return V::cmp_lt(a, b); }
+  template <typename T> static bool one(T a, T b) { return a < b; }
+};
+struct LeOp {
+  template <typename V> static unsigned vec(typename V::vec a, typename V::vec b) { return V::cmp_le(a, b); }
+  template <typename T> static bool one(T a, T b) { return a <= b; }
+};
+
+template <typename V, typename Op> void arith_loop(int mode, const typename V::T* x, const typename V::T* y, typename V::T* out, size_t n) {
+  typedef typename V::T T;
+  typedef typename V::vec vec;
+  const size_t w = V::width;
+  size_t i = 0;
+  if (mode == SIMD_VV) {
+    for (; i + w <= n; i += w) { V::store(out + i, Op::template vec<V>(V::load(x + i), V::load(y + i))); }
+    for (; i < n; i++) { out[i] = Op::one(x[i], y[i]); }
+  } else if (mode == SIMD_VS) {
+    const T ys = *y;
+    const vec yv = V::set1(ys);
+    for (; i + w <= n; i += w) { V::store(out + i, Op::template vec<V>(V::load(x + i), yv)); }
+    for (; i < n; i++) { out[i] = Op::one(x[i], ys); }
+  } else {
+    const T xs = *x;
+    const vec xv = V::set1(xs);
+    for (; i + w <= n; i += w) { V::store(out + i, Op::template vec<V>(xv, V::load(y + i))); }
+    for (; i < n; i++) { out[i] = Op::one(xs, y[i]); }
+  }
+}
+
+// spreads the lane bitmask of one vector into `width` bool bytes
+template <typename V> inline void store_mask(bool* out, unsigned bits) {
+  for (size_t k = 0; k < V::width; k += 8) {
+    uint64_t bytes = simd_mask_bytes[(bits >> k) & 0xFF];
+    memcpy(out + k, &bytes, (V::width - k < 8) ? V::width - k : 8);
+  }
+}
+
+template <typename V, typename Op> void compare_loop(int mode, const typename V::T* x, const typename V::T* y, bool* out, size_t n) {
+  typedef typename V::T T;
+  typedef typename V::vec vec;
+  const size_t w = V::width;
+  size_t i = 0;
+  if (mode == SIMD_VV) {
+    for (; i + w <= n; i += w) { store_mask<V>(out + i, Op::template vec<V>(V::load(x + i), V::load(y + i))); }
+    for (; i < n; i++) { out[i] = Op::one(x[i], y[i]); }
+  } else if (mode == SIMD_VS) {
+    const T ys = *y;
+    const vec yv = V::set1(ys);
+    for (; i + w <= n; i += w) { store_mask<V>(out + i, Op::template vec<V>(V::load(x + i), yv)); }
+    for (; i < n; i++) { out[i] = Op::one(x[i], ys); }
+  } else {
+    const T xs = *x;
+    const vec xv = V::set1(xs);
+    for (; i + w <= n; i += w) { store_mask<V>(out + i, Op::template vec<V>(xv, V::load(y + i))); }
+    for (; i < n; i++) { out[i] = Op::one(xs, y[i]); }
+  }
+}
+
+// MR x (NV * width) tile of c held in registers, one broadcast of a & NV loads of b per k step
+template <typename V, int MR, int NV> void gemm_micro(size_t kc, const typename V::T* a, const typename V::T* b, typename V::T* c, size_t ldc, int accumulate) {
+  typedef typename V::vec vec;
+  const size_t w = V::width;
+  vec acc[MR][NV];
+  for (int r = 0; r < MR; r++) {
+    for (int j = 0; j < NV; j++) acc[r][j] = V::set1(0);
+  }
+  for (size_t p = 0; p < kc; p++) {
+    vec bv[NV];
+    for (int j = 0; j < NV; j++) bv[j] = V::load(b + j * w);
+    for (int r = 0; r < MR; r++) {
+      vec av = V::set1(a[r]);
+      for (int j = 0; j < NV; j++) acc[r][j] = V::fmadd(av, bv[j], acc[r][j]);
+    }
+    a += MR;
+    b += NV * w;
+  }
+  for (int r = 0; r < MR; r++) {
+    for (int j = 0; j < NV; j++) {
+      typename V::T* cp = c + r * ldc + j * w;
+      V::store(cp, accumulate ? V::add(acc[r][j], V::load(cp)) : acc[r][j]);
+    }
+  }
+}
+
+template <typename V> void arith_kernel(int op, int mode, const typename V::T* x, const typename V::T* y, typename V::T* out, size_t n) {
+  switch (op) {
+    case SIMD_ADD: arith_loop<V, AddOp>(mode, x, y, out, n); break;
+    case SIMD_SUB: arith_loop<V, SubOp>(mode, x, y, out, n); break;
+    case SIMD_MUL: arith_loop<V, MulOp>(mode, x, y, out, n); break;
+    case SIMD_DIV: arith_loop<V, DivOp>(mode, x, y, out, n); break;
+  }
+}
+
+template <typename V> void compare_kernel(int op, int mode, const typename V::T* x, const typename V::T* y, bool* out, size_t n) {
+  switch (op) {
+    case SIMD_EQ: compare_loop<V, EqOp>(mode, x, y, out, n); break;
+    case SIMD_NE: compare_loop<V, NeOp>(mode, x, y, out, n); break;
+    case SIMD_GT: compare_loop<V, GtOp>(mode, x, y, out, n); break;
+    case SIMD_GE: compare_loop<V, GeOp>(mode, x, y, out, n); break;
+    case SIMD_LT: compare_loop<V, LtOp>(mode, x, y, out, n); break;
+    case SIMD_LE: compare_loop<V, LeOp>(mode, x, y, out, n); break;
+  }
+}
+
+// reduction ops take (accumulator, value); max/min follow fmax/fmin: a NaN value never wins & a
+// NaN accumulator is replaced by the next value (max_ps/min_ps return their second operand on NaN)
+struct SumRed {
+  template <typename V> static typename V::vec vec(typename V::vec acc, typename V::vec x) { return V::add(acc, x); }
+  template <typename T> static T one(T acc, T x) { return acc + x; }
+};
+struct MaxRed {
+  template <typename V> static typename V::vec vec(typename V::vec acc, typename V::vec x) { return V::select(V::isnan(acc), x, V::max(x, acc)); }
+  template <typename T> static T one(T acc, T x) { return fmax(acc, x); }
+};
+struct MinRed {
+  template <typename V> static typename V::vec vec(typename V::vec acc, typename V::vec x) { return V::select(V::isnan(acc), x, V::min(x, acc)); }
+  template <typename T> static T one(T acc, T x) { return fmin(acc, x); }
+};
+
+// four independent vector accumulators hide the add latency, lanes are folded into `init` at the end
+template <typename V, typename Op> typename V::T reduce_loop(const typename V::T* x, size_t n, typename V::T init) {
+  typedef typename V::T T;
+  typedef typename V::vec vec;
+  const size_t w = V::width;
+  size_t i = 0;
+  T r = init;
+  if (n >= 4 * w) {
+    vec acc[4] = {V::load(x), V::load(x + w), V::load(x + 2 * w), V::load(x + 3 * w)};
+    for (i = 4 * w; i + 4 * w <= n; i += 4 * w) {
+      for (int k = 0; k < 4; k++) acc[k] = Op::template vec<V>(acc[k], V::load(x + i + k * w));
+    }
+    for (; i + w <= n; i += w) { acc[0] = Op::template vec<V>(acc[0], V::load(x + i)); }
+    vec v = Op::template vec<V>(Op::template vec<V>(acc[0], acc[1]), Op::template vec<V>(acc[2], acc[3]));
+    T lanes[w];
+    V::store(lanes, v);
+    for (size_t k = 0; k < w; k++) r = Op::one(r, lanes[k]);
+  }
+  for (; i < n; i++) { r = Op::one(r, x[i]); }
+  return r;
+}
+
+template <typename V, typename Op> void fold_loop(const typename V::T* x, typename V::T* acc, size_t n) {
+  const size_t w = V::width;
+  size_t i = 0;
+  for (; i + w <= n; i += w) { V::store(acc + i, Op::template vec<V>(V::load(acc + i), V::load(x + i))); }
+  for (; i < n; i++) { acc[i] = Op::one(acc[i], x[i]); }
+}
+
+template <typename V> typename V::T reduce_kernel(int op, const typename V::T* x, size_t n, typename V::T init) {
+  switch (op) {
+    case SIMD_MAX: return reduce_loop<V, MaxRed>(x, n, init);
+    case SIMD_MIN: return reduce_loop<V, MinRed>(x, n, init);
+    default: return reduce_loop<V, SumRed>(x, n, init);
+  }
+}
+
+template <typename V> void fold_kernel(int op, const typename V::T* x, typename V::T* acc, size_t n) {
+  switch (op) {
+    case SIMD_MAX: fold_loop<V, MaxRed>(x, acc, n); break;
+    case SIMD_MIN: fold_loop<V, MinRed>(x, acc, n); break;
+    default: fold_loop<V, SumRed>(x, acc, n); break;
+  }
+}
+
+// sum of x[i] * y[i], four fused multiply-add accumulators
+template <typename V> typename V::T dot_kernel(const typename V::T* x, const typename V::T* y, size_t n) {
+  typedef typename V::T T;
+  typedef typename V::vec vec;
+  const size_t w = V::width;
+  size_t i = 0;
+  T r = 0;
+  if (n >= 4 * w) {
+    vec acc[4] = {V::set1(0), V::set1(0), V::set1(0), V::set1(0)};
+    for (; i + 4 * w <= n; i += 4 * w) {
+      for (int k = 0; k < 4; k++) acc[k] = V::fmadd(V::load(x + i + k * w), V::load(y + i + k * w), acc[k]);
+    }
+    for (; i + w <= n; i += w) { acc[0] = V::fmadd(V::load(x + i), V::load(y + i), acc[0]); }
+    T lanes[w];
+    V::store(lanes, V::add(V::add(acc[0], acc[1]), V::add(acc[2], acc[3])));
+    for (size_t k = 0; k < w; k++) r += lanes[k];
+  }
+  for (; i < n; i++) { r += x[i] * y[i]; }
+  return r;
+}
+
+// Knuth's TwoSum on whole vectors: s + x == t + e exactly, no compare or abs needed
+template <typename V> inline typename V::vec two_sum_vec(typename V::vec s, typename V::vec x, typename V::vec& e) {
+  typename V::vec t = V::add(s, x), z = V::sub(t, s);
+  e = V::add(V::sub(s, V::sub(t, z)), V::sub(x, z));
+  return t;
+}
+
+// compensated sum of x[i] (or x[i] * y[i] when y isn't NULL) into (*sum, *comp): four accumulator
+// pairs, the rounding error of every add goes into comp, lanes are merged with scalar TwoSums
+template <typename V> void ksum_kernel(const typename V::T* x, const typename V::T* y, size_t n, typename V::T* sum, typename V::T* comp) {
+  typedef typename V::T T;
+  typedef typename V::vec vec;
+  const size_t w = V::width;
+  size_t i = 0;
+  T s = *sum, c = *comp;
+  if (n >= 4 * w) {
+    vec acc[4] = {V::set1(0), V::set1(0), V::set1(0), V::set1(0)}, err[4] = {V::set1(0), V::set1(0), V::set1(0), V::set1(0)};
+    for (; i + 4 * w <= n; i += 4 * w) {
+      for (int k = 0; k < 4; k++) {
+        vec v = y ? V::mul(V::load(x + i + k * w), V::load(y + i + k * w)) : V::load(x + i + k * w), e;
+        acc[k] = two_sum_vec<V>(acc[k], v, e);
+        err[k] = V::add(err[k], e);
+      }
+    }
+    T lanes[w], errs[w];
+    for (int k = 0; k < 4; k++) {
+      V::store(lanes, acc[k]);
+      V::store(errs, err[k]);
+      for (size_t j = 0; j < w; j++) {
+        T t = s + lanes[j], z = t - s;
+        c += ((s - (t - z)) + (lanes[j] - z)) + errs[j];
+        s = t;
+      }
+    }
+  }
+  for (; i < n; i++) {
+    T v = y ? x[i] * y[i] : x[i];
+    T t = s + v, z = t - s;
+    c += (s - (t - z)) + (v - z);
+    s = t;
+  }
+  *sum = s;
+  *comp = c;
+}
+
+// compensated acc[i] += x[i], rounding errors go into comp[i]
+template <typename V> void kfold_kernel(const typename V::T* x, typename V::T* acc, typename V::T* comp, size_t n) {
+  typedef typename V::T T;
+  const size_t w = V::width;
+  size_t i = 0;
+  for (; i + w <= n; i += w) {
+    typename V::vec e, t = two_sum_vec<V>(V::load(acc + i), V::load(x + i), e);
+    V::store(acc + i, t);
+    V::store(comp + i, V::add(V::load(comp + i), e));
+  }
+  for (; i < n; i++) {
+    T t = acc[i] + x[i], z = t - acc[i];
+    comp[i] += (acc[i] - (t - z)) + (x[i] - z);
+    acc[i] = t;
+  }
+}
+
+// float32 math, evaluated in float64 lanes: the polynomials below are good to ~1e-11 relative,
+// so the only visible error is the final rounding to float (max 1 ulp against libm, mostly 0)
+
+// exp on |r| <= ln2/2 after x = n*ln2 + r, taylor up to r^10/10! & scaled by 2^n through the exponent bits
+template <typename D> inline typename D::vec exp_d(typename D::vec x) {
+  typedef typename D::vec vec;
+  x = D::min(D::max(x, D::set1(-708.0)), D::set1(709.0));
+  vec n = D::round(D::mul(x, D::set1(1.44269504088896338700e+00)));
+  vec r = D::fmadd(n, D::set1(-6.93147180369123816490e-01), x);   // ln2 hi, 32 bits so n*hi is exact
+  r = D::fmadd(n, D::set1(-1.90821492927058770002e-10), r);       // ln2 lo
+  vec p = D::set1(1.0 / 3628800.0);
+  p = D::fmadd(p, r, D::set1(1.0 / 362880.0));
+  p = D::fmadd(p, r, D::set1(1.0 / 40320.0));
+  p = D::fmadd(p, r, D::set1(1.0 / 5040.0));
+  p = D::fmadd(p, r, D::set1(1.0 / 720.0));
+  p = D::fmadd(p, r, D::set1(1.0 / 120.0));
+  p = D::fmadd(p, r, D::set1(1.0 / 24.0));
+  p = D::fmadd(p, r, D::set1(1.0 / 6.0));
+  p = D::fmadd(p, r, D::set1(0.5));
+  p = D::fmadd(p, r, D::set1(1.0));
+  p = D::fmadd(p, r, D::set1(1.0));
+  return D::mul(p, D::exp2i(n));
+}
+
+// log(m * 2^e) with m in [sqrt(1/2), sqrt(2)): 2*atanh(s), s = (m-1)/(m+1), |s| <= 0.172
+template <typename D> inline typename D::vec log_d(typename D::vec x) {
+  typedef typename D::vec vec;
+  vec e = D::exponent(x), m = D::mantissa(x);
+  typename D::mask big = D::gt(m, D::set1(1.41421356237309504880));
+  m = D::select(big, D::mul(m, D::set1(0.5)), m);
+  e = D::select(big, D::add(e, D::set1(1.0)), e);
+  vec f = D::sub(m, D::set1(1.0));
+  vec s = D::div(f, D::add(f, D::set1(2.0)));
+  vec z = D::mul(s, s);
+  vec p = D::set1(1.0 / 13.0);
+  p = D::fmadd(p, z, D::set1(1.0 / 11.0));
+  p = D::fmadd(p, z, D::set1(1.0 / 9.0));
+  p = D::fmadd(p, z, D::set1(1.0 / 7.0));
+  p = D::fmadd(p, z, D::set1(1.0 / 5.0));
+  p = D::fmadd(p, z, D::set1(1.0 / 3.0));
+  p = D::fmadd(p, z, D::set1(1.0));
+  vec res = D::fmadd(e, D::set1(6.93147180559945309417e-01), D::mul(D::add(s, s), p));
+  // the exponent trick is meaningless outside (0, inf), those come from ieee rules
+  res = D::select(D::lt(x, D::set1(0.0)), D::set1(__builtin_nan("")), res);
+  res = D::select(D::eq(x, D::set1(0.0)), D::set1(-__builtin_inf()), res);
+  return D::select(D::eq(x, D::set1(__builtin_inf())), x, res);
+}
+
+// x = n*pi/2 + r, |r| <= pi/4, q = n mod 4; pi/2 hi has 33 bits so n*hi is exact while |x| <= TRIG_MAX_ARG
+template <typename D> inline typename D::vec trig_reduce(typename D::vec x, typename D::vec& q) {
+  typedef typename D::vec vec;
+  vec n = D::round(D::mul(x, D::set1(6.36619772367581382433e-01)));
+  vec r = D::fmadd(n, D::set1(-1.57079632673412561417e+00), x);
+  r = D::fmadd(n, D::set1(-6.07710050650619224932e-11), r);
+  q = D::sub(n, D::mul(D::set1(4.0), D::floor(D::mul(n, D::set1(0.25)))));
+  return r;
+}
+
+// float kernels of freebsd's k_sinf/k_cosf/k_tanf, double coefficients fit for float results
+template <typename D> inline typename D::vec ksin_d(typename D::vec r) {
+  typedef typename D::vec vec;
+  vec z = D::mul(r, r), w = D::mul(z, z), s = D::mul(z, r);
+  vec t = D::fmadd(z, D::set1(2.71831149398982190640e-06), D::set1(-1.98393348360966317347e-04));
+  vec u = D::fmadd(z, D::set1(8.33332938588946317560e-03), D::set1(-1.66666666416265235595e-01));
+  return D::add(D::fmadd(s, u, r), D::mul(D::mul(s, w), t));
+}
+template <typename D> inline typename D::vec kcos_d(typename D::vec r) {
+  typedef typename D::vec vec;
+  vec z = D::mul(r, r), w = D::mul(z, z);
+  vec t = D::fmadd(z, D::set1(2.43904487962774090654e-05), D::set1(-1.38867637746099294692e-03));
+  vec c = D::fmadd(w, D::set1(4.16666233237390631894e-02), D::fmadd(z, D::set1(-4.99999997251031003120e-01), D::set1(1.0)));
+  return D::add(c, D::mul(D::mul(w, z), t));
+}
+template <typename D> inline typename D::vec ktan_d(typename D::vec r) {
+  typedef typename D::vec vec;
+  vec z = D::mul(r, r), w = D::mul(z, z), s = D::mul(z, r);
+  vec a = D::fmadd(z, D::set1(9.46564784943673166728e-03), D::set1(2.97435743359967304927e-03));
+  vec b = D::fmadd(z, D::set1(2.45283181166547278873e-02), D::set1(5.33812378445670393523e-02));
+  vec u = D::fmadd(z, D::set1(1.33392002712976742718e-01), D::set1(3.33331395030791399758e-01));
+  return D::add(D::fmadd(s, u, r), D::mul(D::mul(s, w), D::fmadd(w, a, b)));
+}
+
+template <typename D> inline typename D::vec neg_d(typename D::vec x) { return D::sub(D::set1(0.0), x); }
+
+// odd quadrants swap sin & cos, sin flips sign on quadrants 2-3 & cos on 1-2
+template <typename D> inline typename D::vec sin_d(typename D::vec x) {
+  typedef typename D::vec vec;
+  vec q, r = trig_reduce<D>(x, q);
+  vec odd = D::sub(q, D::mul(D::set1(2.0), D::floor(D::mul(q, D::set1(0.5)))));
+  vec res = D::select(D::eq(odd, D::set1(1.0)), kcos_d<D>(r), ksin_d<D>(r));
+  return D::select(D::gt(q, D::set1(1.5)), neg_d<D>(res), res);
+}
+template <typename D> inline typename D::vec cos_d(typename D::vec x) {
+  typedef typename D::vec vec;
+  vec q, r = trig_reduce<D>(x, q);
+  vec odd = D::sub(q, D::mul(D::set1(2.0), D::floor(D::mul(q, D::set1(0.5)))));
+  vec res = D::select(D::eq(odd, D::set1(1.0)), ksin_d<D>(r), kcos_d<D>(r));
+  vec q1 = D::add(q, D::set1(1.0));
+  q1 = D::sub(q1, D::mul(D::set1(4.0), D::floor(D::mul(q1, D::set1(0.25)))));
+  return D::select(D::gt(q1, D::set1(1.5)), neg_d<D>(res), res);
+}
+template <typename D> inline typename D::vec tan_d(typename D::vec x) {
+  typedef typename D::vec vec;
+  vec q, r = trig_reduce<D>(x, q);
+  vec odd = D::sub(q, D::mul(D::set1(2.0), D::floor(D::mul(q, D::set1(0.5)))));
+  vec t = ktan_d<D>(r);
+  return D::select(D::eq(odd, D::set1(1.0)), D::div(D::set1(-1.0), t), t);
+}
+
+// hyperbolics from exp_d, short odd series near 0 where e - 1/e would cancel
+template <typename D> inline typename D::vec sinh_d(typename D::vec x) {
+  typedef typename D::vec vec;
+  vec a = D::min(D::abs(x), D::set1(100.0));
+  vec e = exp_d<D>(a);
+  vec big = D::mul(D::set1(0.5), D::sub(e, D::div(D::set1(1.0), e)));
+  vec z = D::mul(a, a);
+  vec p = D::fmadd(z, D::set1(1.0 / 362880.0), D::set1(1.0 / 5040.0));
+  p = D::fmadd(p, z, D::set1(1.0 / 120.0));
+  p = D::fmadd(p, z, D::set1(1.0 / 6.0));
+  vec small = D::fmadd(D::mul(p, z), a, a);
+  vec res = D::select(D::lt(a, D::set1(0.125)), small, big);
+  return D::select(D::lt(x, D::set1(0.0)), neg_d<D>(res), res);
+}
+template <typename D> inline typename D::vec cosh_d(typename D::vec x) {
+  typedef typename D::vec vec;
+  vec e = exp_d<D>(D::min(D::abs(x), D::set1(100.0)));
+  return D::mul(D::set1(0.5), D::add(e, D::div(D::set1(1.0), e)));
+}
+template <typename D> inline typename D::vec tanh_d(typename D::vec x) {
+  typedef typename D::vec vec;
+  vec a = D::min(D::abs(x), D::set1(20.0));
+  vec e = exp_d<D>(D::add(a, a));
+  vec big = D::div(D::sub(e, D::set1(1.0)), D::add(e, D::set1(1.0)));
+  vec z = D::mul(a, a);
+  vec p = D::fmadd(z, D::set1(62.0 / 2835.0), D::set1(-17.0 / 315.0));
+  p = D::fmadd(p, z, D::set1(2.0 / 15.0));
+  p = D::fmadd(p, z, D::set1(-1.0 / 3.0));
+  vec small = D::fmadd(D::mul(p, z), a, a);
+  vec res = D::select(D::lt(a, D::set1(0.125)), small, big);
+  return D::select(D::lt(x, D::set1(0.0)), neg_d<D>(res), res);
+}
+
+#define TRIG_MAX_ARG 524288.0f    // 2^19, larger |x| lanes are handed to libm
+
+struct ExpMath {
+  static const bool ranged = false;
+  template <typename D> static typename D::vec eval(typename D::vec x) { return exp_d<D>(x); }
+  static float exact(float x) { return expf(x); }
+};
+struct LogMath {
+  static const bool ranged = false;
+  template <typename D> static typename D::vec eval(typename D::vec x) { return log_d<D>(x); }
+  static float exact(float x) { return logf(x); }
+};
+struct SinMath {
+  static const bool ranged = true;
+  template <typename D> static typename D::vec eval(typename D::vec x) { return sin_d<D>(x); }
+  static float exact(float x) { return sinf(x); }
+};
+struct CosMath {
+  static const bool ranged = true;
+  template <typename D> static typename D::vec eval(typename D::vec x) { return cos_d<D>(x); }
+  static float exact(float x) { return cosf(x); }
+};
+struct TanMath {
+  static const bool ranged = true;
+  template <typename D> static typename D::vec eval(typename D::vec x) { return tan_d<D>(x); }
+  static float exact(float x) { return tanf(x); }
+};
+struct SinhMath {
+  static const bool ranged = false;
+  template <typename D> static typename D::vec eval(typename D::vec x) { return sinh_d<D>(x); }
+  static float exact(float x) { return sinhf(x); }
+};
+struct CoshMath {
+  static const bool ranged = false;
+  template <typename D> static typename D::vec eval(typename D::vec x) { return cosh_d<D>(x); }
+  static float exact(float x) { return coshf(x); }
+};
+struct TanhMath {
+  static const bool ranged = false;
+  template <typename D> static typename D::vec eval(typename D::vec x) { return tanh_d<D>(x); }
+  static float exact(float x) { return tanhf(x); }
+};
+
+// one F32 vector through two F64 halves, nan lanes pass through untouched
+template <typename F, typename D, typename Op> inline void math_block(const float* x, float* out) {
+  typedef typename D::vec dvec;
+  dvec lo = F::to_f64_lo(F::load(x)), hi = F::to_f64_hi(F::load(x));
+  dvec rlo = D::select(D::isnan(lo), lo, Op::template eval<D>(lo));
+  dvec rhi = D::select(D::isnan(hi), hi, Op::template eval<D>(hi));
+  F::store(out, F::from_f64(rlo, rhi));
+  if constexpr (Op::ranged) {
+    const dvec lim = D::set1(TRIG_MAX_ARG);
+    if (D::any(D::gt(D::abs(lo), lim)) || D::any(D::gt(D::abs(hi), lim))) {
+      for (size_t k = 0; k < F::width; k++) {
+        if (x[k] > TRIG_MAX_ARG || x[k] < -TRIG_MAX_ARG) out[k] = Op::exact(x[k]);
+      }
+    }
+  }
+}
+
+// the tail goes through a padded block too, so every element sees the same code path
+template <typename F, typename D, typename Op> void math_loop(const float* x, float* out, size_t n) {
+  const size_t w = F::width;
+  size_t i = 0;
+  for (; i + w <= n; i += w) { math_block<F, D, Op>(x + i, out + i); }
+  if (i < n) {
+    float xb[F::width] = {0}, ob[F::width];
+    memcpy(xb, x + i, (n - i) * sizeof(float));
+    math_block<F, D, Op>(xb, ob);
+    memcpy(out + i, ob, (n - i) * sizeof(float));
+  }
+}
+
+// vector sqrt is correctly rounded, so it's bit-identical to sqrtf
+template <typename F> void sqrt_loop(const float* x, float* out, size_t n) {
+  const size_t w = F::width;
+  size_t i = 0;
+  for (; i + w <= n; i += w) { F::store(out + i, F::sqrt(F::load(x + i))); }
+  for (; i < n; i++) { out[i] = sqrtf(x[i]); }
+}
+
+// dst[j * ds + i] = src[i * ss + j]: SIMD_TRANSPOSE_BLOCK square blocks keep the rows read & the
+// rows written in L1, inside them Tr::B x Tr::B tiles go through registers, ragged edges one by one
+template <typename Tr> void transpose_kernel(const typename Tr::E* src, ptrdiff_t ss, typename Tr::E* dst, ptrdiff_t ds, size_t rows, size_t cols) {
+  const size_t B = Tr::B, L = SIMD_TRANSPOSE_BLOCK;
+  for (size_t i0 = 0; i0 < rows; i0 += L) {
+    size_t i1 = (i0 + L < rows) ? i0 + L : rows;
+    for (size_t j0 = 0; j0 < cols; j0 += L) {
+      size_t j1 = (j0 + L < cols) ? j0 + L : cols;
+      size_t i = i0;
+      for (; i + B <= i1; i += B) {
+        size_t j = j0;
+        for (; j + B <= j1; j += B) { Tr::tile(src + i * ss + j, ss, dst + j * ds + i, ds); }
+        for (; j < j1; j++) { for (size_t r = i; r < i + B; r++) dst[j * ds + r] = src[r * ss + j]; }
+      }
+      for (; i < i1; i++) { for (size_t j = j0; j < j1; j++) dst[j * ds + i] = src[i * ss + j]; }
+    }
+  }
+}
+
+template <typename F, typename D> void math_kernel(int op, const float* x, float* out, size_t n) {
+  switch (op) {
+    case SIMD_SQRT: sqrt_loop<F>(x, out, n); break;
+    case SIMD_EXP: math_loop<F, D, ExpMath>(x, out, n); break;
+    case SIMD_LOG: math_loop<F, D, LogMath>(x, out, n); break;
+    case SIMD_SIN: math_loop<F, D, SinMath>(x, out, n); break;
+    case SIMD_COS: math_loop<F, D, CosMath>(x, out, n); break;
+    case SIMD_TAN: math_loop<F, D, TanMath>(x, out, n); break;
+    case SIMD_SINH: math_loop<F, D, SinhMath>(x, out, n); break;
+    case SIMD_COSH: math_loop<F, D, CoshMath>(x, out, n); break;
+    case SIMD_TANH: math_loop<F, D, TanhMath>(x, out, n); break;
+  }
+}
+
+// tiny n x n matrices in structure-of-arrays blocks: element e of every matrix is the dense row
+// x[e * count ..], one matrix per lane, so a vector works on `width` matrices at once & nothing
+// branches on the data; count is a multiple of the vector width
+template <typename V> inline void swap_lanes(typename V::mask s, typename V::vec& a, typename V::vec& b) {
+  typename V::vec t = V::select(s, b, a);
+  b = V::select(s, a, b);
+  a = t;
+}
+
+// register resident getrf: partial pivoting by compare & select, every row below k trades places
+// with row k in the lanes where its |entry| is larger, which leaves the largest one as the pivot
+template <typename V, int N> struct SmallLU {
+  typedef typename V::vec vec;
+  vec m[N * N], sign;
+  typename V::mask swaps[N * N];    // swaps[k * N + r]: lanes where rows k & r traded places at step k
+  unsigned singular;                // lanes with an exactly zero pivot
+
+  void factor() {
+    const vec zero = V::set1(0);
+    sign = V::set1(1);
+    singular = 0;
+    for (int k = 0; k < N; k++) {
+      for (int r = k + 1; r < N; r++) {
+        typename V::mask s = V::gt(V::abs(m[r * N + k]), V::abs(m[k * N + k]));
+        swaps[k * N + r] = s;
+        for (int c = 0; c < N; c++) swap_lanes<V>(s, m[k * N + c], m[r * N + c]);
+        sign = V::select(s, V::sub(zero, sign), sign);
+      }
+      singular |= V::cmp_eq(m[k * N + k], zero);
+      // a zero pivot column is already eliminated, its lanes skip the update like getrf does
+      typename V::mask live = V::gt(V::abs(m[k * N + k]), zero);
+      vec inv = V::div(V::set1(1), m[k * N + k]);
+      for (int r = k + 1; r < N; r++) {
+        vec l = V::select(live, V::mul(m[r * N + k], inv), zero);
+        m[r * N + k] = l;
+        for (int c = k + 1; c < N; c++) m[r * N + c] = V::sub(m[r * N + c], V::mul(l, m[k * N + c]));
+      }
+    }
+  }
+
+  vec det() const {
+    vec d = sign;
+    for (int k = 0; k < N; k++) d = V::mul(d, m[k * N + k]);
+    return d;
+  }
+
+  // x = A^-1 x for one column: all the row swaps first (like getrs), then L & U
+  void solve(vec* x) const {
+    for (int k = 0; k < N; k++) {
+      for (int r = k + 1; r < N; r++) swap_lanes<V>(swaps[k * N + r], x[k], x[r]);
+    }
+    for (int k = 0; k < N; k++) {
+      for (int r = k + 1; r < N; r++) x[r] = V::sub(x[r], V::mul(m[r * N + k], x[k]));
+    }
+    for (int k = N - 1; k >= 0; k--) {
+      vec s = x[k];
+      for (int j = k + 1; j < N; j++) s = V::sub(s, V::mul(m[k * N + j], x[j]));
+      x[k] = V::div(s, m[k * N + k]);
+    }
+  }
+};
+
+// closed form 2x2 & 3x3 inverse from the adjugate, out gets adj(a) / det(a)
+template <typename V, int N> inline typename V::vec adjugate(const typename V::vec* m, typename V::vec* adj) {
+  typedef typename V::vec vec;
+  if constexpr (N == 2) {
+    const vec zero = V::set1(0);
+    adj[0] = m[3]; adj[1] = V::sub(zero, m[1]); adj[2] = V::sub(zero, m[2]); adj[3] = m[0];
+    return V::sub(V::mul(m[0], m[3]), V::mul(m[1], m[2]));
+  } else {
+    adj[0] = V::sub(V::mul(m[4], m[8]), V::mul(m[5], m[7]));
+    adj[1] = V::sub(V::mul(m[2], m[7]), V::mul(m[1], m[8]));
+    adj[2] = V::sub(V::mul(m[1], m[5]), V::mul(m[2], m[4]));
+    adj[3] = V::sub(V::mul(m[5], m[6]), V::mul(m[3], m[8]));
+    adj[4] = V::sub(V::mul(m[0], m[8]), V::mul(m[2], m[6]));
+    adj[5] = V::sub(V::mul(m[2], m[3]), V::mul(m[0], m[5]));
+    adj[6] = V::sub(V::mul(m[3], m[7]), V::mul(m[4], m[6]));
+    adj[7] = V::sub(V::mul(m[1], m[6]), V::mul(m[0], m[7]));
+    adj[8] = V::sub(V::mul(m[0], m[4]), V::mul(m[1], m[3]));
+    return V::fmadd(m[0], adj[0], V::fmadd(m[1], adj[3], V::mul(m[2], adj[6])));
+  }
+}
+
+// eigenvalues of symmetric 2x2 & 3x3 (upper triangle read) ascending: the 2x2 from its mean & the
+// half gap, the 3x3 by the trigonometric solution of the characteristic cubic (Smith 1961), the
+// acos & cos of each lane going through libm
+template <typename V, int N> inline void small_eigh(const typename V::vec* m, typename V::T* out, size_t count, size_t i) {
+  typedef typename V::T T;
+  typedef typename V::vec vec;
+  const vec half = V::set1((T)0.5);
+  if constexpr (N == 2) {
+    vec mean = V::mul(V::add(m[0], m[3]), half), gap = V::mul(V::sub(m[0], m[3]), half);
+    vec r = V::sqrt(V::fmadd(gap, gap, V::mul(m[1], m[1])));
+    V::store(out + i, V::sub(mean, r));
+    V::store(out + count + i, V::add(mean, r));
+  } else {
+    vec q = V::mul(V::add(V::add(m[0], m[4]), m[8]), V::set1((T)1 / 3));
+    vec b0 = V::sub(m[0], q), b1 = V::sub(m[4], q), b2 = V::sub(m[8], q);
+    vec off = V::fmadd(m[1], m[1], V::fmadd(m[2], m[2], V::mul(m[5], m[5])));
+    vec p2 = V::fmadd(b0, b0, V::fmadd(b1, b1, V::fmadd(b2, b2, V::add(off, off))));
+    vec p = V::sqrt(V::mul(p2, V::set1((T)1 / 6)));
+    // det(A - q I), which is 2 p^3 cos(3 phi)
+    vec d = V::sub(V::mul(b0, V::sub(V::mul(b1, b2), V::mul(m[5], m[5]))), V::mul(m[1], V::sub(V::mul(m[1], b2), V::mul(m[5], m[2]))));
+    d = V::fmadd(m[2], V::sub(V::mul(m[1], m[5]), V::mul(b1, m[2])), d);
+    T qs[V::width], ps[V::width], ds[V::width];
+    V::store(qs, q); V::store(ps, p); V::store(ds, d);
+    for (size_t l = 0; l < V::width; l++) {
+      double pl = ps[l], ql = qs[l], lo = ql, mid = ql, hi = ql;
+      if (pl > 0) {
+        double r = ds[l] / (2 * pl * pl * pl);
+        double phi = acos(r < -1 ? -1 : (r > 1 ? 1 : r)) / 3;
+        hi = ql + 2 * pl * cos(phi);
+        lo = ql + 2 * pl * cos(phi + 2.0943951023931957);   // + 2 pi / 3
+        mid = 3 * ql - hi - lo;
+      }
+      out[i + l] = (T)lo; out[count + i + l] = (T)mid; out[2 * count + i + l] = (T)hi;
+    }
+  }
+}
+
+// one vector of lanes through simd_small_t `op`, returns the lanes that hit a zero pivot
+template <typename V, int N> inline unsigned small_block(int op, int nrhs, const typename V::T* a, const typename V::T* b, typename V::T* out, size_t count, size_t i) {
+  typedef typename V::vec vec;
+  vec m[N * N];
+  for (int e = 0; e < N * N; e++) m[e] = V::load(a + e * count + i);
+  if (op == SIMD_SMALL_EIGH) {
+    if constexpr (N <= 3) small_eigh<V, N>(m, out, count, i);
+    return 0;
+  }
+  if constexpr (N <= 3) {
+    if (op != SIMD_SMALL_SOLVE) {
+      vec adj[N * N], d = adjugate<V, N>(m, adj);
+      if (op == SIMD_SMALL_DET) { V::store(out + i, d); return 0; }
+      vec inv = V::div(V::set1(1), d);
+      for (int e = 0; e < N * N; e++) V::store(out + e * count + i, V::mul(adj[e], inv));
+      return V::cmp_eq(d, V::set1(0));
+    }
+  }
+  SmallLU<V, N> lu;
+  for (int e = 0; e < N * N; e++) lu.m[e] = m[e];
+  lu.factor();
+  if (op == SIMD_SMALL_DET) { V::store(out + i, lu.det()); return 0; }
+  int cols = (op == SIMD_SMALL_INV) ? N : nrhs;
+  for (int c = 0; c < cols; c++) {
+    vec x[N];
+    for (int r = 0; r < N; r++) x[r] = (op == SIMD_SMALL_INV) ? V::set1(r == c ? 1 : 0) : V::load(b + (r * nrhs + c) * count + i);
+    lu.solve(x);
+    for (int r = 0; r < N; r++) V::store(out + (r * cols + c) * count + i, x[r]);
+  }
+  return lu.singular;
+}
+
+template <typename V, int N> int small_loop(int op, int nrhs, const typename V::T* a, const typename V::T* b, typename V::T* out, size_t count) {
+  for (size_t i = 0; i < count; i += V::width) {
+    unsigned singular = small_block<V, N>(op, nrhs, a, b, out, count, i);
+    if (singular) return (int)(i + __builtin_ctz(singular)) + 1;
+  }
+  return 0;
+}
+
+template <typename V> int small_kernel(int op, int n, int nrhs, const typename V::T* a, const typename V::T* b, typename V::T* out, size_t count) {
+  switch (n) {
+    case 2: return small_loop<V, 2>(op, nrhs, a, b, out, count);
+    case 3: return small_loop<V, 3>(op, nrhs, a, b, out, count);
+    case 4: return small_loop<V, 4>(op, nrhs, a, b, out, count);
+    case 5: return small_loop<V, 5>(op, nrhs, a, b, out, count);
+    case 6: return small_loop<V, 6>(op, nrhs, a, b, out, count);
+    case 7: return small_loop<V, 7>(op, nrhs, a, b, out, count);
+    case 8: return small_loop<V, 8>(op, nrhs, a, b, out, count);
+  }
+  return 0;
+}
+
+}
+
+#endif  //!__SIMD_KERNELS__H__
@@ -0,0 +1,138 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+
+// everything below is compiled for sse4.1, only reached through the table once cpuid reports it
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.1"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+#endif
+
+namespace {
+
+struct F32 {
+  typedef float T;
+  typedef __m128 vec;
+  static const size_t width = 4;
+  static vec load(const T* p) { return _mm_loadu_ps(p); }
+  static void store(T* p, vec v) { _mm_storeu_ps(p, v); }
+  static vec set1(T v) { return _mm_set1_ps(v); }
+  static vec add(vec a, vec b) { return _mm_add_ps(a, b); }
+  static vec sub(vec a, vec b) { return _mm_sub_ps(a, b); }
+  static vec mul(vec a, vec b) { return _mm_mul_ps(a, b); }
+  static vec div(vec a, vec b) { return _mm_div_ps(a, b); }
+  static unsigned cmp_eq(vec a, vec b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+  static unsigned cmp_ne(vec a, vec b) { return _mm_movemask_ps(_mm_cmpneq_ps(a, b)); }
+  static unsigned cmp_gt(vec a, vec b) { return _mm_movemask_ps(_mm_cmpgt_ps(a, b)); }
+  static unsigned cmp_ge(vec a, vec b) { return _mm_movemask_ps(_mm_cmpge_ps(a, b)); }
+  static unsigned cmp_lt(vec a, vec b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+  static unsigned cmp_le(vec a, vec b) { return _mm_movemask_ps(_mm_cmple_ps(a, b)); }
+  static vec fmadd(vec a, vec b, vec c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+  static vec sqrt(vec a) { return _mm_sqrt_ps(a); }
+  static vec abs(vec a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+  typedef __m128 mask;
+  static mask gt(vec a, vec b) { return _mm_cmpgt_ps(a, b); }
+  static vec min(vec a, vec b) { return _mm_min_ps(a, b); }
+  static vec max(vec a, vec b) { return _mm_max_ps(a, b); }
+  static mask isnan(vec a) { return _mm_cmpunord_ps(a, a); }
+  static vec select(mask m, vec a, vec b) { return _mm_blendv_ps(b, a, m); }
+  static __m128d to_f64_lo(vec a) { return _mm_cvtps_pd(a); }
+  static __m128d to_f64_hi(vec a) { return _mm_cvtps_pd(_mm_movehl_ps(a, a)); }
+  static vec from_f64(__m128d lo, __m128d hi) { return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)); }
+};
+
+struct F64 {
+  typedef double T;
+  typedef __m128d vec;
+  static const size_t width = 2;
+  static vec load(const T* p) { return _mm_loadu_pd(p); }
+  static void store(T* p, vec v) { _mm_storeu_pd(p, v); }
+  static vec set1(T v) { return _mm_set1_pd(v); }
+  static vec add(vec a, vec b) { return _mm_add_pd(a, b); }
+  static vec sub(vec a, vec b) { return _mm_sub_pd(a, b); }
+  static vec mul(vec a, vec b) { return _mm_mul_pd(a, b); }
+  static vec div(vec a, vec b) { return _mm_div_pd(a, b); }
+  static unsigned cmp_eq(vec a, vec b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+  static unsigned cmp_ne(vec a, vec b) { return _mm_movemask_pd(_mm_cmpneq_pd(a, b)); }
+  static unsigned cmp_gt(vec a, vec b) { return _mm_movemask_pd(_mm_cmpgt_pd(a, b)); }
+  static unsigned cmp_ge(vec a, vec b) { return _mm_movemask_pd(_mm_cmpge_pd(a, b)); }
+  static unsigned cmp_lt(vec a, vec b) { return _mm_movemask_pd(_mm_cmplt_pd(a, b)); }
+  static unsigned cmp_le(vec a, vec b) { return _mm_movemask_pd(_mm_cmple_pd(a, b)); }
+  typedef __m128d mask;
+  static vec fmadd(vec a, vec b, vec c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+  static vec sqrt(vec a) { return _mm_sqrt_pd(a); }
+  static vec min(vec a, vec b) { return _mm_min_pd(a, b); }
+  static vec max(vec a, vec b) { return _mm_max_pd(a, b); }
+  static vec abs(vec a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+  static vec round(vec a) { return _mm_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+  static vec floor(vec a) { return _mm_round_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+  static mask lt(vec a, vec b) { return _mm_cmplt_pd(a, b); }
+  static mask gt(vec a, vec b) { return _mm_cmpgt_pd(a, b); }
+  static mask eq(vec a, vec b) { return _mm_cmpeq_pd(a, b); }
+  static mask isnan(vec a) { return _mm_cmpunord_pd(a, a); }
+  static vec select(mask m, vec a, vec b) { return _mm_blendv_pd(b, a, m); }
+  static bool any(mask m) { return _mm_movemask_pd(m) != 0; }
+  // 2^n for integral n in [-1022, 1023]: n + 1023 lands in the low mantissa bits of n + 2^52 + 1023
+  static vec exp2i(vec n) { return _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(_mm_add_pd(n, _mm_set1_pd(4503599627371519.0))), 52)); }
+  // unbiased exponent & [1, 2) mantissa of positive normal values
+  static vec exponent(vec a) {
+    __m128i e = _mm_or_si128(_mm_srli_epi64(_mm_castpd_si128(a), 52), _mm_castpd_si128(_mm_set1_pd(4503599627370496.0)));
+    return _mm_sub_pd(_mm_castsi128_pd(e), _mm_set1_pd(4503599627371519.0));
+  }
+  static vec mantissa(vec a) {
+    __m128i m = _mm_and_si128(_mm_castpd_si128(a), _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+    return _mm_castsi128_pd(_mm_or_si128(m, _mm_set1_epi64x(0x3FF0000000000000LL)));
+  }
+};
+
+// 4x4 & 2x2 tiles, floats & doubles are only used as bit containers here
+struct T32 {
+  typedef uint32_t E;
+  static const size_t B = 4;
+  static void tile(const E* s, ptrdiff_t ss, E* d, ptrdiff_t ds) {
+    __m128 r0 = _mm_loadu_ps((const float*)s), r1 = _mm_loadu_ps((const float*)(s + ss));
+    __m128 r2 = _mm_loadu_ps((const float*)(s + 2 * ss)), r3 = _mm_loadu_ps((const float*)(s + 3 * ss));
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps((float*)d, r0);
+    _mm_storeu_ps((float*)(d + ds), r1);
+    _mm_storeu_ps((float*)(d + 2 * ds), r2);
+    _mm_storeu_ps((float*)(d + 3 * ds), r3);
+  }
+};
+
+struct T64 {
+  typedef uint64_t E;
+  static const size_t B = 2;
+  static void tile(const E* s, ptrdiff_t ss, E* d, ptrdiff_t ds) {
+    __m128d r0 = _mm_loadu_pd((const double*)s), r1 = _mm_loadu_pd((const double*)(s + ss));
+    _mm_storeu_pd((double*)d, _mm_unpacklo_pd(r0, r1));
+    _mm_storeu_pd((double*)(d + ds), _mm_unpackhi_pd(r0, r1));
+  }
+};
+
+}
+
+#include "simd_kernels.h"
+
+extern const SimdKernels simd_sse4_kernels = {
+  "sse4", arith_kernel<F32>, arith_kernel<F64>, compare_kernel<F32>, compare_kernel<F64>,
+  math_kernel<F32, F64>, {6, 2 * F32::width, gemm_micro<F32, 6, 2>}, {6, 2 * F64::width, gemm_micro<F64, 6, 2>},
+  transpose_kernel<T32>, transpose_kernel<T64>, reduce_kernel<F32>, reduce_kernel<F64>, fold_kernel<F32>, fold_kernel<F64>,
+  dot_kernel<F32>, dot_kernel<F64>, ksum_kernel<F32>, ksum_kernel<F64>, kfold_kernel<F32>, kfold_kernel<F64>,
+  small_kernel<F32>, small_kernel<F64>
+};
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif
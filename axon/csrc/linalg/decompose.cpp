@@ -3,35 +3,40 @@
 #include "../cpu/ops_decomp.h"
 #include "decompose.h"
 
-Array** svd_array(Array* a) {
+Array** svd_array(Array* a, bool full_matrices, bool compute_uv) {
   if (a->ndim < 2) {
     fprintf(stderr, "Input array must be at least 2D for SVD\n");
     exit(EXIT_FAILURE);
   }
 
   int m = a->shape[a->ndim - 2], n = a->shape[a->ndim - 1], min_mn = (m < n) ? m : n;
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
+  // full: u is m x m & vt n x n, otherwise m x k & k x n (k = min(m, n)); neither is computed without compute_uv
+  int u_cols = full_matrices ? m : min_mn, vt_rows = full_matrices ? n : min_mn;
+  // integer inputs are decomposed in float32, results are cast back to the input dtype
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
   size_t batch_size = 1;
   for (int i = 0; i < a->ndim - 2; i++) batch_size *= a->shape[i];
-  size_t u_size = batch_size * m * m, s_size = batch_size * min_mn, vt_size = batch_size * n * n;  
-  float *u = (float*)malloc(u_size * sizeof(float)), *s = (float*)malloc(s_size * sizeof(float)), *vt = (float*)malloc(vt_size * sizeof(float));
-  if (a->ndim == 2) svd_ops(a_float, u, s, vt, a->shape);
-  else batched_svd_ops(a_float, u, s, vt, a->shape, a->ndim);
+  size_t u_size = batch_size * m * u_cols, s_size = batch_size * min_mn, vt_size = batch_size * vt_rows * n;
   int *u_shape = (int*)malloc(a->ndim * sizeof(int)), *s_shape = (int*)malloc((a->ndim - 1) * sizeof(int)), *vt_shape = (int*)malloc(a->ndim * sizeof(int));
   for (int i = 0; i < a->ndim - 2; i++) {
     u_shape[i] = a->shape[i];
     s_shape[i] = a->shape[i];
     vt_shape[i] = a->shape[i];
   }
-  u_shape[a->ndim - 2] = m; u_shape[a->ndim - 1] = m; s_shape[a->ndim - 2] = min_mn; vt_shape[a->ndim - 2] = n; vt_shape[a->ndim - 1] = n;
-  Array* u_result = create_array(u, a->ndim, u_shape, u_size, a->dtype);
-  Array* s_result = create_array(s, a->ndim - 1, s_shape, s_size, a->dtype);
-  Array* vt_result = create_array(vt, a->ndim, vt_shape, vt_size, a->dtype);
-  free(a_float); free(u); free(s); free(vt);
+  u_shape[a->ndim - 2] = m; u_shape[a->ndim - 1] = u_cols; s_shape[a->ndim - 2] = min_mn; vt_shape[a->ndim - 2] = vt_rows; vt_shape[a->ndim - 1] = n;
+  Array* u_result = compute_uv ? empty_array(a->ndim, u_shape, u_size, dtype) : NULL;
+  Array* s_result = empty_array(a->ndim - 1, s_shape, s_size, dtype);
+  Array* vt_result = compute_uv ? empty_array(a->ndim, vt_shape, vt_size, dtype) : NULL;
+  void *u_data = compute_uv ? u_result->data : NULL, *vt_data = compute_uv ? vt_result->data : NULL;
+  if (a->ndim == 2) svd_ops(a_data, u_data, s_result->data, vt_data, a->shape, full_matrices, dtype);
+  else batched_svd_ops(a_data, u_data, s_result->data, vt_data, a->shape, a->ndim, full_matrices, dtype);
+  cast_array_inplace(s_result, a->dtype);
+  if (compute_uv) { cast_array_inplace(u_result, a->dtype); cast_array_inplace(vt_result, a->dtype); }
+  release_dtype_data(a_data, a->data);
   free(u_shape); free(s_shape); free(vt_shape);
   Array** result = (Array**)malloc(3 * sizeof(Array*));
   result[0] = u_result; result[1] = s_result; result[2] = vt_result;
-  free(u_result); free(s_result); free(vt_result);
   return result;
 }
 
@@ -46,15 +51,16 @@ Array* cholesky_array(Array* a) {
     fprintf(stderr, "Matrix must be square for Cholesky decomposition: %d != %d\n", second_last_dim, last_dim);
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
   int* result_shape = (int*)malloc(a->ndim * sizeof(int));
   for (size_t i = 0; i < a->ndim; i++) result_shape[i] = a->shape[i];
   size_t result_size = a->size;
-  float* out = (float*)malloc(result_size * sizeof(float));
-  if (a->ndim == 2) chol_ops(a_float, out, a->shape);
-  else batched_chol_ops(a_float, out, a->shape, a->ndim);
-  Array* result = create_array(out, a->ndim, result_shape, result_size, a->dtype);
-  free(a_float); free(out); free(result_shape);
+  Array* result = empty_array(a->ndim, result_shape, result_size, dtype);
+  if (a->ndim == 2) chol_ops(a_data, result->data, a->shape, dtype);
+  else batched_chol_ops(a_data, result->data, a->shape, a->ndim, dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(result_shape);
   return result;
 }
 
@@ -70,10 +76,12 @@ Array* eig_array(Array* a) {
 
   int* shape = (int*)malloc(1 * sizeof(int));
   shape[0] = a->shape[0]; // eigenvalues count equals matrix dimension
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *out = (float*)malloc(a->shape[0] * sizeof(float));
-  eigenvals_ops_array(a_float, out, a->shape[0]);
-  Array* result = create_array(out, 1, shape, a->shape[0], a->dtype);
-  free(a_float); free(out); free(shape);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array* result = empty_array(1, shape, a->shape[0], dtype);
+  eigenvals_ops_array(a_data, result->data, a->shape[0], dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(shape);
   return result;
 }
 
@@ -88,10 +96,12 @@ Array* eigv_array(Array* a) {
   }
   int* shape = (int*)malloc(2 * sizeof(int));
   shape[0] = a->shape[0]; shape[1] = a->shape[1]; // same dimensions as input matrix
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *out = (float*)malloc(a->size * sizeof(float));
-  eigenvecs_ops_array(a_float, out, a->shape[0]);
-  Array* result = create_array(out, 2, shape, a->size, a->dtype);
-  free(a_float); free(out); free(shape);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array* result = empty_array(2, shape, a->size, dtype);
+  eigenvecs_ops_array(a_data, result->data, a->shape[0], dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(shape);
   return result;
 }
 
@@ -107,10 +117,12 @@ Array* eigh_array(Array* a) {
 
   int* shape = (int*)malloc(1 * sizeof(int));
   shape[0] = a->shape[0]; // eigenvalues count equals matrix dimension
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *out = (float*)malloc(a->shape[0] * sizeof(float));
-  eigenvals_h_ops_array(a_float, out, a->shape[0]);
-  Array* result = create_array(out, 1, shape, a->shape[0], a->dtype);
-  free(a_float); free(out); free(shape);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array* result = empty_array(1, shape, a->shape[0], dtype);
+  eigenvals_h_ops_array(a_data, result->data, a->shape[0], dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(shape);
   return result;
 }
 
@@ -126,10 +138,12 @@ Array* eighv_array(Array* a) {
 
   int* shape = (int*)malloc(2 * sizeof(int));
   shape[0] = a->shape[0]; shape[1] = a->shape[1]; // same dimensions as input matrix
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *out = (float*)malloc(a->size * sizeof(float));
-  eigenvecs_h_ops_array(a_float, out, a->shape[0]);
-  Array* result = create_array(out, 2, shape, a->size, a->dtype);
-  free(a_float); free(out); free(shape);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array* result = empty_array(2, shape, a->size, dtype);
+  eigenvecs_h_ops_array(a_data, result->data, a->shape[0], dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(shape);
   return result;
 }
 
@@ -145,10 +159,12 @@ Array* batched_eig_array(Array* a) {
 
   int* shape = (int*)malloc(2 * sizeof(int));
   shape[0] = a->shape[0], shape[1] = a->shape[1];
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *out = (float*)malloc(a->shape[0] * a->shape[1] * sizeof(float));
-  batched_eigenvals_ops(a_float, out, a->shape[1], a->shape[0]);
-  Array* result = create_array(out, 2, shape, a->shape[0] * a->shape[1], a->dtype);
-  free(a_float); free(out); free(shape);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array* result = empty_array(2, shape, a->shape[0] * a->shape[1], dtype);
+  batched_eigenvals_ops(a_data, result->data, a->shape[1], a->shape[0], dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(shape);
   return result;
 }
 
@@ -164,10 +180,12 @@ Array* batched_eigv_array(Array* a) {
 
   int* shape = (int*)malloc(3 * sizeof(int));
   shape[0] = a->shape[0], shape[1] = a->shape[1], shape[2] = a->shape[2];
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *out = (float*)malloc(a->size * sizeof(float));
-  batched_eigenvecs_ops(a_float, out, a->shape[1], a->shape[0]);
-  Array* result = create_array(out, 3, shape, a->size, a->dtype);
-  free(a_float); free(out); free(shape);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array* result = empty_array(3, shape, a->size, dtype);
+  batched_eigenvecs_ops(a_data, result->data, a->shape[1], a->shape[0], dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(shape);
   return result;
 }
 
@@ -183,10 +201,12 @@ Array* batched_eigh_array(Array* a) {
 
   int* shape = (int*)malloc(2 * sizeof(int));
   shape[0] = a->shape[0], shape[1] = a->shape[1];
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *out = (float*)malloc(a->shape[0] * a->shape[1] * sizeof(float));
-  batched_eigenvals_h_ops(a_float, out, a->shape[1], a->shape[0]);
-  Array* result = create_array(out, 2, shape, a->shape[0] * a->shape[1], a->dtype);
-  free(a_float); free(out); free(shape);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array* result = empty_array(2, shape, a->shape[0] * a->shape[1], dtype);
+  batched_eigenvals_h_ops(a_data, result->data, a->shape[1], a->shape[0], dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(shape);
   return result;
 }
 
@@ -202,52 +222,58 @@ Array* batched_eighv_array(Array* a) {
 
   int* shape = (int*)malloc(3 * sizeof(int));
   shape[0] = a->shape[0], shape[1] = a->shape[1], shape[2] = a->shape[2];
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *out = (float*)malloc(a->size * sizeof(float));
-  batched_eigenvecs_h_ops(a_float, out, a->shape[1], a->shape[0]);
-  Array* result = create_array(out, 3, shape, a->size, a->dtype);
-  free(a_float); free(out); free(shape);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array* result = empty_array(3, shape, a->size, dtype);
+  batched_eigenvecs_h_ops(a_data, result->data, a->shape[1], a->shape[0], dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(shape);
   return result;
 }
 
-Array** qr_array(Array* a) {
+Array** qr_array(Array* a, bool reduced) {
   if (a->ndim != 2) {
     fprintf(stderr, "Only 2D array supported for qr()\n");
     exit(EXIT_FAILURE);
   }
 
-  int m = a->shape[0], n = a->shape[1];
+  int m = a->shape[0], n = a->shape[1], k = reduced && n < m ? n : m;    // q is m x k & r is k x n
   int *q_shape = (int*)malloc(2 * sizeof(int)), *r_shape = (int*)malloc(2 * sizeof(int));
-  q_shape[0] = m; q_shape[1] = m; r_shape[0] = m; r_shape[1] = n;
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *q_out = (float*)malloc(m * m * sizeof(float)), *r_out = (float*)malloc(m * n * sizeof(float));
-  qr_decomp_ops(a_float, q_out, r_out, a->shape);
+  q_shape[0] = m; q_shape[1] = k; r_shape[0] = k; r_shape[1] = n;
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
   Array** result = (Array**)malloc(2 * sizeof(Array*));
-  result[0] = create_array(q_out, 2, q_shape, m * m, a->dtype);
-  result[1] = create_array(r_out, 2, r_shape, m * n, a->dtype);
-  free(a_float); free(q_out); free(r_out); free(q_shape); free(r_shape);
+  result[0] = empty_array(2, q_shape, m * k, dtype);
+  result[1] = empty_array(2, r_shape, k * n, dtype);
+  qr_decomp_ops(a_data, result[0]->data, result[1]->data, a->shape, reduced, dtype);
+  cast_array_inplace(result[0], a->dtype); cast_array_inplace(result[1], a->dtype);
+  release_dtype_data(a_data, a->data); free(q_shape); free(r_shape);
   return result;
 }
 
-Array** batched_qr_array(Array* a) {
+Array** batched_qr_array(Array* a, bool reduced) {
   if (a->ndim < 2) {
     fprintf(stderr, "Array must have at least 2 dimensions for batched qr()\n");
     exit(EXIT_FAILURE);
   }
 
-  int m = a->shape[a->ndim - 2], n = a->shape[a->ndim - 1], batch_size = 1;
+  int m = a->shape[a->ndim - 2], n = a->shape[a->ndim - 1], k = reduced && n < m ? n : m, batch_size = 1;
   for (int i = 0; i < a->ndim - 2; i++) { batch_size *= a->shape[i]; }
   int *q_shape = (int*)malloc(a->ndim * sizeof(int)), *r_shape = (int*)malloc(a->ndim * sizeof(int));
   for (int i = 0; i < a->ndim - 2; i++) {
     q_shape[i] = a->shape[i];
     r_shape[i] = a->shape[i];
   }
-  q_shape[a->ndim - 2] = m; q_shape[a->ndim - 1] = m;
-  r_shape[a->ndim - 2] = m; r_shape[a->ndim - 1] = n;
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size), *q_out = (float*)malloc(batch_size * m * m * sizeof(float)), *r_out = (float*)malloc(batch_size * m * n * sizeof(float));
-  batched_qr_decomp_ops(a_float, q_out, r_out, a->shape, a->ndim);
+  q_shape[a->ndim - 2] = m; q_shape[a->ndim - 1] = k;
+  r_shape[a->ndim - 2] = k; r_shape[a->ndim - 1] = n;
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
   Array** result = (Array**)malloc(2 * sizeof(Array*));
-  result[0] = create_array(q_out, a->ndim, q_shape, batch_size * m * m, a->dtype);
-  result[1] = create_array(r_out, a->ndim, r_shape, batch_size * m * n, a->dtype);
-  free(a_float); free(q_out); free(r_out); free(q_shape); free(r_shape);
+  result[0] = empty_array(a->ndim, q_shape, batch_size * m * k, dtype);
+  result[1] = empty_array(a->ndim, r_shape, batch_size * k * n, dtype);
+  batched_qr_decomp_ops(a_data, result[0]->data, result[1]->data, a->shape, a->ndim, reduced, dtype);
+  cast_array_inplace(result[0], a->dtype); cast_array_inplace(result[1], a->dtype);
+  release_dtype_data(a_data, a->data); free(q_shape); free(r_shape);
   return result;
 }
 
@@ -265,13 +291,15 @@ Array** lu_array(Array* a) {
   int *l_shape = (int*)malloc(2 * sizeof(int)), *u_shape = (int*)malloc(2 * sizeof(int));
   l_shape[0] = n; l_shape[1] = n;
   u_shape[0] = n; u_shape[1] = n;
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *l_out = (float*)malloc(n * n * sizeof(float)), *u_out = (float*)malloc(n * n * sizeof(float));
-  int* p_out = (int*)malloc(n * sizeof(int));
-  lu_decomp_ops(a_float, l_out, u_out, p_out, a->shape);
-  Array** result = (Array**)malloc(2 * sizeof(Array*));
-  result[0] = create_array(l_out, 2, l_shape, n * n, a->dtype);
-  result[1] = create_array(u_out, 2, u_shape, n * n, a->dtype);
-  free(a_float); free(l_out); free(u_out); free(p_out); free(l_shape); free(u_shape); 
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array** result = (Array**)malloc(3 * sizeof(Array*));
+  result[0] = empty_array(2, l_shape, n * n, dtype);
+  result[1] = empty_array(2, u_shape, n * n, dtype);
+  result[2] = empty_array(1, a->shape, n, DTYPE_INT32);
+  lu_decomp_ops(a_data, result[0]->data, result[1]->data, (int*)result[2]->data, a->shape, dtype);
+  cast_array_inplace(result[0], a->dtype); cast_array_inplace(result[1], a->dtype);
+  release_dtype_data(a_data, a->data); free(l_shape); free(u_shape);
   return result;
 }
 
@@ -293,12 +321,148 @@ Array** batched_lu_array(Array* a) {
     l_shape[i] = a->shape[i];
     u_shape[i] = a->shape[i];
   }
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *l_out = (float*)malloc(a->size * sizeof(float)), *u_out = (float*)malloc(a->size * sizeof(float));
-  int* p_out = (int*)malloc(batch_size * n * sizeof(int));
-  batched_lu_decomp_ops(a_float, l_out, u_out, p_out, a->shape, a->ndim);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array** result = (Array**)malloc(3 * sizeof(Array*));
+  result[0] = empty_array(a->ndim, l_shape, a->size, dtype);
+  result[1] = empty_array(a->ndim, u_shape, a->size, dtype);
+  result[2] = empty_array(a->ndim - 1, a->shape, (size_t)batch_size * n, DTYPE_INT32);
+  batched_lu_decomp_ops(a_data, result[0]->data, result[1]->data, (int*)result[2]->data, a->shape, a->ndim, dtype);
+  cast_array_inplace(result[0], a->dtype); cast_array_inplace(result[1], a->dtype);
+  release_dtype_data(a_data, a->data); free(l_shape); free(u_shape);
+  return result;
+}
+// leading dims of a stack of square matrices, n & the matrix count
+static size_t square_batch(Array* a, const char* name, int* n) {
+  if (a->ndim < 2) {
+    fprintf(stderr, "Input array must be at least 2D for %s()\n", name);
+    exit(EXIT_FAILURE);
+  }
+  *n = a->shape[a->ndim - 1];
+  if (a->shape[a->ndim - 2] != *n) {
+    fprintf(stderr, "Array must be square for %s(). dim%zu '%d' != dim%zu '%d'\n", name, a->ndim - 2, a->shape[a->ndim - 2], a->ndim - 1, *n);
+    exit(EXIT_FAILURE);
+  }
+  return (*n > 0) ? a->size / ((size_t)*n * *n) : 0;
+}
+
+Array** lu_factor_array(Array* a) {
+  int n;
+  size_t batch = square_batch(a, "lu_factor", &n);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  int* piv_shape = (int*)malloc(a->ndim * sizeof(int));
+  for (size_t i = 0; i < a->ndim - 1; i++) piv_shape[i] = a->shape[i];
   Array** result = (Array**)malloc(2 * sizeof(Array*));
-  result[0] = create_array(l_out, a->ndim, l_shape, a->size, a->dtype);
-  result[1] = create_array(u_out, a->ndim, u_shape, a->size, a->dtype);
-  free(a_float); free(l_out); free(u_out); free(p_out); free(l_shape); free(u_shape);
+  result[0] = empty_array(a->ndim, a->shape, a->size, dtype);
+  result[1] = empty_array(a->ndim - 1, piv_shape, batch * n, DTYPE_INT32);
+  // the factors stay in the float dtype they were computed in, lu_solve_array takes them as is
+  lu_factor_ops(a_data, result[0]->data, (int*)result[1]->data, n, batch, dtype);
+  release_dtype_data(a_data, a->data); free(piv_shape);
   return result;
-}
\ No newline at end of file
+}
+
+Array* cho_factor_array(Array* a) {
+  int n;
+  size_t batch = square_batch(a, "cho_factor", &n);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, dtype);
+  cho_factor_ops(a_data, result->data, n, batch, dtype);
+  release_dtype_data(a_data, a->data);
+  return result;
+}
+
+Array** eig_parts_array(Array* a) {
+  int n;
+  size_t batch = square_batch(a, "eig", &n);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array** result = (Array**)malloc(2 * sizeof(Array*));
+  for (int i = 0; i < 2; i++) result[i] = empty_array(a->ndim - 1, a->shape, batch * n, dtype);
+  eig_parts_ops(a_data, result[0]->data, result[1]->data, n, batch, dtype);
+  release_dtype_data(a_data, a->data);
+  return result;
+}
+
+Array** svd_topk_array(Array* a, int k, int iters, int64_t seed, bool compute_uv) {
+  if (a->ndim < 2) {
+    fprintf(stderr, "Input array must be at least 2D for SVD\n");
+    exit(EXIT_FAILURE);
+  }
+  int m = a->shape[a->ndim - 2], n = a->shape[a->ndim - 1], min_mn = (m < n) ? m : n;
+  if (k < 1 || k > min_mn || iters < 0) {
+    fprintf(stderr, "svd(k=%d, n_iter=%d) needs 1 <= k <= min(m, n) = %d & n_iter >= 0\n", k, iters, min_mn);
+    exit(EXIT_FAILURE);
+  }
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  size_t batch = 1;
+  for (int i = 0; i < a->ndim - 2; i++) batch *= a->shape[i];
+  int* shape = (int*)malloc(a->ndim * sizeof(int));
+  for (int i = 0; i < a->ndim - 2; i++) shape[i] = a->shape[i];
+  Array** result = (Array**)malloc(3 * sizeof(Array*));
+  shape[a->ndim - 2] = k;
+  result[1] = empty_array(a->ndim - 1, shape, batch * k, dtype);
+  result[0] = result[2] = NULL;
+  if (compute_uv) {
+    shape[a->ndim - 2] = m; shape[a->ndim - 1] = k;
+    result[0] = empty_array(a->ndim, shape, batch * m * k, dtype);
+    shape[a->ndim - 2] = k; shape[a->ndim - 1] = n;
+    result[2] = empty_array(a->ndim, shape, batch * k * n, dtype);
+  }
+  svd_topk_ops(a_data, compute_uv ? result[0]->data : NULL, result[1]->data, compute_uv ? result[2]->data : NULL, m, n, k, iters, batch, seed, dtype);
+  release_dtype_data(a_data, a->data); free(shape);
+  return result;
+}
+
+Array** eigh_topk_array(Array* a, int k, int64_t seed, bool vectors) {
+  int n;
+  size_t batch = square_batch(a, "eigh", &n);
+  if (k < 1 || k > n) {
+    fprintf(stderr, "eigh(k=%d) needs 1 <= k <= %d\n", k, n);
+    exit(EXIT_FAILURE);
+  }
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  int* shape = (int*)malloc(a->ndim * sizeof(int));
+  for (size_t i = 0; i < a->ndim - 1; i++) shape[i] = a->shape[i];
+  Array** result = (Array**)malloc(2 * sizeof(Array*));
+  shape[a->ndim - 2] = k;
+  result[0] = empty_array(a->ndim - 1, shape, batch * k, dtype);
+  result[1] = NULL;
+  if (vectors) {
+    shape[a->ndim - 2] = n; shape[a->ndim - 1] = k;
+    result[1] = empty_array(a->ndim, shape, batch * n * k, dtype);
+  }
+  eigh_topk_ops(a_data, result[0]->data, vectors ? result[1]->data : NULL, n, k, batch, seed, dtype);
+  release_dtype_data(a_data, a->data); free(shape);
+  return result;
+}
+
+Array** eig_pairs_array(Array* a, bool imag) {
+  int n;
+  size_t batch = square_batch(a, "eig", &n);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array** result = (Array**)malloc(3 * sizeof(Array*));
+  result[0] = empty_array(a->ndim - 1, a->shape, batch * n, dtype);
+  result[1] = imag ? empty_array(a->ndim - 1, a->shape, batch * n, dtype) : NULL;
+  result[2] = empty_array(a->ndim, a->shape, a->size, dtype);
+  eig_pairs_ops(a_data, result[0]->data, imag ? result[1]->data : NULL, result[2]->data, n, batch, dtype);
+  release_dtype_data(a_data, a->data);
+  return result;
+}
+
+Array** eigh_pairs_array(Array* a) {
+  int n;
+  size_t batch = square_batch(a, "eigh", &n);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array** result = (Array**)malloc(2 * sizeof(Array*));
+  result[0] = empty_array(a->ndim - 1, a->shape, batch * n, dtype);
+  result[1] = empty_array(a->ndim, a->shape, a->size, dtype);
+  eigh_pairs_ops(a_data, result[0]->data, result[1]->data, n, batch, dtype);
+  release_dtype_data(a_data, a->data);
+  return result;
+}
@@ -1,11 +1,12 @@
 #ifndef __DECOMPOSE__H__
 #define __DECOMPOSE__H__
 
+#include <stdint.h>
 #include "../core/core.h"
 #include "../core/dtype.h"
 
 extern "C" {
-  Array** svd_array(Array* a);
+  Array** svd_array(Array* a, bool full_matrices, bool compute_uv);    // [u, s, vt], u & vt NULL without compute_uv
   Array* cholesky_array(Array* a);
   Array* eig_array(Array* a);        // eigen values
   Array* eigv_array(Array* a);        // eigen vectors
@@ -15,11 +16,20 @@ extern "C" {
   Array* batched_eigv_array(Array* a);    // batched eigen vectors
   Array* batched_eigh_array(Array* a);      // batched eigen hermitian values
   Array* batched_eighv_array(Array* a);      // batched eigen hermitian vectors
-  Array** batched_qr_array(Array* a);
-  Array** qr_array(Array* a);
-  Array** batched_qr_array(Array* a);
-  Array** lu_array(Array* a);
+  Array** qr_array(Array* a, bool reduced);    // reduced: m x k q & k x n r (k = min(m, n)), else m x m & m x n
+  Array** batched_qr_array(Array* a, bool reduced);
+  Array** lu_array(Array* a);    // [l, u, int32 perm], perm[i] the row of a that row i of l @ u reproduces
   Array** batched_lu_array(Array* a);
+  Array** lu_factor_array(Array* a);   // [packed lu, int32 pivots] of a stack of square matrices, for lu_solve_array
+  Array* cho_factor_array(Array* a);    // lower cholesky factor, for cho_solve_array
+  Array** eig_parts_array(Array* a);    // [real, imaginary] parts of the eigenvalues of a stack of square matrices
+  // truncated: [u (m x k), s (k), vt (k x n)] & [w (k), z (n x k)] of the leading k, NULL vectors when not asked for;
+  // seed < 0 draws from the global rng
+  Array** svd_topk_array(Array* a, int k, int iters, int64_t seed, bool compute_uv);
+  Array** eigh_topk_array(Array* a, int k, int64_t seed, bool vectors);
+  // values & vectors of a stack of square matrices from one solve: [real, imaginary (NULL unless imag), vectors] & [w, z]
+  Array** eig_pairs_array(Array* a, bool imag);
+  Array** eigh_pairs_array(Array* a);
 }
 
 #endif  //!__DECOMPOSE__H__
\ No newline at end of file
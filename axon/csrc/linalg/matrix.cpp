@@ -19,12 +19,14 @@ Array* det_array(Array* a) {
     exit(EXIT_FAILURE);
   }
   shape[0] = 1;
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* out = (float*)malloc(1 * sizeof(float));
+  // integer inputs are factored in float32, the result is cast back to the input dtype
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array* result = empty_array(1, shape, 1, dtype);
   // Passing matrix dimension (shape[0]), not total size
-  det_ops_array(a_float, out, a->shape[0]);
-  Array* result = create_array(out, 1, shape, 1, a->dtype);
-  free(a_float); free(out); free(shape);
+  det_ops_array(a_data, result->data, a->shape[0], dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(shape);
   return result;
 }
 
@@ -44,12 +46,13 @@ Array* batched_det_array(Array* a) {
     exit(EXIT_FAILURE);
   }
   shape[0] = a->shape[0]; // Output should have batch size
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* out = (float*)malloc(a->shape[0] * sizeof(float)); // allocating for batch size
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
+  Array* result = empty_array(1, shape, a->shape[0], dtype); // allocating for batch size
   // Pass matrix dimension (shape[1])
-  batched_det_ops(a_float, out, a->shape[1], a->shape[0]);
-  Array* result = create_array(out, 1, shape, a->shape[0], a->dtype);
-  free(a_float); free(out); free(shape);
+  batched_det_ops(a_data, result->data, a->shape[1], a->shape[0], dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(shape);
   return result;
 }
 
@@ -64,16 +67,17 @@ Array* inv_array(Array* a) {
     fprintf(stderr, "Matrix must be square for inverse: %d != %d\n", second_last_dim, last_dim);
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
+  dtype_t dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, dtype);
   int* result_shape = (int*)malloc(a->ndim * sizeof(int));
 
   for (size_t i = 0; i < a->ndim; i++) result_shape[i] = a->shape[i];
   size_t result_size = a->size;
-  float* out = (float*)malloc(result_size * sizeof(float));
-  if (a->ndim == 2) { inv_ops(a_float, out, a->shape); }
-  else { batched_inv_ops(a_float, out, a->shape, a->ndim); }
-  Array* result = create_array(out, a->ndim, result_shape, result_size, a->dtype);
-  free(a_float); free(out); free(result_shape);
+  Array* result = empty_array(a->ndim, result_shape, result_size, dtype);
+  if (a->ndim == 2) { inv_ops(a_data, result->data, a->shape, dtype); }
+  else { batched_inv_ops(a_data, result->data, a->shape, a->ndim, dtype); }
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); free(result_shape);
   return result;
 }
 
@@ -83,7 +87,10 @@ Array* solve_array(Array* a, Array* b) {
     exit(EXIT_FAILURE);
   }
 
-  int a_rows = a->shape[a->ndim - 2], a_cols = a->shape[a->ndim - 1], b_rows = b->shape[b->ndim - 1];
+  // b is one vector per matrix of a when it has one dim less, otherwise a stack of n x nrhs matrices
+  bool b_vector = b->ndim == 1 || b->ndim == a->ndim - 1;
+  int a_rows = a->shape[a->ndim - 2], a_cols = a->shape[a->ndim - 1], b_rows = b_vector ? b->shape[b->ndim - 1] : b->shape[b->ndim - 2];
+  int nrhs = b_vector ? 1 : b->shape[b->ndim - 1];
   if (a_rows != a_cols) {
     fprintf(stderr, "Matrix 'a' must be square for solve: %d != %d\n", a_rows, a_cols);
     exit(EXIT_FAILURE);
@@ -92,25 +99,32 @@ Array* solve_array(Array* a, Array* b) {
     fprintf(stderr, "Matrix 'a' rows must match vector 'b' size: %d != %d\n", a_rows, b_rows);
     exit(EXIT_FAILURE);
   }
+  if (b->ndim > a->ndim || (a_cols > 0 && b->size != a->size / a_cols * nrhs)) {
+    fprintf(stderr, "Batch dims of 'b' must match those of 'a' for solve\n");
+    exit(EXIT_FAILURE);
+  }
 
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype), dtype = get_float_dtype(result_dtype);
+  void *a_data = as_contiguous_data(a, dtype), *b_data = as_contiguous_data(b, dtype);
   int* result_shape = (int*)malloc(b->ndim * sizeof(int));
 
   for (size_t i = 0; i < b->ndim; i++) result_shape[i] = b->shape[i];
   size_t result_size = b->size;
-  float* out = (float*)malloc(result_size * sizeof(float));
-  if (a->ndim == 2 && b->ndim <= 2) {
-    int shape_b[2] = {b->shape[b->ndim - 1], (b->ndim == 2) ? b->shape[1] : 1};
-    solve_ops(a_float, b_float, out, a->shape + (a->ndim - 2), shape_b);
+  Array* result = empty_array(b->ndim, result_shape, result_size, dtype);
+  if (a->ndim == 2) {
+    int shape_b[2] = {b_rows, nrhs};
+    solve_ops(a_data, b_data, result->data, a->shape, shape_b, dtype);
   } else {
-    int shape_a_2d[2] = {a->shape[a->ndim - 2], a->shape[a->ndim - 1]};
-    int shape_b_2d[2] = {b->shape[b->ndim - 1], (b->ndim >= 2) ? b->shape[b->ndim - 1] : 1};
-    batched_solve_ops(a_float, b_float, out, shape_a_2d, shape_b_2d, a->ndim);
+    // b's shape as a stack of n x nrhs matrices with a's batch dims
+    int* shape_b = (int*)malloc(a->ndim * sizeof(int));
+    for (size_t i = 0; i < a->ndim - 2; i++) shape_b[i] = a->shape[i];
+    shape_b[a->ndim - 2] = b_rows; shape_b[a->ndim - 1] = nrhs;
+    batched_solve_ops(a_data, b_data, result->data, a->shape, shape_b, a->ndim, dtype);
+    free(shape_b);
   }
 
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, b->ndim, result_shape, result_size, result_dtype);
-  free(a_float); free(b_float); free(out); free(result_shape);
+  cast_array_inplace(result, result_dtype);
+  release_dtype_data(a_data, a->data); release_dtype_data(b_data, b->data); free(result_shape);
   return result;
 }
 
@@ -119,48 +133,94 @@ Array* lstsq_array(Array* a, Array* b) {
     fprintf(stderr, "Matrix 'a' must be at least 2D and vector 'b' must be at least 1D\n");
     exit(EXIT_FAILURE);
   }
-  int a_rows = a->shape[a->ndim - 2], a_cols = a->shape[a->ndim - 1], b_rows = (b->ndim >= 2) ? b->shape[b->ndim - 2] : b->shape[0];
+  // b is one vector per matrix of a when it has one dim less, otherwise a stack of m x nrhs matrices
+  bool b_vector = b->ndim == 1 || b->ndim == a->ndim - 1;
+  int a_rows = a->shape[a->ndim - 2], a_cols = a->shape[a->ndim - 1], b_rows = b_vector ? b->shape[b->ndim - 1] : b->shape[b->ndim - 2];
+  int nrhs = b_vector ? 1 : b->shape[b->ndim - 1];
   if (a_rows != b_rows) {
     fprintf(stderr, "Matrix 'a' rows must match vector 'b' size: %d != %d\n", a_rows, b_rows);
     exit(EXIT_FAILURE);
   }
+  if (b->ndim > a->ndim || (a_cols > 0 && b->size != a->size / a_cols * nrhs)) {
+    fprintf(stderr, "Batch dims of 'b' must match those of 'a' for lstsq\n");
+    exit(EXIT_FAILURE);
+  }
 
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
-  size_t result_ndim;
-  int* result_shape;  
-  if (b->ndim == 1) {
-    // b is 1D vector -> result is 1D with shape [a_cols]
-    result_ndim = 1;
-    result_shape = (int*)malloc(result_ndim * sizeof(int));
-    result_shape[0] = a_cols;
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype), dtype = get_float_dtype(result_dtype);
+  void *a_data = as_contiguous_data(a, dtype), *b_data = as_contiguous_data(b, dtype);
+  // b's shape with its row dim (m) turned into a's column count (n)
+  int* result_shape = (int*)malloc(b->ndim * sizeof(int));
+  for (size_t i = 0; i < b->ndim; i++) result_shape[i] = b->shape[i];
+  result_shape[b_vector ? b->ndim - 1 : b->ndim - 2] = a_cols;
+  size_t result_size = b->size / (a_rows ? a_rows : 1) * a_cols;
+  Array* result = empty_array(b->ndim, result_shape, result_size, dtype);
+  if (a->ndim == 2) {
+    int shape_b[2] = {b_rows, nrhs};
+    lstsq_ops(a_data, b_data, result->data, a->shape, shape_b, dtype);
   } else {
-    // b is 2D or higher -> result keeps b's batch dimensions + [a_cols, b_cols]
-    result_ndim = b->ndim;
-    result_shape = (int*)malloc(result_ndim * sizeof(int));
-    for (size_t i = 0; i < result_ndim - 2; i++) result_shape[i] = b->shape[i];
-    if (result_ndim >= 2) {
-      result_shape[result_ndim - 2] = a_cols;  // Number of unknowns
-      result_shape[result_ndim - 1] = b->shape[b->ndim - 1];  // Number of RHS
-    } else {
-      result_shape[0] = a_cols;
+    int* shape_b = (int*)malloc(a->ndim * sizeof(int));
+    for (size_t i = 0; i < a->ndim - 2; i++) shape_b[i] = a->shape[i];
+    shape_b[a->ndim - 2] = b_rows; shape_b[a->ndim - 1] = nrhs;
+    batched_lstsq_ops(a_data, b_data, result->data, a->shape, shape_b, a->ndim, dtype);
+    free(shape_b);
+  }
+
+  cast_array_inplace(result, result_dtype);
+  release_dtype_data(a_data, a->data); release_dtype_data(b_data, b->data); free(result_shape);
+  return result;
+}
+// b against the factors `f` of one or a stack of n x n matrices: b is a vector or an n x nrhs matrix
+// per factor, or any stack of those against a single factor; fills n, nrhs & the matrix counts
+static void factor_rhs(Array* f, Array* b, const char* name, int* n, int* nrhs, size_t* batch, size_t* factors) {
+  if (f->ndim < 2 || b->ndim < 1) {
+    fprintf(stderr, "Factors must be at least 2D and 'b' at least 1D for %s()\n", name);
+    exit(EXIT_FAILURE);
+  }
+  *n = f->shape[f->ndim - 1];
+  bool b_vector = b->ndim == 1 || (f->ndim > 2 && b->ndim == f->ndim - 1);
+  int b_rows = b_vector ? b->shape[b->ndim - 1] : b->shape[b->ndim - 2];
+  *nrhs = b_vector ? 1 : b->shape[b->ndim - 1];
+  if (b_rows != *n) {
+    fprintf(stderr, "Factor rows must match 'b' rows for %s(): %d != %d\n", name, *n, b_rows);
+    exit(EXIT_FAILURE);
+  }
+  *factors = (*n > 0) ? f->size / ((size_t)*n * *n) : 0;
+  *batch = (*n > 0 && *nrhs > 0) ? b->size / ((size_t)*n * *nrhs) : 0;
+  if (f->ndim > 2) {
+    size_t b_batch_dims = b->ndim - (b_vector ? 1 : 2);
+    bool same = b_batch_dims == f->ndim - 2;
+    for (size_t i = 0; same && i < b_batch_dims; i++) same = b->shape[i] == f->shape[i];
+    if (!same) {
+      fprintf(stderr, "Batch dims of 'b' must match those of the factors for %s()\n", name);
+      exit(EXIT_FAILURE);
     }
   }
+}
 
-  size_t result_size = 1;
-  for (size_t i = 0; i < result_ndim; i++) result_size *= result_shape[i];
-  float* out = (float*)malloc(result_size * sizeof(float));
-  if (a->ndim == 2 && b->ndim <= 2) {
-    int shape_a_2d[2] = {a_rows, a_cols};
-    int shape_b_2d[2] = {b_rows, (b->ndim == 2) ? b->shape[1] : 1};
-    lstsq_ops(a_float, b_float, out, shape_a_2d, shape_b_2d);
-  } else {
-    int shape_a_2d[2] = {a_rows, a_cols};
-    int shape_b_2d[2] = {b_rows, (b->ndim >= 2) ? b->shape[b->ndim - 1] : 1};
-    batched_lstsq_ops(a_float, b_float, out, shape_a_2d, shape_b_2d, a->ndim);
+Array* lu_solve_array(Array* lu, Array* piv, Array* b) {
+  int n, nrhs;
+  size_t batch, factors;
+  factor_rhs(lu, b, "lu_solve", &n, &nrhs, &batch, &factors);
+  if (piv->size != factors * n) {
+    fprintf(stderr, "Pivots don't match the lu factors: %zu != %zu\n", piv->size, factors * n);
+    exit(EXIT_FAILURE);
   }
+  dtype_t dtype = get_float_dtype(promote_dtypes(lu->dtype, b->dtype));
+  void *lu_data = as_contiguous_data(lu, dtype), *b_data = as_contiguous_data(b, dtype), *piv_data = as_contiguous_data(piv, DTYPE_INT32);
+  Array* result = empty_array(b->ndim, b->shape, b->size, dtype);
+  lu_solve_ops(lu_data, (int*)piv_data, b_data, result->data, n, nrhs, batch, factors, dtype);
+  release_dtype_data(lu_data, lu->data); release_dtype_data(b_data, b->data); release_dtype_data(piv_data, piv->data);
+  return result;
+}
 
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, result_ndim, result_shape, result_size, result_dtype);
-  free(a_float); free(b_float); free(out); free(result_shape);
+Array* cho_solve_array(Array* c, Array* b) {
+  int n, nrhs;
+  size_t batch, factors;
+  factor_rhs(c, b, "cho_solve", &n, &nrhs, &batch, &factors);
+  dtype_t dtype = get_float_dtype(promote_dtypes(c->dtype, b->dtype));
+  void *c_data = as_contiguous_data(c, dtype), *b_data = as_contiguous_data(b, dtype);
+  Array* result = empty_array(b->ndim, b->shape, b->size, dtype);
+  cho_solve_ops(c_data, b_data, result->data, n, nrhs, batch, factors, dtype);
+  release_dtype_data(c_data, c->data); release_dtype_data(b_data, b->data);
   return result;
-}
\ No newline at end of file
+}
@@ -10,6 +10,8 @@ extern "C" {
   Array* inv_array(Array* a);
   Array* solve_array(Array* a, Array* b);
   Array* lstsq_array(Array* a, Array* b);
+  Array* lu_solve_array(Array* lu, Array* piv, Array* b);   // from lu_factor_array, O(n^2) per right-hand side
+  Array* cho_solve_array(Array* c, Array* b);     // from cho_factor_array
 }
 
 #endif  //!__MATRIX__H__
\ No newline at end of file
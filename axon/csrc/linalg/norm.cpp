@@ -9,25 +9,17 @@ Array* clip_array(Array* a, float max_val) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
+  // integer inputs are normalized in float32, float inputs keep their precision
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, result_dtype);
+  if (a_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
     exit(EXIT_FAILURE);
   }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  clip_array_ops(a_float, out, max_val, a->size);
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) { result_dtype = DTYPE_FLOAT32; }
-  else { result_dtype = a->dtype; }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  clip_array_ops(a_data, result->data, max_val, a->size, result_dtype);
+  release_dtype_data(a_data, a->data);
   return result;
 }
 
@@ -36,25 +28,16 @@ Array* clamp_array(Array* a, float min_val, float max_val) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, result_dtype);
+  if (a_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
     exit(EXIT_FAILURE);
   }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  clamp_array_ops(a_float, out, min_val, max_val, a->size);
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) { result_dtype = DTYPE_FLOAT32; }
-  else { result_dtype = a->dtype; }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  clamp_array_ops(a_data, result->data, min_val, max_val, a->size, result_dtype);
+  release_dtype_data(a_data, a->data);
   return result;
 }
 
@@ -63,25 +46,16 @@ Array* mm_norm_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, result_dtype);
+  if (a_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
     exit(EXIT_FAILURE);
   }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  mm_norm_array_ops(a_float, out, a->size);
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) { result_dtype = DTYPE_FLOAT32; }
-  else { result_dtype = a->dtype; }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  mm_norm_array_ops(a_data, result->data, a->size, result_dtype);
+  release_dtype_data(a_data, a->data);
   return result;
 }
 
@@ -90,25 +64,16 @@ Array* std_norm_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, result_dtype);
+  if (a_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
     exit(EXIT_FAILURE);
   }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  std_norm_array_ops(a_float, out, a->size);
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) { result_dtype = DTYPE_FLOAT32; }
-  else { result_dtype = a->dtype; }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  std_norm_array_ops(a_data, result->data, a->size, result_dtype);
+  release_dtype_data(a_data, a->data);
   return result;
 }
 
@@ -117,25 +82,16 @@ Array* rms_norm_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, result_dtype);
+  if (a_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
     exit(EXIT_FAILURE);
   }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  rms_norm_array_ops(a_float, out, a->size);
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) { result_dtype = DTYPE_FLOAT32; }
-  else { result_dtype = a->dtype; }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  rms_norm_array_ops(a_data, result->data, a->size, result_dtype);
+  release_dtype_data(a_data, a->data);
   return result;
 }
 
@@ -144,25 +100,16 @@ Array* l1_norm_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, result_dtype);
+  if (a_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
     exit(EXIT_FAILURE);
   }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  l1_norm_array_ops(a_float, out, a->size);
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) { result_dtype = DTYPE_FLOAT32; }
-  else { result_dtype = a->dtype; }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  l1_norm_array_ops(a_data, result->data, a->size, result_dtype);
+  release_dtype_data(a_data, a->data);
   return result;
 }
 
@@ -171,25 +118,16 @@ Array* l2_norm_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, result_dtype);
+  if (a_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
     exit(EXIT_FAILURE);
   }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  l2_norm_array_ops(a_float, out, a->size);
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) { result_dtype = DTYPE_FLOAT32; }
-  else { result_dtype = a->dtype; }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  l2_norm_array_ops(a_data, result->data, a->size, result_dtype);
+  release_dtype_data(a_data, a->data);
   return result;
 }
 
@@ -198,25 +136,16 @@ Array* unit_norm_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, result_dtype);
+  if (a_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
     exit(EXIT_FAILURE);
   }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  unit_norm_array_ops(a_float, out, a->size);
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) { result_dtype = DTYPE_FLOAT32; }
-  else { result_dtype = a->dtype; }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  unit_norm_array_ops(a_data, result->data, a->size, result_dtype);
+  release_dtype_data(a_data, a->data);
   return result;
 }
 
@@ -225,24 +154,15 @@ Array* robust_norm_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  void* a_data = as_contiguous_data(a, result_dtype);
+  if (a_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion\n");
     exit(EXIT_FAILURE);
   }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  robust_norm_array_ops(a_float, out, a->size);
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) { result_dtype = DTYPE_FLOAT32; }
-  else { result_dtype = a->dtype; }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  robust_norm_array_ops(a_data, result->data, a->size, result_dtype);
+  release_dtype_data(a_data, a->data);
   return result;
 }
\ No newline at end of file
@@ -14,11 +14,12 @@ Array* vector_dot(Array* a, Array* b) {
   }
   int* shape = (int*)malloc(1 * sizeof(int));
   shape[0] = 1;
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
-  float* out = (float*)malloc(1 * sizeof(float));
-  vector_dot_ops(a_float, b_float, out, a->size);
-  Array* result = create_array(out, 1, shape, 1, a->dtype);
-  free(a_float); free(b_float); free(out); free(shape);
+  dtype_t dtype = get_float_dtype(promote_dtypes(a->dtype, b->dtype));
+  void *a_data = as_contiguous_data(a, dtype), *b_data = as_contiguous_data(b, dtype);
+  Array* result = empty_array(1, shape, 1, dtype);
+  vector_dot_ops(a_data, b_data, result->data, a->size, dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); release_dtype_data(b_data, b->data); free(shape);
   return result;
 }
 
@@ -57,15 +58,16 @@ Array* vector_matrix_dot(Array* a, Array* b) {
     output_size = mat->shape[1];
     shape[0] = mat->shape[1];
   }
-  float *vec_float = convert_to_float32(vec->data, vec->dtype, vec->size), *mat_float = convert_to_float32(mat->data, mat->dtype, mat->size), * out = (float*)malloc(output_size * sizeof(float));
+  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype), dtype = get_float_dtype(result_dtype);
+  void *vec_data = as_contiguous_data(vec, dtype), *mat_data = as_contiguous_data(mat, dtype);
+  Array* result = empty_array(1, shape, output_size, dtype);
   if (is_matrix_vector) {
-    matrix_vector_dot_ops(mat_float, vec_float, out, mat->size, vec->size);
+    matrix_vector_dot_ops(mat_data, vec_data, result->data, mat->size, vec->size, dtype);
   } else {
-    vector_matrix_dot_ops(vec_float, mat_float, out, vec->size, mat->size);
+    vector_matrix_dot_ops(vec_data, mat_data, result->data, vec->size, mat->size, dtype);
   }
-  dtype_t result_dtype = promote_dtypes(a->dtype, b->dtype);
-  Array* result = create_array(out, 1, shape, output_size, result_dtype);
-  free(vec_float); free(mat_float); free(out); free(shape);
+  cast_array_inplace(result, result_dtype);
+  release_dtype_data(vec_data, vec->data); release_dtype_data(mat_data, mat->data); free(shape);
   return result;
 }
 
@@ -80,11 +82,12 @@ Array* vector_inner(Array* a, Array* b) {
   }
   int* shape = (int*)malloc(1 * sizeof(int));
   shape[0] = 1;
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
-  float* out = (float*)malloc(1 * sizeof(float));
-  vector_inner_product_ops(a_float, b_float, out, a->size);
-  Array* result = create_array(out, 1, shape, 1, a->dtype);
-  free(a_float); free(b_float); free(out); free(shape);
+  dtype_t dtype = get_float_dtype(promote_dtypes(a->dtype, b->dtype));
+  void *a_data = as_contiguous_data(a, dtype), *b_data = as_contiguous_data(b, dtype);
+  Array* result = empty_array(1, shape, 1, dtype);
+  vector_inner_product_ops(a_data, b_data, result->data, a->size, dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); release_dtype_data(b_data, b->data); free(shape);
   return result;
 }
 
@@ -95,11 +98,12 @@ Array* vector_outer(Array* a, Array* b) {
   }
   int* shape = (int*)malloc(2 * sizeof(int));
   shape[0] = a->shape[0]; shape[1] = b->shape[0];
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
-  float* out = (float*)malloc(a->shape[0] * b->shape[0] * sizeof(float));
-  vector_outer_product_ops(a_float, b_float, out, a->shape[0], b->shape[0]);
-  Array* result = create_array(out, 2, shape, a->shape[0] * b->shape[0], a->dtype);
-  free(a_float); free(b_float); free(out); free(shape);
+  dtype_t dtype = get_float_dtype(promote_dtypes(a->dtype, b->dtype));
+  void *a_data = as_contiguous_data(a, dtype), *b_data = as_contiguous_data(b, dtype);
+  Array* result = empty_array(2, shape, a->shape[0] * b->shape[0], dtype);
+  vector_outer_product_ops(a_data, b_data, result->data, a->shape[0], b->shape[0], dtype);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); release_dtype_data(b_data, b->data); free(shape);
   return result;
 }
 
@@ -129,7 +133,8 @@ Array* vector_cross_axis(Array* a, Array* b, int axis) {
     }
   }
 
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
+  dtype_t dtype = get_float_dtype(promote_dtypes(a->dtype, b->dtype));
+  void *a_data = as_contiguous_data(a, dtype), *b_data = as_contiguous_data(b, dtype);
   int* out_shape = (int*)malloc(a->ndim * sizeof(int));
   size_t out_size = 1;  
   for (int i = 0; i < a->ndim; i++) {
@@ -141,15 +146,15 @@ Array* vector_cross_axis(Array* a, Array* b, int axis) {
 
   // For 2D cross product, we need to remove the axis dimension
   if (a->shape[axis] == 2) { out_size /= 1; }  // Adjust for the removed dimension
-  float* out = (float*)malloc(out_size * sizeof(float));
+  void* out = malloc(out_size * get_dtype_size(dtype));
   size_t* strides = (size_t*)malloc(a->ndim * sizeof(size_t));
   strides[a->ndim - 1] = 1;
   for (int i = a->ndim - 2; i >= 0; i--) { strides[i] = strides[i + 1] * a->shape[i + 1]; }
-  if (a->ndim == 2) { cross_2d_ops(a_float, b_float, out, a->shape[0], a->shape[1], axis); }
-  else if (a->ndim == 3) { cross_3d_ops(a_float, b_float, out, a->shape[0], a->shape[1], a->shape[2], axis); }
+  if (a->ndim == 2) { cross_2d_ops(a_data, b_data, out, a->shape[0], a->shape[1], axis, dtype); }
+  else if (a->ndim == 3) { cross_3d_ops(a_data, b_data, out, a->shape[0], a->shape[1], a->shape[2], axis, dtype); }
   else {
     fprintf(stderr, "Only 2D and 3D arrays supported for cross product with axis\n");
-    free(a_float); free(b_float); free(out); free(out_shape); free(strides);
+    release_dtype_data(a_data, a->data); release_dtype_data(b_data, b->data); free(out); free(out_shape); free(strides);
     exit(EXIT_FAILURE);
   }
 
@@ -161,12 +166,14 @@ Array* vector_cross_axis(Array* a, Array* b, int axis) {
     for (int i = 0; i < a->ndim; i++) {
       if (i != axis) { final_shape[j++] = a->shape[i]; }
     }
-    Array* result = create_array(out, final_ndim, final_shape, out_size, a->dtype);
-    free(a_float); free(b_float); free(out); free(out_shape); free(strides); free(final_shape);
+    Array* result = empty_array(final_ndim, final_shape, out_size, a->dtype);
+    copy_with_dtype_conversion(out, dtype, result->data, a->dtype, out_size);
+    release_dtype_data(a_data, a->data); release_dtype_data(b_data, b->data); free(out); free(out_shape); free(strides); free(final_shape);
     return result;
   } else {
-    Array* result = create_array(out, a->ndim, out_shape, out_size, a->dtype);
-    free(a_float); free(b_float); free(out); free(strides);
+    Array* result = empty_array(a->ndim, out_shape, out_size, a->dtype);
+    copy_with_dtype_conversion(out, dtype, result->data, a->dtype, out_size);
+    release_dtype_data(a_data, a->data); release_dtype_data(b_data, b->data); free(out); free(out_shape); free(strides);
     return result;
   }
 }
@@ -176,42 +183,40 @@ Array* vector_cross(Array* a, Array* b) {
     fprintf(stderr, "Arrays must have same number of dimensions for cross product\n");
     exit(EXIT_FAILURE);
   }
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (a_float == NULL || b_float == NULL || out == NULL) {
+  dtype_t dtype = get_float_dtype(promote_dtypes(a->dtype, b->dtype));
+  void *a_data = as_contiguous_data(a, dtype), *b_data = as_contiguous_data(b, dtype);
+  if (a_data == NULL || b_data == NULL) {
     fprintf(stderr, "Memory allocation failed during dtype conversion");
-    if (a_float) free(a_float);
-    if (b_float) free(b_float);
-    if (out) free(out);
     exit(EXIT_FAILURE);
   }
 
   int* shape = (int*)malloc(a->ndim * sizeof(int));
   for (int i = 0; i < a->ndim; i++) { shape[i] = a->shape[i]; }
+  Array* result = empty_array(a->ndim, shape, a->size, dtype);
   if (a->ndim == 1) {
     if (a->shape[0] != b->shape[0]) {
       fprintf(stderr, "Arrays must have same size for cross product. size_a '%d' != size_b '%d'\n", a->shape[0], b->shape[0]);
       exit(EXIT_FAILURE);
     }
-    cross_1d_ops(a_float, b_float, out, a->size);
+    cross_1d_ops(a_data, b_data, result->data, a->size, dtype);
   } else if (a->ndim == 2) {
     if (a->shape[0] != b->shape[0] || a->shape[1] != b->shape[1]) {
       fprintf(stderr, "Arrays must have same shape for cross product\n");
       exit(EXIT_FAILURE);
     }
-    cross_2d_ops(a_float, b_float, out, a->shape[0], a->shape[1], -1);
+    cross_2d_ops(a_data, b_data, result->data, a->shape[0], a->shape[1], -1, dtype);
   } else if (a->ndim == 3) {
     if (a->shape[0] != b->shape[0] || a->shape[1] != b->shape[1] || a->shape[2] != b->shape[2]) {
       fprintf(stderr, "Arrays must have same shape for cross product\n");
       exit(EXIT_FAILURE);
     }
-    cross_3d_ops(a_float, b_float, out, a->shape[0], a->shape[1], a->shape[2], -1);
+    cross_3d_ops(a_data, b_data, result->data, a->shape[0], a->shape[1], a->shape[2], -1, dtype);
   } else {
     fprintf(stderr, "Only 1D, 2D, and 3D arrays supported for cross product\n");
     exit(EXIT_FAILURE);
   }
 
-  Array* result = create_array(out, a->ndim, shape, a->size, a->dtype);
-  free(a_float); free(b_float); free(out); free(shape);
+  cast_array_inplace(result, a->dtype);
+  release_dtype_data(a_data, a->data); release_dtype_data(b_data, b->data); free(shape);
   return result;
 }
\ No newline at end of file
@@ -5,13 +5,15 @@
 #include "core/dtype.h"
 
 extern "C" {
-  // reduction ops
-  Array* sum_array(Array* a, int axis, bool keepdims);
-  Array* mean_array(Array* a, int axis, bool keepdims);
-  Array* max_array(Array* a, int axis, bool keepdims);
-  Array* min_array(Array* a, int axis, bool keepdims);
-  Array* var_array(Array* a, int axis, int ddof);
-  Array* std_array(Array* a, int axis, int ddof);
+  // reduction ops, `axes` lists the `naxes` dims to reduce in one pass (negative ones count from
+  // the back), naxes 0 reduces all of them
+  Array* sum_array(Array* a, int* axes, int naxes, bool keepdims);
+  Array* mean_array(Array* a, int* axes, int naxes, bool keepdims);
+  Array* max_array(Array* a, int* axes, int naxes, bool keepdims);
+  Array* min_array(Array* a, int* axes, int naxes, bool keepdims);
+  Array* var_array(Array* a, int* axes, int naxes, int ddof, bool keepdims);
+  Array* std_array(Array* a, int* axes, int naxes, int ddof, bool keepdims);
+  Array** mean_var_array(Array* a, int* axes, int naxes, int ddof, bool keepdims);
 }
 
 #endif  //!__REDUX_OPS__H__
\ No newline at end of file
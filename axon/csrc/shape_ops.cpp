@@ -1,44 +1,52 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "cpu/ops_shape.h"
+#include "core/contiguous.h"
 #include "shape_ops.h"
 
+// zero-copy: swaps the last two dims (batched transpose for 3-d & up), 1-d arrays come back as a plain view
 Array* transpose_array(Array* a) {
   if (a == NULL) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
-  }  
+  }
   int ndim = a->ndim;
-  int* result_shape = (int*)malloc(ndim * sizeof(int));
-  if (result_shape == NULL) {
+  int* axes = (int*)malloc(ndim * sizeof(int));
+  if (axes == NULL) {
     fprintf(stderr, "Memory allocation failed\n");
     exit(EXIT_FAILURE);
   }
-  // creating the result shape (reversed dimensions)
-  for (int i = 0; i < ndim; i++) { result_shape[i] = a->shape[ndim - 1 - i]; }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  // performing transpose based on dimensions
-  // IMPORTANT: passing the ORIGINAL shape to transpose functions, not the result shape
-  switch(ndim) {
-    case 1: transpose_1d_array_ops(a_float, out, a->shape); break;
-    case 2: transpose_2d_array_ops(a_float, out, a->shape); break;
-    case 3: transpose_3d_array_ops(a_float, out, a->shape); break;
-    default:
-    if (ndim > 3) { transpose_ndim_array_ops(a_float, out, a->shape, a->ndim); }
-    else {
-      fprintf(stderr, "Transpose supported only for 1-3 dimensional arrays\n");
-      free(a_float);
-      free(out);
-      free(result_shape);
-      exit(EXIT_FAILURE);
-    }
+  for (int i = 0; i < ndim; i++) { axes[i] = i; }
+  if (ndim >= 2) { axes[ndim - 2] = ndim - 1; axes[ndim - 1] = ndim - 2; }
+  Array* result = permute_view(a, axes, ndim);
+  free(axes);
+  return result;
+}
+
+// zero-copy: dim i of the result is dim axes[i] of `a`, negative axes count from the back
+Array* permute_array(Array* a, int* axes, int ndim) {
+  if (a == NULL || axes == NULL) {
+    fprintf(stderr, "Array or axes pointers are null!\n");
+    exit(EXIT_FAILURE);
   }
-  dtype_t result_dtype = a->dtype;
-  Array* result = create_array(out, ndim, result_shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
-  free(result_shape);
+  int* perm = (int*)malloc(ndim * sizeof(int));
+  if (perm == NULL) {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
+  for (int i = 0; i < ndim; i++) { perm[i] = axes[i] < 0 ? axes[i] + ndim : axes[i]; }
+  Array* result = permute_view(a, perm, ndim);
+  free(perm);
+  if (result == NULL) exit(EXIT_FAILURE);
+  return result;
+}
+
+// view over a's buffer when its strides allow it, a dense copy otherwise (e.g. flattening a transposed view)
+static Array* reshape_or_copy(Array* a, int* shape, int ndim) {
+  Array* result = reshape_view(a, shape, ndim);
+  if (result != NULL) return result;
+  result = empty_array(ndim, shape, a->size, a->dtype);
+  contiguous_array_ops(a->data, result->data, a->strides, a->shape, a->ndim, get_dtype_size(a->dtype));
   return result;
 }
 
@@ -47,34 +55,21 @@ Array* reshape_array(Array* a, int* new_shape, int new_ndim) {
     fprintf(stderr, "Array or shape pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  int* shape = (int*)malloc(new_ndim * sizeof(int));
-  if (shape == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    exit(EXIT_FAILURE);
-  }
 
-  // copying new shape and calculate new size
+  // calculating new size
   size_t new_size = 1;
   for (int i = 0; i < new_ndim; i++) {
-    shape[i] = new_shape[i];
-    new_size *= shape[i];
+    if (new_shape[i] <= 0) {
+      fprintf(stderr, "Invalid shape dimension: %d\n", new_shape[i]);
+      exit(EXIT_FAILURE);
+    }
+    new_size *= new_shape[i];
   }
   if (new_size != a->size) {
     fprintf(stderr, "Can't reshape the array. array's size doesn't match the target size: %zu != %zu\n", a->size, new_size);
-    free(shape);
     exit(EXIT_FAILURE);
   }
-  // converting array to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  // performing reshape (basically just copy data)
-  reassign_array_ops(a_float, out, a->size);
-  dtype_t result_dtype = a->dtype;    // reshaping preserves the original dtype
-  Array* result = create_array(out, new_ndim, shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
-  free(shape);
-  return result;
+  return reshape_or_copy(a, new_shape, new_ndim);
 }
 
 Array* squeeze_array(Array* a, int axis) {
@@ -83,8 +78,8 @@ Array* squeeze_array(Array* a, int axis) {
     exit(EXIT_FAILURE);
   }
   int new_ndim = 0;
-  int* temp_shape = (int*)malloc(a->ndim * sizeof(int));
-  if (temp_shape == NULL) {
+  int* shape = (int*)malloc((a->ndim + 1) * sizeof(int));
+  if (shape == NULL) {
     fprintf(stderr, "Memory allocation failed\n");
     exit(EXIT_FAILURE);
   }
@@ -93,7 +88,7 @@ Array* squeeze_array(Array* a, int axis) {
   if (axis == -1) {
     for (int i = 0; i < a->ndim; i++) {
       if (a->shape[i] != 1) {
-        temp_shape[new_ndim] = a->shape[i];
+        shape[new_ndim] = a->shape[i];
         new_ndim++;
       }
     }
@@ -101,18 +96,18 @@ Array* squeeze_array(Array* a, int axis) {
     // validate axis
     if (axis < 0 || axis >= a->ndim) {
       fprintf(stderr, "axis %d is out of bounds for array of dimension %zu\n", axis, a->ndim);
-      free(temp_shape);
+      free(shape);
       exit(EXIT_FAILURE);
     }
     if (a->shape[axis] != 1) {
       fprintf(stderr, "cannot select an axis to squeeze out which has size not equal to one\n");
-      free(temp_shape);
+      free(shape);
       exit(EXIT_FAILURE);
     }
     // remove specific axis
     for (int i = 0; i < a->ndim; i++) {
       if (i != axis) {
-        temp_shape[new_ndim] = a->shape[i];
+        shape[new_ndim] = a->shape[i];
         new_ndim++;
       }
     }
@@ -121,20 +116,10 @@ Array* squeeze_array(Array* a, int axis) {
   // handling edge case where all dimensions are squeezed out
   if (new_ndim == 0) {
     new_ndim = 1;
-    temp_shape[0] = 1;
+    shape[0] = 1;
   }
-  int* shape = (int*)malloc(new_ndim * sizeof(int));
-  for (int i = 0; i < new_ndim; i++) { shape[i] = temp_shape[i]; }
-  free(temp_shape);
-
-  // converting array to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  reassign_array_ops(a_float, out, a->size);  // performing squeeze (basically just copy data)
-  dtype_t result_dtype = a->dtype;  // squeeze preserves the original dtype
-  Array* result = create_array(out, new_ndim, shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  // dropping size-1 dims never needs a copy
+  Array* result = reshape_or_copy(a, shape, new_ndim);
   free(shape);
   return result;
 }
@@ -155,6 +140,10 @@ Array* expand_dims_array(Array* a, int axis) {
     exit(EXIT_FAILURE);
   }
   int* shape = (int*)malloc(new_ndim * sizeof(int));
+  if (shape == NULL) {
+    fprintf(stderr, "Memory allocation failed\n");
+    exit(EXIT_FAILURE);
+  }
   // create new shape with expanded dimension
   int old_idx = 0;
   for (int i = 0; i < new_ndim; i++) {
@@ -162,14 +151,8 @@ Array* expand_dims_array(Array* a, int axis) {
     else { shape[i] = a->shape[old_idx]; old_idx++; }
   }
 
-  // converting array to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  reassign_array_ops(a_float, out, a->size);   // performing expand_dims (basically just copy data)
-  dtype_t result_dtype = a->dtype;  // expand_dims preserves the original dtype
-  Array* result = create_array(out, new_ndim, shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  // neither does inserting one
+  Array* result = reshape_or_copy(a, shape, new_ndim);
   free(shape);
   return result;
 }
@@ -179,19 +162,8 @@ Array* flatten_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  int new_ndim = 1;
-  int* shape = (int*)malloc(new_ndim * sizeof(int));
-  shape[0] = a->size;   // flattened array has single dimension with size equal to total elements
-  // converting array to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  reassign_array_ops(a_float, out, a->size);  // performing flatten (basically just copy data)
-  dtype_t result_dtype = a->dtype;  // flatten preserves the original dtype
-  Array* result = create_array(out, new_ndim, shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
-  free(shape);
-  return result;
+  int shape = a->size;   // flattened array has single dimension with size equal to total elements
+  return reshape_or_copy(a, &shape, 1);
 }
 
 Array* equal_array(Array* a, Array* b) {
@@ -199,29 +171,22 @@ Array* equal_array(Array* a, Array* b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  if (a->ndim != b->ndim) {
-    fprintf(stderr, "Arrays must have same dimensions %d and %d for equal\n", a->ndim, b->ndim);
-    exit(EXIT_FAILURE);
-  }
-
-  // checking if shapes match
-  for (size_t i = 0; i < a->ndim; i++) {
-    if (a->shape[i] != b->shape[i]) {
-      fprintf(stderr, "Arrays must have the same shape for comparison\n");
-      exit(EXIT_FAILURE);
-    }
-  }
-  // converting both Arrays to float32 for computation
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  // perform the equality comparison
-  equal_array_ops(a_float, b_float, out, a->size);
+  // shapes that differ are broadcast like the arithmetic ops
+  int* shape;
+  size_t size;
+  int ndim = broadcast_shape(a, b, &shape, &size);
+  // comparing in the promoted dtype of both operands
+  dtype_t cmp_dtype = promote_dtypes(a->dtype, b->dtype);
+  Array* a_cast = as_dtype_array(a, cmp_dtype);
+  Array* b_cast = as_dtype_array(b, cmp_dtype);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
+  Array* result = empty_array(ndim, shape, size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_broadcast(&it, a_cast, b_cast, result);
+  equal_array_ops(&it, cmp_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
+  free(shape);
   return result;
 }
 
@@ -230,25 +195,11 @@ Array* equal_scalar(Array* a, float b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  // converting both Arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  equal_scalar_ops(a_float, b, out, a->size);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  equal_scalar_ops(&it, b, a->dtype);
   return result;
 }
 
@@ -257,30 +208,21 @@ Array* not_equal_array(Array* a, Array* b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  if (a->ndim != b->ndim) {
-    fprintf(stderr, "Arrays must have same dimensions %d and %d for equal\n", a->ndim, b->ndim);
-    exit(EXIT_FAILURE);
-  }
-
-  // checking if shapes match
-  for (size_t i = 0; i < a->ndim; i++) {
-    if (a->shape[i] != b->shape[i]) {
-      fprintf(stderr, "Arrays must have the same shape for comparison\n");
-      exit(EXIT_FAILURE);
-    }
-  }
-  // converting both Arrays to float32 for computation
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  
-  // perform the equality comparison
-  not_equal_array_ops(a_float, b_float, out, a->size);
+  int* shape;
+  size_t size;
+  int ndim = broadcast_shape(a, b, &shape, &size);
+  // comparing in the promoted dtype of both operands
+  dtype_t cmp_dtype = promote_dtypes(a->dtype, b->dtype);
+  Array* a_cast = as_dtype_array(a, cmp_dtype);
+  Array* b_cast = as_dtype_array(b, cmp_dtype);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
+  Array* result = empty_array(ndim, shape, size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_broadcast(&it, a_cast, b_cast, result);
+  not_equal_array_ops(&it, cmp_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
+  free(shape);
   return result;
 }
 
@@ -289,25 +231,11 @@ Array* not_equal_scalar(Array* a, float b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  // converting both Arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  not_equal_scalar_ops(a_float, b, out, a->size);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  not_equal_scalar_ops(&it, b, a->dtype);
   return result;
 }
 
@@ -316,30 +244,21 @@ Array* greater_array(Array* a, Array* b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  if (a->ndim != b->ndim) {
-    fprintf(stderr, "Arrays must have same dimensions %d and %d for equal\n", a->ndim, b->ndim);
-    exit(EXIT_FAILURE);
-  }
-
-  // checking if shapes match
-  for (size_t i = 0; i < a->ndim; i++) {
-    if (a->shape[i] != b->shape[i]) {
-      fprintf(stderr, "Arrays must have the same shape for comparison\n");
-      exit(EXIT_FAILURE);
-    }
-  }
-  // converting both Arrays to float32 for computation
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  
-  // perform the equality comparison
-  greater_array_ops(a_float, b_float, out, a->size);
+  int* shape;
+  size_t size;
+  int ndim = broadcast_shape(a, b, &shape, &size);
+  // comparing in the promoted dtype of both operands
+  dtype_t cmp_dtype = promote_dtypes(a->dtype, b->dtype);
+  Array* a_cast = as_dtype_array(a, cmp_dtype);
+  Array* b_cast = as_dtype_array(b, cmp_dtype);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
+  Array* result = empty_array(ndim, shape, size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_broadcast(&it, a_cast, b_cast, result);
+  greater_array_ops(&it, cmp_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
+  free(shape);
   return result;
 }
 
@@ -348,25 +267,11 @@ Array* greater_scalar(Array* a, float b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  // converting both Arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  greater_scalar_ops(a_float, b, out, a->size);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  greater_scalar_ops(&it, b, a->dtype);
   return result;
 }
 
@@ -375,30 +280,21 @@ Array* greater_equal_array(Array* a, Array* b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  if (a->ndim != b->ndim) {
-    fprintf(stderr, "Arrays must have same dimensions %d and %d for equal\n", a->ndim, b->ndim);
-    exit(EXIT_FAILURE);
-  }
-
-  // checking if shapes match
-  for (size_t i = 0; i < a->ndim; i++) {
-    if (a->shape[i] != b->shape[i]) {
-      fprintf(stderr, "Arrays must have the same shape for comparison\n");
-      exit(EXIT_FAILURE);
-    }
-  }
-  // converting both Arrays to float32 for computation
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  
-  // perform the equality comparison
-  greater_equal_array_ops(a_float, b_float, out, a->size);
+  int* shape;
+  size_t size;
+  int ndim = broadcast_shape(a, b, &shape, &size);
+  // comparing in the promoted dtype of both operands
+  dtype_t cmp_dtype = promote_dtypes(a->dtype, b->dtype);
+  Array* a_cast = as_dtype_array(a, cmp_dtype);
+  Array* b_cast = as_dtype_array(b, cmp_dtype);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
+  Array* result = empty_array(ndim, shape, size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_broadcast(&it, a_cast, b_cast, result);
+  greater_equal_array_ops(&it, cmp_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
+  free(shape);
   return result;
 }
 
@@ -407,25 +303,11 @@ Array* greater_equal_scalar(Array* a, float b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  // converting both Arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  greater_equal_scalar_ops(a_float, b, out, a->size);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  greater_equal_scalar_ops(&it, b, a->dtype);
   return result;
 }
 
@@ -434,30 +316,21 @@ Array* smaller_array(Array* a, Array* b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  if (a->ndim != b->ndim) {
-    fprintf(stderr, "Arrays must have same dimensions %d and %d for equal\n", a->ndim, b->ndim);
-    exit(EXIT_FAILURE);
-  }
-
-  // checking if shapes match
-  for (size_t i = 0; i < a->ndim; i++) {
-    if (a->shape[i] != b->shape[i]) {
-      fprintf(stderr, "Arrays must have the same shape for comparison\n");
-      exit(EXIT_FAILURE);
-    }
-  }
-  // converting both Arrays to float32 for computation
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  
-  // perform the equality comparison
-  smaller_array_ops(a_float, b_float, out, a->size);
+  int* shape;
+  size_t size;
+  int ndim = broadcast_shape(a, b, &shape, &size);
+  // comparing in the promoted dtype of both operands
+  dtype_t cmp_dtype = promote_dtypes(a->dtype, b->dtype);
+  Array* a_cast = as_dtype_array(a, cmp_dtype);
+  Array* b_cast = as_dtype_array(b, cmp_dtype);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
+  Array* result = empty_array(ndim, shape, size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_broadcast(&it, a_cast, b_cast, result);
+  smaller_array_ops(&it, cmp_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
+  free(shape);
   return result;
 }
 
@@ -466,25 +339,11 @@ Array* smaller_scalar(Array* a, float b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  // converting both Arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  smaller_scalar_ops(a_float, b, out, a->size);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  smaller_scalar_ops(&it, b, a->dtype);
   return result;
 }
 
@@ -493,30 +352,21 @@ Array* smaller_equal_array(Array* a, Array* b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  if (a->ndim != b->ndim) {
-    fprintf(stderr, "Arrays must have same dimensions %d and %d for equal\n", a->ndim, b->ndim);
-    exit(EXIT_FAILURE);
-  }
-
-  // checking if shapes match
-  for (size_t i = 0; i < a->ndim; i++) {
-    if (a->shape[i] != b->shape[i]) {
-      fprintf(stderr, "Arrays must have the same shape for comparison\n");
-      exit(EXIT_FAILURE);
-    }
-  }
-  // converting both Arrays to float32 for computation
-  float *a_float = convert_to_float32(a->data, a->dtype, a->size), *b_float = convert_to_float32(b->data, b->dtype, b->size);
-  float* out = (float*)malloc(a->size * sizeof(float));
-  
-  // perform the equality comparison
-  smaller_equal_array_ops(a_float, b_float, out, a->size);
+  int* shape;
+  size_t size;
+  int ndim = broadcast_shape(a, b, &shape, &size);
+  // comparing in the promoted dtype of both operands
+  dtype_t cmp_dtype = promote_dtypes(a->dtype, b->dtype);
+  Array* a_cast = as_dtype_array(a, cmp_dtype);
+  Array* b_cast = as_dtype_array(b, cmp_dtype);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(b_float);
-  free(out);
+  Array* result = empty_array(ndim, shape, size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_broadcast(&it, a_cast, b_cast, result);
+  smaller_equal_array_ops(&it, cmp_dtype);
+  release_dtype_array(a_cast, a);
+  release_dtype_array(b_cast, b);
+  free(shape);
   return result;
 }
 
@@ -525,24 +375,10 @@ Array* smaller_equal_scalar(Array* a, float b) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  // converting both Arrays to float32 for computation
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    if (a_float) free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
-  smaller_equal_scalar_ops(a_float, b, out, a->size);
   // comparison operations always return boolean type
-  dtype_t result_dtype = DTYPE_BOOL;
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, DTYPE_BOOL);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  smaller_equal_scalar_ops(&it, b, a->dtype);
   return result;
 }
\ No newline at end of file
@@ -6,7 +6,8 @@
 
 extern "C" {
   // shaping ops
-  Array* transpose_array(Array* a);
+  Array* transpose_array(Array* a);   // transpose & permute return views, data moves once they're made contiguous
+  Array* permute_array(Array* a, int* axes, int ndim);
   Array* equal_array(Array* a, Array* b);
   Array* equal_scalar(Array* a, float b);
   Array* not_equal_array(Array* a, Array* b);
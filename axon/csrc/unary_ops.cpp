@@ -8,30 +8,14 @@ Array* sin_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  sin_ops(a_float, out, a->size);
   // For trigonometric functions, always return float type
   // If input is integer, promote to float32; if already float, keep same precision
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) {
-    result_dtype = DTYPE_FLOAT32;
-  } else {
-    result_dtype = a->dtype; // keep float32 or float64
-  }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  sin_ops(&it, a->dtype);
   return result;
 }
 
@@ -40,30 +24,14 @@ Array* sinh_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  sinh_ops(a_float, out, a->size);
   // For trigonometric functions, always return float type
   // If input is integer, promote to float32; if already float, keep same precision
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) {
-    result_dtype = DTYPE_FLOAT32;
-  } else {
-    result_dtype = a->dtype; // keep float32 or float64
-  }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  sinh_ops(&it, a->dtype);
   return result;
 }
 
@@ -72,30 +40,14 @@ Array* cos_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  cos_ops(a_float, out, a->size);
   // For trigonometric functions, always return float type
   // If input is integer, promote to float32; if already float, keep same precision
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) {
-    result_dtype = DTYPE_FLOAT32;
-  } else {
-    result_dtype = a->dtype; // keep float32 or float64
-  }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  cos_ops(&it, a->dtype);
   return result;
 }
 
@@ -104,30 +56,14 @@ Array* cosh_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  cosh_ops(a_float, out, a->size);
   // For trigonometric functions, always return float type
   // If input is integer, promote to float32; if already float, keep same precision
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) {
-    result_dtype = DTYPE_FLOAT32;
-  } else {
-    result_dtype = a->dtype; // keep float32 or float64
-  }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  cosh_ops(&it, a->dtype);
   return result;
 }
 
@@ -136,30 +72,14 @@ Array* tan_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  tan_ops(a_float, out, a->size);
   // For trigonometric functions, always return float type
   // If input is integer, promote to float32; if already float, keep same precision
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) {
-    result_dtype = DTYPE_FLOAT32;
-  } else {
-    result_dtype = a->dtype; // keep float32 or float64
-  }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  tan_ops(&it, a->dtype);
   return result;
 }
 
@@ -168,30 +88,14 @@ Array* tanh_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  tanh_ops(a_float, out, a->size);
   // For trigonometric functions, always return float type
   // If input is integer, promote to float32; if already float, keep same precision
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) {
-    result_dtype = DTYPE_FLOAT32;
-  } else {
-    result_dtype = a->dtype; // keep float32 or float64
-  }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  tanh_ops(&it, a->dtype);
   return result;
 }
 
@@ -200,29 +104,13 @@ Array* log_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  log_array_ops(a_float, out, a->size);
-  // If input is integer, promote to float32; if already float, keep same precision
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) {
-    result_dtype = DTYPE_FLOAT32;
-  } else {
-    result_dtype = a->dtype; // keep float32 or float64
-  }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  // integer inputs promote to float32, float inputs keep their precision
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  log_array_ops(&it, a->dtype);
   return result;
 }
 
@@ -231,29 +119,13 @@ Array* exp_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  exp_array_ops(a_float, out, a->size);
-  // If input is integer, promote to float32; if already float, keep same precision
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) {
-    result_dtype = DTYPE_FLOAT32;
-  } else {
-    result_dtype = a->dtype; // keep float32 or float64
-  }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  // integer inputs promote to float32, float inputs keep their precision
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  exp_array_ops(&it, a->dtype);
   return result;
 }
 
@@ -262,22 +134,11 @@ Array* abs_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  abs_array_ops(a_float, out, a->size);
-  Array* result = create_array(out, a->ndim, a->shape, a->size, a->dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, a->dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  abs_array_ops(&it, a->dtype);
   return result;
 }
 
@@ -286,22 +147,11 @@ Array* neg_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  neg_array_ops(a_float, out, a->size);
-  Array* result = create_array(out, a->ndim, a->shape, a->size, a->dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, a->dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  neg_array_ops(&it, a->dtype);
   return result;
 }
 
@@ -310,29 +160,13 @@ Array* sqrt_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  sqrt_array_ops(a_float, out, a->size);
-  // If input is integer, promote to float32; if already float, keep same precision
-  dtype_t result_dtype;
-  if (is_integer_dtype(a->dtype) || a->dtype == DTYPE_BOOL) {
-    result_dtype = DTYPE_FLOAT32;
-  } else {
-    result_dtype = a->dtype; // keep float32 or float64
-  }
-  Array* result = create_array(out, a->ndim, a->shape, a->size, result_dtype);
-  free(a_float);
-  free(out);
+  // integer inputs promote to float32, float inputs keep their precision
+  dtype_t result_dtype = get_float_dtype(a->dtype);
+  Array* result = empty_array(a->ndim, a->shape, a->size, result_dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  sqrt_array_ops(&it, a->dtype);
   return result;
 }
 
@@ -341,21 +175,10 @@ Array* sign_array(Array* a) {
     fprintf(stderr, "Array value pointers are null!\n");
     exit(EXIT_FAILURE);
   }
-  float* a_float = convert_to_float32(a->data, a->dtype, a->size);
-  if (a_float == NULL) {
-    fprintf(stderr, "Memory allocation failed during dtype conversion\n");
-    exit(EXIT_FAILURE);
-  }
-  float* out = (float*)malloc(a->size * sizeof(float));
-  if (out == NULL) {
-    fprintf(stderr, "Memory allocation failed\n");
-    free(a_float);
-    exit(EXIT_FAILURE);
-  }
 
-  sign_array_ops(a_float, out, a->size);
-  Array* result = create_array(out, a->ndim, a->shape, a->size, a->dtype);
-  free(a_float);
-  free(out);
+  Array* result = empty_array(a->ndim, a->shape, a->size, a->dtype);
+  NdIter it;
+  iter_init_unary(&it, a, result);
+  sign_array_ops(&it, a->dtype);
   return result;
 }
\ No newline at end of file
@@ -1,9 +1,29 @@
 from typing import *
-from ctypes import c_int, c_float, c_double
+from ctypes import c_int, c_int64, c_float, c_double, c_bool
 from .._cbase import CArray, lib, DType
 from .._core import array
 from .._helpers import DtypeHelp, ShapeHelp
 
+# factors & their solves stay in the float dtype the c side computed them in
+def _float_label(ptr: CArray) -> str: return "float64" if ptr.dtype == DType.FLOAT64 else "float32"
+
+def _shaped_outputs(result_ptr, shapes: list, dtype: DType) -> list:
+  # wraps the non-NULL entries of an Array** result & frees the pointer list itself
+  # without a dtype the outputs keep the one the c side computed them in, a given dtype is a real cast
+  outs = []
+  for i, shape in enumerate(shapes):
+    if not result_ptr[i]: continue
+    ptr = result_ptr[i]
+    if dtype and DtypeHelp._parse_dtype(dtype) != ptr.contents.dtype:
+      ptr, old = lib.cast_array(ptr, c_int(DtypeHelp._parse_dtype(dtype))), ptr
+      lib.delete_array(old)
+    out, size = array(ptr.contents, dtype if dtype else lib.get_dtype_name(ptr.contents.dtype).decode()), 1
+    for dim in shape: size *= dim
+    out.shape, out.size, out.ndim, out.strides = shape, size, len(shape), ShapeHelp.get_strides(shape)
+    outs.append(out)
+  lib.delete_buffer(result_ptr)
+  return outs
+
 def det(a: array, dtype: DType = 'float32') -> array:
   a = a if isinstance(a, array) else array(a, 'float32')
   if a.ndim == 2:
@@ -16,7 +36,8 @@ def det(a: array, dtype: DType = 'float32') -> array:
   out = array(ptr, dtype if dtype is not None else a.dtype)
   return (setattr(out, "shape", out_shape), setattr(out, "ndim", out_ndim), setattr(out, "size", out_size), setattr(out, "strides", out_strides), out)[4]
 
-def lu(a: array, dtype: DType = 'float32') -> array:
+def lu(a: array, dtype: DType = 'float32', p_indices: bool = False) -> array:
+  # p_indices also returns the int32 row permutation of the same factorization: a[..., perm, :] == l @ u
   a = a if isinstance(a, array) else array(a, 'float32')
   result_ptr = lib.lu_array(a.data) if a.ndim == 2 else lib.batched_lu_array(a.data)
   if a.ndim == 2:
@@ -24,54 +45,63 @@ def lu(a: array, dtype: DType = 'float32') -> array:
     l_size, u_size = a.shape[0] * a.shape[0], a.shape[0] * a.shape[1]
   else:
     l_shape, u_shape = a.shape[:-2] + (a.shape[-2], a.shape[-2]), a.shape[:-2] + (a.shape[-2], a.shape[-1])
-    l_size, u_size = (a.size // a.shape[-1]) * a.shape[-2], a.size // a.shape[-1]
-  l_out, u_out = array(result_ptr[0].contents, dtype or a.dtype), array(result_ptr[1].contents, dtype or a.dtype)
-  for out, shape, size in [(l_out, l_shape, l_size), (u_out, u_shape, u_size)]:
+    l_size, u_size = (a.size // a.shape[-1]) * a.shape[-2], a.size
+  l_out, u_out, p_out = array(result_ptr[0].contents, dtype or a.dtype), array(result_ptr[1].contents, dtype or a.dtype), array(result_ptr[2].contents, "int32")
+  lib.delete_buffer(result_ptr)
+  for out, shape, size in [(l_out, l_shape, l_size), (u_out, u_shape, u_size), (p_out, a.shape[:-1], a.size // a.shape[-1] if a.shape[-1] else 0)]:
     out.shape, out.ndim, out.size, out.strides = shape, len(shape), size, ShapeHelp.get_strides(shape)
-  return [l_out, u_out]
+  return [l_out, u_out, p_out] if p_indices else [l_out, u_out]
 
-def qr(a: array, dtype: DType = 'float32') -> array:
+def lu_factor(a: array) -> Tuple[array, array]:
+  # packed factors (unit L below the diagonal, U on & above it) & int32 pivots, for lu_solve
   a = a if isinstance(a, array) else array(a, 'float32')
-  result_ptr = lib.qr_array(a.data) if a.ndim == 2 else lib.batched_qr_array(a.data)
-  if a.ndim == 2:
-    q_shape, r_shape = (a.shape[0], a.shape[0]), (a.shape[0], a.shape[1])
-    q_size, r_size = a.shape[0] * a.shape[0], a.shape[0] * a.shape[1]
-  else:
-    q_shape, r_shape = a.shape[:-2] + (a.shape[-2], a.shape[-2]), a.shape[:-1]
-    q_size, r_size = (a.size // a.shape[-1]) * a.shape[-2], a.size // a.shape[-1]
+  result_ptr = lib.lu_factor_array(a.data)
+  lu, piv = array(result_ptr[0].contents, _float_label(result_ptr[0].contents)), array(result_ptr[1].contents, "int32")
+  lib.delete_buffer(result_ptr)
+  lu.shape, lu.ndim, lu.size, lu.strides = a.shape, a.ndim, a.size, ShapeHelp.get_strides(a.shape)
+  piv.shape, piv.ndim, piv.size, piv.strides = a.shape[:-1], a.ndim - 1, a.size // a.shape[-1] if a.shape[-1] else 0, ShapeHelp.get_strides(a.shape[:-1])
+  return lu, piv
+
+def cho_factor(a: array) -> array:
+  # lower cholesky factor of a symmetric positive definite matrix, for cho_solve
+  a = a if isinstance(a, array) else array(a, 'float32')
+  ptr = lib.cho_factor_array(a.data).contents
+  out = array(ptr, _float_label(ptr))
+  out.shape, out.ndim, out.size, out.strides = a.shape, a.ndim, a.size, ShapeHelp.get_strides(a.shape)
+  return out
+
+def qr(a: array, dtype: DType = 'float32', mode: str = 'complete') -> array:
+  # 'complete' gives the m x m Q & m x n R, 'reduced' the m x k Q & k x n R, k = min(m, n)
+  if mode not in ('complete', 'reduced'): raise ValueError(f"qr mode must be 'complete' or 'reduced', got '{mode}'")
+  a = a if isinstance(a, array) else array(a, 'float32')
+  result_ptr = lib.qr_array(a.data, c_bool(mode == 'reduced')) if a.ndim == 2 else lib.batched_qr_array(a.data, c_bool(mode == 'reduced'))
+  m, n = a.shape[-2], a.shape[-1]
+  k = min(m, n) if mode == 'reduced' else m
+  q_shape, r_shape = a.shape[:-2] + (m, k), a.shape[:-2] + (k, n)
+  q_size, r_size = (a.size // (m * n) if m * n else 0) * m * k, (a.size // (m * n) if m * n else 0) * k * n
   q_out, r_out = array(result_ptr[0].contents, dtype or a.dtype), array(result_ptr[1].contents, dtype or a.dtype)
+  lib.delete_buffer(result_ptr)
   for out, shape, size in [(q_out, q_shape, q_size), (r_out, r_shape, r_size)]:
     out.shape, out.ndim, out.size, out.strides = shape, len(shape), size, ShapeHelp.get_strides(shape)
   return [q_out, r_out]
 
-def svd(a: array, dtype: DType = 'float32') -> array:
+def svd(a: array, dtype: DType = None, full_matrices: bool = True, compute_uv: bool = True, k: int = None, n_iter: int = 2, seed: int = None) -> array:
+  # full_matrices: u (..., m, m) & vt (..., n, n), otherwise (..., m, k) & (..., k, n), k = min(m, n);
+  # compute_uv=False returns the singular values alone & never builds u or vt
+  # k: only the leading k triplets, u (..., m, k) & vt (..., k, n), from a randomized range finder with
+  # n_iter power iterations; seed makes its draws reproducible
   a = a if isinstance(a, array) else array(a, 'float32')
-  result_tuple = lib.svd_array(a.data)
-
-  u_ptr = result_tuple[0].contents
-  s_ptr = result_tuple[1].contents
-  vt_ptr = result_tuple[2].contents
-  u, s, vt = array(u_ptr, dtype if dtype else a.dtype), array(s_ptr, dtype if dtype else a.dtype), array(vt_ptr, dtype if dtype else a.dtype)
   m, n = a.shape[-2], a.shape[-1]
-  min_mn = min(m, n)
-
-  if a.ndim == 2:
-    u_shape, u_size, u_ndim, u_strides = (m, m), m * m, 2, ShapeHelp.get_strides((m, m))
-    s_shape, s_size, s_ndim, s_strides = (min_mn, ), min_mn, 1, (1, )
-    vt_shape, vt_size, vt_ndim, vt_strides = (n, n), n * n, 2, ShapeHelp.get_strides((n, n))
-  else:
-    batch_shape, batch_size = a.shape[:-2], 1
-    for dim in batch_shape: batch_size *= dim
-    u_shape, s_shape, vt_shape = batch_shape + (m, m), batch_shape + (min_mn,), batch_shape + (n, n)
-    u_size, s_size, vt_size = batch_size * m * m, batch_size * min_mn, batch_size * n * n
-    u_ndim, s_ndim, vt_ndim = a.ndim, a.ndim - 1, a.ndim
-    u_strides, s_strides, vt_strides = ShapeHelp.get_strides(u_shape), ShapeHelp.get_strides(s_shape), ShapeHelp.get_strides(vt_shape)
-
-  u.shape, u.size, u.ndim, u.strides = u_shape, u_size, u_ndim, u_strides
-  s.shape, s.size, s.ndim, s.strides = s_shape, s_size, s_ndim, s_strides
-  vt.shape, vt.size, vt.ndim, vt.strides = vt_shape, vt_size, vt_ndim, vt_strides
-
-  return u, s, vt
+  batch_shape = a.shape[:-2]
+  if k is not None:
+    result_ptr = lib.svd_topk_array(a.data, c_int(k), c_int(n_iter), c_int64(-1 if seed is None else seed), c_bool(compute_uv))
+    outs = _shaped_outputs(result_ptr, [batch_shape + (m, k), batch_shape + (k,), batch_shape + (k, n)], dtype)
+    return tuple(outs) if compute_uv else outs[0]
+  result_ptr = lib.svd_array(a.data, c_bool(full_matrices), c_bool(compute_uv))
+  k = min(m, n)
+  u_cols, vt_rows = (m, n) if full_matrices else (k, k)
+  outs = _shaped_outputs(result_ptr, [batch_shape + (m, u_cols), batch_shape + (k,), batch_shape + (vt_rows, n)], dtype)
+  return tuple(outs) if compute_uv else outs[0]
 
 def cholesky(a: array, dtype: DType = 'float32') -> array:
   a = a if isinstance(a, array) else array(a, 'float32')
@@ -80,8 +110,29 @@ def cholesky(a: array, dtype: DType = 'float32') -> array:
   out.shape, out.size, out.ndim, out.strides = a.shape, a.size, a.ndim, a.strides
   return out
 
-def eign(a: array, dtype: DType = 'float32') -> array:
+def eig(a: array, dtype: DType = None, imag: bool = False) -> tuple:
+  # (values, vectors) or (real, imaginary, vectors) out of one solve, any stack of square matrices;
+  # vectors are packed like eignv's
   a = a if isinstance(a, array) else array(a, 'float32')
+  result_ptr = lib.eig_pairs_array(a.data, c_bool(imag))
+  return tuple(_shaped_outputs(result_ptr, [a.shape[:-1], a.shape[:-1], a.shape], dtype))
+
+def eigh(a: array, dtype: DType = None, k: int = None, seed: int = None) -> tuple:
+  # (values ascending, vectors as columns) out of one solve, the k of largest magnitude when k is given
+  a = a if isinstance(a, array) else array(a, 'float32')
+  if k is not None: return tuple(_eignh_topk(a, dtype, k, seed, True))
+  result_ptr = lib.eigh_pairs_array(a.data)
+  return tuple(_shaped_outputs(result_ptr, [a.shape[:-1], a.shape], dtype))
+
+def eign(a: array, dtype: DType = 'float32', imag: bool = False) -> array:
+  a = a if isinstance(a, array) else array(a, 'float32')
+  if imag:
+    # (real, imaginary) parts, conjugate pairs adjacent with the positive imaginary part first
+    result_ptr = lib.eig_parts_array(a.data)
+    parts = [array(result_ptr[i].contents, _float_label(result_ptr[i].contents)) for i in range(2)]
+    lib.delete_buffer(result_ptr)
+    for out in parts: out.shape, out.ndim, out.size, out.strides = a.shape[:-1], a.ndim - 1, a.size // a.shape[-1] if a.shape[-1] else 0, ShapeHelp.get_strides(a.shape[:-1])
+    return tuple(parts)
   if a.ndim == 2:
     ptr = lib.eig_array(a.data).contents
     out_shape, out_size, out_ndim, out_strides = (a.shape[0],), a.shape[0], 1, (1,)
@@ -104,8 +155,14 @@ def eignv(a: array, dtype: DType = 'float32') -> array:
   out = array(ptr, dtype if dtype is not None else a.dtype)
   return (setattr(out, "shape", out_shape), setattr(out, "ndim", out_ndim), setattr(out, "size", out_size), setattr(out, "strides", out_strides), out)[4]
 
-def eignh(a: array, dtype: DType = 'float32') -> array:
+def _eignh_topk(a: array, dtype: DType, k: int, seed: int, vectors: bool) -> list:
+  # the k eigenpairs of largest magnitude by thick restart lanczos, values ascending & vectors (..., n, k)
+  result_ptr = lib.eigh_topk_array(a.data, c_int(k), c_int64(-1 if seed is None else seed), c_bool(vectors))
+  return _shaped_outputs(result_ptr, [a.shape[:-2] + (k,), a.shape[:-1] + (k,)], dtype)
+
+def eignh(a: array, dtype: DType = 'float32', k: int = None, seed: int = None) -> array:
   a = a if isinstance(a, array) else array(a, 'float32')
+  if k is not None: return _eignh_topk(a, dtype, k, seed, False)[0]
   if a.ndim == 2:
     ptr = lib.eigh_array(a.data).contents
     out_shape, out_size, out_ndim, out_strides = (a.shape[0],), a.shape[0], 1, (1,)
@@ -116,8 +173,9 @@ def eignh(a: array, dtype: DType = 'float32') -> array:
   out = array(ptr, dtype if dtype is not None else a.dtype)
   return (setattr(out, "shape", out_shape), setattr(out, "ndim", out_ndim), setattr(out, "size", out_size), setattr(out, "strides", out_strides), out)[4]
 
-def eignhv(a: array, dtype: DType = 'float32') -> array:
+def eignhv(a: array, dtype: DType = 'float32', k: int = None, seed: int = None) -> array:
   a = a if isinstance(a, array) else array(a, 'float32')
+  if k is not None: return _eignh_topk(a, dtype, k, seed, True)[1]
   if a.ndim == 2:
     ptr = lib.eighv_array(a.data).contents
     out_shape, out_size, out_ndim, out_strides = a.shape, a.size, a.ndim, a.strides
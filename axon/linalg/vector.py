@@ -3,6 +3,7 @@ from ctypes import c_int, c_float, c_double
 from .._cbase import CArray, lib, DType
 from .._core import array
 from .._helpers import DtypeHelp, ShapeHelp
+from .decompose import _float_label
 
 def dot(a: array, b: array, dtype: DType = 'float32') -> array:
   a, b = a if isinstance(a, array) else array(a, 'float32'), b if isinstance(b, array) else array(b, 'float32')
@@ -64,18 +65,30 @@ def solve(a: array, b: array, dtype: DType = 'float32') -> array:
   a, b = a if isinstance(a, array) else array(a, 'float32'), b if isinstance(b, array) else array(b, 'float32')
   ptr = lib.solve_array(a.data, b.data).contents
   out = array(ptr, dtype if dtype is not None else a.dtype)
-  if b.ndim == 1:
-    out_shape, out_size, out_ndim, out_strides = (a.shape[1],), a.shape[1], 1, (1,)
-  else:
-    out_shape, out_size, out_ndim, out_strides = (a.shape[1], b.shape[1]), a.shape[1] * b.shape[1], 2, ShapeHelp.get_strides((a.shape[1], b.shape[1]))
+  out_shape, out_size, out_ndim, out_strides = tuple(b.shape), b.size, b.ndim, ShapeHelp.get_strides(tuple(b.shape))
   return (setattr(out, "shape", out_shape), setattr(out, "ndim", out_ndim), setattr(out, "size", out_size), setattr(out, "strides", out_strides), out)[4]
 
+def lu_solve(lu_and_piv: Tuple[array, array], b: array) -> array:
+  # b is a vector or matrix of right-hand sides per factor, or any stack of them against one factor
+  (lu, piv), b = lu_and_piv, b if isinstance(b, array) else array(b, 'float32')
+  ptr = lib.lu_solve_array(lu.data, piv.data, b.data).contents
+  out = array(ptr, _float_label(ptr))
+  out.shape, out.ndim, out.size, out.strides = tuple(b.shape), b.ndim, b.size, ShapeHelp.get_strides(tuple(b.shape))
+  return out
+
+def cho_solve(c: array, b: array) -> array:
+  b = b if isinstance(b, array) else array(b, 'float32')
+  ptr = lib.cho_solve_array(c.data, b.data).contents
+  out = array(ptr, _float_label(ptr))
+  out.shape, out.ndim, out.size, out.strides = tuple(b.shape), b.ndim, b.size, ShapeHelp.get_strides(tuple(b.shape))
+  return out
+
 def lstsq(a: array, b: array, dtype: DType = 'float32') -> array:
   a, b = a if isinstance(a, array) else array(a, 'float32'), b if isinstance(b, array) else array(b, 'float32')
   ptr = lib.lstsq_array(a.data, b.data).contents
   out = array(ptr, dtype if dtype is not None else a.dtype)
-  if b.ndim == 1:
-    out_shape, out_size, out_ndim, out_strides = (a.shape[1],), a.shape[1], 1, (1,)
-  else:
-    out_shape, out_size, out_ndim, out_strides = (a.shape[1], b.shape[1]), a.shape[1] * b.shape[1], 2, ShapeHelp.get_strides((a.shape[1], b.shape[1]))
+  # b's shape with its row dim swapped for a's column count
+  b_vector = b.ndim == 1 or b.ndim == a.ndim - 1
+  out_shape = tuple(b.shape[:-1]) + (a.shape[-1],) if b_vector else tuple(b.shape[:-2]) + (a.shape[-1], b.shape[-1])
+  out_size, out_ndim, out_strides = b.size // b.shape[-1 if b_vector else -2] * a.shape[-1] if b.shape[-1 if b_vector else -2] else 0, len(out_shape), ShapeHelp.get_strides(out_shape)
   return (setattr(out, "shape", out_shape), setattr(out, "ndim", out_ndim), setattr(out, "size", out_size), setattr(out, "strides", out_strides), out)[4]
\ No newline at end of file
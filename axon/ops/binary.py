@@ -12,7 +12,8 @@ def add_array_ops(self, other):
       if ShapeHelp.is_broadcastable(self.shape, other.shape): result_ptr = lib.add_broadcasted_array(self.data, other.data).contents
       else: raise ValueError(f"Shapes {self.shape} & {other.shape} are incompatible for broadcasting")
   out = array(result_ptr, self.dtype)
-  out.shape, out.ndim, out.size, out.strides = self.shape, self.ndim, self.size, self.strides
+  shape = self.shape if isinstance(other, (int, float)) else ShapeHelp.broadcast_shapes(self.shape, other.shape)[0]
+  out.shape, out.ndim, out.size, out.strides = shape, len(shape), ShapeHelp.get_size(shape), ShapeHelp.get_strides(shape)
   return out
 
 def sub_array_ops(self, other):
@@ -25,7 +26,8 @@ def sub_array_ops(self, other):
       if ShapeHelp.is_broadcastable(self.shape, other.shape): result_ptr = lib.sub_broadcasted_array(self.data, other.data).contents
       else: raise ValueError(f"Shapes {self.shape} & {other.shape} are incompatible for broadcasting")
   out = array(result_ptr, self.dtype)
-  out.shape, out.ndim, out.size, out.strides = self.shape, self.ndim, self.size, self.strides
+  shape = self.shape if isinstance(other, (int, float)) else ShapeHelp.broadcast_shapes(self.shape, other.shape)[0]
+  out.shape, out.ndim, out.size, out.strides = shape, len(shape), ShapeHelp.get_size(shape), ShapeHelp.get_strides(shape)
   return out
 
 def mul_array_ops(self, other):
@@ -35,10 +37,11 @@ def mul_array_ops(self, other):
   else:
     if self.shape == other.shape: result_ptr = lib.mul_array(self.data, other.data).contents
     else:
-      if ShapeHelp.is_broadcastable(self.shape, other.shape): result_ptr = lib.sub_broadcasted_array(self.data, other.data).contents
+      if ShapeHelp.is_broadcastable(self.shape, other.shape): result_ptr = lib.mul_broadcasted_array(self.data, other.data).contents
       else: raise ValueError(f"Shapes {self.shape} & {other.shape} are incompatible for broadcasting")
   out = array(result_ptr, self.dtype)
-  out.shape, out.ndim, out.size, out.strides = self.shape, self.ndim, self.size, self.strides
+  shape = self.shape if isinstance(other, (int, float)) else ShapeHelp.broadcast_shapes(self.shape, other.shape)[0]
+  out.shape, out.ndim, out.size, out.strides = shape, len(shape), ShapeHelp.get_size(shape), ShapeHelp.get_strides(shape)
   return out
 
 def div_array_ops(self, other):
@@ -48,10 +51,11 @@ def div_array_ops(self, other):
   else:
     if self.shape == other.shape: result_ptr = lib.div_array(self.data, other.data).contents
     else:
-      if ShapeHelp.is_broadcastable(self.shape, other.shape): result_ptr = lib.sub_broadcasted_array(self.data, other.data).contents
+      if ShapeHelp.is_broadcastable(self.shape, other.shape): result_ptr = lib.div_broadcasted_array(self.data, other.data).contents
       else: raise ValueError(f"Shapes {self.shape} & {other.shape} are incompatible for broadcasting")
   out = array(result_ptr, self.dtype)
-  out.shape, out.ndim, out.size, out.strides = self.shape, self.ndim, self.size, self.strides
+  shape = self.shape if isinstance(other, (int, float)) else ShapeHelp.broadcast_shapes(self.shape, other.shape)[0]
+  out.shape, out.ndim, out.size, out.strides = shape, len(shape), ShapeHelp.get_size(shape), ShapeHelp.get_strides(shape)
   return out
 
 def pow_array_ops(self, exp):
@@ -73,7 +77,7 @@ def matmul_array_ops(self, other):
   from .._core import array
   other = other if isinstance(other, (CArray, array)) else array(other, self.dtype)
   if self.ndim <= 2 and other.ndim <= 2: result_ptr = lib.matmul_array(self.data, other.data).contents
-  elif self.ndim == 3 and other.ndim == 3: result_ptr = lib.batch_matmul_arry(self.data, other.data).contents
+  elif self.ndim == 3 and other.ndim == 3: result_ptr = lib.batch_matmul_array(self.data, other.data).contents
   else: result_ptr = lib.broadcasted_matmul_array(self.data, other.data).contents
   out = array(result_ptr, self.dtype)
   shape, ndim, size = lib.out_shape(result_ptr), out.data.ndim, lib.out_size(result_ptr)
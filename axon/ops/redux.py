@@ -1,73 +1,40 @@
 from .._cbase import CArray, lib, DType
 from .._helpers import ShapeHelp, DtypeHelp
 from ctypes import c_float, c_int, c_bool
+from typing import Optional, Tuple, Union
 
-def sum_array_ops(self, axis: int=-1, keepdims: bool=False):
-  from .._core import array
-  out = array(lib.sum_array(self.data, c_int(axis), c_bool(keepdims)).contents, self.dtype)
-  if axis == -1: out.shape, out.size, out.ndim = (1,) if keepdims else (), 1, 1 if keepdims else 0
-  else:
-    new_shape = list(self.shape)
-    if keepdims: new_shape[axis] = 1
-    else: new_shape.pop(axis)
-    out.shape = tuple(new_shape)
-    out.size, out.ndim, out.strides = 1 if not new_shape else eval('*'.join(map(str, new_shape))), len(new_shape), ShapeHelp.get_strides(out.shape) if out.shape else []
-  return out
-
-def mean_array_ops(self, axis: int=-1, keepdims: bool=False):
-  from .._core import array
-  out = array(lib.mean_array(self.data, c_int(axis), c_bool(keepdims)).contents, self.dtype)
-  if axis == -1: out.shape, out.size, out.ndim = (1,) if keepdims else (), 1, 1 if keepdims else 0
-  else:
-    new_shape = list(self.shape)
-    if keepdims: new_shape[axis] = 1
-    else: new_shape.pop(axis)
-    out.shape = tuple(new_shape)
-    out.size, out.ndim, out.strides = 1 if not new_shape else eval('*'.join(map(str, new_shape))), len(new_shape), ShapeHelp.get_strides(out.shape) if out.shape else []
-  return out
+def _reduce_axes(self, axis) -> Tuple[int, ...]:
+  # None reduces every dim, an int or a tuple of ints reduce those dims (negatives count from the back, -1 included)
+  if axis is None: return ()
+  axes = tuple(ax + self.ndim if ax < 0 else ax for ax in ((axis,) if isinstance(axis, int) else axis))
+  if any(ax < 0 or ax >= self.ndim for ax in axes): raise ValueError(f"axis {axis} out of range for array of dimension {self.ndim}")
+  if len(set(axes)) != len(axes): raise ValueError(f"repeated axis in {axis}")
+  return axes
 
-def min_array_ops(self, axis: int=-1, keepdims: bool=False):
+def _reduce_out(self, ptr, axes: Tuple[int, ...], keepdims: bool, dtype):
   from .._core import array
-  out = array(lib.min_array(self.data, c_int(axis), c_bool(keepdims)).contents, self.dtype)
-  if axis == -1: out.shape, out.size, out.ndim = (1,) if keepdims else (), 1, 1 if keepdims else 0
-  else:
-    new_shape = list(self.shape)
-    if keepdims: new_shape[axis] = 1
-    else: new_shape.pop(axis)
-    out.shape = tuple(new_shape)
-    out.size, out.ndim, out.strides = 1 if not new_shape else eval('*'.join(map(str, new_shape))), len(new_shape), ShapeHelp.get_strides(out.shape) if out.shape else []
+  out = array(ptr.contents, dtype)
+  reduced = set(axes) if axes else set(range(self.ndim))
+  new_shape = [1 if i in reduced else dim for i, dim in enumerate(self.shape) if keepdims or i not in reduced]
+  out.shape = tuple(new_shape)
+  out.size, out.ndim, out.strides = ShapeHelp.get_size(new_shape), len(new_shape), ShapeHelp.get_strides(out.shape) if out.shape else []
   return out
 
-def max_array_ops(self, axis: int=-1, keepdims: bool=False):
-  from .._core import array
-  out = array(lib.max_array(self.data, c_int(axis), c_bool(keepdims)).contents, self.dtype)
-  if axis == -1: out.shape, out.size, out.ndim = (1,) if keepdims else (), 1, 1 if keepdims else 0
-  else:
-    new_shape = list(self.shape)
-    if keepdims: new_shape[axis] = 1
-    else: new_shape.pop(axis)
-    out.shape = tuple(new_shape)
-    out.size, out.ndim, out.strides = 1 if not new_shape else eval('*'.join(map(str, new_shape))), len(new_shape), ShapeHelp.get_strides(out.shape) if out.shape else []
-  return out
+def _reduce(self, fn, axis, keepdims: bool, *args):
+  axes = _reduce_axes(self, axis)
+  return _reduce_out(self, fn(self.data, (c_int * max(len(axes), 1))(*axes), c_int(len(axes)), *args, c_bool(keepdims)), axes, keepdims, self.dtype)
 
-def var_array_ops(self, axis: int=-1, ddof: int=0):
-  from .._core import array
-  out = array(lib.var_array(self.data, c_int(axis), c_int(ddof)).contents, self.dtype)
-  if axis == -1: out.shape, out.size, out.ndim = (), 1, 0
-  else:
-    new_shape = list(self.shape)
-    new_shape.pop(axis)
-    out.shape = tuple(new_shape)
-    out.size, out.ndim, out.strides = 1 if not new_shape else eval('*'.join(map(str, new_shape))), len(new_shape), ShapeHelp.get_strides(out.shape) if out.shape else []
-  return out
+def sum_array_ops(self, axis: Optional[Union[int, Tuple[int, ...]]]=None, keepdims: bool=False): return _reduce(self, lib.sum_array, axis, keepdims)
+def mean_array_ops(self, axis: Optional[Union[int, Tuple[int, ...]]]=None, keepdims: bool=False): return _reduce(self, lib.mean_array, axis, keepdims)
+def min_array_ops(self, axis: Optional[Union[int, Tuple[int, ...]]]=None, keepdims: bool=False): return _reduce(self, lib.min_array, axis, keepdims)
+def max_array_ops(self, axis: Optional[Union[int, Tuple[int, ...]]]=None, keepdims: bool=False): return _reduce(self, lib.max_array, axis, keepdims)
+def var_array_ops(self, axis: Optional[Union[int, Tuple[int, ...]]]=None, ddof: int=0, keepdims: bool=False): return _reduce(self, lib.var_array, axis, keepdims, c_int(ddof))
+def std_array_ops(self, axis: Optional[Union[int, Tuple[int, ...]]]=None, ddof: int=0, keepdims: bool=False): return _reduce(self, lib.std_array, axis, keepdims, c_int(ddof))
 
-def std_array_ops(self, axis: int=-1, ddof: int=0):
-  from .._core import array
-  out = array(lib.std_array(self.data, c_int(axis), c_int(ddof)).contents, self.dtype)
-  if axis == -1: out.shape, out.size, out.ndim = (), 1, 0
-  else:
-    new_shape = list(self.shape)
-    new_shape.pop(axis)
-    out.shape = tuple(new_shape)
-    out.size, out.ndim, out.strides = 1 if not new_shape else eval('*'.join(map(str, new_shape))), len(new_shape), ShapeHelp.get_strides(out.shape) if out.shape else []
-  return out
\ No newline at end of file
+def mean_var_array_ops(self, axis: Optional[Union[int, Tuple[int, ...]]]=None, ddof: int=0, keepdims: bool=False):
+  # both moments from one pass, float64 for float64 input & float32 otherwise
+  axes, dtype = _reduce_axes(self, axis), "float64" if self.dtype in ("float64", "double") else "float32"
+  result_ptr = lib.mean_var_array(self.data, (c_int * max(len(axes), 1))(*axes), c_int(len(axes)), c_int(ddof), c_bool(keepdims))
+  mean, var = _reduce_out(self, result_ptr[0], axes, keepdims, dtype), _reduce_out(self, result_ptr[1], axes, keepdims, dtype)
+  lib.delete_buffer(result_ptr)
+  return mean, var
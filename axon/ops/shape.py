@@ -2,19 +2,29 @@ from .._cbase import CArray, lib, DType
 from .._helpers import ShapeHelp, DtypeHelp
 from ctypes import c_int
 
-def transpose_array_ops(self):
+# reshapes come back as views when the layout allows it, so strides are read from the c array
+def _view_strides(out): return list(lib.out_strides(out.data)[:out.ndim])
+
+def transpose_array_ops(self, axes=None):
   from .._core import array
-  assert self.ndim <= 3, ".transpose() only supported till 3-d arrays"
-  out = array(lib.transpose_array(self.data).contents, self.dtype)
-  out.shape, out.size, out.ndim = tuple(ShapeHelp.transpose_shape(self.shape)), self.size, self.ndim
-  out.strides = ShapeHelp.get_strides(out.shape)
+  if axes is None:  # swapping the last two dims
+    axes = list(range(self.ndim))
+    if self.ndim >= 2: axes[-2], axes[-1] = axes[-1], axes[-2]
+    out = array(lib.transpose_array(self.data).contents, self.dtype)
+  else:
+    axes = [a + self.ndim if a < 0 else a for a in axes]
+    if sorted(axes) != list(range(self.ndim)): raise ValueError(f"axes {tuple(axes)} don't match array of {self.ndim} dims")
+    out = array(lib.permute_array(self.data, (c_int * self.ndim)(*axes), c_int(self.ndim)).contents, self.dtype)
+  out.shape, out.size, out.ndim = tuple(self.shape[a] for a in axes), self.size, self.ndim
+  out.strides = [self.strides[a] for a in axes]   # a view, strides follow the axes
   return out
 
 def flatten_array_ops(self):
   from .._core import array
   out = array(lib.flatten_array(self.data).contents, self.dtype)
   out.shape = (self.size,)
-  out.size, out.ndim, out.strides = self.size, 1, ShapeHelp.get_strides(out.shape)
+  out.size, out.ndim = self.size, 1
+  out.strides = _view_strides(out)
   return out
 
 def expand_dims_ops(self, axis):
@@ -25,7 +35,8 @@ def expand_dims_ops(self, axis):
   if axis < 0: axis = len(new_shape) + axis + 1
   new_shape.insert(axis, 1)
   out.shape = tuple(new_shape)
-  out.size, out.ndim, out.strides = self.size, len(out.shape), ShapeHelp.get_strides(out.shape)
+  out.size, out.ndim = self.size, len(out.shape)
+  out.strides = _view_strides(out)
   return out
 
 def squeeze_array_ops(self, axis):
@@ -37,7 +48,8 @@ def squeeze_array_ops(self, axis):
     if self.shape[axis] != 1: raise ValueError(f"Cannot squeeze axis {axis} with size {self.shape[axis]}")
     new_shape = list(self.shape); new_shape.pop(axis)
   out.shape = tuple(new_shape) if new_shape else (1,)
-  out.size, out.ndim, out.strides = self.size, len(out.shape), ShapeHelp.get_strides(out.shape)
+  out.size, out.ndim = self.size, len(out.shape)
+  out.strides = _view_strides(out)
   return out
 
 def reshape_array_ops(self, new_shape):
@@ -48,12 +60,13 @@ def reshape_array_ops(self, new_shape):
   if new_size != self.size: raise ValueError(f"Cannot reshape array of size {self.size} into shape {new_shape}")
   result_ptr = lib.reshape_array(self.data, (c_int * ndim)(*new_shape), c_int(ndim)).contents
   out = array(result_ptr, self.dtype)
-  out.shape, out.size, out.ndim = tuple(new_shape), self.size, ndim; out.strides = ShapeHelp.get_strides(new_shape)
+  out.shape, out.size, out.ndim = tuple(new_shape), self.size, ndim; out.strides = _view_strides(out)
   return out
 
 def to_list_array(self):
   data_ptr = lib.out_data(self.data)
-  data_array = [data_ptr[i] for i in range(self.size)]
+  data_array = data_ptr[:self.size]
+  lib.delete_buffer(data_ptr)
   if self.ndim == 0: return data_array[0]
   elif self.ndim == 1: return data_array
   else: return ShapeHelp.reshape_list(data_array, self.shape)
@@ -61,7 +74,7 @@ def to_list_array(self):
 def contiguous_array_ops(self):
   from .._core import array
   out = array(lib.contiguous_array(self.data).contents, self.dtype)
-  out.shape, out.size, out.ndim, out.strides = self.shape, self.size, self.ndim, self.strides
+  out.shape, out.size, out.ndim, out.strides = self.shape, self.size, self.ndim, ShapeHelp.get_strides(self.shape)
   return out
 
 def make_contiguous_array_ops(self) -> None:
@@ -137,6 +137,18 @@ class TestArrayViews:
     b = a.view()
     assert b.shape == a.shape
 
+  def test_view_outlives_base(self):
+    from axon._cbase import lib
+    a = ax.array([[1, 2], [3, 4]])
+    b = a.view()
+    assert lib.storage_refcount_array(a.data) == 2
+    c = ax.array(b)     # wraps b's c array, no new reference
+    assert lib.storage_refcount_array(b.data) == 2
+    del a
+    assert lib.storage_refcount_array(b.data) == 1
+    del b
+    assert c.tolist() == [[1, 2], [3, 4]]
+
 class TestBinaryOperations:
   def test_add_array(self):
     a = ax.array([1, 2, 3])
@@ -202,6 +214,60 @@ class TestBinaryOperations:
     expected = [4.0, 9.0, 16.0]
     assert c.tolist() == expected
 
+  def test_integer_overflow_saturates(self):
+    # int32 limits come back through float32, 2147483647 reads as 2147483648.0
+    a = ax.array([2000000000, -2000000000], dtype='int32')
+    assert (a + a).tolist() == [2147483648.0, -2147483648.0]
+    assert (a - (-a)).tolist() == [2147483648.0, -2147483648.0]
+    assert (a * a).tolist() == [2147483648.0, 2147483648.0]
+    assert (a * 2).tolist() == (a + a).tolist()
+    b = ax.array([30000, -30000], dtype='int16')
+    assert (b + b).tolist() == [32767.0, -32768.0]
+    assert (b * b).tolist() == [32767.0, 32767.0]
+    assert (b * -b).tolist() == [-32768.0, -32768.0]
+    assert (b * 2).tolist() == (b + b).tolist()
+    u = ax.array([200, 10], dtype='uint8')
+    assert (u + u).tolist() == [255.0, 20.0]
+    assert (u + 100).tolist() == [255.0, 110.0]
+    assert (u - ax.array([250, 250], dtype='uint8')).tolist() == [0.0, 0.0]
+    assert (u - 250).tolist() == [0.0, 0.0]
+    assert (u * u).tolist() == [255.0, 100.0]
+
+  def test_integer_overflow_saturates_between_arrays(self):
+    a = ax.array([100, -100, 5], dtype='int8')
+    b = ax.array([100, 100, -128], dtype='int8')
+    assert (a + b).tolist() == [127.0, 0.0, -123.0]
+    assert (a - b).tolist() == [0.0, -128.0, 127.0]
+    assert (a * b).tolist() == [127.0, -128.0, -128.0]
+    # broadcast row against a matrix
+    m = ax.array([[120, -120], [1, 2]], dtype='int8')
+    r = ax.array([10, 10], dtype='int8')
+    assert (m + r).tolist() == [[127.0, -110.0], [11.0, 12.0]]
+    assert (m - r).tolist() == [[110.0, -128.0], [-9.0, -8.0]]
+    # int64 limits read back through float32 as +-2**63
+    x = ax.array([2**62, -2**62], dtype='int64')
+    y = ax.array([2**62, 2**62], dtype='int64')
+    assert (x + y).tolist() == [2.0**63, 0.0]
+    assert (x - y).tolist() == [0.0, -2.0**63]
+    assert (x * y).tolist() == [2.0**63, -2.0**63]
+    # transposed operand
+    t = ax.array([[200, 1], [2, 200]], dtype='uint8')
+    assert (t + t.transpose()).tolist() == [[255.0, 3.0], [3.0, 255.0]]
+
+  def test_broadcast_row(self):
+    a = ax.array([[1, 2, 3], [4, 5, 6]])
+    b = ax.array([10, 20, 30])
+    c = a * b
+    assert c.shape == (2, 3)
+    assert c.tolist() == [[10.0, 40.0, 90.0], [40.0, 100.0, 180.0]]
+
+  def test_broadcast_column(self):
+    a = ax.array([[1, 2, 3], [4, 5, 6]])
+    b = ax.array([[1], [2]])
+    c = a / b
+    assert c.shape == (2, 3)
+    assert c.tolist() == [[1.0, 2.0, 3.0], [2.0, 2.5, 3.0]]
+
 class TestReverseOperations:
   def test_radd(self):
     a = ax.array([1, 2, 3])
@@ -314,6 +380,36 @@ class TestMatrixOperations:
     expected = np.matmul([[1, 2], [3, 4]], [[5, 6], [7, 8]]).tolist()
     assert np.allclose(c.tolist(), expected, atol=1e-5)
 
+  def test_matmul_edge_tiles(self):
+    # sizes that leave partial register tiles & span several k blocks
+    x = np.random.randn(37, 301).astype(np.float32)
+    y = np.random.randn(301, 53).astype(np.float32)
+    c = ax.array(x.tolist()) @ ax.array(y.tolist())
+    assert c.shape == (37, 53)
+    assert np.allclose(c.tolist(), x @ y, atol=1e-3)
+
+  def test_matmul_batch(self):
+    x = np.random.randn(3, 5, 7).astype(np.float32)
+    y = np.random.randn(3, 7, 4).astype(np.float32)
+    c = ax.array(x.tolist()) @ ax.array(y.tolist())
+    assert c.shape == (3, 5, 4)
+    assert np.allclose(c.tolist(), x @ y, atol=1e-4)
+
+  def test_matmul_views(self):
+    # transposed & permuted operands are packed through their strides, mixed dtypes still convert
+    rng = np.random.default_rng(5)
+    x, y = rng.standard_normal((37, 53)).astype(np.float32), rng.standard_normal((41, 53)).astype(np.float32)
+    z, w = rng.standard_normal((4, 53, 6)).astype(np.float32), rng.standard_normal((4, 6, 53)).astype(np.float32)
+    a, b, c, d = ax.array(x.tolist()), ax.array(y.tolist()), ax.array(z.tolist()), ax.array(w.tolist())
+    assert np.allclose((a @ b.transpose()).tolist(), x @ y.T, atol=1e-4)
+    assert np.allclose((b.transpose().transpose() @ a.transpose()).tolist(), y @ x.T, atol=1e-4)
+    assert np.allclose((d @ c.permute(0, 2, 1).permute(0, 2, 1)).tolist(), w @ z, atol=1e-4)
+    assert np.allclose((c.permute(0, 2, 1) @ d.permute(0, 2, 1)).tolist(), z.transpose(0, 2, 1) @ w.transpose(0, 2, 1), atol=1e-4)
+    assert np.allclose((b @ d.permute(0, 2, 1)).tolist(), y @ w.transpose(0, 2, 1), atol=1e-4)
+    assert np.allclose((ax.array(x.tolist(), dtype='float64') @ b.transpose()).tolist(), x @ y.T, atol=1e-4)
+    xi, yi = (x * 10).astype(np.int32), (y * 10).astype(np.int32)
+    assert np.array_equal((ax.array(xi.tolist(), dtype='int32') @ ax.array(yi.tolist(), dtype='int32').transpose()).tolist(), xi @ yi.T)
+
 class TestShapeOperations:
   def test_transpose_2d(self):
     a = ax.array([[1, 2, 3], [4, 5, 6]])
@@ -322,6 +418,17 @@ class TestShapeOperations:
     expected = [[1, 4], [2, 5], [3, 6]]
     assert b.tolist() == expected
 
+  def test_permute_view(self):
+    from axon._cbase import lib
+    x = np.arange(5 * 37 * 45).reshape(5, 37, 45) % 97
+    for dtype in ['float32', 'float64', 'int8']:
+      a = ax.array(x.tolist(), dtype=dtype)
+      b = a.permute(2, 0, 1)
+      assert b.shape == (45, 5, 37)
+      assert b.is_view() and lib.storage_refcount_array(a.data) == 2
+      assert np.array_equal(np.array(b.contiguous().tolist()), x.transpose(2, 0, 1))
+      assert np.array_equal(np.array(a.transpose().tolist()), x.transpose(0, 2, 1))
+
   def test_reshape(self):
     a = ax.array([1, 2, 3, 4, 5, 6])
     b = a.reshape([2, 3])
@@ -334,6 +441,17 @@ class TestShapeOperations:
     b = a.reshape((2, 2))
     assert b.shape == (2, 2)
 
+  def test_reshape_view_or_copy(self):
+    x = np.arange(24).reshape(2, 3, 4)
+    a = ax.array(x.tolist())
+    assert a.reshape((6, 4)).is_view() and a.flatten().is_view()
+    assert a.expand_dims(1).squeeze(1).is_view()
+    t = a.permute(1, 0, 2)    # (3, 2, 4), only the last dim stays dense
+    assert t.reshape((3, 2, 2, 2)).is_view()
+    f = t.reshape((6, 4))
+    assert not f.is_view()
+    assert np.array_equal(np.array(f.tolist()), x.transpose(1, 0, 2).reshape(6, 4))
+
   def test_flatten(self):
     a = ax.array([[1, 2], [3, 4]])
     b = a.flatten()
@@ -409,6 +527,38 @@ class TestReductionOperations:
     expected = [1.0, 3.0]
     assert result.tolist() == expected
 
+  def test_reduce_axes_of_views(self):
+    x = (np.arange(7 * 40 * 9) % 23 - 11).reshape(7, 40, 9).astype(np.float32)
+    x[3, 5, 2] = np.nan
+    a = ax.array(x.tolist())
+    for v, xv in [(a, x), (a.permute(2, 0, 1), x.transpose(2, 0, 1))]:
+      for axis in range(3):
+        assert np.allclose(v.sum(axis).tolist(), xv.sum(axis=axis), equal_nan=True)
+        assert np.array_equal(v.max(axis).tolist(), np.fmax.reduce(xv, axis=axis), equal_nan=True)
+        assert np.array_equal(v.min(axis).tolist(), np.fmin.reduce(xv, axis=axis), equal_nan=True)
+
+  def test_reduce_multiple_axes(self):
+    x = (np.arange(2 * 3 * 4 * 5) % 13 - 6).reshape(2, 3, 4, 5).astype(np.float32)
+    a = ax.array(x.tolist())
+    for axes in [(0, 2), (1, -1), (0, 1, 2, 3)]:
+      for keepdims in [False, True]:
+        out = a.sum(axis=axes, keepdims=keepdims)
+        assert out.shape == x.sum(axis=axes, keepdims=keepdims).shape
+        assert np.allclose(out.tolist(), x.sum(axis=axes, keepdims=keepdims))
+        assert np.allclose(a.max(axis=axes, keepdims=keepdims).tolist(), x.max(axis=axes, keepdims=keepdims))
+        assert np.allclose(a.var(axis=axes, keepdims=keepdims).tolist(), x.var(axis=axes, keepdims=keepdims), atol=1e-5)
+
+  def test_reduce_negative_axes(self):
+    # -1 is the last axis like any other negative axis, only None reduces everything
+    x = (np.arange(3 * 4 * 5) % 7 - 3).reshape(3, 4, 5).astype(np.float32)
+    a = ax.array(x.tolist())
+    for axis in (-1, -2, -3):
+      assert a.sum(axis=axis).shape == x.sum(axis=axis).shape
+      assert np.allclose(a.sum(axis=axis).tolist(), x.sum(axis=axis))
+      assert np.allclose(a.mean(axis=axis, keepdims=True).tolist(), x.mean(axis=axis, keepdims=True))
+      assert np.allclose(a.var(axis=axis).tolist(), x.var(axis=axis), atol=1e-5)
+    assert a.sum(axis=None).shape == () and a.sum().tolist() == x.sum()
+
   def test_var_default(self):
     a = ax.array([1, 2, 3, 4])
     result = a.var()
@@ -433,6 +583,17 @@ class TestReductionOperations:
     expected = np.std([1, 2, 3, 4], ddof=1)
     assert abs(result.tolist() - expected) < 1e-5
 
+  def test_mean_var(self):
+    # a large offset relative to the spread is where a naive sum of squares loses the variance
+    x = (1e4 + (np.arange(3 * 5000) % 7 - 3) * 0.5).reshape(3, 5000).astype(np.float32)
+    a = ax.array(x.tolist())
+    for axis in [None, 0, 1, (0, 1)]:
+      mean, var = a.mean_var(axis=axis, ddof=1)
+      xd = x.astype(np.float64)
+      assert np.allclose(mean.tolist(), xd.mean(axis=axis), rtol=1e-6)
+      assert np.allclose(var.tolist(), xd.var(axis=axis, ddof=1), rtol=1e-4)
+      assert np.allclose(a.std(axis=axis, ddof=1).tolist(), xd.std(axis=axis, ddof=1), rtol=1e-4)
+
 class TestClippingOperations:
   def test_clip(self):
     a = ax.array([1, 5, 10, 15])
@@ -460,6 +621,13 @@ class TestComparisonOperations:
     expected = [False, True, False]
     assert result.tolist() == expected
 
+  def test_greater_broadcast(self):
+    a = ax.array([[1, 5], [3, 2]])
+    b = ax.array([2, 4])
+    result = a > b
+    assert result.shape == (2, 2)
+    assert result.tolist() == [[False, True], [True, False]]
+
   def test_not_equal_array(self):
     a = ax.array([1, 2, 3])
     b = ax.array([1, 5, 3])
@@ -28,6 +28,33 @@ class TestDecompose:
     assert l.shape == (2, 2, 2)
     assert u.shape == (2, 2, 2)
 
+  def test_lu_blocked(self):
+    # past one panel, so the trailing gemm updates & blocked triangular solves all run
+    x = np.random.default_rng(0).standard_normal((150, 150)) + 150 * np.eye(150)
+    a = ax.array(x.tolist(), dtype='float64')
+    l, u = ax.linalg.lu(a)
+    l, u = np.array(l.tolist()), np.array(u.tolist())
+    assert np.allclose(np.tril(l), l) and np.allclose(np.triu(u), u)
+    assert np.allclose(np.sort((l @ u).ravel()), np.sort(x.ravel()), atol=1e-4)
+    assert np.allclose(np.array(ax.linalg.inv(a).tolist()), np.linalg.inv(x), atol=1e-6)
+    b = np.arange(150.0)
+    assert np.allclose(ax.linalg.solve(a, ax.array(b.tolist(), dtype='float64')).tolist(), np.linalg.solve(x, b), atol=1e-5)
+    small = x[:6, :6]
+    assert abs(ax.linalg.det(ax.array(small.tolist(), dtype='float64')).tolist() / np.linalg.det(small) - 1) < 1e-5
+
+  def test_factor_reuse(self):
+    rng = np.random.default_rng(1)
+    x = rng.standard_normal((90, 90)) + 90 * np.eye(90)
+    spd = x @ x.T
+    lu, piv = ax.linalg.lu_factor(ax.array(x.tolist(), dtype='float64'))
+    c = ax.linalg.cho_factor(ax.array(spd.tolist(), dtype='float64'))
+    assert piv.shape == (90,) and np.allclose(np.array(c.tolist()), np.linalg.cholesky(spd), atol=1e-4)
+    for b in (rng.standard_normal(90), rng.standard_normal((90, 3)), rng.standard_normal((5, 90, 2))):
+      expected = np.linalg.solve(x, b) if b.ndim < 3 else np.stack([np.linalg.solve(x, m) for m in b])
+      assert np.allclose(ax.linalg.lu_solve((lu, piv), ax.array(b.tolist(), dtype='float64')).tolist(), expected, atol=1e-5)
+      expected = np.linalg.solve(spd, b) if b.ndim < 3 else np.stack([np.linalg.solve(spd, m) for m in b])
+      assert np.allclose(ax.linalg.cho_solve(c, ax.array(b.tolist(), dtype='float64')).tolist(), expected, atol=1e-5)
+
   def test_qr_2d(self):
     a = ax.array([[1, 1], [1, 0], [0, 1]], dtype='float32')
     q, r = ax.linalg.qr(a)
@@ -36,6 +63,22 @@ class TestDecompose:
     product = np.dot(np.array(q.tolist()), np.array(r.tolist()))
     assert np.allclose(product.tolist(), np.array(a.tolist()), atol=1e-4)
 
+  def test_qr_householder_lstsq(self):
+    rng = np.random.default_rng(2)
+    a = rng.standard_normal((150, 70))
+    for mode, k in (('complete', 150), ('reduced', 70)):
+      q, r = ax.linalg.qr(ax.array(a.tolist(), dtype='float64'), mode=mode)
+      assert q.shape == (150, k) and r.shape == (k, 70)
+      q, r = np.array(q.tolist()), np.array(r.tolist())
+      assert np.allclose(q.T @ q, np.eye(k), atol=1e-5) and np.allclose(q @ r, a, atol=1e-5)
+    # the normal equations lose this one in float32 (cond(a)^2 ~ 1e7)
+    v = np.vander(np.linspace(0, 1, 40), 6, increasing=True)
+    x = ax.linalg.lstsq(ax.array(v.tolist(), dtype='float32'), ax.array((v @ np.arange(1, 7.)).tolist(), dtype='float32'))
+    assert np.allclose(x.tolist(), np.arange(1, 7.), atol=1e-2)
+    wide, b = rng.standard_normal((2, 4, 9)), rng.standard_normal((2, 4))
+    x = ax.linalg.lstsq(ax.array(wide.tolist(), dtype='float64'), ax.array(b.tolist(), dtype='float64'))
+    assert x.shape == (2, 9) and np.allclose(x.tolist(), [np.linalg.lstsq(wide[i], b[i], rcond=None)[0] for i in range(2)], atol=1e-5)
+
   def test_svd_2d(self):
     a = ax.array([[1, 2], [3, 4], [5, 6]], dtype='float32')
     u, s, vt = ax.linalg.svd(a)
@@ -45,6 +88,88 @@ class TestDecompose:
     u_np, s_np, vt_np = np.linalg.svd(np.array(a.tolist()))
     assert np.allclose(np.array(s.tolist()), s_np, atol=1e-3)
 
+  def test_svd_bidiagonal_modes(self):
+    rng = np.random.default_rng(5)
+    a = rng.standard_normal((30, 12)) @ np.diag(np.logspace(0, -4, 12)) @ np.linalg.qr(rng.standard_normal((12, 12)))[0]
+    expected = np.linalg.svd(a, compute_uv=False)
+    for x, k in ((a, 12), (a.T, 12)):
+      u, s, vt = ax.linalg.svd(ax.array(x.tolist(), dtype='float64'), full_matrices=False)
+      assert u.shape == (x.shape[0], k) and vt.shape == (k, x.shape[1])
+      u, s, vt = np.array(u.tolist()), np.array(s.tolist()), np.array(vt.tolist())
+      assert np.allclose(s, expected, rtol=1e-3, atol=1e-9) and np.allclose(u * s @ vt, x, atol=1e-6)
+      assert np.allclose(u.T @ u, np.eye(k), atol=1e-6) and np.allclose(vt @ vt.T, np.eye(k), atol=1e-6)
+    u, s, vt = ax.linalg.svd(ax.array(a.tolist(), dtype='float64'))
+    assert u.shape == (30, 30) and vt.shape == (12, 12) and np.allclose(np.array(u.tolist()).T @ np.array(u.tolist()), np.eye(30), atol=1e-6)
+    s = ax.linalg.svd(ax.array(np.stack([a, 2 * a]).tolist(), dtype='float64'), compute_uv=False)
+    assert s.shape == (2, 12) and np.allclose(s.tolist(), [expected, 2 * expected], rtol=1e-3, atol=1e-9)
+
+  def test_truncated_svd_lanczos_eigh(self):
+    rng = np.random.default_rng(7)
+    q1, q2 = np.linalg.qr(rng.standard_normal((80, 40)))[0], np.linalg.qr(rng.standard_normal((40, 40)))[0]
+    sv = np.exp(-np.arange(40) / 4.0)
+    a = (q1 * sv) @ q2.T
+    for x in (a, a.T):
+      u, s, vt = ax.linalg.svd(ax.array(x.tolist(), dtype='float64'), k=5, seed=1)
+      assert u.shape == (x.shape[0], 5) and s.shape == (5,) and vt.shape == (5, x.shape[1])
+      u, s, vt = np.array(u.tolist()), np.array(s.tolist()), np.array(vt.tolist())
+      assert np.allclose(s, sv[:5], rtol=1e-4) and np.allclose(u.T @ u, np.eye(5), atol=1e-6)
+    s1, s2 = ax.linalg.svd(ax.array(a.tolist(), dtype='float64'), k=3, seed=4, compute_uv=False), ax.linalg.svd(ax.array(a.tolist(), dtype='float64'), k=3, seed=4, compute_uv=False)
+    assert s1.tolist() == s2.tolist()
+    b = rng.standard_normal((120, 120))
+    x = np.array(ax.array(((b + b.T) / 2).tolist(), dtype='float64').tolist())
+    ev = np.linalg.eigvalsh(x)
+    expected = np.sort(ev[np.argsort(-np.abs(ev))[:4]])
+    w = ax.linalg.eignh(ax.array(x.tolist(), dtype='float64'), k=4, seed=2)
+    z = np.array(ax.linalg.eignhv(ax.array(x.tolist(), dtype='float64'), k=4, seed=2).tolist())
+    assert np.allclose(w.tolist(), expected, atol=1e-4) and z.shape == (120, 4)
+    assert np.allclose(x @ z, z * expected, atol=1e-4) and np.all(z[0] >= 0)
+
+  def test_combined_decompositions(self):
+    rng = np.random.default_rng(11)
+    x = np.array(ax.array(rng.standard_normal((7, 7)).tolist(), dtype='float64').tolist())
+    a = ax.array(x.tolist(), dtype='float64')
+    l, u, perm = ax.linalg.lu(a, p_indices=True)
+    assert perm.shape == (7,) and np.allclose(x[np.array(perm.tolist(), dtype=int)], np.array(l.tolist()) @ np.array(u.tolist()), atol=1e-6)
+    wr, wi, v = ax.linalg.eig(a, imag=True)
+    w = np.array(wr.tolist()) + 1j * np.array(wi.tolist())
+    assert np.allclose(np.sort_complex(w), np.sort_complex(np.linalg.eigvals(x)), atol=1e-6)
+    assert np.allclose(v.tolist(), ax.linalg.eignv(a).tolist())
+    s = (x + x.T) / 2
+    w, z = ax.linalg.eigh(ax.array(np.stack([s, 2 * s]).tolist(), dtype='float64'))
+    w, z = np.array(w.tolist()), np.array(z.tolist())
+    assert w.shape == (2, 7) and z.shape == (2, 7, 7)
+    assert np.allclose(s @ z[0], z[0] * w[0], atol=1e-6) and np.allclose(w[1], 2 * w[0], atol=1e-6)
+    # outputs are labelled with the dtype their buffers hold, a requested dtype really casts them
+    labels = {0: 'float32', 1: 'float64'}
+    for outs in (ax.linalg.eigh(a), ax.linalg.eig(a), ax.linalg.svd(a, k=3, seed=1), ax.linalg.svd(a, dtype='float32', k=3, seed=1), ax.linalg.eigh(a, dtype='float32')):
+      for out in outs: assert out.dtype == labels[out.data.dtype]
+    w64, w32 = ax.linalg.eigh(a)[0], ax.linalg.eigh(a, dtype='float32')[0]
+    assert w64.dtype == 'float64' and w32.dtype == 'float32' and np.allclose((w64 * 2).tolist(), (w32 * 2).tolist(), atol=1e-5)
+
+  def test_small_batched_kernels(self):
+    # 70 matrices leave a ragged structure-of-arrays block, every simd level must match the general path
+    rng = np.random.default_rng(13)
+    initial = ax.simd_level()
+    try:
+      for n in (2, 3, 4, 6):
+        x = rng.standard_normal((70, n, n)) + n * np.eye(n)
+        x[5] = 0   # singular: det only, the zero pivot must not turn into nan
+        a = ax.array(x.tolist(), dtype='float64')
+        x = np.array(a.tolist())
+        b = np.array(ax.array(rng.standard_normal((70, n, 2)).tolist(), dtype='float64').tolist())
+        s = (x + x.transpose(0, 2, 1)) / 2
+        for level in ("scalar", "sse4", "avx2", "avx512"):
+          ax.set_simd_level(level)
+          assert np.allclose(ax.linalg.det(a).tolist(), np.linalg.det(x), atol=1e-5)
+          ok = np.arange(70) != 5
+          inv = np.array(ax.linalg.inv(ax.array(x[ok].tolist(), dtype='float64')).tolist())
+          assert np.allclose(inv, np.linalg.inv(x[ok]), atol=1e-5)
+          sol = np.array(ax.linalg.solve(ax.array(x[ok].tolist(), dtype='float64'), ax.array(b[ok].tolist(), dtype='float64')).tolist())
+          assert np.allclose(sol, np.linalg.solve(x[ok], b[ok]), atol=1e-5)
+          if n <= 3: assert np.allclose(ax.linalg.eignh(ax.array(s.tolist(), dtype='float64')).tolist(), np.linalg.eigvalsh(s), atol=1e-5)
+    finally:
+      ax.set_simd_level(initial)
+
   def test_cholesky(self):
     a = ax.array([[4, 12, -16], [12, 37, -43], [-16, -43, 98]], dtype='float32')
     result = ax.linalg.cholesky(a)
@@ -64,6 +189,21 @@ class TestDecompose:
     result = ax.linalg.eignv(a)
     assert result.shape == (2, 2)
 
+  def test_eign_francis_complex(self):
+    a = np.random.default_rng(4).standard_normal((40, 40))
+    wr, wi = ax.linalg.eign(ax.array(a.tolist(), dtype='float64'), imag=True)
+    w = np.array(wr.tolist()) + 1j * np.array(wi.tolist())
+    assert np.allclose(np.sort_complex(w), np.sort_complex(np.linalg.eigvals(a)), atol=1e-5)
+    # complex pairs come back as (real, imaginary) columns
+    v, vectors, j = np.array(ax.linalg.eignv(ax.array(a.tolist(), dtype='float64')).tolist()), [], 0
+    while j < 40:
+      if w[j].imag > 0: vectors += [v[:, j] + 1j * v[:, j + 1], v[:, j] - 1j * v[:, j + 1]]; j += 2
+      else: vectors.append(v[:, j]); j += 1
+    vectors = np.stack(vectors, axis=1)
+    assert np.allclose(a @ vectors, vectors * w, atol=1e-5) and np.allclose(np.linalg.norm(vectors, axis=0), 1, atol=1e-5)
+    wr, wi = ax.linalg.eign(ax.array([[0, -1], [1, 0]], dtype='float32'), imag=True)
+    assert np.allclose(wr.tolist(), [0, 0]) and np.allclose(wi.tolist(), [1, -1])
+
   def test_eignh_hermitian(self):
     a = ax.array([[2, 1], [1, 2]], dtype='float32')
     result = ax.linalg.eignh(a)
@@ -77,6 +217,17 @@ class TestDecompose:
     result = ax.linalg.eignhv(a)
     assert result.shape == (2, 2)
 
+  def test_eignh_tridiagonal_ql(self):
+    x = np.random.default_rng(3).standard_normal((120, 120))
+    a = x + x.T
+    expected = np.linalg.eigvalsh(a)
+    w = ax.linalg.eignh(ax.array(a.tolist(), dtype='float64'))
+    z = np.array(ax.linalg.eignhv(ax.array(a.tolist(), dtype='float64')).tolist())
+    assert np.allclose(w.tolist(), expected, atol=1e-4)
+    assert np.allclose(z.T @ z, np.eye(120), atol=1e-5) and np.allclose(a @ z, z * expected, atol=1e-4)
+    batch = ax.linalg.eignh(ax.array(np.stack([a[:40, :40], 2 * a[:40, :40]]).tolist(), dtype='float64'))
+    assert batch.shape == (2, 40) and np.allclose(batch.tolist(), np.linalg.eigvalsh(np.stack([a[:40, :40], 2 * a[:40, :40]])), atol=1e-4)
+
 class TestNorm:
   def test_normalize_mm(self):
     a = ax.array([1, 2, 3, 4, 5], dtype='float32')
@@ -0,0 +1,50 @@
+import pytest
+import numpy as np
+import axon as ax
+
+FUNCS = ["exp", "log", "sin", "cos", "tan", "sinh", "cosh", "tanh", "sqrt"]
+
+def ordered_bits(v):
+  i = np.asarray(v, dtype=np.float32).view(np.int32).astype(np.int64)
+  return np.where(i < 0, -(i & 0x7fffffff), i)
+
+def ulp_error(a, b):
+  a, b = np.asarray(a, dtype=np.float32), np.asarray(b, dtype=np.float32)
+  err = np.abs(ordered_bits(a) - ordered_bits(b))
+  err[np.isnan(a) & np.isnan(b)] = 0
+  return err
+
+def sweep_inputs():
+  # every 2^16th float32 bit pattern covers denormals, both signs & inf/nan, plus a dense pass over [-20, 20]
+  bits = (np.arange(0, 2**32, 2**16, dtype=np.uint64) + 12345).astype(np.uint32).view(np.float32)
+  dense = np.linspace(-20, 20, 8001, dtype=np.float32)
+  edges = np.array([np.inf, -np.inf, np.nan, 0.0, -0.0, 1e-45, 88.7, 89.4, -103.9, 524287.9, 1e6, 1e30], dtype=np.float32)
+  return np.concatenate([bits, dense, edges])
+
+class TestMathMode:
+  def setup_method(self): self.initial = ax.math_mode()
+  def teardown_method(self): ax.set_math_mode(self.initial)
+
+  def test_default_exact(self):
+    assert self.initial == "exact"
+
+  def test_set_mode(self):
+    assert ax.set_math_mode("fast") == "fast"
+    assert ax.math_mode() == "fast"
+    assert ax.set_math_mode("exact") == "exact"
+    with pytest.raises(ValueError, match="Unknown math mode"):
+      ax.set_math_mode("approx")
+
+  @pytest.mark.parametrize("fn", FUNCS)
+  def test_fast_ulp_bound(self, fn):
+    x = sweep_inputs()
+    a = ax.array(x.tolist())
+    ax.set_math_mode("exact")
+    exact = np.array(getattr(a, fn)().tolist(), dtype=np.float32)
+    ax.set_math_mode("fast")
+    fast = np.array(getattr(a, fn)().tolist(), dtype=np.float32)
+    assert np.array_equal(np.isnan(exact), np.isnan(fast))
+    assert ulp_error(exact, fast).max() <= (0 if fn == "sqrt" else 2)
+
+if __name__ == "__main__":
+  pytest.main([__file__, "-v"])
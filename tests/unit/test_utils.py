@@ -223,5 +223,122 @@ class TestUtils:
     with pytest.raises(ValueError, match="Invalid arange parameters"):
       ax.arange(0.0, 10.0, -1.0)
 
+  def test_simd_levels_agree(self):
+    # 19 columns leave a tail after every vector width, the nan checks the unordered != lane
+    a_np = np.arange(-19, 19, dtype=np.float32).reshape(2, 19) / 4
+    a_np[0, 0] = np.nan
+    b_np = np.linspace(-3, 3, 19, dtype=np.float32)
+    a, b = ax.array(a_np.tolist()), ax.array(b_np.tolist())
+    initial = ax.simd_level()
+    results = []
+    try:
+      for level in ("scalar", "sse4", "avx2", "avx512"):
+        ax.set_simd_level(level)
+        results.append(((a + b).tolist(), (a / 2.0).tolist(), (a != b).tolist(), (a > b).tolist()))
+    finally:
+      ax.set_simd_level(initial)
+    assert ax.simd_level() == initial
+    for res in results:
+      np.testing.assert_allclose(res[0], a_np + b_np, rtol=1e-6)
+      np.testing.assert_allclose(res[1], a_np / 2.0, rtol=1e-6)
+      assert res[2] == (a_np != b_np).tolist()
+      assert res[3] == (a_np > b_np).tolist()
+
+  def test_simd_level_unknown(self):
+    with pytest.raises(ValueError, match="Unknown simd level"):
+      ax.set_simd_level("neon")
+
+  def test_sum_modes(self):
+    # the 1s vanish next to 1e8 in float32, only the compensated mode keeps them
+    x = np.tile(np.array([1e8, 1, -1e8, 1], dtype=np.float32), 5003)
+    a, ones = ax.array(x.tolist()), ax.array(np.ones_like(x).tolist())
+    cols = ax.array(np.repeat(x[:, None], 9, axis=1).tolist())
+    initial_level, initial_mode = ax.simd_level(), ax.sum_mode()
+    assert initial_mode == "pairwise"
+    try:
+      for level in ("scalar", "sse4", "avx2", "avx512"):
+        ax.set_simd_level(level)
+        assert ax.set_sum_mode("kahan") == "kahan"
+        assert a.sum().tolist() == 2 * 5003
+        assert a.dot(ones).tolist() == 2 * 5003
+        assert cols.sum(axis=0).tolist() == [2.0 * 5003] * 9
+        assert ax.set_sum_mode("pairwise") == "pairwise"
+    finally:
+      ax.set_simd_level(initial_level)
+      ax.set_sum_mode(initial_mode)
+    with pytest.raises(ValueError, match="Unknown sum mode"):
+      ax.set_sum_mode("naive")
+
+  def test_pairwise_outer_axis(self):
+    # tall columns are added as a tree of row blocks too, serial adds drift to ~1e-5 here
+    rng = np.random.default_rng(3)
+    x = rng.random((300000, 3)).astype(np.float32)
+    y = rng.random((3, 200000, 2)).astype(np.float32)
+    a, b = ax.array(x.tolist()), ax.array(y.tolist())
+    ref_x, ref_y = x.astype(np.float64).sum(axis=0), y.astype(np.float64).sum(axis=1)
+    initial = ax.simd_level()
+    try:
+      for level in ("scalar", "avx2"):
+        ax.set_simd_level(level)
+        assert np.abs(np.array(a.sum(axis=0).tolist()) / ref_x - 1).max() < 1e-6
+        assert np.abs(np.array(a.mean(axis=0).tolist()) / (ref_x / len(x)) - 1).max() < 1e-6
+        assert np.abs(np.array(b.sum(axis=1).tolist()) / ref_y - 1).max() < 1e-6
+        assert np.abs(np.array(b.permute(1, 0, 2).sum(axis=0).tolist()) / ref_y - 1).max() < 1e-6
+    finally:
+      ax.set_simd_level(initial)
+
+  def test_num_threads_agree(self):
+    # big enough to be split into slices, odd widths so slices start & end mid-row
+    a_np = np.random.default_rng(17).standard_normal((301, 517)).astype(np.float32)
+    a = ax.array(a_np.tolist())
+    initial = ax.get_num_threads()
+    results = []
+    try:
+      for n in (1, 4):
+        assert ax.set_num_threads(n) == n
+        results.append(((a * a).tolist(), (a > 0.5).tolist(), a.sum().tolist(), a.sum(axis=0).tolist(), a.max(axis=1).tolist()))
+    finally:
+      ax.set_num_threads(initial)
+    assert ax.get_num_threads() == initial
+    assert results[0] == results[1]
+    np.testing.assert_allclose(results[1][0], a_np * a_np, rtol=1e-6)
+    # the total of zero-mean data can land near 0, so the float32 rounding gets an absolute floor
+    np.testing.assert_allclose(results[1][2], a_np.astype(np.float64).sum(), rtol=1e-4, atol=1e-3)
+    np.testing.assert_allclose(results[1][3], a_np.sum(axis=0), rtol=1e-4, atol=1e-4)
+    np.testing.assert_allclose(results[1][4], a_np.max(axis=1))
+
+  def test_num_threads_invalid(self):
+    with pytest.raises(ValueError, match="Thread count"):
+      ax.set_num_threads(-1)
+
+  def test_alloc_pool_reuse(self):
+    a = ax.array([[1, 2, 3], [4, 5, 6]])
+    (a + a).tolist()    # warms the size classes used below
+    ax.reset_alloc_stats()
+    for _ in range(50): b = a * 2.0
+    stats = ax.alloc_stats()
+    assert stats["hits"] >= 50 and stats["hit_rate"] > 0.9
+    assert b.tolist() == [[2, 4, 6], [8, 10, 12]]
+    ax.trim_alloc_pool()
+    assert ax.alloc_stats()["released"] > 0
+
+  def test_data_alignment_and_hugepages(self):
+    initial, threshold = ax.hugepage_mode(), ax.hugepage_threshold()
+    try:
+      ax.set_hugepage_mode("thp", 1 << 20)
+      small, big = ax.ones(3, 5), ax.ones(600, 600)
+      for a in (small, big, ax.ones(3000)): assert a.data.data % 64 == 0
+      assert not small.is_hugepage()
+      view = big.view()
+      assert view.is_hugepage() == big.is_hugepage()
+      del big
+      assert view.sum().tolist() == 360000.0
+      ax.set_hugepage_mode("off")
+      assert not ax.ones(600, 600).is_hugepage()
+    finally:
+      ax.set_hugepage_mode(initial, threshold)
+    with pytest.raises(ValueError, match="Unknown huge page mode"):
+      ax.set_hugepage_mode("always")
+
 if __name__ == "__main__":
   pytest.main([__file__, "-v"])
\ No newline at end of file